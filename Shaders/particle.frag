@@ -7,6 +7,10 @@ layout(location = 0) in vec4 fragColor; // Recibe el color de la partícula
 layout(location = 0) out vec4 outColor;
 
 void main() {
+    // Los slots libres del pool (partículas muertas) llegan con alfa 0: no se dibujan
+    if (fragColor.a <= 0.0) {
+        discard;
+    }
     // Asignar el color recibido del vertex shader
     outColor = fragColor;
 }
\ No newline at end of file
@@ -1,33 +1,42 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 // Entradas desde el buffer de vértices (coinciden con ParticleRenderer::getAttributeDescriptions)
 layout(location = 0) in vec2 inPosition; // Posición en coordenadas de simulación/mundo
-layout(location = 1) in vec4 inColor;    // Color de la partícula
+layout(location = 1) in uint inSpecies;  // Índice en la tabla de especies (16 bits bajos)
+layout(location = 3) in uint inAlive;    // 0 = slot libre del pool
+
+// El pipeline de puntos no tiene más descriptores: la tabla de especies es el set 0
+#define SPECIES_SET 0
+#include "species.glsl"
 
 // Salidas hacia el fragment shader
 layout(location = 0) out vec4 fragColor; // Color interpolado para el fragmento
 
-// Parámetros (Idealmente desde UBO o Push Constant, pero hardcodeados temporalmente)
-const float SIM_WIDTH = 1920.0;
-const float SIM_HEIGHT = 1080.0;
-const float POINT_SIZE = 4.0; // Tamaño del punto en píxeles
+// Cámara 2D (particulas::CameraPushConstants): ndc = posición del mundo * scale + offset
+layout(push_constant) uniform CameraParams {
+    vec2 scale;
+    vec2 offset;
+} camera;
+
+// Tamaño de punto como constante de especialización: cada variante de pipeline (PipelineVariantKey)
+// lo fija al compilar, así que sigue siendo una constante para el compilador del driver
+layout(constant_id = 0) const float POINT_SIZE = 4.0; // Tamaño del punto en píxeles
 
 void main() {
-    // 1. Transformar coordenadas de simulación a NDC [-1, +1]
-    //    NDC_X = (WorldX / Width) * 2.0 - 1.0
-    //    NDC_Y = (WorldY / Height) * 2.0 - 1.0
-    //    (Vulkan invierte Y implícitamente en el viewport por defecto, así que esta simple transformación funciona)
-    vec2 ndcPos;
-    ndcPos.x = (inPosition.x / SIM_WIDTH) * 2.0 - 1.0;
-    ndcPos.y = (inPosition.y / SIM_HEIGHT) * 2.0 - 1.0; // Y se mapea de [0, H] a [-1, 1]
+    // 1. Transformar coordenadas del mundo a NDC [-1, +1] con la cámara (zoom/desplazamiento).
+    //    El dominio de simulación ya no depende del tamaño de la ventana.
+    //    (Vulkan invierte Y implícitamente en el viewport por defecto, así que Y crece hacia abajo)
+    vec2 ndcPos = inPosition * camera.scale + camera.offset;
 
     // 2. Asignar la posición final en coordenadas de clip
     //    Z = 0.0 (en el plano cercano), W = 1.0 (sin perspectiva)
     gl_Position = vec4(ndcPos, 0.0, 1.0);
 
-    // 3. Establecer el tamaño del punto a renderizar
-    gl_PointSize = POINT_SIZE; // Necesita habilitar la característica 'shaderPointSize' en el Device
+    // 3. Establecer el tamaño del punto a renderizar: POINT_SIZE corresponde al radio 2 de la especie
+    Species species = speciesTable[speciesIndex(inSpecies)];
+    gl_PointSize = max(1.0, POINT_SIZE * species.radius * 0.5); // Necesita 'shaderPointSize' en el Device
 
-    // 4. Pasar el color de la partícula al fragment shader
-    fragColor = inColor;
+    // 4. Pasar el color de la especie al fragment shader (alfa 0 = hueco del pool, se descarta)
+    fragColor = inAlive != 0u ? species.color : vec4(0.0);
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+// Definiciones compartidas por los compute shaders de partículas en GPU.
+// Deben coincidir con particulas::Particle y GpuParticleSystem (gpu_particle_system.hpp).
+
+#define PARTICLE_GROUP_SIZE 256u
+
+#include "particle_struct.glsl"
+
+// Contadores globales (particulas::GpuParticleCounters)
+struct ParticleCounters {
+    uint rangeEnd;      // Fin del rango ocupado (vivas + huecos) en el buffer fuente
+    uint liveCount;     // Vivas tras la compactación
+    uint freeCount;     // Huecos apilados en freeList durante este frame
+    uint freeConsumed;  // Huecos ya reutilizados por la emisión
+    uint dropped;       // Emisiones descartadas por falta de capacidad
+};
+
+layout(std430, binding = 0) buffer SrcParticles { Particle src[]; };
+layout(std430, binding = 1) buffer DstParticles { Particle dst[]; };
+layout(std430, binding = 2) buffer Counters { ParticleCounters counters; };
+layout(std430, binding = 3) buffer FreeList { uint freeList[]; };
+layout(std430, binding = 4) buffer ScanOffsets { uint scanOffsets[]; };
+layout(std430, binding = 5) buffer BlockSums { uint blockSums[]; };
+layout(std430, binding = 6) buffer IndirectDraw {
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint firstInstance;
+} indirectDraw;
+layout(std430, binding = 7) buffer VisibleParticles { Particle visible[]; }; // Salida del culling
+layout(std430, binding = 8) buffer VisibleDraw {
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint firstInstance;
+} visibleDraw;
+
+// Mismo layout que particulas::GpuParticleParams
+layout(push_constant) uniform GpuParticleParams {
+    vec4 viewRect;          // Rectángulo visible del mundo (min.xy, max.xy) para el culling
+    vec2 emitterPosition;
+    vec2 emitterDirection;
+    vec2 domainSize;
+    vec2 gravity;           // Aceleración constante, escalada por Species::gravityScale
+    float deltaTime;
+    float spreadRadians;
+    float speed;
+    float speedJitter;
+    float particleLifetime;
+    uint emitCount;
+    uint capacity;
+    uint seed;
+    uint emitterSpecies;    // Índice en la tabla de especies de las partículas emitidas
+} params;
+
+uint occupiedRangeEnd() {
+    return min(counters.rangeEnd, params.capacity);
+}
@@ -0,0 +1,11 @@
+// Estructura Particle compartida por todos los compute shaders.
+// Mismo layout que particulas::Particle (32 bytes en std430).
+
+struct Particle {
+    vec2 position;
+    vec2 velocity;
+    float age;
+    float lifetime;
+    uint species; // Bits 0-15: índice en la tabla de especies (species.glsl); 16-31 reservados
+    uint alive;
+};
@@ -0,0 +1,23 @@
+// Tabla de especies (particulas::Species, species.hpp). Cada partícula guarda solo su índice
+// en los 16 bits bajos de Particle::species; color, radio y comportamiento se leen de aquí.
+// Por defecto es el set 1 (passes de cómputo); particle.vert define SPECIES_SET 0.
+
+#define MAX_SPECIES 256
+
+#ifndef SPECIES_SET
+#define SPECIES_SET 1
+#endif
+
+struct Species {
+    vec4 color;
+    float radius;
+    float drag;
+    float gravityScale;
+    float restitution;
+};
+
+layout(std140, set = SPECIES_SET, binding = 0) uniform SpeciesTable { Species speciesTable[MAX_SPECIES]; };
+
+uint speciesIndex(uint packedSpecies) {
+    return min(packedSpecies & 0xFFFFu, uint(MAX_SPECIES - 1));
+}
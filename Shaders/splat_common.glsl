@@ -0,0 +1,29 @@
+// Definiciones compartidas por el renderizador de splats (splat_renderer.hpp).
+// Las partículas se agrupan por teselas de pantalla de SPLAT_TILE_SIZE x SPLAT_TILE_SIZE píxeles;
+// cada tesela se acumula en memoria compartida con atómicos y se escribe a accumImage.
+
+#define SPLAT_TILE_SIZE 16u
+#define SPLAT_GROUP_SIZE 256u
+#define SPLAT_INVALID_TILE 0xFFFFFFFFu
+
+#include "particle_struct.glsl"
+
+layout(std430, binding = 0) readonly buffer Particles { Particle particles[]; };
+layout(std430, binding = 1) readonly buffer CountBuffer { uint gpuParticleCount; }; // VkDrawIndirectCommand::vertexCount
+layout(std430, binding = 2) buffer TileCounts { uint tileCounts[]; };
+layout(std430, binding = 3) buffer TileOffsets { uint tileOffsets[]; };
+layout(std430, binding = 4) buffer ParticleBins { uvec2 particleBins[]; }; // (tesela, posición dentro de la tesela)
+layout(std430, binding = 5) buffer BinnedIndices { uint binnedIndices[]; };
+layout(binding = 6, rgba32f) uniform image2D accumImage; // rgb = color medio, a = nº de partículas
+
+#include "splat_params.glsl"
+#include "species.glsl"
+
+uint splatParticleCount() {
+    return params.useCountBuffer != 0u ? min(gpuParticleCount, params.particleCount) : params.particleCount;
+}
+
+// Misma transformación que particle.vert (cámara 2D): mundo -> píxeles (Y hacia abajo)
+ivec2 splatPixel(vec2 position) {
+    return ivec2(floor(position * params.viewScale + params.viewOffset));
+}
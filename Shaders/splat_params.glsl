@@ -0,0 +1,15 @@
+// Push constants del renderizador de splats, compartidas por los compute shaders y el tone-map.
+
+// Mismo layout que particulas::SplatParams
+layout(push_constant) uniform SplatParams {
+    vec4 background;
+    vec2 viewScale;       // Mundo -> píxeles: pixel = position * viewScale + viewOffset (cámara 2D)
+    vec2 viewOffset;
+    uvec2 extent;
+    uint tilesX;
+    uint tileCount;
+    uint particleCount;   // Número de partículas (o capacidad si useCountBuffer)
+    uint useCountBuffer;  // 1 = leer el número de vivas de CountBuffer (simulación en GPU)
+    float exposure;
+    float renderScale;    // Píxeles del acumulador por píxel de pantalla (extent ya viene escalado)
+} params;
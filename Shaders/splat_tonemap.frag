@@ -0,0 +1,19 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Tone-map del acumulador de splats: la densidad se comprime con 1 - exp(-exposure * n)
+// y mezcla el color medio de las partículas sobre el fondo. Con renderScale < 1 el acumulador
+// solo cubre extent píxeles y se amplía al más cercano.
+
+#include "splat_params.glsl"
+
+layout(binding = 6, rgba32f) readonly uniform image2D accumImage; // Mismo binding que en splat_common.glsl
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    ivec2 pixel = min(ivec2(gl_FragCoord.xy * params.renderScale), ivec2(params.extent) - 1);
+    vec4 accum = imageLoad(accumImage, pixel);
+    float coverage = 1.0 - exp(-params.exposure * accum.a);
+    outColor = vec4(mix(params.background.rgb, accum.rgb, coverage), 1.0);
+}
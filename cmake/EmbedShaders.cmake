@@ -0,0 +1,36 @@
+# Genera un .cpp con el SPIR-V de cada shader como array de bytes, para que el ejecutable
+# no lea ficheros de shaders al arrancar (ver src/core/embedded_shaders.hpp).
+# Uso: cmake -DSPIRV_FILES="a.spv|b.spv" -DOUTPUT_FILE=embedded_shaders.cpp -P EmbedShaders.cmake
+
+string(REPLACE "|" ";" SPIRV_FILES "${SPIRV_FILES}")
+
+set(CONTENT "// Generado por cmake/EmbedShaders.cmake a partir de los .spv compilados. No editar.\n")
+string(APPEND CONTENT "#include \"core/embedded_shaders.hpp\"\n\nnamespace particulas {\n\nnamespace {\n\n")
+# CMake no admite cuantificadores {n}: patrón de 16 bytes construido a mano
+set(LINE_PATTERN "")
+foreach(BYTE_INDEX RANGE 1 16)
+    string(APPEND LINE_PATTERN "0x[0-9a-f][0-9a-f],")
+endforeach()
+
+set(TABLE "")
+set(INDEX 0)
+foreach(SPIRV_FILE ${SPIRV_FILES})
+    get_filename_component(SHADER_NAME ${SPIRV_FILE} NAME)
+    file(READ ${SPIRV_FILE} HEX_DATA HEX)
+    string(LENGTH "${HEX_DATA}" HEX_LENGTH)
+    math(EXPR BYTE_COUNT "${HEX_LENGTH} / 2")
+    # 0xAB, por byte y un salto de línea cada 16 bytes
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX_DATA}")
+    string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n    " BYTES "${BYTES}")
+    string(APPEND CONTENT "// ${SHADER_NAME}\nalignas(4) const unsigned char shader${INDEX}[] = {\n    ${BYTES}\n};\n\n")
+    string(APPEND TABLE "    {\"${SHADER_NAME}\", shader${INDEX}, ${BYTE_COUNT}},\n")
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+string(APPEND CONTENT "const EmbeddedShader embeddedShaders[] = {\n${TABLE}    {nullptr, nullptr, 0} // Centinela\n};\n\n} // namespace\n\n")
+string(APPEND CONTENT "const EmbeddedShader* findEmbeddedShader(const std::string& name) {\n")
+string(APPEND CONTENT "    for (const EmbeddedShader* shader = embeddedShaders; shader->name != nullptr; ++shader) {\n")
+string(APPEND CONTENT "        if (name == shader->name) return shader;\n    }\n    return nullptr;\n}\n\n")
+string(APPEND CONTENT "size_t getEmbeddedShaderCount() {\n    return ${INDEX};\n}\n\n} // namespace particulas\n")
+
+file(WRITE "${OUTPUT_FILE}" "${CONTENT}")
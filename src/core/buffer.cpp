@@ -0,0 +1,39 @@
+#include "buffer.hpp"
+#include "utils/vulkan_debug.hpp"
+
+namespace particulas {
+
+Buffer::Buffer(const Device& device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+    : device_(device.getLogicalDevice()), size_(size) {
+    VkBufferCreateInfo bufferInfo{}; bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO; bufferInfo.size = size; bufferInfo.usage = usage; bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    particulas::debug::checkVkResult(vkCreateBuffer(device_, &bufferInfo, nullptr, &buffer_), "Buffer creation");
+
+    VkMemoryRequirements memRequirements; vkGetBufferMemoryRequirements(device_, buffer_, &memRequirements);
+    VkMemoryAllocateInfo allocInfo{}; allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO; allocInfo.allocationSize = memRequirements.size;
+    try {
+        allocInfo.memoryTypeIndex = device.findMemoryType(memRequirements.memoryTypeBits, properties);
+        particulas::debug::checkVkResult(vkAllocateMemory(device_, &allocInfo, nullptr, &memory_), "Buffer memory allocation");
+        particulas::debug::checkVkResult(vkBindBufferMemory(device_, buffer_, memory_, 0), "Bind buffer memory");
+    } catch (...) {
+        if (memory_ != VK_NULL_HANDLE) vkFreeMemory(device_, memory_, nullptr);
+        vkDestroyBuffer(device_, buffer_, nullptr);
+        throw;
+    }
+}
+
+Buffer::~Buffer() {
+    if (mapped_) vkUnmapMemory(device_, memory_);
+    if (buffer_ != VK_NULL_HANDLE) vkDestroyBuffer(device_, buffer_, nullptr);
+    if (memory_ != VK_NULL_HANDLE) vkFreeMemory(device_, memory_, nullptr);
+}
+
+void* Buffer::map() {
+    if (!mapped_) particulas::debug::checkVkResult(vkMapMemory(device_, memory_, 0, size_, 0, &mapped_), "Map buffer memory");
+    return mapped_;
+}
+
+void Buffer::unmap() {
+    if (mapped_) { vkUnmapMemory(device_, memory_); mapped_ = nullptr; }
+}
+
+} // namespace particulas
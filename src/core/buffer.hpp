@@ -0,0 +1,37 @@
+#ifndef PARTICULAS_CORE_BUFFER_HPP
+#define PARTICULAS_CORE_BUFFER_HPP
+
+#include "core/device.hpp"
+
+#include <vulkan/vulkan.h>
+
+namespace particulas {
+
+// VkBuffer + VkDeviceMemory propios (RAII). Lanza excepción si falla la creación.
+class Buffer {
+public:
+    Buffer(const Device& device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+    ~Buffer();
+
+    VkBuffer get() const { return buffer_; }
+    VkDeviceMemory getMemory() const { return memory_; }
+    VkDeviceSize getSize() const { return size_; }
+
+    // Solo para memoria HOST_VISIBLE. El puntero sigue válido hasta unmap() o la destrucción.
+    void* map();
+    void unmap();
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+private:
+    VkDevice device_;
+    VkBuffer buffer_ = VK_NULL_HANDLE;
+    VkDeviceMemory memory_ = VK_NULL_HANDLE;
+    VkDeviceSize size_ = 0;
+    void* mapped_ = nullptr;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_BUFFER_HPP
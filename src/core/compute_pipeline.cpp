@@ -0,0 +1,32 @@
+#include "compute_pipeline.hpp"
+#include "shader_module.hpp"
+#include "utils/vulkan_debug.hpp"
+
+namespace particulas {
+
+ComputePipeline::ComputePipeline(VkDevice device, const std::string& shaderPath, VkPipelineLayout pipelineLayout,
+                                 VkPipelineCache pipelineCache)
+    : device_(device) {
+    VkShaderModule shaderModule = createShaderModule(device_, shaderPath);
+
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = shaderModule;
+    stageInfo.pName = "main";
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = stageInfo;
+    pipelineInfo.layout = pipelineLayout;
+
+    VkResult result = vkCreateComputePipelines(device_, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline_);
+    vkDestroyShaderModule(device_, shaderModule, nullptr); // Limpiar el módulo incluso si falla
+    particulas::debug::checkVkResult(result, "Create compute pipeline from " + shaderPath);
+}
+
+ComputePipeline::~ComputePipeline() {
+    if (pipeline_ != VK_NULL_HANDLE) vkDestroyPipeline(device_, pipeline_, nullptr);
+}
+
+} // namespace particulas
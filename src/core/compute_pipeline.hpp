@@ -0,0 +1,29 @@
+#ifndef PARTICULAS_CORE_COMPUTE_PIPELINE_HPP
+#define PARTICULAS_CORE_COMPUTE_PIPELINE_HPP
+
+#include <vulkan/vulkan.h>
+#include <string>
+
+namespace particulas {
+
+// Pipeline de cómputo de un solo shader. El layout lo proporciona (y lo destruye) quien lo crea,
+// para que varios pipelines compartan descriptores y push constants.
+class ComputePipeline {
+public:
+    ComputePipeline(VkDevice device, const std::string& shaderPath, VkPipelineLayout pipelineLayout,
+                    VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+    ~ComputePipeline();
+
+    VkPipeline get() const { return pipeline_; }
+
+    ComputePipeline(const ComputePipeline&) = delete;
+    ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+private:
+    VkDevice device_;
+    VkPipeline pipeline_ = VK_NULL_HANDLE;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_COMPUTE_PIPELINE_HPP
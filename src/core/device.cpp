@@ -1,14 +1,15 @@
 
 #include "device.hpp"
 #include "utils/vulkan_debug.hpp"
+#include "utils/logger.hpp"
 #include <vulkan/vulkan_core.h>
 
 #include <stdexcept>
-#include <iostream>
 #include <vector>
 #include <set>
 #include <string>
 #include <optional>
+#include <algorithm>
 
 namespace particulas {
 
@@ -40,7 +41,7 @@ void Device::pickPhysicalDevice() {
         if (isDeviceSuitable(device)) {
             physicalDevice_ = device;
             VkPhysicalDeviceProperties props; vkGetPhysicalDeviceProperties(physicalDevice_, &props);
-            std::cout << "Selected Physical Device: " << props.deviceName << std::endl;
+            PARTICULAS_LOG(Info) << "Selected Physical Device: " << props.deviceName;
             break;
         }
     }
@@ -93,6 +94,32 @@ static uint32_t findPresentQueueFamilyInternal(VkPhysicalDevice device, VkSurfac
     throw std::runtime_error("Internal Error: No present queue family found!");
 }
 
+// Semáforos timeline: extensión VK_KHR_timeline_semaphore + característica timelineSemaphore.
+// vkGetPhysicalDeviceFeatures2 es núcleo 1.1 (la instancia pide 1.1).
+static bool queryTimelineSemaphoreSupport(VkPhysicalDevice device) {
+    VkPhysicalDeviceProperties props; vkGetPhysicalDeviceProperties(device, &props);
+    if (props.apiVersion < VK_API_VERSION_1_1) return false;
+    uint32_t extensionCount = 0; vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount); vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+    bool hasExtension = false;
+    for (const auto& extension : extensions) { if (std::string(extension.extensionName) == VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) { hasExtension = true; break; } }
+    if (!hasExtension) return false;
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures{}; timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    VkPhysicalDeviceFeatures2 features2{}; features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2; features2.pNext = &timelineFeatures;
+    vkGetPhysicalDeviceFeatures2(device, &features2);
+    return timelineFeatures.timelineSemaphore == VK_TRUE;
+}
+
+// VK_EXT_memory_budget: se consulta con vkGetPhysicalDeviceMemoryProperties2 (núcleo 1.1)
+static bool queryMemoryBudgetSupport(VkPhysicalDevice device) {
+    VkPhysicalDeviceProperties props; vkGetPhysicalDeviceProperties(device, &props);
+    if (props.apiVersion < VK_API_VERSION_1_1) return false;
+    uint32_t extensionCount = 0; vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount); vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+    for (const auto& extension : extensions) { if (std::string(extension.extensionName) == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) return true; }
+    return false;
+}
+
 void Device::createLogicalDevice() {
     graphicsQueueFamilyIndex_ = findQueueFamilies(physicalDevice_);
     presentQueueFamilyIndex_ = findPresentQueueFamilyInternal(physicalDevice_, surface_);
@@ -108,16 +135,27 @@ void Device::createLogicalDevice() {
     // --- Habilitar Características - USAR VkPhysicalDeviceFeatures BÁSICA Y VACÍA ---
     VkPhysicalDeviceFeatures deviceFeaturesToEnable{}; // <-- Estructura básica vacía
 
+    // --- Extensiones opcionales ---
+    std::vector<const char*> enabledExtensions = deviceExtensions;
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures{}; timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    timelineSemaphores_ = queryTimelineSemaphoreSupport(physicalDevice_);
+    if (timelineSemaphores_) {
+        enabledExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        timelineFeatures.timelineSemaphore = VK_TRUE;
+    }
+    memoryBudget_ = queryMemoryBudgetSupport(physicalDevice_);
+    if (memoryBudget_) enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME); // Sin características: basta con habilitarla
+
     // --- Información de Creación ---
     VkDeviceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    createInfo.pNext = nullptr;                         // <-- SIN pNext
+    createInfo.pNext = timelineSemaphores_ ? &timelineFeatures : nullptr; // Solo características opcionales
     createInfo.pEnabledFeatures = &deviceFeaturesToEnable; // <-- Apuntar a features básicas vacías
 
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+    createInfo.ppEnabledExtensionNames = enabledExtensions.data();
     createInfo.enabledLayerCount = 0;
     createInfo.ppEnabledLayerNames = nullptr;
 
@@ -126,7 +164,9 @@ void Device::createLogicalDevice() {
 
     vkGetDeviceQueue(logicalDevice_, graphicsQueueFamilyIndex_, 0, &graphicsQueue_);
     vkGetDeviceQueue(logicalDevice_, presentQueueFamilyIndex_, 0, &presentQueue_);
-    std::cout << "Logical device created successfully (without explicit shaderPointSize)." << std::endl;
+    PARTICULAS_LOG(Info) << "Logical device created successfully (without explicit shaderPointSize, timeline semaphores "
+              << (timelineSemaphores_ ? "enabled" : "unavailable") << ", memory budget "
+              << (memoryBudget_ ? "enabled" : "unavailable") << ").";
 }
 
 uint32_t Device::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
@@ -136,4 +176,37 @@ uint32_t Device::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags prope
     throw std::runtime_error("Failed to find suitable memory type!");
 }
 
-} // namespace particulas
\ No newline at end of file
+uint32_t Device::queryMemoryBudget(MemoryBudget& heaps) const {
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{}; budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    VkPhysicalDeviceMemoryProperties2 memProperties2{}; memProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memProperties2.pNext = memoryBudget_ ? &budgetProperties : nullptr;
+    vkGetPhysicalDeviceMemoryProperties2(physicalDevice_, &memProperties2);
+
+    const VkPhysicalDeviceMemoryProperties& memProperties = memProperties2.memoryProperties;
+    for (uint32_t i = 0; i < memProperties.memoryHeapCount; ++i) {
+        MemoryHeapBudget& heap = heaps[i];
+        heap.size = memProperties.memoryHeaps[i].size;
+        heap.deviceLocal = (memProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        if (memoryBudget_) {
+            heap.budget = budgetProperties.heapBudget[i];
+            heap.usage = budgetProperties.heapUsage[i];
+        } else {
+            heap.budget = heap.size / 5 * 4; // El driver y otros procesos también usan el heap
+            heap.usage = 0;
+        }
+    }
+    return memProperties.memoryHeapCount;
+}
+
+VkDeviceSize Device::getAvailableDeviceLocalBytes() const {
+    MemoryBudget heaps;
+    uint32_t heapCount = queryMemoryBudget(heaps);
+    VkDeviceSize available = 0;
+    for (uint32_t i = 0; i < heapCount; ++i) {
+        if (!heaps[i].deviceLocal || heaps[i].usage >= heaps[i].budget) continue;
+        available = std::max(available, heaps[i].budget - heaps[i].usage);
+    }
+    return available;
+}
+
+} // namespace particulas
@@ -2,6 +2,7 @@
 #define PARTICULAS_CORE_DEVICE_HPP
 
 #include <vulkan/vulkan.h>
+#include <array>
 #include <vector>
 #include <optional>
 #include <string> // Para std::string en checkVkResult
@@ -15,6 +16,16 @@ struct SwapChainSupportDetails {
 
 namespace particulas {
 
+// Estado de un heap de memoria. Con VK_EXT_memory_budget, budget y usage son los que informa el
+// driver para este proceso; sin ella, budget es una estimación (80% del heap) y usage es 0 (desconocido).
+struct MemoryHeapBudget {
+    VkDeviceSize size = 0;
+    VkDeviceSize budget = 0;
+    VkDeviceSize usage = 0;
+    bool deviceLocal = false;
+};
+using MemoryBudget = std::array<MemoryHeapBudget, VK_MAX_MEMORY_HEAPS>;
+
 class Device {
 public:
     Device(VkInstance instance, VkSurfaceKHR surface);
@@ -25,6 +36,16 @@ public:
     VkQueue getGraphicsQueue() const { return graphicsQueue_; }
     VkQueue getPresentQueue() const { return presentQueue_; }
     uint32_t getGraphicsQueueFamilyIndex() const { return graphicsQueueFamilyIndex_; }
+    // VK_KHR_timeline_semaphore habilitado (extensión o núcleo 1.2) con la característica timelineSemaphore
+    bool supportsTimelineSemaphores() const { return timelineSemaphores_; }
+    // VK_EXT_memory_budget habilitado: queryMemoryBudget devuelve uso y presupuesto reales por heap
+    bool supportsMemoryBudget() const { return memoryBudget_; }
+
+    // Un elemento por heap, sin reservar memoria (se puede llamar cada frame). Devuelve el número de heaps.
+    uint32_t queryMemoryBudget(MemoryBudget& heaps) const;
+    // Lo que aún cabe en el heap DEVICE_LOCAL con más margen (presupuesto - uso), para planificar
+    // reservas grandes antes de hacerlas en lugar de fallar con VK_ERROR_OUT_OF_DEVICE_MEMORY.
+    VkDeviceSize getAvailableDeviceLocalBytes() const;
     // uint32_t getPresentQueueFamilyIndex() const { return presentQueueFamilyIndex_; } // Si se almacenara
 
     // --- Función de Utilidad ---
@@ -45,6 +66,8 @@ private:
     VkQueue presentQueue_ = VK_NULL_HANDLE;
     uint32_t graphicsQueueFamilyIndex_ = UINT32_MAX; // Inicializar a valor inválido
     uint32_t presentQueueFamilyIndex_ = UINT32_MAX; // Almacenar también el índice de presentación
+    bool timelineSemaphores_ = false;
+    bool memoryBudget_ = false;
 };
 
 } // namespace particulas
@@ -0,0 +1,23 @@
+#ifndef PARTICULAS_CORE_EMBEDDED_SHADERS_HPP
+#define PARTICULAS_CORE_EMBEDDED_SHADERS_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace particulas {
+
+// SPIR-V incrustado en el ejecutable en tiempo de compilación (cmake/EmbedShaders.cmake).
+// data está alineado a 4 bytes y puede pasarse directamente como pCode.
+struct EmbeddedShader {
+    const char* name;           // Nombre del fichero compilado, p.ej. "particle.vert.spv"
+    const unsigned char* data;
+    size_t size;                // En bytes
+};
+
+// nullptr si el shader no está incrustado
+const EmbeddedShader* findEmbeddedShader(const std::string& name);
+size_t getEmbeddedShaderCount();
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_EMBEDDED_SHADERS_HPP
@@ -0,0 +1,88 @@
+#include "frame_command_pools.hpp"
+#include "utils/vulkan_debug.hpp"
+
+#include <stdexcept>
+
+namespace particulas {
+
+FrameCommandPools::FrameCommandPools(VkDevice device, uint32_t queueFamilyIndex, uint32_t framesInFlight, size_t threadCount)
+    : device_(device), queueFamilyIndex_(queueFamilyIndex), threadCount_(threadCount) {
+    if (framesInFlight == 0 || threadCount == 0) throw std::invalid_argument("FrameCommandPools needs at least one frame and one thread.");
+    frames_.resize(framesInFlight);
+    try {
+        for (Frame& frame : frames_) {
+            frame.primaryPool = createPool();
+            VkCommandBufferAllocateInfo allocInfo{}; allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frame.primaryPool; allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            particulas::debug::checkVkResult(vkAllocateCommandBuffers(device_, &allocInfo, &frame.primary), "Frame primary command buffer allocation");
+
+            frame.threads.resize(threadCount_);
+            for (ThreadPoolSlot& slot : frame.threads) slot.pool = createPool();
+        }
+    } catch (...) {
+        destroy();
+        throw;
+    }
+}
+
+FrameCommandPools::~FrameCommandPools() {
+    destroy();
+}
+
+VkCommandPool FrameCommandPools::createPool() const {
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = queueFamilyIndex_;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; // Sin RESET_COMMAND_BUFFER: solo reinicio del pool entero
+    VkCommandPool pool = VK_NULL_HANDLE;
+    particulas::debug::checkVkResult(vkCreateCommandPool(device_, &poolInfo, nullptr, &pool), "Frame command pool creation");
+    return pool;
+}
+
+void FrameCommandPools::destroy() {
+    // Destruir un pool libera también sus command buffers
+    for (Frame& frame : frames_) {
+        for (ThreadPoolSlot& slot : frame.threads) {
+            if (slot.pool != VK_NULL_HANDLE) vkDestroyCommandPool(device_, slot.pool, nullptr);
+        }
+        if (frame.primaryPool != VK_NULL_HANDLE) vkDestroyCommandPool(device_, frame.primaryPool, nullptr);
+    }
+    frames_.clear();
+}
+
+void FrameCommandPools::beginFrame(uint32_t frameIndex) {
+    Frame& frame = frames_.at(frameIndex);
+    particulas::debug::checkVkResult(vkResetCommandPool(device_, frame.primaryPool, 0), "Reset frame primary command pool");
+    for (ThreadPoolSlot& slot : frame.threads) {
+        if (slot.used == 0) continue; // Nada grabado en este pool desde el último reinicio
+        particulas::debug::checkVkResult(vkResetCommandPool(device_, slot.pool, 0), "Reset frame thread command pool");
+        slot.used = 0;
+    }
+}
+
+VkCommandBuffer FrameCommandPools::beginSecondary(uint32_t frameIndex, size_t threadIndex,
+                                                  VkRenderPass renderPass, VkFramebuffer framebuffer) {
+    if (threadIndex >= threadCount_) throw std::out_of_range("FrameCommandPools thread index out of range.");
+    ThreadPoolSlot& slot = frames_[frameIndex].threads[threadIndex];
+    if (slot.used == slot.secondaries.size()) {
+        VkCommandBufferAllocateInfo allocInfo{}; allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = slot.pool; allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        particulas::debug::checkVkResult(vkAllocateCommandBuffers(device_, &allocInfo, &commandBuffer), "Secondary command buffer allocation");
+        slot.secondaries.push_back(commandBuffer);
+    }
+    VkCommandBuffer commandBuffer = slot.secondaries[slot.used++];
+
+    VkCommandBufferInheritanceInfo inheritance{}; inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = renderPass; inheritance.subpass = 0; inheritance.framebuffer = framebuffer;
+    VkCommandBufferBeginInfo beginInfo{}; beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (renderPass != VK_NULL_HANDLE) beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritance;
+    particulas::debug::checkVkResult(vkBeginCommandBuffer(commandBuffer, &beginInfo), "Begin secondary command buffer");
+    return commandBuffer;
+}
+
+} // namespace particulas
@@ -0,0 +1,61 @@
+#ifndef PARTICULAS_CORE_FRAME_COMMAND_POOLS_HPP
+#define PARTICULAS_CORE_FRAME_COMMAND_POOLS_HPP
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace particulas {
+
+// Command pools por frame en vuelo y por hilo de grabación. Cada frame tiene un pool con su
+// command buffer primario y un pool por hilo para los secundarios, así los hilos graban en
+// paralelo sin compartir pool (los pools exigen sincronización externa). Todos los pools son
+// TRANSIENT y se reinician de golpe con vkResetCommandPool al empezar el frame, en vez de
+// reiniciar cada command buffer por separado.
+class FrameCommandPools {
+public:
+    // threadCount: hilos que pueden grabar (ThreadPool::getConcurrency()); threadIndex < threadCount
+    FrameCommandPools(VkDevice device, uint32_t queueFamilyIndex, uint32_t framesInFlight, size_t threadCount);
+    ~FrameCommandPools();
+
+    // Reinicia todos los pools del frame. Solo tras esperar a que la GPU terminó con él.
+    void beginFrame(uint32_t frameIndex);
+
+    VkCommandBuffer getPrimary(uint32_t frameIndex) const { return frames_[frameIndex].primary; }
+
+    // Comienza un secundario del pool del hilo threadIndex (se reutilizan los ya asignados).
+    // Con renderPass != VK_NULL_HANDLE se graba para ejecutarse dentro de ese render pass (subpass 0).
+    VkCommandBuffer beginSecondary(uint32_t frameIndex, size_t threadIndex,
+                                   VkRenderPass renderPass = VK_NULL_HANDLE, VkFramebuffer framebuffer = VK_NULL_HANDLE);
+
+    size_t getThreadCount() const { return threadCount_; }
+
+    FrameCommandPools(const FrameCommandPools&) = delete;
+    FrameCommandPools& operator=(const FrameCommandPools&) = delete;
+
+private:
+    struct ThreadPoolSlot {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> secondaries; // Asignados bajo demanda y reutilizados
+        size_t used = 0;                          // Secundarios en uso este frame
+    };
+    struct Frame {
+        VkCommandPool primaryPool = VK_NULL_HANDLE;
+        VkCommandBuffer primary = VK_NULL_HANDLE;
+        std::vector<ThreadPoolSlot> threads;
+    };
+
+    VkCommandPool createPool() const;
+    void destroy();
+
+    VkDevice device_;
+    uint32_t queueFamilyIndex_;
+    size_t threadCount_;
+    std::vector<Frame> frames_;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_FRAME_COMMAND_POOLS_HPP
@@ -0,0 +1,59 @@
+#include "gpu_timer.hpp"
+#include "utils/vulkan_debug.hpp"
+#include "utils/logger.hpp"
+
+
+namespace particulas {
+
+GpuTimer::GpuTimer(const Device& device, uint32_t framesInFlight)
+    : device_(device.getLogicalDevice()), written_(framesInFlight, 0) {
+    VkPhysicalDeviceProperties properties; vkGetPhysicalDeviceProperties(device.getPhysicalDevice(), &properties);
+    uint32_t familyCount = 0; vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount); vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, families.data());
+    uint32_t validBits = families[device.getGraphicsQueueFamilyIndex()].timestampValidBits;
+    if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f) {
+        PARTICULAS_LOG(Warning) << "graphics queue does not support timestamps; GPU timing disabled.";
+        return;
+    }
+    nanosecondsPerTick_ = properties.limits.timestampPeriod;
+    validMask_ = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1ull);
+
+    VkQueryPoolCreateInfo poolInfo{}; poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP; poolInfo.queryCount = framesInFlight * 2;
+    particulas::debug::checkVkResult(vkCreateQueryPool(device_, &poolInfo, nullptr, &queryPool_), "Timestamp query pool creation");
+}
+
+GpuTimer::~GpuTimer() {
+    if (queryPool_ != VK_NULL_HANDLE) vkDestroyQueryPool(device_, queryPool_, nullptr);
+}
+
+void GpuTimer::reset(VkCommandBuffer commandBuffer, uint32_t frame) {
+    if (!isSupported()) return;
+    vkCmdResetQueryPool(commandBuffer, queryPool_, frame * 2, 2);
+    written_[frame] = 0;
+}
+
+void GpuTimer::begin(VkCommandBuffer commandBuffer, uint32_t frame) {
+    if (!isSupported()) return;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_, frame * 2);
+}
+
+void GpuTimer::end(VkCommandBuffer commandBuffer, uint32_t frame) {
+    if (!isSupported()) return;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_, frame * 2 + 1);
+    written_[frame] = 1;
+}
+
+bool GpuTimer::resolve(uint32_t frame, double& milliseconds) {
+    if (!isSupported() || !written_[frame]) return false;
+    uint64_t timestamps[2] = {0, 0};
+    VkResult result = vkGetQueryPoolResults(device_, queryPool_, frame * 2, 2, sizeof(timestamps), timestamps,
+                                            sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) return false; // VK_NOT_READY: el frame aún no ha terminado
+    written_[frame] = 0;
+    uint64_t ticks = ((timestamps[1] & validMask_) - (timestamps[0] & validMask_)) & validMask_;
+    milliseconds = static_cast<double>(ticks) * nanosecondsPerTick_ * 1e-6;
+    return true;
+}
+
+} // namespace particulas
@@ -0,0 +1,42 @@
+#ifndef PARTICULAS_CORE_GPU_TIMER_HPP
+#define PARTICULAS_CORE_GPU_TIMER_HPP
+
+#include "core/device.hpp"
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace particulas {
+
+// Intervalo de tiempo de GPU por frame en vuelo (dos timestamps por slot).
+// Si la cola no admite timestamps isSupported() es false y todas las llamadas son no-ops.
+class GpuTimer {
+public:
+    GpuTimer(const Device& device, uint32_t framesInFlight);
+    ~GpuTimer();
+
+    bool isSupported() const { return queryPool_ != VK_NULL_HANDLE; }
+
+    // reset() va fuera de cualquier render pass; begin()/end() pueden ir dentro
+    void reset(VkCommandBuffer commandBuffer, uint32_t frame);
+    void begin(VkCommandBuffer commandBuffer, uint32_t frame);
+    void end(VkCommandBuffer commandBuffer, uint32_t frame);
+
+    // Tras esperar la fence del frame: duración del último intervalo grabado en el slot.
+    // Devuelve false si el slot no tiene un intervalo completo.
+    bool resolve(uint32_t frame, double& milliseconds);
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+private:
+    VkDevice device_;
+    VkQueryPool queryPool_ = VK_NULL_HANDLE;
+    double nanosecondsPerTick_ = 1.0;
+    uint64_t validMask_ = ~0ull;
+    std::vector<uint8_t> written_; // Slot con begin+end grabados y aún no resueltos
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_GPU_TIMER_HPP
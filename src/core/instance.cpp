@@ -1,8 +1,8 @@
 #include "instance.hpp"
 #include "utils/vulkan_debug.hpp"
+#include "utils/logger.hpp"
 
 #include <GLFW/glfw3.h>
-#include <iostream>
 #include <stdexcept>
 #include <vector>
 #include <cstring>
@@ -15,7 +15,7 @@ Instance::Instance(const std::vector<const char*>& enabledLayers,
 #ifndef NDEBUG
     validationLayersEnabled_ = true;
     if (!checkValidationLayerSupport(enabledLayers)) {
-        std::cerr << "Warning: Requested validation layers are not available. Disabling validation layers.\n";
+        PARTICULAS_LOG(Warning) << "Requested validation layers are not available. Disabling validation layers.";
         validationLayersEnabled_ = false;
     }
 #else
@@ -66,15 +66,15 @@ void Instance::createInstance(const std::vector<const char*>& enabledLayers,
     createInfo.enabledExtensionCount = static_cast<uint32_t>(requiredExtensions.size());
     createInfo.ppEnabledExtensionNames = requiredExtensions.data();
 
-    std::cout << "Enabled Instance Extensions:" << std::endl;
-    for(const char* extName : requiredExtensions) { std::cout << "  - " << extName << std::endl; }
+    PARTICULAS_LOG(Info) << "Enabled Instance Extensions:";
+    for(const char* extName : requiredExtensions) { PARTICULAS_LOG(Info) << "  - " << extName; }
 
     VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
     if (validationLayersEnabled_) {
         createInfo.enabledLayerCount = static_cast<uint32_t>(enabledLayers.size());
         createInfo.ppEnabledLayerNames = enabledLayers.data();
-        std::cout << "Enabled Validation Layers:" << std::endl;
-        for(const char* layerName : enabledLayers) { std::cout << "  - " << layerName << std::endl; }
+        PARTICULAS_LOG(Info) << "Enabled Validation Layers:";
+        for(const char* layerName : enabledLayers) { PARTICULAS_LOG(Info) << "  - " << layerName; }
 
         particulas::debug::populateDebugMessengerCreateInfo(debugCreateInfo);
         createInfo.pNext = &debugCreateInfo;
@@ -88,7 +88,7 @@ void Instance::createInstance(const std::vector<const char*>& enabledLayers,
     if (result != VK_SUCCESS) {
         particulas::debug::checkVkResult(result, "Instance creation");
     } else {
-         std::cout << "Vulkan Instance created successfully." << std::endl;
+         PARTICULAS_LOG(Info) << "Vulkan Instance created successfully.";
     }
 }
 
@@ -100,8 +100,8 @@ bool Instance::checkValidationLayerSupport(const std::vector<const char*>& layer
     std::vector<VkLayerProperties> availableLayers(layerCount);
     vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
 
-    std::cout << "Available Validation Layers:" << std::endl;
-    for (const auto& layerProperties : availableLayers) { std::cout << "  - " << layerProperties.layerName << std::endl; }
+    PARTICULAS_LOG(Debug) << "Available Validation Layers:";
+    for (const auto& layerProperties : availableLayers) { PARTICULAS_LOG(Debug) << "  - " << layerProperties.layerName; }
 
     for (const char* requestedLayerName : layersToCheck) {
         bool layerFound = false;
@@ -111,7 +111,7 @@ bool Instance::checkValidationLayerSupport(const std::vector<const char*>& layer
             }
         }
         if (!layerFound) {
-            std::cerr << "Error: Requested validation layer not found: " << requestedLayerName << std::endl;
+            PARTICULAS_LOG(Error) << "Requested validation layer not found: " << requestedLayerName;
             return false;
         }
     }
@@ -133,7 +133,7 @@ void Instance::setupDebugMessenger() {
     if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to set up debug messenger after instance creation! Error code: " + std::to_string(result));
     } else {
-        std::cout << "Debug messenger set up successfully (persistent)." << std::endl;
+        PARTICULAS_LOG(Info) << "Debug messenger set up successfully (persistent).";
     }
 }
 
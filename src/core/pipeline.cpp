@@ -1,17 +1,31 @@
 #include "pipeline.hpp"
 #include "rendering/particle_renderer.hpp" // <-- ASEGÚRATE QUE ESTÁ INCLUIDO
+#include "rendering/camera.hpp"
+#include "shader_module.hpp"
 #include "utils/vulkan_debug.hpp"
+#include "utils/logger.hpp"
 
 #include <stdexcept>
-#include <iostream>
-#include <fstream>
 #include <vector>
 #include <array>
+#include <cstring>
 
 namespace particulas {
 
-Pipeline::Pipeline(VkDevice device, VkRenderPass renderPass, VkDescriptorSetLayout descriptorSetLayout)
-    : device_(device), renderPass_(renderPass), descriptorSetLayout_(descriptorSetLayout),
+uint64_t PipelineVariantKey::hash() const {
+    uint32_t words[2];
+    std::memcpy(&words[0], &pointSize, sizeof(float));
+    words[1] = static_cast<uint32_t>(blendMode);
+    uint64_t hash = 1469598103934665603ull;
+    for (uint32_t word : words) {
+        for (int byte = 0; byte < 4; ++byte) { hash ^= (word >> (byte * 8)) & 0xFFu; hash *= 1099511628211ull; }
+    }
+    return hash;
+}
+
+Pipeline::Pipeline(VkDevice device, VkRenderPass renderPass, VkDescriptorSetLayout descriptorSetLayout,
+                   VkPipelineCache pipelineCache, const PipelineVariantKey& variant)
+    : device_(device), renderPass_(renderPass), descriptorSetLayout_(descriptorSetLayout), pipelineCache_(pipelineCache), variant_(variant),
       graphicsPipeline_(VK_NULL_HANDLE), pipelineLayout_(VK_NULL_HANDLE) {
     try {
         createPipelineLayout();
@@ -34,6 +48,9 @@ void Pipeline::createPipelineLayout() {
         pipelineLayoutInfo.setLayoutCount = 1;
         pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout_;
     } else { pipelineLayoutInfo.setLayoutCount = 0; }
+    // Cámara 2D en push constants del vertex shader (CameraPushConstants)
+    VkPushConstantRange cameraRange{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(CameraPushConstants)};
+    pipelineLayoutInfo.pushConstantRangeCount = 1; pipelineLayoutInfo.pPushConstantRanges = &cameraRange;
     VkResult result = vkCreatePipelineLayout(device_, &pipelineLayoutInfo, nullptr, &pipelineLayout_);
     particulas::debug::checkVkResult(result, "Create pipeline layout");
 }
@@ -41,15 +58,21 @@ void Pipeline::createPipelineLayout() {
 void Pipeline::createGraphicsPipeline() {
     VkShaderModule vertShaderModule = VK_NULL_HANDLE, fragShaderModule = VK_NULL_HANDLE;
     try {
-        vertShaderModule = createShaderModule("shaders/particle.vert.spv");
-        fragShaderModule = createShaderModule("shaders/particle.frag.spv");
+        vertShaderModule = createShaderModule(device_, "shaders/particle.vert.spv");
+        fragShaderModule = createShaderModule(device_, "shaders/particle.frag.spv");
     } catch (...) { // Limpiar si falla la carga
         if (vertShaderModule != VK_NULL_HANDLE) vkDestroyShaderModule(device_, vertShaderModule, nullptr);
         if (fragShaderModule != VK_NULL_HANDLE) vkDestroyShaderModule(device_, fragShaderModule, nullptr);
         throw;
     }
 
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{}; /*...*/ vertShaderStageInfo.sType=VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO; vertShaderStageInfo.stage=VK_SHADER_STAGE_VERTEX_BIT; vertShaderStageInfo.module=vertShaderModule; vertShaderStageInfo.pName="main";
+    // Constante de especialización del vertex shader (POINT_SIZE)
+    VkSpecializationMapEntry specializationEntry{0, 0, sizeof(float)};
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = 1; specializationInfo.pMapEntries = &specializationEntry;
+    specializationInfo.dataSize = sizeof(float); specializationInfo.pData = &variant_.pointSize;
+
+    VkPipelineShaderStageCreateInfo vertShaderStageInfo{}; /*...*/ vertShaderStageInfo.sType=VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO; vertShaderStageInfo.stage=VK_SHADER_STAGE_VERTEX_BIT; vertShaderStageInfo.module=vertShaderModule; vertShaderStageInfo.pName="main"; vertShaderStageInfo.pSpecializationInfo=&specializationInfo;
     VkPipelineShaderStageCreateInfo fragShaderStageInfo{}; /*...*/ fragShaderStageInfo.sType=VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO; fragShaderStageInfo.stage=VK_SHADER_STAGE_FRAGMENT_BIT; fragShaderStageInfo.module=fragShaderModule; fragShaderStageInfo.pName="main";
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
 
@@ -67,8 +90,17 @@ void Pipeline::createGraphicsPipeline() {
     VkPipelineViewportStateCreateInfo viewportState{}; /*...*/ viewportState.sType=VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO; viewportState.viewportCount=1; viewportState.scissorCount=1;
     VkPipelineRasterizationStateCreateInfo rasterizer{}; /*...*/ rasterizer.sType=VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO; rasterizer.polygonMode=VK_POLYGON_MODE_FILL; rasterizer.lineWidth=1.0f; rasterizer.cullMode=VK_CULL_MODE_NONE; rasterizer.frontFace=VK_FRONT_FACE_CLOCKWISE;
     VkPipelineMultisampleStateCreateInfo multisampling{}; /*...*/ multisampling.sType=VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO; multisampling.rasterizationSamples=VK_SAMPLE_COUNT_1_BIT;
-    VkPipelineDepthStencilStateCreateInfo depthStencil{}; /*...*/ depthStencil.sType=VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO; depthStencil.depthTestEnable=VK_TRUE; depthStencil.depthWriteEnable=VK_TRUE; depthStencil.depthCompareOp=VK_COMPARE_OP_LESS;
+    VkPipelineDepthStencilStateCreateInfo depthStencil{}; /*...*/ depthStencil.sType=VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO; depthStencil.depthTestEnable=VK_TRUE; depthStencil.depthWriteEnable=(variant_.blendMode == BlendMode::Opaque) ? VK_TRUE : VK_FALSE; depthStencil.depthCompareOp=VK_COMPARE_OP_LESS;
     VkPipelineColorBlendAttachmentState colorBlendAttachment{}; /*...*/ colorBlendAttachment.colorWriteMask=VK_COLOR_COMPONENT_R_BIT|VK_COLOR_COMPONENT_G_BIT|VK_COLOR_COMPONENT_B_BIT|VK_COLOR_COMPONENT_A_BIT; colorBlendAttachment.blendEnable=VK_FALSE;
+    if (variant_.blendMode != BlendMode::Opaque) { // Las variantes mezcladas no escriben profundidad para no ocultarse entre sí
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.dstColorBlendFactor = (variant_.blendMode == BlendMode::Additive) ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
     VkPipelineColorBlendStateCreateInfo colorBlending{}; /*...*/ colorBlending.sType=VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO; colorBlending.attachmentCount=1; colorBlending.pAttachments=&colorBlendAttachment;
     std::vector<VkDynamicState> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
     VkPipelineDynamicStateCreateInfo dynamicStateInfo{}; /*...*/ dynamicStateInfo.sType=VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO; dynamicStateInfo.dynamicStateCount=static_cast<uint32_t>(dynamicStates.size()); dynamicStateInfo.pDynamicStates=dynamicStates.data();
@@ -88,28 +120,13 @@ void Pipeline::createGraphicsPipeline() {
     pipelineInfo.renderPass = renderPass_;
     pipelineInfo.subpass = 0;
 
-    VkResult result = vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline_);
+    VkResult result = vkCreateGraphicsPipelines(device_, pipelineCache_, 1, &pipelineInfo, nullptr, &graphicsPipeline_);
     // Limpiar módulos incluso si falla
     vkDestroyShaderModule(device_, fragShaderModule, nullptr);
     vkDestroyShaderModule(device_, vertShaderModule, nullptr);
     // Comprobar resultado y lanzar si falla
     particulas::debug::checkVkResult(result, "Create graphics pipeline");
-    std::cout << "Graphics pipeline created successfully.\n";
-}
-
-VkShaderModule Pipeline::createShaderModule(const std::string& filepath) { /* ... (código como antes) ... */
-    std::vector<char> shaderCode = readFile(filepath);
-    VkShaderModuleCreateInfo createInfo{}; createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO; createInfo.codeSize = shaderCode.size(); createInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
-    VkShaderModule shaderModule = VK_NULL_HANDLE;
-    VkResult result = vkCreateShaderModule(device_, &createInfo, nullptr, &shaderModule);
-    particulas::debug::checkVkResult(result, "Create shader module from " + filepath);
-    return shaderModule;
-}
-std::vector<char> Pipeline::readFile(const std::string& filepath) { /* ... (código como antes) ... */
-    std::ifstream file(filepath, std::ios::ate | std::ios::binary);
-    if (!file.is_open()) throw std::runtime_error("Failed to open shader file: " + filepath);
-    size_t fileSize = (size_t) file.tellg(); if (fileSize == 0) { file.close(); throw std::runtime_error("Shader file is empty: " + filepath); }
-    std::vector<char> buffer(fileSize); file.seekg(0); file.read(buffer.data(), fileSize); file.close(); return buffer;
+    PARTICULAS_LOG(Info) << "Graphics pipeline created successfully.";
 }
 
 } // namespace particulas
\ No newline at end of file
@@ -2,21 +2,41 @@
 #define PARTICULAS_CORE_PIPELINE_HPP
 
 #include <vulkan/vulkan.h>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <array> // Necesario para las funciones estáticas si las declaras aquí, aunque están en ParticleRenderer
 
 namespace particulas {
 
+// Modo de mezcla de una variante de pipeline
+enum class BlendMode : uint32_t { Opaque = 0, Additive = 1, Alpha = 2 };
+
+// Estado que distingue variantes del pipeline de partículas. pointSize va como constante de
+// especialización de particle.vert (constant_id 0); la cámara va en push constants.
+struct PipelineVariantKey {
+    float pointSize = 4.0f;
+    BlendMode blendMode = BlendMode::Opaque;
+
+    uint64_t hash() const; // FNV-1a sobre los campos
+    bool operator==(const PipelineVariantKey& other) const {
+        return pointSize == other.pointSize && blendMode == other.blendMode;
+    }
+    bool operator!=(const PipelineVariantKey& other) const { return !(*this == other); }
+};
+
 class Pipeline {
 public:
-    // Constructor: necesita dispositivo, render pass, y opcionalmente layout de descriptores
-    Pipeline(VkDevice device, VkRenderPass renderPass, VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE);
+    // Constructor: necesita dispositivo, render pass, y opcionalmente layout de descriptores, pipeline cache
+    // y la variante a compilar. Puede llamarse desde un hilo secundario (el cache es interno al driver).
+    Pipeline(VkDevice device, VkRenderPass renderPass, VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE,
+             VkPipelineCache pipelineCache = VK_NULL_HANDLE, const PipelineVariantKey& variant = PipelineVariantKey{});
     ~Pipeline();
 
     // --- Getters ---
     VkPipeline getGraphicsPipeline() const { return graphicsPipeline_; }
     VkPipelineLayout getPipelineLayout() const { return pipelineLayout_; }
+    const PipelineVariantKey& getVariant() const { return variant_; }
 
     // --- Funciones estáticas para obtener descripciones de vértices ---
     // Movidas a ParticleRenderer, pero podrían estar aquí si fueran genéricas.
@@ -27,13 +47,13 @@ private:
     // --- Métodos Privados ---
     void createPipelineLayout();
     void createGraphicsPipeline();
-    VkShaderModule createShaderModule(const std::string& filepath);
-    std::vector<char> readFile(const std::string& filepath);
 
     // --- Miembros ---
     VkDevice device_;                   // Handle del dispositivo lógico
     VkRenderPass renderPass_;           // Handle del render pass compatible
     VkDescriptorSetLayout descriptorSetLayout_; // Handle del layout (puede ser VK_NULL_HANDLE)
+    VkPipelineCache pipelineCache_;     // Cache persistente (puede ser VK_NULL_HANDLE)
+    PipelineVariantKey variant_;        // Constantes de especialización y modo de mezcla
 
     VkPipeline graphicsPipeline_ = VK_NULL_HANDLE; // Handle del pipeline gráfico creado
     VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE; // Handle del layout del pipeline creado
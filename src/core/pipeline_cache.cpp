@@ -0,0 +1,96 @@
+#include "pipeline_cache.hpp"
+#include "utils/vulkan_debug.hpp"
+#include "utils/logger.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace particulas {
+
+namespace {
+
+// Comprueba que los datos empiezan con una VkPipelineCacheHeaderVersionOne de este dispositivo
+bool isCompatibleCacheData(const std::vector<char>& data, const VkPhysicalDeviceProperties& properties) {
+    if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne)) return false;
+    VkPipelineCacheHeaderVersionOne header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    return header.headerSize >= sizeof(header)
+        && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        && header.vendorID == properties.vendorID
+        && header.deviceID == properties.deviceID
+        && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+} // namespace
+
+PipelineCache::PipelineCache(const Device& device, const std::string& directory)
+    : device_(device.getLogicalDevice()) {
+    VkPhysicalDeviceProperties properties; vkGetPhysicalDeviceProperties(device.getPhysicalDevice(), &properties);
+
+    std::stringstream name;
+    name << std::hex << std::setfill('0') << std::setw(4) << properties.vendorID << "_" << std::setw(4) << properties.deviceID
+         << "_" << std::setw(8) << properties.driverVersion << "_";
+    for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) name << std::setw(2) << static_cast<unsigned>(properties.pipelineCacheUUID[i]);
+    name << ".bin";
+    filePath_ = (std::filesystem::path(directory) / name.str()).string();
+
+    std::vector<char> initialData;
+    std::ifstream file(filePath_, std::ios::ate | std::ios::binary);
+    if (file.is_open()) {
+        initialData.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(initialData.data(), static_cast<std::streamsize>(initialData.size()));
+        if (!file || !isCompatibleCacheData(initialData, properties)) {
+            PARTICULAS_LOG(Warning) << "discarding incompatible pipeline cache " << filePath_;
+            initialData.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{}; cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = initialData.size(); cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+    VkResult result = vkCreatePipelineCache(device_, &cacheInfo, nullptr, &pipelineCache_);
+    if (result != VK_SUCCESS && !initialData.empty()) {
+        // Datos rechazados por el driver: empezar con un cache vacío
+        cacheInfo.initialDataSize = 0; cacheInfo.pInitialData = nullptr;
+        initialData.clear();
+        result = vkCreatePipelineCache(device_, &cacheInfo, nullptr, &pipelineCache_);
+    }
+    particulas::debug::checkVkResult(result, "Pipeline cache creation");
+    loadedBytes_ = initialData.size();
+    PARTICULAS_LOG(Info) << "Pipeline cache: " << (loadedBytes_ > 0 ? "loaded " + std::to_string(loadedBytes_) + " bytes from " : "cold start, will write ")
+              << filePath_;
+}
+
+PipelineCache::~PipelineCache() {
+    if (pipelineCache_ == VK_NULL_HANDLE) return;
+    save();
+    vkDestroyPipelineCache(device_, pipelineCache_, nullptr);
+}
+
+void PipelineCache::save() {
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(device_, pipelineCache_, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) return;
+    std::vector<char> data(dataSize);
+    if (vkGetPipelineCacheData(device_, pipelineCache_, &dataSize, data.data()) != VK_SUCCESS) return;
+
+    try {
+        std::filesystem::path path(filePath_);
+        if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path());
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += ".tmp";
+        {
+            std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+            out.write(data.data(), static_cast<std::streamsize>(dataSize));
+            if (!out) throw std::runtime_error("write failed");
+        }
+        std::filesystem::rename(temporaryPath, path); // Nunca deja un fichero a medias
+    } catch (const std::exception& e) {
+        PARTICULAS_LOG(Warning) << "could not save pipeline cache to " << filePath_ << ": " << e.what();
+    }
+}
+
+} // namespace particulas
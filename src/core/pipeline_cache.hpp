@@ -0,0 +1,41 @@
+#ifndef PARTICULAS_CORE_PIPELINE_CACHE_HPP
+#define PARTICULAS_CORE_PIPELINE_CACHE_HPP
+
+#include "core/device.hpp"
+
+#include <vulkan/vulkan.h>
+#include <string>
+
+namespace particulas {
+
+// VkPipelineCache persistente en disco. El fichero se nombra con vendor/device ID, versión
+// del driver y pipelineCacheUUID, así que un cambio de GPU o de driver usa otro fichero.
+// Los datos cargados se validan contra la cabecera antes de pasarlos al driver.
+class PipelineCache {
+public:
+    explicit PipelineCache(const Device& device, const std::string& directory = "pipeline_cache");
+    ~PipelineCache(); // Guarda en disco antes de destruir
+
+    VkPipelineCache get() const { return pipelineCache_; }
+
+    // true si se cargó un fichero válido (arranque "en caliente")
+    bool wasLoadedFromDisk() const { return loadedBytes_ > 0; }
+    size_t getLoadedBytes() const { return loadedBytes_; }
+    const std::string& getFilePath() const { return filePath_; }
+
+    // Escribe los datos actuales del cache (fichero temporal + rename). No lanza: avisa por consola.
+    void save();
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+private:
+    VkDevice device_;
+    VkPipelineCache pipelineCache_ = VK_NULL_HANDLE;
+    std::string filePath_;
+    size_t loadedBytes_ = 0;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_PIPELINE_CACHE_HPP
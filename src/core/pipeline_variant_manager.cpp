@@ -0,0 +1,92 @@
+#include "pipeline_variant_manager.hpp"
+#include "utils/logger.hpp"
+
+#include <chrono>
+
+namespace particulas {
+
+PipelineVariantManager::PipelineVariantManager(VkDevice device, VkRenderPass renderPass, VkDescriptorSetLayout descriptorSetLayout,
+                                               VkPipelineCache pipelineCache, const PipelineVariantKey& initialVariant)
+    : device_(device), renderPass_(renderPass), descriptorSetLayout_(descriptorSetLayout), pipelineCache_(pipelineCache),
+      requested_(initialVariant) {
+    auto pipeline = std::make_unique<Pipeline>(device_, renderPass_, descriptorSetLayout_, pipelineCache_, initialVariant);
+    current_ = pipeline.get();
+    variants_.emplace(initialVariant.hash(), std::move(pipeline));
+    worker_ = std::thread(&PipelineVariantManager::workerLoop, this);
+}
+
+PipelineVariantManager::~PipelineVariantManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        queue_.clear();
+    }
+    workAvailable_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+void PipelineVariantManager::request(const PipelineVariantKey& variant) {
+    requested_ = variant;
+    uint64_t hash = variant.hash();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (variants_.count(hash) || queued_.count(hash) || failed_.count(hash)) return;
+        queue_.push_back(variant);
+        queued_.insert(hash);
+    }
+    workAvailable_.notify_one();
+}
+
+bool PipelineVariantManager::update() {
+    if (current_->getVariant() == requested_) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = variants_.find(requested_.hash());
+    if (it == variants_.end()) return false; // Aún compilando (o falló): seguir con la actual
+    current_ = it->second.get();
+    return true;
+}
+
+bool PipelineVariantManager::isPending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return variants_.count(requested_.hash()) == 0 && failed_.count(requested_.hash()) == 0;
+}
+
+size_t PipelineVariantManager::getVariantCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return variants_.size();
+}
+
+void PipelineVariantManager::workerLoop() {
+    for (;;) {
+        PipelineVariantKey variant;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_) return;
+            variant = queue_.front();
+            queue_.pop_front();
+        }
+
+        // Compilación fuera del lock: el hilo principal sigue grabando frames con la variante actual
+        std::unique_ptr<Pipeline> pipeline;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            pipeline = std::make_unique<Pipeline>(device_, renderPass_, descriptorSetLayout_, pipelineCache_, variant);
+        } catch (const std::exception& e) {
+            PARTICULAS_LOG(Warning) << "pipeline variant compilation failed: " << e.what();
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t hash = variant.hash();
+        queued_.erase(hash);
+        if (pipeline) {
+            PARTICULAS_LOG(Info) << "[Pipeline] Variant " << logHex(hash) << " compiled in background (" << ms << " ms).";
+            variants_.emplace(hash, std::move(pipeline));
+        } else {
+            failed_.insert(hash);
+        }
+    }
+}
+
+} // namespace particulas
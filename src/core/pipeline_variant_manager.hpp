@@ -0,0 +1,68 @@
+#ifndef PARTICULAS_CORE_PIPELINE_VARIANT_MANAGER_HPP
+#define PARTICULAS_CORE_PIPELINE_VARIANT_MANAGER_HPP
+
+#include "pipeline.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace particulas {
+
+// Variantes del pipeline de partículas indexadas por PipelineVariantKey::hash(). Las variantes
+// nuevas se compilan en un hilo propio contra el pipeline cache compartido; mientras tanto los
+// frames siguen usando la variante actual, así que cambiar de variante nunca bloquea el bucle.
+// Las variantes compiladas se conservan hasta destruir el gestor (pueden seguir en vuelo).
+class PipelineVariantManager {
+public:
+    // Compila la variante inicial de forma síncrona: siempre hay un pipeline utilizable.
+    // descriptorSetLayout: set 0 de todas las variantes (tabla de especies)
+    PipelineVariantManager(VkDevice device, VkRenderPass renderPass, VkDescriptorSetLayout descriptorSetLayout,
+                           VkPipelineCache pipelineCache, const PipelineVariantKey& initialVariant);
+    ~PipelineVariantManager(); // Espera a que termine la compilación en curso
+
+    // No bloquea: pasa a ser la variante deseada y se encola si aún no está compilada
+    void request(const PipelineVariantKey& variant);
+
+    // Hilo principal, una vez por frame: adopta la variante deseada si ya está lista.
+    // Devuelve true si la variante actual ha cambiado.
+    bool update();
+
+    const Pipeline& getCurrent() const { return *current_; }
+    const PipelineVariantKey& getRequested() const { return requested_; }
+    bool isPending() const;   // La variante deseada aún no está disponible
+    size_t getVariantCount() const;
+
+    PipelineVariantManager(const PipelineVariantManager&) = delete;
+    PipelineVariantManager& operator=(const PipelineVariantManager&) = delete;
+
+private:
+    void workerLoop();
+
+    VkDevice device_;
+    VkRenderPass renderPass_;
+    VkDescriptorSetLayout descriptorSetLayout_;
+    VkPipelineCache pipelineCache_;
+
+    const Pipeline* current_ = nullptr;   // Solo lo toca el hilo principal
+    PipelineVariantKey requested_;
+
+    mutable std::mutex mutex_;            // Protege variants_, queue_, queued_, failed_, stop_
+    std::condition_variable workAvailable_;
+    std::unordered_map<uint64_t, std::unique_ptr<Pipeline>> variants_;
+    std::deque<PipelineVariantKey> queue_;
+    std::unordered_set<uint64_t> queued_; // Encoladas o compilándose
+    std::unordered_set<uint64_t> failed_; // No se reintentan
+    bool stop_ = false;
+    std::thread worker_;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_PIPELINE_VARIANT_MANAGER_HPP
@@ -0,0 +1,454 @@
+#include "render_graph.hpp"
+#include "utils/vulkan_debug.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+constexpr VkAccessFlags WRITE_ACCESS_MASK =
+    VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+constexpr VkPipelineStageFlags ANY_QUEUE_STAGES =
+    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT |
+    VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+// Etapas que un pase de cada cola puede declarar
+VkPipelineStageFlags allowedStages(QueueClass queue) {
+    switch (queue) {
+    case QueueClass::Compute: return ANY_QUEUE_STAGES | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    case QueueClass::Transfer: return ANY_QUEUE_STAGES;
+    case QueueClass::Graphics: default: return ~0u;
+    }
+}
+
+const char* queueName(QueueClass queue) {
+    switch (queue) {
+    case QueueClass::Compute: return "compute";
+    case QueueClass::Transfer: return "transfer";
+    case QueueClass::Graphics: default: return "graphics";
+    }
+}
+
+double toMiB(VkDeviceSize bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+}
+
+RenderGraph::RenderGraph(const Device& device, uint32_t framesInFlight)
+    : device_(device), logicalDevice_(device.getLogicalDevice()), framesInFlight_(framesInFlight) {
+    if (framesInFlight == 0) throw std::invalid_argument("RenderGraph needs at least one frame in flight.");
+}
+
+RenderGraph::~RenderGraph() {
+    destroy();
+}
+
+void RenderGraph::destroy() {
+    timer_.reset();
+    for (Resource& resource : resources_) {
+        if (!resource.transient) continue;
+        if (resource.view != VK_NULL_HANDLE) vkDestroyImageView(logicalDevice_, resource.view, nullptr);
+        if (resource.image != VK_NULL_HANDLE) vkDestroyImage(logicalDevice_, resource.image, nullptr);
+        if (resource.buffer != VK_NULL_HANDLE) vkDestroyBuffer(logicalDevice_, resource.buffer, nullptr);
+        resource.view = VK_NULL_HANDLE; resource.image = VK_NULL_HANDLE; resource.buffer = VK_NULL_HANDLE;
+    }
+    for (MemoryBlock& block : blocks_) {
+        if (block.memory != VK_NULL_HANDLE) vkFreeMemory(logicalDevice_, block.memory, nullptr);
+    }
+    blocks_.clear();
+}
+
+// --- Recursos ---
+GraphResource RenderGraph::addResource(Resource resource) {
+    if (compiled_) throw std::runtime_error("RenderGraph resources must be declared before compile().");
+    resources_.push_back(std::move(resource));
+    return static_cast<GraphResource>(resources_.size() - 1);
+}
+
+GraphResource RenderGraph::importBuffer(const std::string& name, VkBuffer buffer) {
+    if (buffer == VK_NULL_HANDLE) throw std::invalid_argument("Imported buffer '" + name + "' is null.");
+    Resource resource; resource.name = name; resource.buffer = buffer;
+    return addResource(std::move(resource));
+}
+
+GraphResource RenderGraph::importImage(const std::string& name, VkImage image, VkImageAspectFlags aspect, VkImageLayout layout) {
+    if (image == VK_NULL_HANDLE) throw std::invalid_argument("Imported image '" + name + "' is null.");
+    Resource resource; resource.name = name; resource.isImage = true; resource.image = image;
+    resource.aspect = aspect; resource.layout = layout;
+    return addResource(std::move(resource));
+}
+
+GraphResource RenderGraph::createTransientBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage) {
+    if (size == 0) throw std::invalid_argument("Transient buffer '" + name + "' has zero size.");
+    Resource resource; resource.name = name; resource.transient = true;
+    resource.size = size; resource.bufferUsage = usage;
+    return addResource(std::move(resource));
+}
+
+GraphResource RenderGraph::createTransientImage(const std::string& name, VkFormat format, VkExtent2D extent,
+                                                VkImageUsageFlags usage, VkImageAspectFlags aspect) {
+    if (extent.width == 0 || extent.height == 0) throw std::invalid_argument("Transient image '" + name + "' has zero extent.");
+    Resource resource; resource.name = name; resource.isImage = true; resource.transient = true;
+    resource.format = format; resource.extent = extent; resource.imageUsage = usage; resource.aspect = aspect;
+    return addResource(std::move(resource));
+}
+
+// --- Pases ---
+uint32_t RenderGraph::addPass(const std::string& name, QueueClass queue, std::vector<ResourceAccess> reads,
+                              std::vector<ResourceAccess> writes, RecordFunction record) {
+    if (compiled_) throw std::runtime_error("RenderGraph passes must be declared before compile().");
+    if (!record) throw std::invalid_argument("Render graph pass '" + name + "' has no record function.");
+    Pass pass; pass.name = name; pass.queue = queue; pass.record = std::move(record);
+
+    // Lecturas y escrituras del mismo recurso se fusionan en un único uso por pase
+    auto merge = [&](const ResourceAccess& access, bool write) {
+        if (access.resource >= resources_.size()) throw std::invalid_argument("Render graph pass '" + name + "' uses an unknown resource.");
+        if ((access.stages & ~allowedStages(queue)) != 0) {
+            throw std::invalid_argument("Render graph pass '" + name + "' declares stages its " + queueName(queue) + " queue cannot run.");
+        }
+        const Resource& resource = resources_[access.resource];
+        if (resource.isImage && access.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+            throw std::invalid_argument("Render graph pass '" + name + "' must give a layout for image '" + resource.name + "'.");
+        }
+        auto it = std::find_if(pass.uses.begin(), pass.uses.end(), [&](const PassUse& use) { return use.resource == access.resource; });
+        if (it == pass.uses.end()) {
+            pass.uses.push_back(PassUse{access.resource, 0, 0, access.layout, false});
+            it = pass.uses.end() - 1;
+        } else if (resource.isImage && it->layout != access.layout) {
+            throw std::invalid_argument("Render graph pass '" + name + "' uses image '" + resource.name + "' in two layouts.");
+        }
+        it->stages |= access.stages;
+        it->access |= access.access;
+        it->write = it->write || write;
+    };
+    for (const ResourceAccess& access : reads) merge(access, false);
+    for (const ResourceAccess& access : writes) merge(access, true);
+
+    passes_.push_back(std::move(pass));
+    return static_cast<uint32_t>(passes_.size() - 1);
+}
+
+void RenderGraph::setPassEnabled(uint32_t pass, bool enabled) {
+    Pass& target = passes_.at(pass);
+    if (target.enabled == enabled) return;
+    target.enabled = enabled;
+    barriersDirty_ = true;
+}
+
+// --- compile ---
+void RenderGraph::compile() {
+    if (compiled_) throw std::runtime_error("RenderGraph::compile called twice.");
+    for (size_t p = 0; p < passes_.size(); ++p) {
+        for (const PassUse& use : passes_[p].uses) {
+            Resource& resource = resources_[use.resource];
+            if (resource.firstPass < 0) resource.firstPass = static_cast<int>(p);
+            resource.lastPass = static_cast<int>(p);
+        }
+    }
+    try {
+        createTransientObjects();
+        assignMemoryBlocks();
+        if (!passes_.empty()) timer_ = std::make_unique<GpuTimer>(device_, framesInFlight_ * static_cast<uint32_t>(passes_.size()));
+    } catch (...) {
+        destroy();
+        throw;
+    }
+    compiled_ = true;
+    deriveBarriers(); // Con todos los pases activos; se rehace si cambian
+    barriersDirty_ = false;
+}
+
+void RenderGraph::createTransientObjects() {
+    for (Resource& resource : resources_) {
+        if (!resource.transient) continue;
+        if (resource.firstPass < 0) throw std::runtime_error("Transient resource '" + resource.name + "' is never used by a pass.");
+        if (resource.isImage) {
+            VkImageCreateInfo imageInfo{}; imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO; imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.extent = {resource.extent.width, resource.extent.height, 1}; imageInfo.mipLevels = 1; imageInfo.arrayLayers = 1;
+            imageInfo.format = resource.format; imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL; imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageInfo.usage = resource.imageUsage; imageInfo.samples = VK_SAMPLE_COUNT_1_BIT; imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            particulas::debug::checkVkResult(vkCreateImage(logicalDevice_, &imageInfo, nullptr, &resource.image), "Transient image creation (" + resource.name + ")");
+            vkGetImageMemoryRequirements(logicalDevice_, resource.image, &resource.requirements);
+        } else {
+            VkBufferCreateInfo bufferInfo{}; bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = resource.size; bufferInfo.usage = resource.bufferUsage; bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            particulas::debug::checkVkResult(vkCreateBuffer(logicalDevice_, &bufferInfo, nullptr, &resource.buffer), "Transient buffer creation (" + resource.name + ")");
+            vkGetBufferMemoryRequirements(logicalDevice_, resource.buffer, &resource.requirements);
+        }
+    }
+}
+
+// Reparto voraz de mayor a menor: cada transitorio entra en el primer bloque con un tipo de memoria
+// compatible cuyos ocupantes no estén vivos en ninguno de sus pases. Todos se enlazan en el offset 0
+// (el alineamiento del bloque es el de su reserva).
+void RenderGraph::assignMemoryBlocks() {
+    std::vector<GraphResource> order;
+    for (GraphResource r = 0; r < resources_.size(); ++r) {
+        if (resources_[r].transient) order.push_back(r);
+    }
+    std::sort(order.begin(), order.end(), [&](GraphResource a, GraphResource b) {
+        return resources_[a].requirements.size > resources_[b].requirements.size;
+    });
+
+    auto overlaps = [&](const Resource& a, const Resource& b) {
+        return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+    };
+    for (GraphResource r : order) {
+        Resource& resource = resources_[r];
+        int chosen = -1;
+        for (size_t b = 0; b < blocks_.size() && chosen < 0; ++b) {
+            MemoryBlock& block = blocks_[b];
+            if ((block.memoryTypeBits & resource.requirements.memoryTypeBits) == 0) continue;
+            bool free = std::none_of(block.occupants.begin(), block.occupants.end(),
+                                     [&](GraphResource other) { return overlaps(resource, resources_[other]); });
+            if (free) chosen = static_cast<int>(b);
+        }
+        if (chosen < 0) {
+            blocks_.emplace_back();
+            chosen = static_cast<int>(blocks_.size() - 1);
+        }
+        MemoryBlock& block = blocks_[chosen];
+        block.memoryTypeBits &= resource.requirements.memoryTypeBits;
+        block.size = std::max(block.size, resource.requirements.size);
+        block.occupants.push_back(r);
+        resource.block = chosen;
+    }
+
+    for (MemoryBlock& block : blocks_) {
+        VkMemoryAllocateInfo allocInfo{}; allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO; allocInfo.allocationSize = block.size;
+        allocInfo.memoryTypeIndex = device_.findMemoryType(block.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        particulas::debug::checkVkResult(vkAllocateMemory(logicalDevice_, &allocInfo, nullptr, &block.memory), "Render graph transient memory");
+        for (GraphResource r : block.occupants) {
+            Resource& resource = resources_[r];
+            if (resource.isImage) {
+                particulas::debug::checkVkResult(vkBindImageMemory(logicalDevice_, resource.image, block.memory, 0), "Bind transient image (" + resource.name + ")");
+                VkImageViewCreateInfo viewInfo{}; viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO; viewInfo.image = resource.image;
+                viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D; viewInfo.format = resource.format;
+                viewInfo.subresourceRange = {resource.aspect, 0, 1, 0, 1};
+                particulas::debug::checkVkResult(vkCreateImageView(logicalDevice_, &viewInfo, nullptr, &resource.view), "Transient image view (" + resource.name + ")");
+            } else {
+                particulas::debug::checkVkResult(vkBindBufferMemory(logicalDevice_, resource.buffer, block.memory, 0), "Bind transient buffer (" + resource.name + ")");
+            }
+        }
+    }
+}
+
+// --- deriveBarriers ---
+// Recorre los pases activos en orden siguiendo, por recurso, la última escritura y las lecturas
+// posteriores. Solo se emite barrera si hay riesgo: leer algo escrito que aún no es visible en esa
+// etapa/acceso, escribir tras lecturas (WAR, basta dependencia de ejecución) o tras otra escritura,
+// o cambiar de layout. El primer uso de un transitorio espera a todos los usos de su bloque de
+// memoria, incluidos los del frame anterior que aún pueda estar en la cola.
+void RenderGraph::deriveBarriers() {
+    std::vector<BarrierState>& states = barrierStates_;
+    states.assign(resources_.size(), BarrierState{});
+    for (size_t r = 0; r < resources_.size(); ++r) {
+        if (resources_[r].isImage && !resources_[r].transient) states[r].layout = resources_[r].layout;
+    }
+
+    std::vector<VkPipelineStageFlags>& blockStages = blockStages_;
+    std::vector<VkAccessFlags>& blockWriteAccess = blockWriteAccess_;
+    blockStages.assign(blocks_.size(), 0);
+    blockWriteAccess.assign(blocks_.size(), 0);
+    for (const Pass& pass : passes_) {
+        if (!pass.enabled) continue;
+        for (const PassUse& use : pass.uses) {
+            const Resource& resource = resources_[use.resource];
+            if (!resource.transient) continue;
+            blockStages[resource.block] |= use.stages;
+            if (use.write) blockWriteAccess[resource.block] |= use.access & WRITE_ACCESS_MASK;
+        }
+    }
+
+    derivedBarrierCount_ = 0;
+    for (Pass& pass : passes_) {
+        pass.srcStages = 0; pass.dstStages = 0;
+        pass.memoryBarrier = VkMemoryBarrier{}; pass.memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        pass.imageBarriers.clear();
+        if (!pass.enabled) continue;
+
+        for (const PassUse& use : pass.uses) {
+            const Resource& resource = resources_[use.resource];
+            BarrierState& state = states[use.resource];
+            VkPipelineStageFlags srcStages = 0;
+            VkAccessFlags srcAccess = 0;
+            VkImageLayout oldLayout = state.layout;
+            bool layoutChange = resource.isImage && state.layout != use.layout;
+            bool barrier = false;
+
+            if (!state.touched && resource.transient) {
+                srcStages = blockStages[resource.block];
+                srcAccess = blockWriteAccess[resource.block];
+                oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; // El contenido anterior (de otro ocupante) se descarta
+                layoutChange = resource.isImage;
+                barrier = true;
+            } else if (!state.touched && layoutChange) {
+                srcStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT; // Último uso del frame anterior desconocido
+                srcAccess = VK_ACCESS_MEMORY_WRITE_BIT;
+                barrier = true;
+            } else if (use.write || layoutChange) {
+                srcStages = state.readStages | state.writeStages;
+                srcAccess = state.writeAccess;
+                barrier = srcStages != 0 || layoutChange;
+            } else if (state.writeStages != 0 &&
+                       ((use.stages & ~state.visibleStages) != 0 || (use.access & ~state.visibleAccess) != 0)) {
+                srcStages = state.writeStages;
+                srcAccess = state.writeAccess;
+                barrier = true;
+            }
+
+            if (barrier) {
+                pass.srcStages |= srcStages != 0 ? srcStages : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+                pass.dstStages |= use.stages;
+                if (layoutChange) {
+                    VkImageMemoryBarrier imageBarrier{}; imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                    imageBarrier.srcAccessMask = srcAccess; imageBarrier.dstAccessMask = use.access;
+                    imageBarrier.oldLayout = oldLayout; imageBarrier.newLayout = use.layout;
+                    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                    imageBarrier.image = resource.image;
+                    imageBarrier.subresourceRange = {resource.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+                    pass.imageBarriers.push_back(imageBarrier);
+                } else {
+                    pass.memoryBarrier.srcAccessMask |= srcAccess;
+                    pass.memoryBarrier.dstAccessMask |= use.access;
+                }
+            }
+
+            if (use.write || layoutChange) {
+                // Una transición de layout cuenta como escritura: lo que venga después se ordena tras ella
+                state.writeStages = use.stages;
+                state.writeAccess = use.write ? (use.access & WRITE_ACCESS_MASK) : 0;
+                state.readStages = use.write ? 0 : use.stages;
+                state.visibleStages = use.write ? 0 : use.stages;
+                state.visibleAccess = use.write ? 0 : use.access;
+            } else {
+                state.readStages |= use.stages;
+                if (barrier) { state.visibleStages |= use.stages; state.visibleAccess |= use.access; }
+            }
+            state.layout = use.layout;
+            state.touched = true;
+        }
+        if (pass.srcStages != 0) ++derivedBarrierCount_;
+    }
+
+    // Las imágenes importadas vuelven a su layout para el siguiente frame (y para quien las use fuera del grafo)
+    tailSrcStages_ = 0; tailDstStages_ = 0;
+    tailBarriers_.clear();
+    for (size_t r = 0; r < resources_.size(); ++r) {
+        const Resource& resource = resources_[r];
+        const BarrierState& state = states[r];
+        if (!resource.isImage || resource.transient || !state.touched || state.layout == resource.layout) continue;
+        VkImageMemoryBarrier imageBarrier{}; imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.srcAccessMask = state.writeAccess; imageBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        imageBarrier.oldLayout = state.layout; imageBarrier.newLayout = resource.layout;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = resource.image;
+        imageBarrier.subresourceRange = {resource.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+        tailBarriers_.push_back(imageBarrier);
+        tailSrcStages_ |= state.writeStages | state.readStages;
+        tailDstStages_ = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    if (!tailBarriers_.empty()) ++derivedBarrierCount_;
+}
+
+// --- execute ---
+void RenderGraph::execute(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    if (!compiled_) throw std::runtime_error("RenderGraph::execute called before compile().");
+    if (frameIndex >= framesInFlight_) throw std::out_of_range("RenderGraph frame index out of range.");
+    if (barriersDirty_) {
+        deriveBarriers();
+        barriersDirty_ = false;
+    }
+
+    uint32_t passCount = static_cast<uint32_t>(passes_.size());
+    for (uint32_t p = 0; p < passCount; ++p) {
+        Pass& pass = passes_[p];
+        if (!pass.enabled) continue;
+        uint32_t slot = frameIndex * passCount + p;
+        timer_->reset(commandBuffer, slot);
+        if (pass.srcStages != 0) {
+            bool memory = pass.memoryBarrier.srcAccessMask != 0 || pass.memoryBarrier.dstAccessMask != 0;
+            vkCmdPipelineBarrier(commandBuffer, pass.srcStages, pass.dstStages, 0,
+                                 memory ? 1 : 0, memory ? &pass.memoryBarrier : nullptr, 0, nullptr,
+                                 static_cast<uint32_t>(pass.imageBarriers.size()), pass.imageBarriers.data());
+        }
+        timer_->begin(commandBuffer, slot);
+        pass.record(commandBuffer);
+        timer_->end(commandBuffer, slot);
+    }
+    if (!tailBarriers_.empty()) {
+        vkCmdPipelineBarrier(commandBuffer, tailSrcStages_, tailDstStages_, 0, 0, nullptr, 0, nullptr,
+                             static_cast<uint32_t>(tailBarriers_.size()), tailBarriers_.data());
+    }
+}
+
+// --- Tiempos ---
+void RenderGraph::resolveTimings(uint32_t frameIndex) {
+    if (!timer_) return;
+    uint32_t passCount = static_cast<uint32_t>(passes_.size());
+    for (uint32_t p = 0; p < passCount; ++p) {
+        Pass& pass = passes_[p];
+        double milliseconds = 0.0;
+        if (timer_->resolve(frameIndex * passCount + p, milliseconds)) {
+            pass.lastMilliseconds = milliseconds;
+            pass.totalMilliseconds += milliseconds;
+            ++pass.timedFrames;
+        } else {
+            pass.lastMilliseconds = 0.0;
+        }
+    }
+}
+
+VkDeviceSize RenderGraph::getTransientBytes() const {
+    VkDeviceSize total = 0;
+    for (const MemoryBlock& block : blocks_) total += block.size;
+    return total;
+}
+
+VkDeviceSize RenderGraph::getUnaliasedBytes() const {
+    VkDeviceSize total = 0;
+    for (const Resource& resource : resources_) {
+        if (resource.transient) total += resource.requirements.size;
+    }
+    return total;
+}
+
+void RenderGraph::printReport(std::ostream& out) const {
+    out << "[RenderGraph] passes=" << passes_.size() << " barriersPerFrame=" << derivedBarrierCount_
+        << std::fixed << std::setprecision(2)
+        << " transientMiB=" << toMiB(getTransientBytes()) << " (unaliased " << toMiB(getUnaliasedBytes())
+        << ", blocks=" << blocks_.size() << ")\n";
+
+    // Lotes: pases activos consecutivos de la misma cola
+    out << "  queue batches:";
+    bool first = true;
+    const Pass* previous = nullptr;
+    for (const Pass& pass : passes_) {
+        if (!pass.enabled) continue;
+        if (!previous || previous->queue != pass.queue) {
+            out << (first ? " " : " } -> ") << queueName(pass.queue) << " { " << pass.name;
+            first = false;
+        } else {
+            out << ", " << pass.name;
+        }
+        previous = &pass;
+    }
+    out << (first ? " (none)\n" : " }\n");
+
+    for (const Pass& pass : passes_) {
+        out << "  " << std::left << std::setw(10) << pass.name << std::right << " [" << queueName(pass.queue) << "]"
+            << " frames=" << pass.timedFrames << " avgGpuMs=" << std::setprecision(3)
+            << (pass.timedFrames > 0 ? pass.totalMilliseconds / pass.timedFrames : 0.0)
+            << (pass.enabled ? "" : " (disabled)") << "\n";
+    }
+    for (size_t b = 0; b < blocks_.size(); ++b) {
+        out << "  block " << b << ": " << std::setprecision(2) << toMiB(blocks_[b].size) << " MiB <-";
+        for (GraphResource r : blocks_[b].occupants) out << " " << resources_[r].name;
+        out << "\n";
+    }
+    out << std::defaultfloat;
+}
+
+} // namespace particulas
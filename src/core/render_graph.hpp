@@ -0,0 +1,184 @@
+#ifndef PARTICULAS_CORE_RENDER_GRAPH_HPP
+#define PARTICULAS_CORE_RENDER_GRAPH_HPP
+
+#include "core/device.hpp"
+#include "core/gpu_timer.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace particulas {
+
+// Cola preferida de un pase. Limita las etapas que el pase puede declarar y agrupa los pases en
+// lotes por cola en el informe. Device solo crea la cola gráfica (que admite cómputo y
+// transferencia), así que hoy todos los lotes se graban en ella en orden de declaración.
+enum class QueueClass { Graphics, Compute, Transfer };
+
+using GraphResource = uint32_t;
+
+// Uso de un recurso por un pase: etapas y accesos con los que lo lee o escribe y, en imágenes,
+// el layout que necesita.
+struct ResourceAccess {
+    GraphResource resource;
+    VkPipelineStageFlags stages;
+    VkAccessFlags access;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED; // Ignorado en buffers
+};
+
+// Grafo de frame mínimo. Los pases declaran qué recursos leen y escriben y el grafo:
+//  - deriva las barreras entre pases (RAW, WAR, WAW y cambios de layout), solo donde hay riesgo y
+//    fusionadas en un único vkCmdPipelineBarrier por pase;
+//  - crea los recursos transitorios y reparte su memoria: dos transitorios cuya vida (del primer al
+//    último pase que los usa) no se solapa comparten la misma VkDeviceMemory;
+//  - mide cada pase con timestamps (un intervalo de GpuTimer por pase y frame en vuelo).
+// Las barreras dentro de un pase y las que dependen del frame anterior siguen siendo cosa del pase.
+// Los attachments del render pass los sincronizan sus dependencias de subpass, no el grafo.
+class RenderGraph {
+public:
+    using RecordFunction = std::function<void(VkCommandBuffer)>;
+
+    RenderGraph(const Device& device, uint32_t framesInFlight);
+    ~RenderGraph();
+
+    // --- Recursos ---
+    // Importados: los crea y destruye otro objeto; el grafo solo ordena sus usos. Una imagen
+    // importada empieza y termina cada frame en el layout indicado.
+    GraphResource importBuffer(const std::string& name, VkBuffer buffer);
+    GraphResource importImage(const std::string& name, VkImage image, VkImageAspectFlags aspect, VkImageLayout layout);
+    // Transitorios: el grafo los crea en compile(). Su contenido no sobrevive entre frames.
+    GraphResource createTransientBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage);
+    GraphResource createTransientImage(const std::string& name, VkFormat format, VkExtent2D extent,
+                                       VkImageUsageFlags usage, VkImageAspectFlags aspect);
+
+    // --- Pases (se ejecutan en el orden en que se añaden) ---
+    uint32_t addPass(const std::string& name, QueueClass queue, std::vector<ResourceAccess> reads,
+                     std::vector<ResourceAccess> writes, RecordFunction record);
+    // Un pase desactivado no se graba ni cuenta para las barreras de este frame
+    void setPassEnabled(uint32_t pass, bool enabled);
+
+    // Crea los transitorios, reparte su memoria y prepara los timestamps. Una sola vez, tras declararlo todo.
+    void compile();
+
+    // Graba los pases activos con sus barreras y timestamps. Fuera de cualquier render pass.
+    void execute(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    // Tras esperar el frame: lee sus timestamps. getPassMilliseconds devuelve lo último resuelto
+    // (0 si el pase no se ejecutó en ese frame).
+    void resolveTimings(uint32_t frameIndex);
+    double getPassMilliseconds(uint32_t pass) const { return passes_.at(pass).lastMilliseconds; }
+    uint32_t getPassCount() const { return static_cast<uint32_t>(passes_.size()); }
+    const std::string& getPassName(uint32_t pass) const { return passes_.at(pass).name; }
+    bool isPassEnabled(uint32_t pass) const { return passes_.at(pass).enabled; }
+    bool isTimingSupported() const { return timer_ && timer_->isSupported(); }
+
+    // Pases con su cola y tiempo medio, barreras derivadas, lotes por cola y memoria transitoria
+    void printReport(std::ostream& out) const;
+
+    VkBuffer getBuffer(GraphResource resource) const { return resources_.at(resource).buffer; }
+    VkImage getImage(GraphResource resource) const { return resources_.at(resource).image; }
+    VkImageView getImageView(GraphResource resource) const { return resources_.at(resource).view; }
+    VkDeviceSize getTransientBytes() const;  // Memoria reservada para los transitorios
+    VkDeviceSize getUnaliasedBytes() const;  // La que ocuparían con una reserva cada uno
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+private:
+    struct Resource {
+        std::string name;
+        bool isImage = false;
+        bool transient = false;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkImageAspectFlags aspect = 0;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED; // Importadas: layout al empezar/terminar el frame
+        // Descripción de los transitorios
+        VkDeviceSize size = 0;
+        VkBufferUsageFlags bufferUsage = 0;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent = {0, 0};
+        VkImageUsageFlags imageUsage = 0;
+        VkMemoryRequirements requirements{};
+        int firstPass = -1, lastPass = -1; // Vida sobre todos los pases declarados
+        int block = -1;                    // Bloque de memoria compartido
+    };
+
+    // Uso combinado de un recurso dentro de un pase (lecturas y escrituras fusionadas)
+    struct PassUse {
+        GraphResource resource;
+        VkPipelineStageFlags stages = 0;
+        VkAccessFlags access = 0;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        bool write = false;
+    };
+
+    struct Pass {
+        std::string name;
+        QueueClass queue;
+        std::vector<PassUse> uses;
+        RecordFunction record;
+        bool enabled = true;
+        // Derivado en deriveBarriers()
+        VkPipelineStageFlags srcStages = 0, dstStages = 0;
+        VkMemoryBarrier memoryBarrier{};
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+        // Tiempos
+        double lastMilliseconds = 0.0;
+        double totalMilliseconds = 0.0;
+        uint64_t timedFrames = 0;
+    };
+
+    // Estado de un recurso mientras deriveBarriers recorre los pases
+    struct BarrierState {
+        VkPipelineStageFlags writeStages = 0;
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0;   // Lecturas desde la última escritura
+        VkPipelineStageFlags visibleStages = 0; // Etapas/accesos que ya vieron la última escritura
+        VkAccessFlags visibleAccess = 0;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        bool touched = false;
+    };
+
+    struct MemoryBlock {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        uint32_t memoryTypeBits = ~0u;
+        std::vector<GraphResource> occupants;
+    };
+
+    GraphResource addResource(Resource resource);
+    void createTransientObjects();
+    void assignMemoryBlocks();
+    void deriveBarriers();
+    void destroy();
+
+    const Device& device_;
+    VkDevice logicalDevice_;
+    uint32_t framesInFlight_;
+    std::vector<Resource> resources_;
+    std::vector<Pass> passes_;
+    std::vector<MemoryBlock> blocks_;
+    std::unique_ptr<GpuTimer> timer_; // Un intervalo por (frame, pase)
+    bool compiled_ = false;
+    bool barriersDirty_ = true;
+
+    // Barreras finales: devuelven las imágenes importadas a su layout de partida
+    VkPipelineStageFlags tailSrcStages_ = 0, tailDstStages_ = 0;
+    std::vector<VkImageMemoryBarrier> tailBarriers_;
+    // Memoria de trabajo de deriveBarriers: se reutiliza al activar o desactivar pases durante el bucle
+    std::vector<BarrierState> barrierStates_;
+    std::vector<VkPipelineStageFlags> blockStages_;
+    std::vector<VkAccessFlags> blockWriteAccess_;
+    uint32_t derivedBarrierCount_ = 0; // vkCmdPipelineBarrier por frame con los pases activos
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_RENDER_GRAPH_HPP
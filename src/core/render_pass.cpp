@@ -5,8 +5,17 @@
 
 namespace particulas {
 
-RenderPass::RenderPass(VkDevice device, VkFormat swapChainImageFormat, VkFormat depthFormat)
-    : device_(device), renderPass_(VK_NULL_HANDLE) {
+const char* depthModeName(DepthMode mode) {
+    switch (mode) {
+        case DepthMode::None: return "none";
+        case DepthMode::Transient: return "transient";
+        case DepthMode::Stored: return "stored";
+    }
+    return "unknown";
+}
+
+RenderPass::RenderPass(VkDevice device, VkFormat swapChainImageFormat, VkFormat depthFormat, DepthMode depthMode)
+    : device_(device), renderPass_(VK_NULL_HANDLE), depthMode_(depthMode) {
     createRenderPass(swapChainImageFormat, depthFormat);
 }
 
@@ -31,7 +40,8 @@ void RenderPass::createRenderPass(VkFormat swapChainImageFormat, VkFormat depthF
     depthAttachment.format = depthFormat;
     depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE; // No necesitamos almacenar los datos de profundidad
+    // Transient: el contenido nunca sale de la memoria en chip (tilers) ni se escribe al final
+    depthAttachment.storeOp = (depthMode_ == DepthMode::Stored) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -52,16 +62,24 @@ void RenderPass::createRenderPass(VkFormat swapChainImageFormat, VkFormat depthF
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef; // Solo una attachment de color
-    subpass.pDepthStencilAttachment = &depthAttachmentRef; // Attachment de profundidad
+    subpass.pDepthStencilAttachment = hasDepth() ? &depthAttachmentRef : nullptr; // Attachment de profundidad (opcional)
 
     // Dependencia de subpass (para asegurar que la imagen esté lista antes de renderizar)
     VkSubpassDependency dependency{};
     dependency.srcSubpass = VK_SUBPASS_EXTERNAL; // Fuera del render pass
     dependency.dstSubpass = 0;                   // Nuestro único subpass
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    // Sin profundidad solo hace falta ordenar la salida de color; con ella también los tests
+    // tempranos (la imagen de profundidad se reutiliza entre frames en vuelo)
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     dependency.srcAccessMask = 0;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    if (hasDepth()) {
+        dependency.srcStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT; // Escrituras del frame anterior
+        dependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    }
 
 
     // Array de Attachments
@@ -70,7 +88,7 @@ void RenderPass::createRenderPass(VkFormat swapChainImageFormat, VkFormat depthF
     // Descripción del Render Pass
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.attachmentCount = getAttachmentCount();
     renderPassInfo.pAttachments = attachments.data();
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpass;
@@ -5,16 +5,29 @@
 
 namespace particulas {
 
+// Configuración del attachment de profundidad del pase principal
+enum class DepthMode {
+    None,      // Sin profundidad: solo color (la lista de puntos 2D no necesita depth test)
+    Transient, // CLEAR + DONT_CARE, imagen TRANSIENT en memoria LAZILY_ALLOCATED si existe
+    Stored     // CLEAR + STORE en memoria del dispositivo (p.ej. para leer la profundidad después)
+};
+
+const char* depthModeName(DepthMode mode);
+
 class RenderPass {
 public:
-    RenderPass(VkDevice device, VkFormat swapChainImageFormat, VkFormat depthFormat);
+    RenderPass(VkDevice device, VkFormat swapChainImageFormat, VkFormat depthFormat, DepthMode depthMode = DepthMode::Transient);
     ~RenderPass();
 
     VkRenderPass get() const { return renderPass_; }
+    DepthMode getDepthMode() const { return depthMode_; }
+    bool hasDepth() const { return depthMode_ != DepthMode::None; }
+    uint32_t getAttachmentCount() const { return hasDepth() ? 2u : 1u; } // Color (0) + profundidad (1)
 
 private:
     VkDevice device_;
     VkRenderPass renderPass_;
+    DepthMode depthMode_;
 
     void createRenderPass(VkFormat swapChainImageFormat, VkFormat depthFormat);
 };
@@ -0,0 +1,34 @@
+#include "shader_module.hpp"
+#include "embedded_shaders.hpp"
+#include "utils/vulkan_debug.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace particulas {
+
+std::vector<char> readShaderFile(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Failed to open shader file: " + filepath);
+    size_t fileSize = (size_t) file.tellg(); if (fileSize == 0) { file.close(); throw std::runtime_error("Shader file is empty: " + filepath); }
+    std::vector<char> buffer(fileSize); file.seekg(0); file.read(buffer.data(), fileSize); file.close(); return buffer;
+}
+
+VkShaderModule createShaderModule(VkDevice device, const std::string& filepath) {
+    VkShaderModuleCreateInfo createInfo{}; createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    std::vector<char> shaderCode; // Solo se usa si el shader no está incrustado
+    size_t nameStart = filepath.find_last_of("/\\");
+    const EmbeddedShader* embedded = findEmbeddedShader(nameStart == std::string::npos ? filepath : filepath.substr(nameStart + 1));
+    if (embedded) {
+        createInfo.codeSize = embedded->size; createInfo.pCode = reinterpret_cast<const uint32_t*>(embedded->data);
+    } else {
+        shaderCode = readShaderFile(filepath);
+        createInfo.codeSize = shaderCode.size(); createInfo.pCode = reinterpret_cast<const uint32_t*>(shaderCode.data());
+    }
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    VkResult result = vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule);
+    particulas::debug::checkVkResult(result, "Create shader module from " + filepath);
+    return shaderModule;
+}
+
+} // namespace particulas
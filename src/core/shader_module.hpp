@@ -0,0 +1,19 @@
+#ifndef PARTICULAS_CORE_SHADER_MODULE_HPP
+#define PARTICULAS_CORE_SHADER_MODULE_HPP
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+
+namespace particulas {
+
+// Lee un fichero SPIR-V completo. Lanza excepción si no existe o está vacío.
+std::vector<char> readShaderFile(const std::string& filepath);
+
+// Crea un VkShaderModule. Usa el SPIR-V incrustado en el ejecutable si existe uno con el mismo
+// nombre de fichero; si no, lee filepath del disco. Lanza excepción en error.
+VkShaderModule createShaderModule(VkDevice device, const std::string& filepath);
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_SHADER_MODULE_HPP
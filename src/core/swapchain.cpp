@@ -1,14 +1,24 @@
 #include "swapchain.hpp"
 // device.hpp y window.hpp incluidos vía swapchain.hpp
 #include "utils/vulkan_debug.hpp"
+#include "utils/logger.hpp"
 
 #include <stdexcept>
 #include <algorithm>
-#include <iostream>
 #include <limits>
 
 namespace particulas {
 
+const char* presentModeName(VkPresentModeKHR mode) {
+    switch (mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return "immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR: return "mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR: return "fifo";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "fifo-relaxed";
+        default: return "other";
+    }
+}
+
 // --- Implementación de funciones auxiliares ---
 SwapChainSupportDetails Swapchain::querySwapChainSupport() { /* ... (como antes) ... */
     if (physicalDevice_ == VK_NULL_HANDLE || surface_ == VK_NULL_HANDLE) throw std::runtime_error("Cannot query swapchain support: Physical device or surface not set.");
@@ -29,8 +39,9 @@ VkSurfaceFormatKHR Swapchain::chooseSwapSurfaceFormat(const std::vector<VkSurfac
 }
 VkPresentModeKHR Swapchain::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) { /* ... (como antes) ... */
     if (availablePresentModes.empty()) throw std::runtime_error("No present modes available!");
+    for (const auto& availablePresentMode : availablePresentModes) { if (availablePresentMode == preferredPresentMode_) return availablePresentMode; }
     for (const auto& availablePresentMode : availablePresentModes) { if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) return availablePresentMode; }
-    return VK_PRESENT_MODE_FIFO_KHR;
+    return VK_PRESENT_MODE_FIFO_KHR; // Siempre disponible
 }
 VkExtent2D Swapchain::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, const Window& window) { /* ... (como antes) ... */
     if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) return capabilities.currentExtent;
@@ -43,10 +54,13 @@ VkExtent2D Swapchain::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilit
 }
 
 // --- Constructor (Corregido) ---
-Swapchain::Swapchain(const Device& device, VkSurfaceKHR surface, const Window& window)
+Swapchain::Swapchain(const Device& device, VkSurfaceKHR surface, const Window& window, VkPresentModeKHR preferredPresentMode,
+                     VkImageUsageFlags extraUsage)
     : device_(device.getLogicalDevice()),
       physicalDevice_(device.getPhysicalDevice()),
       surface_(surface),
+      preferredPresentMode_(preferredPresentMode),
+      imageUsage_(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | extraUsage),
       graphicsQueueFamilyIndex_(device.getGraphicsQueueFamilyIndex()),
       // Obtener el índice de presentación que encontró Device
       // Asume que Device tiene un getter o lo almacena como hicimos.
@@ -73,7 +87,7 @@ Swapchain::Swapchain(const Device& device, VkSurfaceKHR surface, const Window& w
 
     createSwapchain(window);
     createImageViews();
-    std::cout << "Swapchain created successfully." << std::endl;
+    PARTICULAS_LOG(Info) << "Swapchain created successfully.";
 }
 
 
@@ -95,6 +109,7 @@ void Swapchain::createSwapchain(const Window& window) { /* ... (como antes, sin
     SwapChainSupportDetails swapChainSupport = querySwapChainSupport();
     VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
     VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+    supportedPresentModes_ = swapChainSupport.presentModes;
     VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities, window);
     uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
     if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) imageCount = swapChainSupport.capabilities.maxImageCount;
@@ -103,11 +118,15 @@ void Swapchain::createSwapchain(const Window& window) { /* ... (como antes, sin
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
     createInfo.surface = surface_;
     createInfo.minImageCount = imageCount;
+    minImageCount_ = imageCount;
     createInfo.imageFormat = surfaceFormat.format;
     createInfo.imageColorSpace = surfaceFormat.colorSpace;
     createInfo.imageExtent = extent;
     createInfo.imageArrayLayers = 1;
-    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if ((swapChainSupport.capabilities.supportedUsageFlags & imageUsage_) != imageUsage_) {
+        throw std::runtime_error("Surface does not support the requested swapchain image usage flags.");
+    }
+    createInfo.imageUsage = imageUsage_;
 
     uint32_t queueFamilyIndicesArray[] = {graphicsQueueFamilyIndex_, presentQueueFamilyIndex_};
     if (graphicsQueueFamilyIndex_ != presentQueueFamilyIndex_) {
@@ -133,9 +152,11 @@ void Swapchain::createSwapchain(const Window& window) { /* ... (como antes, sin
     vkGetSwapchainImagesKHR(device_, swapchain_, &imageCount, swapchainImages_.data());
     swapchainImageFormat_ = surfaceFormat.format;
     swapchainExtent_ = extent;
-    std::cout << "  - Swapchain Image Count: " << imageCount << std::endl;
-    std::cout << "  - Swapchain Format: " << swapchainImageFormat_ << std::endl;
-    std::cout << "  - Swapchain Extent: " << swapchainExtent_.width << "x" << swapchainExtent_.height << std::endl;
+    presentMode_ = presentMode;
+    PARTICULAS_LOG(Info) << "  - Swapchain Image Count: " << imageCount;
+    PARTICULAS_LOG(Info) << "  - Swapchain Present Mode: " << presentModeName(presentMode_);
+    PARTICULAS_LOG(Info) << "  - Swapchain Format: " << swapchainImageFormat_;
+    PARTICULAS_LOG(Info) << "  - Swapchain Extent: " << swapchainExtent_.width << "x" << swapchainExtent_.height;
 }
 
 // --- createImageViews ---
@@ -11,9 +11,15 @@ namespace particulas {
 
 // SwapChainSupportDetails está definido en device.hpp
 
+const char* presentModeName(VkPresentModeKHR mode);
+
 class Swapchain {
 public:
-    Swapchain(const Device& device, VkSurfaceKHR surface, const Window& window);
+    // preferredPresentMode se usa si la superficie lo admite; si no, MAILBOX y por último FIFO.
+    // extraUsage se añade a COLOR_ATTACHMENT (p. ej. TRANSFER_SRC para capturar frames); lanza
+    // std::runtime_error si la superficie no lo admite.
+    Swapchain(const Device& device, VkSurfaceKHR surface, const Window& window,
+              VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR, VkImageUsageFlags extraUsage = 0);
     ~Swapchain();
 
     VkSwapchainKHR get() const { return swapchain_; }
@@ -21,6 +27,11 @@ public:
     const std::vector<VkImageView>& getImageViews() const { return swapchainImageViews_; }
     VkFormat getImageFormat() const { return swapchainImageFormat_; }
     VkExtent2D getExtent() const { return swapchainExtent_; }
+    VkPresentModeKHR getPresentMode() const { return presentMode_; }
+    VkImageUsageFlags getImageUsage() const { return imageUsage_; }
+    uint32_t getMinImageCount() const { return minImageCount_; }
+    // Modos de presentación que admite la superficie (consultados al crear el swapchain)
+    const std::vector<VkPresentModeKHR>& getSupportedPresentModes() const { return supportedPresentModes_; }
 
 private:
     void createSwapchain(const Window& window); // Pasar Window
@@ -38,6 +49,11 @@ private:
     std::vector<VkImageView> swapchainImageViews_;
     VkFormat swapchainImageFormat_ = VK_FORMAT_UNDEFINED;
     VkExtent2D swapchainExtent_ = {0, 0};
+    VkPresentModeKHR preferredPresentMode_;
+    VkImageUsageFlags imageUsage_;
+    VkPresentModeKHR presentMode_ = VK_PRESENT_MODE_FIFO_KHR;
+    uint32_t minImageCount_ = 0;
+    std::vector<VkPresentModeKHR> supportedPresentModes_;
     uint32_t graphicsQueueFamilyIndex_;
     uint32_t presentQueueFamilyIndex_; // Guardar el índice de presentación
 };
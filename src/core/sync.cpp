@@ -1,18 +1,20 @@
 #include "sync.hpp"
 #include "utils/vulkan_debug.hpp" // Para checkVkResult
+#include "utils/logger.hpp"
 
 #include <stdexcept>
-#include <iostream>
+#include <algorithm>
 #include <limits>
 
 namespace particulas {
 
-Sync::Sync(VkDevice device)
-    : device_(device), currentFrame_(0) {
+Sync::Sync(const Device& device, bool preferTimeline)
+    : device_(device.getLogicalDevice()), currentFrame_(0) {
 
-    imageAvailableSemaphores_.resize(MAX_FRAMES_IN_FLIGHT);
-    renderFinishedSemaphores_.resize(MAX_FRAMES_IN_FLIGHT);
-    inFlightFences_.resize(MAX_FRAMES_IN_FLIGHT);
+    imageAvailableSemaphores_.resize(MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+    renderFinishedSemaphores_.resize(MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+    bool useTimeline = preferTimeline && device.supportsTimelineSemaphores();
+    if (!useTimeline) inFlightFences_.resize(MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -24,17 +26,30 @@ Sync::Sync(VkDevice device)
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
          VkResult result1 = vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &imageAvailableSemaphores_[i]);
          VkResult result2 = vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &renderFinishedSemaphores_[i]);
-         VkResult result3 = vkCreateFence(device_, &fenceInfo, nullptr, &inFlightFences_[i]);
+         VkResult result3 = useTimeline ? VK_SUCCESS : vkCreateFence(device_, &fenceInfo, nullptr, &inFlightFences_[i]);
          if (result1 != VK_SUCCESS || result2 != VK_SUCCESS || result3 != VK_SUCCESS) {
             // Limpiar parcialmente si falla
              for(size_t j = 0; j <= i; ++j) {
                 if (imageAvailableSemaphores_[j] != VK_NULL_HANDLE) vkDestroySemaphore(device_, imageAvailableSemaphores_[j], nullptr);
                 if (renderFinishedSemaphores_[j] != VK_NULL_HANDLE) vkDestroySemaphore(device_, renderFinishedSemaphores_[j], nullptr);
-                if (inFlightFences_[j] != VK_NULL_HANDLE) vkDestroyFence(device_, inFlightFences_[j], nullptr);
+                if (!useTimeline && inFlightFences_[j] != VK_NULL_HANDLE) vkDestroyFence(device_, inFlightFences_[j], nullptr);
              }
             throw std::runtime_error("Failed to create synchronization objects for frame " + std::to_string(i));
         }
     }
+
+    if (useTimeline) {
+        try {
+            timeline_ = std::make_unique<TimelineSemaphore>(device, 0);
+        } catch (...) {
+            for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+                vkDestroySemaphore(device_, imageAvailableSemaphores_[i], nullptr);
+                vkDestroySemaphore(device_, renderFinishedSemaphores_[i], nullptr);
+            }
+            throw;
+        }
+    }
+    PARTICULAS_LOG(Info) << "Frame sync: " << (useTimeline ? "timeline semaphore" : "per-frame fences");
 }
 
 Sync::~Sync() {
@@ -49,9 +64,9 @@ Sync::~Sync() {
         if (imageAvailableSemaphores_[i] != VK_NULL_HANDLE) {
             vkDestroySemaphore(device_, imageAvailableSemaphores_[i], nullptr);
         }
-        if (inFlightFences_[i] != VK_NULL_HANDLE) {
-            vkDestroyFence(device_, inFlightFences_[i], nullptr);
-        }
+    }
+    for (VkFence fence : inFlightFences_) {
+        if (fence != VK_NULL_HANDLE) vkDestroyFence(device_, fence, nullptr);
     }
 }
 
@@ -63,22 +78,86 @@ VkSemaphore Sync::getRenderFinishedSemaphore() const {
     return renderFinishedSemaphores_[currentFrame_];
 }
 
-VkFence Sync::getInFlightFence() const {
-    return inFlightFences_[currentFrame_];
-}
-
-void Sync::waitForFence() const {
+void Sync::waitForFrame() const {
+    if (timeline_) {
+        timeline_->wait(slotValues_[currentFrame_]); // Valor 0 (slot sin usar) ya está alcanzado
+        return;
+    }
     VkResult result = vkWaitForFences(device_, 1, &inFlightFences_[currentFrame_], VK_TRUE, std::numeric_limits<uint64_t>::max());
     particulas::debug::checkVkResult(result, "Wait for fence");
 }
 
-void Sync::resetFence() const {
-    VkResult result = vkResetFences(device_, 1, &inFlightFences_[currentFrame_]);
-     particulas::debug::checkVkResult(result, "Reset fence");
+void Sync::addWait(VkSemaphore timelineSemaphore, uint64_t value, VkPipelineStageFlags stage) {
+    if (!timeline_) throw std::runtime_error("Sync::addWait requires timeline semaphore support.");
+    if (pendingWaitCount_ == MAX_PENDING_WAITS) throw std::runtime_error("Sync::addWait: too many waits for one submission (MAX_PENDING_WAITS).");
+    pendingWaits_[pendingWaitCount_++] = {timelineSemaphore, value, stage};
+}
+
+void Sync::submit(VkQueue queue, VkCommandBuffer commandBuffer, VkPipelineStageFlags acquireWaitStage) {
+    uint64_t signalValue = frameCounter_ + 1;
+
+    // Espera 0: imagen adquirida (binario, valor ignorado); el resto, dependencias timeline
+    std::array<VkSemaphore, MAX_PENDING_WAITS + 1> waitSemaphores = {imageAvailableSemaphores_[currentFrame_]};
+    std::array<VkPipelineStageFlags, MAX_PENDING_WAITS + 1> waitStages = {acquireWaitStage};
+    std::array<uint64_t, MAX_PENDING_WAITS + 1> waitValues = {0};
+    uint32_t waitCount = 1;
+    for (size_t i = 0; i < pendingWaitCount_; ++i, ++waitCount) {
+        waitSemaphores[waitCount] = pendingWaits_[i].semaphore; waitStages[waitCount] = pendingWaits_[i].stage; waitValues[waitCount] = pendingWaits_[i].value;
+    }
+    pendingWaitCount_ = 0;
+
+    VkSemaphore signalSemaphores[2] = {renderFinishedSemaphores_[currentFrame_], getTimelineSemaphore()};
+    uint64_t signalValues[2] = {0, signalValue};
+
+    VkSubmitInfo submitInfo{}; submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = waitCount; submitInfo.pWaitSemaphores = waitSemaphores.data(); submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = 1; submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = timeline_ ? 2 : 1; submitInfo.pSignalSemaphores = signalSemaphores;
+
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo{}; timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    VkFence fence = VK_NULL_HANDLE;
+    if (timeline_) {
+        timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount; timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        timelineInfo.signalSemaphoreValueCount = 2; timelineInfo.pSignalSemaphoreValues = signalValues;
+        submitInfo.pNext = &timelineInfo;
+        timeline_->reserveNext();
+    } else {
+        fence = inFlightFences_[currentFrame_];
+        particulas::debug::checkVkResult(vkResetFences(device_, 1, &fence), "Reset fence");
+    }
+    particulas::debug::checkVkResult(vkQueueSubmit(queue, 1, &submitInfo, fence), "Queue submit");
+    frameCounter_ = signalValue;
+    slotValues_[currentFrame_] = signalValue;
+}
+
+uint64_t Sync::getCompletedValue() const {
+    if (timeline_) return timeline_->getCompletedValue();
+    // Con fences: el mayor valor cuyo slot ya está señalado, sin saltar ninguno pendiente
+    uint64_t completed = frameCounter_;
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        if (slotValues_[i] != 0 && vkGetFenceStatus(device_, inFlightFences_[i]) == VK_NOT_READY) {
+            completed = std::min(completed, slotValues_[i] - 1);
+        }
+    }
+    return completed;
+}
+
+void Sync::waitForValue(uint64_t value) const {
+    if (value > frameCounter_) throw std::runtime_error("Sync::waitForValue: value " + std::to_string(value) + " has not been submitted.");
+    if (timeline_) { timeline_->wait(value); return; }
+    // La cola completa en orden: basta la fence del primer slot con valor >= value. Los valores
+    // más antiguos que todos los slots ya se esperaron antes de reutilizar su slot.
+    size_t slot = MAX_FRAMES_IN_FLIGHT;
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        if (slotValues_[i] >= value && (slot == MAX_FRAMES_IN_FLIGHT || slotValues_[i] < slotValues_[slot])) slot = i;
+    }
+    if (slot == MAX_FRAMES_IN_FLIGHT) return;
+    VkResult result = vkWaitForFences(device_, 1, &inFlightFences_[slot], VK_TRUE, std::numeric_limits<uint64_t>::max());
+    particulas::debug::checkVkResult(result, "Wait for fence");
 }
 
 void Sync::nextFrame() {
     currentFrame_ = (currentFrame_ + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
-} // namespace particulas
\ No newline at end of file
+} // namespace particulas
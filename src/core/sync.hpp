@@ -1,7 +1,12 @@
 #ifndef PARTICULAS_CORE_SYNC_HPP
 #define PARTICULAS_CORE_SYNC_HPP
 
+#include "core/device.hpp"
+#include "core/timeline_semaphore.hpp"
+
 #include <vulkan/vulkan.h>
+#include <array>
+#include <memory>
 #include <vector>
 
 namespace particulas {
@@ -9,17 +14,38 @@ namespace particulas {
 // Definir MAX_FRAMES_IN_FLIGHT en el namespace
 const int MAX_FRAMES_IN_FLIGHT = 2; // Hacerla accesible como particulas::MAX_FRAMES_IN_FLIGHT
 
+// Sincronización de frames de la cola gráfica. Con semáforos timeline hay un único contador
+// monótono: el frame N señala el valor N y esperar un slot es esperar el valor que señaló su
+// última submission. Sin soporte se usa el esquema clásico de una fence por frame en vuelo,
+// con la misma interfaz de valores (waitForValue traduce el valor a la fence de su slot).
+// Los semáforos binarios de adquisición/presentación se mantienen en ambos modos (WSI no
+// admite timeline).
 class Sync {
 public:
-    Sync(VkDevice device);
+    Sync(const Device& device, bool preferTimeline = true);
     ~Sync();
 
     VkSemaphore getImageAvailableSemaphore() const;
     VkSemaphore getRenderFinishedSemaphore() const;
-    VkFence getInFlightFence() const;
 
-    void waitForFence() const;
-    void resetFence() const;
+    // Espera a que la GPU termine la submission anterior de este slot de frame
+    void waitForFrame() const;
+
+    // Envía el command buffer del frame: espera la imagen adquirida (y las dependencias añadidas
+    // con addWait), señala renderFinished y el valor del frame (timeline) o la fence del slot.
+    void submit(VkQueue queue, VkCommandBuffer commandBuffer, VkPipelineStageFlags acquireWaitStage);
+
+    // Dependencia de la siguiente submission sobre el valor de otro semáforo timeline (otra cola).
+    // Solo en modo timeline (lanza excepción en el modo con fences) y hasta MAX_PENDING_WAITS por frame.
+    void addWait(VkSemaphore timelineSemaphore, uint64_t value, VkPipelineStageFlags stage);
+
+    // --- Contador de frames ---
+    bool usesTimelineSemaphore() const { return timeline_ != nullptr; }
+    VkSemaphore getTimelineSemaphore() const { return timeline_ ? timeline_->get() : VK_NULL_HANDLE; }
+    uint64_t getFrameValue() const { return frameCounter_ + 1; } // Valor que señalará el frame en grabación
+    uint64_t getSubmittedValue() const { return frameCounter_; }
+    uint64_t getCompletedValue() const;
+    void waitForValue(uint64_t value) const; // Cualquier valor ya enviado
 
     // Obtener el índice del frame actual (0..MAX_FRAMES_IN_FLIGHT-1)
     uint32_t getCurrentFrameIndex() const { return currentFrame_; } // <-- Getter añadido
@@ -27,13 +53,21 @@ public:
     void nextFrame(); // Hacerla pública
 
 private:
+    struct PendingWait { VkSemaphore semaphore; uint64_t value; VkPipelineStageFlags stage; };
+    static constexpr size_t MAX_PENDING_WAITS = 4; // Tamaño fijo: enviar un frame no reserva memoria
+
     VkDevice device_;
     std::vector<VkSemaphore> imageAvailableSemaphores_;
     std::vector<VkSemaphore> renderFinishedSemaphores_;
-    std::vector<VkFence> inFlightFences_;
+    std::vector<VkFence> inFlightFences_;              // Solo sin timeline
+    std::unique_ptr<TimelineSemaphore> timeline_;      // Solo con timeline
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> slotValues_{}; // Valor de la última submission de cada slot
+    std::array<PendingWait, MAX_PENDING_WAITS> pendingWaits_{};
+    size_t pendingWaitCount_ = 0;
+    uint64_t frameCounter_ = 0;                        // Último valor enviado
     uint32_t currentFrame_ = 0;
 };
 
 } // namespace particulas
 
-#endif // PARTICULAS_CORE_SYNC_HPP
\ No newline at end of file
+#endif // PARTICULAS_CORE_SYNC_HPP
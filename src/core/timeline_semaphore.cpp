@@ -0,0 +1,40 @@
+#include "timeline_semaphore.hpp"
+#include "utils/vulkan_debug.hpp"
+
+#include <stdexcept>
+
+namespace particulas {
+
+TimelineSemaphore::TimelineSemaphore(const Device& device, uint64_t initialValue)
+    : device_(device.getLogicalDevice()), lastReserved_(initialValue) {
+    if (!device.supportsTimelineSemaphores()) throw std::runtime_error("Timeline semaphores are not enabled on this device.");
+    waitSemaphores_ = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(vkGetDeviceProcAddr(device_, "vkWaitSemaphoresKHR"));
+    getCounterValue_ = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(vkGetDeviceProcAddr(device_, "vkGetSemaphoreCounterValueKHR"));
+    if (!waitSemaphores_ || !getCounterValue_) throw std::runtime_error("Failed to load VK_KHR_timeline_semaphore entry points.");
+
+    VkSemaphoreTypeCreateInfoKHR typeInfo{}; typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR; typeInfo.initialValue = initialValue;
+    VkSemaphoreCreateInfo semaphoreInfo{}; semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO; semaphoreInfo.pNext = &typeInfo;
+    particulas::debug::checkVkResult(vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &semaphore_), "Create timeline semaphore");
+}
+
+TimelineSemaphore::~TimelineSemaphore() {
+    if (semaphore_ != VK_NULL_HANDLE) vkDestroySemaphore(device_, semaphore_, nullptr);
+}
+
+uint64_t TimelineSemaphore::getCompletedValue() const {
+    uint64_t value = 0;
+    particulas::debug::checkVkResult(getCounterValue_(device_, semaphore_, &value), "Get timeline semaphore value");
+    return value;
+}
+
+bool TimelineSemaphore::wait(uint64_t value, uint64_t timeoutNanoseconds) const {
+    VkSemaphoreWaitInfoKHR waitInfo{}; waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    waitInfo.semaphoreCount = 1; waitInfo.pSemaphores = &semaphore_; waitInfo.pValues = &value;
+    VkResult result = waitSemaphores_(device_, &waitInfo, timeoutNanoseconds);
+    if (result == VK_TIMEOUT) return false;
+    particulas::debug::checkVkResult(result, "Wait timeline semaphore");
+    return true;
+}
+
+} // namespace particulas
@@ -0,0 +1,46 @@
+#ifndef PARTICULAS_CORE_TIMELINE_SEMAPHORE_HPP
+#define PARTICULAS_CORE_TIMELINE_SEMAPHORE_HPP
+
+#include "core/device.hpp"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <limits>
+
+namespace particulas {
+
+// Semáforo timeline (VK_KHR_timeline_semaphore) con un contador monótono: una instancia por cola.
+// Cada submission reserva el siguiente valor con reserveNext() y lo señala; la CPU u otras colas
+// esperan cualquier valor pasado sin objetos extra. Requiere Device::supportsTimelineSemaphores().
+class TimelineSemaphore {
+public:
+    explicit TimelineSemaphore(const Device& device, uint64_t initialValue = 0);
+    ~TimelineSemaphore();
+
+    VkSemaphore get() const { return semaphore_; }
+
+    // Reserva el siguiente valor a señalar por una submission de la cola
+    uint64_t reserveNext() { return ++lastReserved_; }
+    uint64_t getLastReserved() const { return lastReserved_; }
+
+    // Último valor alcanzado en la GPU (no bloquea)
+    uint64_t getCompletedValue() const;
+
+    // Bloquea hasta que el contador alcance value. Devuelve false si vence el timeout.
+    bool wait(uint64_t value, uint64_t timeoutNanoseconds = std::numeric_limits<uint64_t>::max()) const;
+
+    TimelineSemaphore(const TimelineSemaphore&) = delete;
+    TimelineSemaphore& operator=(const TimelineSemaphore&) = delete;
+
+private:
+    VkDevice device_;
+    VkSemaphore semaphore_ = VK_NULL_HANDLE;
+    uint64_t lastReserved_;
+    // Puntos de entrada de la extensión (cargados con vkGetDeviceProcAddr)
+    PFN_vkWaitSemaphoresKHR waitSemaphores_ = nullptr;
+    PFN_vkGetSemaphoreCounterValueKHR getCounterValue_ = nullptr;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_CORE_TIMELINE_SEMAPHORE_HPP
@@ -3,17 +3,43 @@
 #include "core/device.hpp"
 #include "core/swapchain.hpp"
 #include "core/command_pool.hpp"
+#include "core/frame_command_pools.hpp"
 #include "core/sync.hpp"
 #include "core/pipeline.hpp"
+#include "core/pipeline_variant_manager.hpp"
 #include "core/render_pass.hpp"
+#include "core/render_graph.hpp"
+#include "core/pipeline_cache.hpp"
+#include "core/embedded_shaders.hpp"
 #include "particles/particle_system.hpp"
+#include "particles/constraint_scenes.hpp"
+#include "particles/morton_reorder.hpp"
+#include "particles/ensemble.hpp"
 #include "rendering/particle_renderer.hpp"
+#include "rendering/gpu_particle_system.hpp"
+#include "rendering/splat_renderer.hpp"
+#include "rendering/camera.hpp"
+#include "rendering/species_buffer.hpp"
+#include "rendering/performance_hud.hpp"
+#include "rendering/frame_capture.hpp"
+#include "particles/spatial_grid.hpp"
 #include "utils/vulkan_debug.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/perf_counters.hpp"
+#include "utils/metrics_server.hpp"
+#include "utils/startup_timer.hpp"
+#include "utils/allocation_tracker.hpp"
+#include "utils/logger.hpp"
+#include "utils/shared_snapshot_writer.hpp"
+#include "utils/scenario.hpp"
+#include "utils/sweep_report.hpp"
+#include "utils/quality_controller.hpp"
 
 #include <vulkan/vulkan.h>
 #include <GLFW/glfw3.h>
 
 #include <stdexcept>
+#include <exception>
 #include <iostream>
 #include <vector>
 #include <cstdlib>
@@ -28,6 +54,8 @@
 #include <sstream>     // <-- Para stringstream
 #include <filesystem>  // <-- Para path, exists, create_directory
 #include <algorithm>   // <-- Para min, replace (opcional)
+#include <cmath>
+#include <cstdio>
 
 // <-- Headers específicos de plataforma -->
 #ifdef _WIN32
@@ -38,6 +66,7 @@
     #include <unistd.h>
     #include <limits.h> // Para HOST_NAME_MAX (o usar POSIX_HOST_NAME_MAX)
     #include <pwd.h>    // Para getpwuid, getuid
+    #include <fcntl.h>  // Para open (lectura de /proc sin reservar memoria)
     // LOGIN_NAME_MAX puede necesitar <stdio.h> o estar definido en otro lugar
     #ifndef LOGIN_NAME_MAX
     #define LOGIN_NAME_MAX 256 // Definición común si no existe
@@ -51,27 +80,77 @@
 const uint32_t WINDOW_WIDTH = 1920;
 const uint32_t WINDOW_HEIGHT = 1080;
 const int PARTICLE_COUNT = 10000;
+const size_t PARTICLE_CAPACITY = 20000;    // Slots del pool (iniciales + emitidas)
+const bool DOWNSCALE_CAPACITY_TO_GPU_BUDGET = true; // Si la capacidad no cabe en memoria de GPU: reducirla (true) o abortar (false)
+const double GPU_MEMORY_HEADROOM = 0.25;   // Fracción del presupuesto libre reservada a temporales del grafo, driver y otros procesos
+const bool ENABLE_DEMO_EMITTER = true;     // Emisor continuo en el centro del dominio
 const std::string APP_VERSION = "1.0-OOP_FrameRenderTime"; 
+const bool RUN_CONSTRAINT_BENCHMARK = false; // Ejecutar el benchmark de restricciones (sin ventana) antes de arrancar
+const bool RUN_MORTON_BENCHMARK = false;   // Medir la pasada de vecindad antes/después del orden Morton
+const bool ENABLE_MORTON_REORDER = true;   // Reordenar por curva Z cada 600 updates o si la localidad empeora 2x
+const bool SIMULATE_ON_GPU = false;        // Simulación, emisión y compactación en compute shaders + vkCmdDrawIndirect
+const particulas::DepthMode DEPTH_MODE = particulas::DepthMode::None; // Puntos 2D planos: el depth test no aporta nada
+const bool USE_TIMELINE_SEMAPHORES = true; // Sync con semáforo timeline si el dispositivo lo admite (si no, fences)
+const bool START_WITH_SPLAT_RENDERER = false; // Renderizador inicial; la tecla R alterna entre puntos y splats
+const float DOMAIN_WIDTH = 3840.0f;        // Dominio del mundo, independiente de la ventana (cámara con zoom/pan)
+const float DOMAIN_HEIGHT = 2160.0f;
+const bool ENABLE_VIEW_CULLING = true;     // Subir y dibujar solo las partículas dentro de la vista
+const float CULL_CELL_SIZE = 64.0f;        // Celda de la rejilla de culling en CPU (unidades del mundo)
+const float CAMERA_PAN_SPEED = 800.0f;     // Píxeles de pantalla por segundo con las flechas/WASD
+const bool ENABLE_PERFORMANCE_HUD = true;  // Overlay ImGui con tiempos y controles en vivo (F1 lo muestra/oculta)
+const bool START_WITH_HUD_VISIBLE = true;
+const int MAX_SIMULATION_STEPS_PER_FRAME = 8; // Con ritmo de simulación fijo, el atraso que no cabe se descarta
+const bool ENABLE_METRICS_ENDPOINT = false; // Métricas en vivo para Prometheus: curl http://127.0.0.1:9464/metrics
+const uint16_t METRICS_ENDPOINT_PORT = 9464;
+const bool ENABLE_PERF_COUNTERS = false;   // Contadores hardware por fase e hilo (perf_event_open, Linux) en <métricas>_perf.csv
+const size_t MAX_RECORDED_FRAMES = 216000; // Tiempos por frame para el CSV (1 h a 60 fps), reservados al arrancar: el bucle no reserva
+const size_t MAX_RECORDED_PERF_FRAMES = 36000; // Ídem para las muestras de los contadores hardware
+const uint64_t ALLOCATION_WARMUP_FRAMES = 300; // Con PARTICULAS_TRACK_ALLOCATIONS: a partir de aquí un frame no debe reservar memoria
+const bool FAIL_ON_STEADY_STATE_ALLOCATION = false; // Lanzar excepción en el primer frame estable que reserve (si no, solo avisar)
+const bool ENABLE_SHARED_SNAPSHOTS = false; // Publicar cada paso en memoria compartida para otros procesos (SnapshotConsumer)
+const char* const SHARED_SNAPSHOT_NAME = "/particulas_snapshots";
+const uint32_t SHARED_SNAPSHOT_SLOTS = 4;  // Anillo: un lector tiene 3 publicaciones de margen para procesar un snapshot
+const bool ENABLE_FRAME_CAPTURE = false;   // Copiar los frames (sin el HUD) a PNG o vídeo crudo desde un hilo aparte, sin parar el pipeline
+const particulas::CaptureFormat FRAME_CAPTURE_FORMAT = particulas::CaptureFormat::PngSequence;
+const char* const FRAME_CAPTURE_OUTPUT = "capture"; // PNG: directorio; crudo: fichero o FIFO
+const char* const FRAME_CAPTURE_PIPE = "";  // Crudo: comando que recibe los frames por stdin (p. ej. ffmpeg, ver frame_capture.hpp)
+const uint32_t FRAME_CAPTURE_INTERVAL = 1;  // Un frame de cada N
+const uint64_t FRAME_CAPTURE_MAX_FRAMES = 600; // 0 = sin límite
+const size_t ENSEMBLE_MEMBERS = 0;          // > 0: barrido de K simulaciones independientes en rejilla, con métricas en <métricas>_ensemble.csv
+const int ENSEMBLE_MEMBER_PARTICLES = 2000; // Partículas iniciales de cada miembro (dominio DOMAIN_WIDTH x DOMAIN_HEIGHT)
+const float ENSEMBLE_MAX_GRAVITY = 300.0f;  // Gravedad de 0 (primer miembro) a este valor (último)
+const float ENSEMBLE_EMITTER_RATE = 500.0f; // Emisor en los miembros impares (0 = ninguno)
+const bool ENABLE_QUALITY_CONTROLLER = false; // Kiosco: bajar subpasos, escala de splats y partículas dibujadas para no pasar del presupuesto
+const double QUALITY_FRAME_BUDGET_MS = 16.6;  // Objetivo para el p95 del intervalo entre frames (decisiones en <métricas>_quality.csv)
+const float QUALITY_MIN_RENDER_SCALE = 0.5f;  // Resolución mínima del acumulador de splats
+const float QUALITY_MIN_DRAW_FRACTION = 0.25f; // Fracción mínima de las partículas visibles que se dibuja (solo CPU)
 // --- Aplicación Principal ---
 class ParticleSimulationApp {
 public:
-    void run() {
+    // Sin escenarios: modo interactivo con las constantes de arriba. Con escenarios: se ejecutan en
+    // orden sobre la misma ventana, instancia y dispositivo (ver runSweep) y se sale.
+    void run(const std::vector<particulas::Scenario>& scenarios = {}) {
         try {
-            initWindow();
-            initVulkan();
-            initSimulation();
-            mainLoop();
+            scenario_ = scenarios.empty() ? makeInteractiveScenario() : scenarios.front();
+            startupTimer_.measure("initWindow", [this] { initWindow(); });
+            startupTimer_.measure("initVulkan", [this] { initVulkan(); });
+            startupTimer_.measure("initSimulation", [this] { initSimulation(); });
+            if (ENABLE_METRICS_ENDPOINT) startMetricsEndpoint();
+            if (ENABLE_SHARED_SNAPSHOTS && scenarios.empty()) startSharedSnapshots(); // El segmento se dimensiona con la primera escena
+            finishStartup();
+            if (scenarios.empty()) mainLoop();
+            else runSweep(scenarios);
         } catch (const std::exception& e) {
-            std::cerr << "FATAL ERROR during initialization or main loop: " << e.what() << std::endl;
+            PARTICULAS_LOG(Error) << "FATAL ERROR during initialization or main loop: " << e.what();
             // Intenta limpiar lo que se haya podido inicializar
             try {
                 cleanup();
             } catch (const std::exception& cleanup_e) {
-                 std::cerr << "FATAL ERROR during cleanup: " << cleanup_e.what() << std::endl;
+                 PARTICULAS_LOG(Error) << "FATAL ERROR during cleanup: " << cleanup_e.what();
             }
              throw; // Relanzar la excepción original para indicar fallo
         } catch (...) {
-             std::cerr << "FATAL ERROR: Unknown exception caught!" << std::endl;
+             PARTICULAS_LOG(Error) << "FATAL ERROR: Unknown exception caught!";
              cleanup(); // Intentar limpiar
              throw;
         }
@@ -87,153 +166,590 @@ private:
     VkDebugUtilsMessengerEXT debugMessenger_ = VK_NULL_HANDLE;
     VkSurfaceKHR surface_ = VK_NULL_HANDLE;
     std::unique_ptr<particulas::Device> device_;
+    std::unique_ptr<particulas::PipelineCache> pipelineCache_; // Persistente en disco por GPU/driver
     std::unique_ptr<particulas::Swapchain> swapchain_;
     std::unique_ptr<particulas::RenderPass> renderPass_;
-    std::unique_ptr<particulas::Pipeline> pipeline_;
+    std::unique_ptr<particulas::SpeciesBuffer> speciesBuffer_; // Tabla de especies (puntos, cómputo y splats)
+    std::unique_ptr<particulas::PipelineVariantManager> pipelineVariants_; // Variante actual + compilación en segundo plano
     std::vector<VkFramebuffer> swapchainFramebuffers_;
-    std::unique_ptr<particulas::CommandPool> commandPool_; // <-- Tipo Correcto
-    std::vector<VkCommandBuffer> commandBuffers_;
+    std::unique_ptr<particulas::CommandPool> commandPool_; // <-- Tipo Correcto (subidas puntuales)
+    std::unique_ptr<particulas::FrameCommandPools> frameCommandPools_; // Primario + secundarios por frame e hilo
     std::unique_ptr<particulas::Sync> sync_;
     
 
     // --- Recursos de Simulación y Renderizado ---
+    std::unique_ptr<particulas::ThreadPool> threadPool_;
     std::unique_ptr<particulas::ParticleSystem> particleSystem_;
+    std::unique_ptr<particulas::Ensemble> ensemble_; // Con ENSEMBLE_MEMBERS: particleSystem_ solo contiene su rejilla
+    particulas::Scenario scenario_;                  // Escena, renderizador, ventana y present mode activos
     std::unique_ptr<particulas::ParticleRenderer> particleRenderer_; // <-- Tipo Correcto
+    std::unique_ptr<particulas::GpuParticleSystem> gpuParticles_; // Solo con SIMULATE_ON_GPU
+    std::unique_ptr<particulas::SplatRenderer> splatRenderer_;
+    float gpuDeltaTime_ = 0.0f; // deltaTime del frame para los passes de cómputo
+
+    // --- Grafo de frame: pases, barreras entre ellos, temporales compartidos y tiempos por pase ---
+    // Partes del frame grabadas en secundarios independientes, en el orden en que se ejecutan
+    enum RecordTask { RECORD_SIMULATION = 0, RECORD_SPLAT, RECORD_SCENE, RECORD_TASK_COUNT };
+    static constexpr uint32_t NO_PASS = UINT32_MAX;
+    std::unique_ptr<particulas::RenderGraph> renderGraph_;
+    uint32_t simulatePass_ = NO_PASS, splatPass_ = NO_PASS, scenePass_ = NO_PASS, capturePass_ = NO_PASS, overlayPass_ = NO_PASS;
+    std::array<VkCommandBuffer, RECORD_TASK_COUNT> frameSecondaries_{}; // Secundarios del frame que se graba
+    VkFramebuffer frameFramebuffer_ = VK_NULL_HANDLE;
+    uint32_t frameImageIndex_ = 0;
+
+    // --- HUD de rendimiento y controles en vivo ---
+    enum CpuPhase { CPU_SIMULATE = 0, CPU_WAIT, CPU_UPLOAD, CPU_RECORD, CPU_PRESENT, CPU_PHASE_COUNT };
+    std::unique_ptr<particulas::PerformanceHud> hud_;
+    particulas::HudControls hudControls_;
+    bool hudToggleKeyDown_ = false;
+    std::array<double, CPU_PHASE_COUNT> cpuPhaseMilliseconds_{}; // Último frame
+    uint64_t residentBytes_ = 0;
+    uint32_t hudFramesSinceMemorySample_ = 0;
+    particulas::MemoryBudget gpuMemoryBudget_{};  // Último muestreo de los heaps del dispositivo
+    uint32_t gpuHeapCount_ = 0;
+    uint32_t framesSinceBudgetSample_ = 0;
+    float simulationRateHz_ = 0.0f;       // 0 = un paso de simulación por frame
+    float simulationAccumulator_ = 0.0f;  // Tiempo aún no simulado con ritmo fijo
+    std::unique_ptr<particulas::QualityController> qualityController_; // Solo con presupuesto de frame
+    int simulationSubsteps_ = 1;          // Subpasos del solver de restricciones (el controlador los baja desde los de la escena)
+    float drawFraction_ = 1.0f;
+
+    // --- Contadores hardware por fase (opcional): simular, empaquetar lo visible y grabar ---
+    enum PerfPhase { PERF_SIMULATE = 0, PERF_PACK, PERF_RECORD, PERF_PHASE_COUNT };
+    struct PerfFrameSample {
+        std::array<particulas::PerfSample, PERF_PHASE_COUNT> phases{};
+        size_t particles = 0;
+    };
+    std::unique_ptr<particulas::PerfCounters> perfCounters_; // Nulo si está desactivado o el kernel no lo permite
+    PerfFrameSample perfFrame_;                              // Frame en curso
+    std::vector<PerfFrameSample> perfFrames_;
+
+    // --- Reservas de memoria por fase (solo con PARTICULAS_TRACK_ALLOCATIONS) ---
+    // Las fases de CpuPhase más el HUD, las llamadas al WSI (adquirir y presentar, que reservan
+    // dentro del driver y no se exigen a cero) y el resto del frame
+    enum AllocationPhase { ALLOC_HUD = CPU_PHASE_COUNT, ALLOC_DRIVER, ALLOC_OTHER, ALLOC_PHASE_COUNT };
+    std::array<particulas::AllocationCounts, ALLOC_PHASE_COUNT> allocationsAtFrameStart_{};
+    std::array<particulas::AllocationCounts, ALLOC_PHASE_COUNT> steadyStateAllocations_{}; // Suma tras el calentamiento
+    uint64_t allocationFrames_ = 0;
+    uint64_t framesWithAllocations_ = 0;
+
+    // --- Métricas en vivo (scrape del proceso en marcha) ---
+    particulas::LiveMetrics liveMetrics_;                    // El bucle de frame escribe, el servidor lee
+    std::unique_ptr<particulas::MetricsServer> metricsServer_;
+    std::unique_ptr<particulas::SharedSnapshotWriter> snapshotWriter_; // Nulo si está desactivado
+    std::unique_ptr<particulas::FrameCapture> frameCapture_;           // Ídem
+    uint64_t lastSnapshotStep_ = 0;
+    uint64_t stepsAtLastRateSample_ = 0;
+    std::chrono::high_resolution_clock::time_point lastRateSampleTime_;
+
+    // --- Cámara y culling por vista ---
+    std::unique_ptr<particulas::Camera2D> camera_;
+    std::unique_ptr<particulas::SpatialGrid> cullGrid_;     // Solo simulación en CPU
+    std::vector<particulas::Particle> visibleParticles_;    // Tamaño = capacidad, reservado una vez
+    uint32_t drawnParticles_ = 0;                           // Partículas subidas este frame (CPU)
+    bool cameraResetKeyDown_ = false;
+    bool cameraDragging_ = false;
+    double lastCursorX_ = 0.0, lastCursorY_ = 0.0;
 
     // --- Recursos de Profundidad ---
     VkImage depthImage_ = VK_NULL_HANDLE;
     VkDeviceMemory depthImageMemory_ = VK_NULL_HANDLE;
     VkImageView depthImageView_ = VK_NULL_HANDLE;
+    bool depthLazilyAllocated_ = false; // Memoria LAZILY_ALLOCATED (solo DepthMode::Transient)
 
     // --- Estado ---
     bool framebufferResized_ = false;
+
+    // --- Modo de renderizado (puntos vs splats) y su coste medido en GPU ---
+    enum RenderMode { RENDER_POINTS = 0, RENDER_SPLATS = 1, RENDER_MODE_COUNT };
+    struct RenderModeStats { double gpuMilliseconds = 0.0; double particles = 0.0; uint64_t frames = 0; };
+    RenderMode renderMode_ = RENDER_POINTS;
+    bool renderToggleKeyDown_ = false;
+    bool pointSizeKeyDown_ = false;
+    bool blendKeyDown_ = false;
+    std::array<RenderModeStats, RENDER_MODE_COUNT> renderStats_{};
+    std::array<RenderMode, particulas::MAX_FRAMES_IN_FLIGHT> timedRenderMode_{}; // Modo grabado en cada slot
+    std::array<uint32_t, particulas::MAX_FRAMES_IN_FLIGHT> timedParticles_{};
     // uint32_t currentFrame_ = 0; // No necesario si usamos getter de Sync
 
     // --- Miembros NUEVOS para Métricas ---
     std::vector<double> frameRenderTimesSeconds_; // <-- Guardar en segundos (double para precisión)
+    std::vector<double> scenarioFrameSeconds_;    // Barrido: intervalos entre frames del escenario medido (reservado una vez)
+    uint64_t unrecordedFrames_ = 0;               // Frames tras llenarse frameRenderTimesSeconds_ (MAX_RECORDED_FRAMES)
     std::chrono::time_point<std::chrono::system_clock> runStartTime_;
     std::string gpuName_ = "Unknown";
     bool metricsSaved_ = false;
+    particulas::StartupTimer startupTimer_; // Desglose del arranque (frío vs caliente)
 
     // --- Inicialización ---
     void initWindow() {
-        std::cout << "Initializing Window..." << std::endl;
-        window_ = std::make_unique<particulas::Window>(WINDOW_WIDTH, WINDOW_HEIGHT, "Simulación de Partículas Vulkan");
+        PARTICULAS_LOG(Info) << "Initializing Window...";
+        window_ = std::make_unique<particulas::Window>(static_cast<int>(scenario_.windowWidth), static_cast<int>(scenario_.windowHeight),
+                                                       "Simulación de Partículas Vulkan");
         // TODO: Añadir callback GLFW para detectar redimensionamiento
-        std::cout << "Window Initialized." << std::endl;
+        PARTICULAS_LOG(Info) << "Window Initialized.";
     }
 
     void initVulkan() {
-        std::cout << "Initializing Vulkan..." << std::endl;
-        createInstance();
-        setupDebugMessenger();
-        createSurface();
-        createDevice();
-        createSwapchain();
-        createRenderPass();
-        createGraphicsPipeline();
-        createDepthResources();
-        createFramebuffers();
-        createCommandPool();
-        createCommandBuffers();
-        createSyncObjects();
-        std::cout << "Vulkan Initialized." << std::endl;
+        PARTICULAS_LOG(Info) << "Initializing Vulkan...";
+        startupTimer_.measure("createInstance", [this] { createInstance(); });
+        startupTimer_.measure("setupDebugMessenger", [this] { setupDebugMessenger(); });
+        startupTimer_.measure("createSurface", [this] { createSurface(); });
+        startupTimer_.measure("createDevice", [this] { createDevice(); });
+        startupTimer_.measure("createPipelineCache", [this] { createPipelineCache(); });
+        startupTimer_.measure("createSwapchain", [this] { createSwapchain(); });
+        startupTimer_.measure("createRenderPass", [this] { createRenderPass(); });
+        startupTimer_.measure("createSpeciesBuffer", [this] { createSpeciesBuffer(); });
+        startupTimer_.measure("createGraphicsPipeline", [this] { createGraphicsPipeline(); });
+        startupTimer_.measure("createDepthResources", [this] { createDepthResources(); });
+        startupTimer_.measure("createFramebuffers", [this] { createFramebuffers(); });
+        printAttachmentBandwidthReport();
+        startupTimer_.measure("createCommandPool", [this] { createCommandPool(); });
+        startupTimer_.measure("createThreadPool", [this] { threadPool_ = std::make_unique<particulas::ThreadPool>(); });
+        if (ENABLE_PERF_COUNTERS) startupTimer_.measure("createPerfCounters", [this] { createPerfCounters(); });
+        startupTimer_.measure("createFrameCommandPools", [this] { createFrameCommandPools(); });
+        startupTimer_.measure("createSyncObjects", [this] { createSyncObjects(); });
+        PARTICULAS_LOG(Info) << "Vulkan Initialized.";
     }
 
     void initSimulation() {
-        std::cout << "Initializing Simulation..." << std::endl;
+        PARTICULAS_LOG(Info) << "Initializing Simulation...";
         if (!swapchain_) throw std::runtime_error("Swapchain not initialized before simulation init.");
         VkExtent2D extent = swapchain_->getExtent();
-        particleSystem_ = std::make_unique<particulas::ParticleSystem>(
-            PARTICLE_COUNT, static_cast<float>(extent.width), static_cast<float>(extent.height) );
+        if (ENSEMBLE_MEMBERS > 0 && !scenario_.simulateOnGpu) {
+            createEnsemble();
+        } else {
+            if (ENSEMBLE_MEMBERS > 0) { PARTICULAS_LOG(Warning) << "Ensemble mode needs CPU simulation; running a single simulation."; }
+            createParticleSystem();
+        }
+
+        glm::vec2 domainSize(particleSystem_->getWidth(), particleSystem_->getHeight());
+        camera_ = std::make_unique<particulas::Camera2D>(domainSize);
+        camera_->setViewportSize(static_cast<float>(extent.width), static_cast<float>(extent.height));
+        if (ENABLE_VIEW_CULLING) {
+            cullGrid_ = std::make_unique<particulas::SpatialGrid>(domainSize, CULL_CELL_SIZE, particleSystem_->getCapacity());
+        }
+        if (ENABLE_VIEW_CULLING || scenario_.frameBudgetMs > 0.0) visibleParticles_.resize(particleSystem_->getCapacity()); // También para dibujar una fracción
 
-        if (!device_ || !commandPool_) throw std::runtime_error("Device or CommandPool not initialized before renderer init.");
+        if (!device_ || !commandPool_ || !speciesBuffer_) throw std::runtime_error("Device or CommandPool not initialized before renderer init.");
+        speciesBuffer_->upload(particleSystem_->getSpecies()); // Aún no hay frames en vuelo
         // Usar el tipo correcto aquí también
-        particleRenderer_ = std::make_unique<particulas::ParticleRenderer>(*device_, *commandPool_); // <-- Tipo Correcto
+        particleRenderer_ = std::make_unique<particulas::ParticleRenderer>(*device_, *commandPool_, speciesBuffer_->getDescriptorSet()); // <-- Tipo Correcto
         particleRenderer_->createBuffers(particleSystem_->getParticles()); // <-- Usar ->
-        std::cout << "Simulation Initialized." << std::endl;
+        if (scenario_.simulateOnGpu) {
+            // El estado inicial (partículas y emisores) se copia a la GPU; a partir de aquí la CPU no lo toca
+            startupTimer_.measure("GpuParticleSystem", [this] {
+                gpuParticles_ = std::make_unique<particulas::GpuParticleSystem>(*device_, *commandPool_, *particleSystem_, *speciesBuffer_, pipelineCache_->get());
+            });
+        }
+        startupTimer_.measure("SplatRenderer", [&] {
+            splatRenderer_ = std::make_unique<particulas::SplatRenderer>(*device_, *commandPool_, renderPass_->get(), extent,
+                static_cast<uint32_t>(particleSystem_->getCapacity()), domainSize, *speciesBuffer_, pipelineCache_->get());
+        });
+        if (ENABLE_PERFORMANCE_HUD) startupTimer_.measure("createPerformanceHud", [this] { createPerformanceHud(); });
+        if (ENABLE_FRAME_CAPTURE) startupTimer_.measure("createFrameCapture", [this] { createFrameCapture(); });
+        startupTimer_.measure("createRenderGraph", [this] { createRenderGraph(); });
+        renderMode_ = scenario_.splats ? RENDER_SPLATS : RENDER_POINTS;
+        simulationRateHz_ = scenario_.simulationRateHz;
+        simulationAccumulator_ = 0.0f;
+        createQualityController();
+        PARTICULAS_LOG(Info) << "Simulation Initialized.";
+    }
+
+    // Escena del escenario activo; en modo interactivo, la de las constantes de arriba
+    void createParticleSystem() {
+        const particulas::Scenario& scenario = scenario_;
+        const bool emitter = scenario.physics == particulas::PhysicsMode::Emitter;
+        size_t requestedCapacity = scenario.capacity;
+        if (requestedCapacity == 0) {
+            // Régimen estable del emisor (rate * lifetime) con un 10 % de margen
+            requestedCapacity = static_cast<size_t>(scenario.particleCount)
+                + (emitter ? static_cast<size_t>(std::ceil(scenario.emitterRate * scenario.emitterLifetime * 1.1f)) : 0);
+        }
+        size_t capacity = planParticleCapacity(requestedCapacity);
+        int count = static_cast<int>(std::min<size_t>(scenario.particleCount, capacity));
+        const size_t speciesCount = particulas::ParticleSystem::DEFAULT_SPECIES_COUNT;
+        if (scenario.physics == particulas::PhysicsMode::Cloth) {
+            // Tela cuadrada con a lo sumo count partículas: side*side no pasa de la capacidad planificada
+            // (el pool crecería por encima del presupuesto y los buffers de la GPU no coincidirían)
+            int side = static_cast<int>(std::floor(std::sqrt(static_cast<double>(count))));
+            if (side < 2) {
+                side = 2; // Malla mínima 2x2
+                if (capacity < 4) {
+                    capacity = planParticleCapacity(4);
+                    if (capacity < 4) throw std::runtime_error("The cloth scene needs 4 particles; the GPU memory budget allows fewer.");
+                    PARTICULAS_LOG(Warning) << "Cloth needs a 2x2 grid: particle capacity raised to " << capacity << ".";
+                }
+            }
+            if (static_cast<size_t>(side) * side != static_cast<size_t>(scenario.particleCount)) {
+                PARTICULAS_LOG(Info) << "Cloth grid " << side << "x" << side << " = " << side * side << " particles (requested "
+                                     << scenario.particleCount << ", capacity " << capacity << ").";
+            }
+            particulas::ConstraintScene scene = particulas::makeGridScene(side, side, DOMAIN_WIDTH, DOMAIN_HEIGHT);
+            auto solver = std::make_unique<particulas::ConstraintSolver>(threadPool_.get());
+            particulas::applyScene(scene, *solver);
+            particleSystem_ = std::make_unique<particulas::ParticleSystem>(std::move(scene.particles), DOMAIN_WIDTH, DOMAIN_HEIGHT, capacity,
+                                                                           std::move(scene.species));
+            particleSystem_->setConstraintSolver(std::move(solver));
+        } else if (scenario.distribution == particulas::ParticleDistribution::Uniform) {
+            particleSystem_ = std::make_unique<particulas::ParticleSystem>(count, DOMAIN_WIDTH, DOMAIN_HEIGHT, capacity, speciesCount, scenario.seed);
+        } else {
+            particleSystem_ = std::make_unique<particulas::ParticleSystem>(
+                particulas::makeDistributedParticles(scenario.distribution, static_cast<size_t>(count), DOMAIN_WIDTH, DOMAIN_HEIGHT,
+                                                     speciesCount, scenario.seed),
+                DOMAIN_WIDTH, DOMAIN_HEIGHT, capacity, particulas::makeDefaultSpecies(speciesCount));
+            particleSystem_->setRandomSeed(scenario.seed);
+        }
+        if (scenario.physics == particulas::PhysicsMode::Gravity || scenario.physics == particulas::PhysicsMode::Cloth) {
+            particleSystem_->setGravity({0.0f, scenario.gravity});
+        }
+        if (emitter) {
+            // Especie propia para las chispas del emisor: pequeñas y frenadas por el rozamiento
+            particulas::Species spark;
+            spark.color = {1.0f, 0.6f, 0.2f, 1.0f};
+            spark.radius = 1.5f;
+            spark.drag = 0.5f;
+            particulas::Emitter emitter;
+            emitter.species = particleSystem_->addSpecies(spark);
+            emitter.position = {DOMAIN_WIDTH * 0.5f, DOMAIN_HEIGHT * 0.5f};
+            emitter.spreadRadians = 6.2831853f; // Emisión radial
+            emitter.rate = scenario.emitterRate;
+            emitter.particleLifetime = scenario.emitterLifetime;
+            particleSystem_->addEmitter(emitter);
+        }
+        if (ENABLE_MORTON_REORDER) particleSystem_->enableMortonReorder(threadPool_.get());
+    }
+
+    // El modo interactivo como un escenario más: lo que antes leía initSimulation de las constantes
+    static particulas::Scenario makeInteractiveScenario() {
+        particulas::Scenario scenario;
+        scenario.name = "interactive";
+        scenario.particleCount = PARTICLE_COUNT;
+        scenario.capacity = PARTICLE_CAPACITY;
+        scenario.physics = ENABLE_DEMO_EMITTER ? particulas::PhysicsMode::Emitter : particulas::PhysicsMode::Free;
+        scenario.emitterRate = 2000.0f;
+        scenario.emitterLifetime = 3.0f;
+        scenario.seed = particulas::ParticleSystem::RANDOM_SEED;
+        scenario.simulateOnGpu = SIMULATE_ON_GPU;
+        scenario.splats = START_WITH_SPLAT_RENDERER;
+        scenario.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+        scenario.windowWidth = WINDOW_WIDTH;
+        scenario.windowHeight = WINDOW_HEIGHT;
+        scenario.hud = START_WITH_HUD_VISIBLE;
+        scenario.frameBudgetMs = ENABLE_QUALITY_CONTROLLER ? QUALITY_FRAME_BUDGET_MS : 0.0;
+        return scenario;
+    }
+
+    // Modo conjunto: los miembros se simulan en paralelo sobre threadPool_ y cada paso se copian,
+    // desplazados a su mosaico, a un único ParticleSystem que nunca se actualiza por sí mismo. Así
+    // culling, subida, dibujo, HUD y snapshots ven una sola escena: una subida y un draw por frame.
+    void createEnsemble() {
+        ensemble_ = std::make_unique<particulas::Ensemble>(DOMAIN_WIDTH, DOMAIN_HEIGHT,
+            particulas::Ensemble::makeGravitySweep(ENSEMBLE_MEMBERS, ENSEMBLE_MEMBER_PARTICLES, ENSEMBLE_MAX_GRAVITY, ENSEMBLE_EMITTER_RATE),
+            particulas::ParticleSystem::DEFAULT_SPECIES_COUNT, threadPool_.get());
+        size_t capacity = ensemble_->getTotalCapacity();
+        if (planParticleCapacity(capacity) < capacity) {
+            throw std::runtime_error("Ensemble of " + std::to_string(ENSEMBLE_MEMBERS) + " members does not fit the GPU memory budget.");
+        }
+        glm::vec2 tiledSize = ensemble_->getTiledSize();
+        particleSystem_ = std::make_unique<particulas::ParticleSystem>(std::vector<particulas::Particle>(1), tiledSize.x, tiledSize.y,
+                                                                       capacity, ensemble_->getSpecies());
+        ensemble_->packTiled(*particleSystem_);
+        PARTICULAS_LOG(Info) << "Ensemble: " << ensemble_->getMemberCount() << " members in a " << ensemble_->getColumns() << "x"
+                             << ensemble_->getRows() << " grid, " << capacity << " particle slots.";
+    }
+
+    // Guarda el pipeline cache ya poblado e imprime el desglose del arranque
+    void finishStartup() {
+        if (pipelineCache_) pipelineCache_->save();
+        startupTimer_.addNote(std::string("pipeline cache: ") + (pipelineCache_ && pipelineCache_->wasLoadedFromDisk()
+            ? "warm (" + std::to_string(pipelineCache_->getLoadedBytes()) + " bytes loaded)" : "cold"));
+        startupTimer_.addNote("embedded SPIR-V modules: " + std::to_string(particulas::getEmbeddedShaderCount()));
+        particulas::Logger::flush();
+        startupTimer_.print();
     }
 
     // --- Bucle Principal ---
     void mainLoop() {
-        std::cout << "Starting Main Loop..." << std::endl;
+        PARTICULAS_LOG(Info) << "Starting Main Loop...";
+        FrameClock clock = startFrameLoop();
+        while (window_ && !window_->shouldClose()) runFrame(clock);
+        PARTICULAS_LOG(Info) << "Exiting Main Loop.";
+        if(device_) { vkDeviceWaitIdle(device_->getLogicalDevice()); PARTICULAS_LOG(Info) << "GPU Idle."; }
+    }
+
+    struct FrameClock {
+        std::chrono::high_resolution_clock::time_point lastFrameEndTime;   // Tiempo al final del frame anterior
+        std::chrono::high_resolution_clock::time_point lastFrameStartTime; // Intervalo entre frames para el HUD
+    };
+
+    static FrameClock makeFrameClock() {
+        auto now = std::chrono::high_resolution_clock::now();
+        return {now, now};
+    }
+
+    FrameClock startFrameLoop() {
         runStartTime_ = std::chrono::system_clock::now(); // <-- Guardar hora inicio para archivo/metadata
-        auto lastFrameEndTime = std::chrono::high_resolution_clock::now(); // Tiempo al final del frame anterior
-        frameRenderTimesSeconds_.reserve(3600);// <-- Reservar espacio
+        FrameClock clock = makeFrameClock();
+        frameRenderTimesSeconds_.reserve(MAX_RECORDED_FRAMES); // Todo de una vez: el bucle no debe reservar
+        lastRateSampleTime_ = clock.lastFrameEndTime;
+        startAllocationTracking();
+        return clock;
+    }
 
-        while (window_ && !window_->shouldClose()) {
-            window_->pollEvents();
+    void runFrame(FrameClock& clock) {
+        auto& lastFrameEndTime = clock.lastFrameEndTime;
+        auto& lastFrameStartTime = clock.lastFrameStartTime;
+        window_->pollEvents();
+        handleHudToggle();
+        handleRenderModeToggle();
+        handlePipelineVariantKeys();
+
+        // Calcular deltaTime para la simulación basado en el tiempo *entre* frames
+        auto currentFrameStartTime = std::chrono::high_resolution_clock::now();
+        float deltaTime = std::chrono::duration<float>(currentFrameStartTime - lastFrameEndTime).count();
+        deltaTime = std::min(deltaTime, 0.1f); // Clamp
+        double frameIntervalSeconds = std::chrono::duration<double>(currentFrameStartTime - lastFrameStartTime).count();
+        if (hud_) hud_->addFrameTime(frameIntervalSeconds * 1000.0);
+        liveMetrics_.frameTimeSeconds.observe(frameIntervalSeconds);
+        lastFrameStartTime = currentFrameStartTime;
+        updateQualityController(frameIntervalSeconds);
+        handleCameraInput(deltaTime);
+
+        // Actualizar simulación ANTES de medir el renderizado
+        auto simulationStartTime = std::chrono::steady_clock::now();
+        particulas::AllocationTracker::setPhase(CPU_SIMULATE);
+        perfFrame_ = PerfFrameSample{};
+        beginPerfPhase();
+        advanceSimulation(deltaTime);
+        publishSnapshot();
+        endPerfPhase(PERF_SIMULATE);
+        cpuPhaseMilliseconds_[CPU_SIMULATE] = millisecondsSince(simulationStartTime);
+        particulas::AllocationTracker::setPhase(ALLOC_HUD);
+        sampleGpuMemoryBudget();
+        updateHud(); // Construye el overlay y aplica sus controles antes de grabar el frame
+
+        // --- Medir y Registrar el Tiempo de drawFrame ---
+        auto renderStartTime = std::chrono::high_resolution_clock::now();
+        drawFrame(); // Ejecutar renderizado
+        auto renderEndTime = std::chrono::high_resolution_clock::now();
+        particulas::AllocationTracker::setPhase(ALLOC_OTHER);
+        double renderDurationSeconds = std::chrono::duration<double>(renderEndTime - renderStartTime).count();
+        if (renderDurationSeconds > 1e-9) { // Evitar valores cero o negativos
+            if (frameRenderTimesSeconds_.size() < MAX_RECORDED_FRAMES) frameRenderTimesSeconds_.push_back(renderDurationSeconds); // Guardar en segundos
+            else ++unrecordedFrames_;
+        }
+        publishLiveMetrics(renderEndTime);
+        if (perfCounters_ && perfFrames_.size() < MAX_RECORDED_PERF_FRAMES) {
+            perfFrame_.particles = particleSystem_ ? particleSystem_->getParticleCount() : 0;
+            perfFrames_.push_back(perfFrame_);
+        }
+        checkFrameAllocations();
+        // ----------------------------------------------------
 
-            // Calcular deltaTime para la simulación basado en el tiempo *entre* frames
-            auto currentFrameStartTime = std::chrono::high_resolution_clock::now();
-            float deltaTime = std::chrono::duration<float>(currentFrameStartTime - lastFrameEndTime).count();
-            deltaTime = std::min(deltaTime, 0.1f); // Clamp
+        lastFrameEndTime = renderEndTime; // Actualizar tiempo final para el siguiente deltaTime
+    }
 
-            // Actualizar simulación ANTES de medir el renderizado
-            if (particleSystem_ && deltaTime > 0.0f) {
-                 particleSystem_->update(deltaTime);
-            }
+    // --- Barrido de escenarios ---
+    // Todos sobre la misma ventana, instancia, dispositivo, pipelines y pool de hilos: entre uno y
+    // otro solo se recrea la simulación (y el swapchain si cambia el tamaño o el present mode).
+    // Cada escenario se calienta warmup segundos y luego se mide duration segundos; al final se
+    // escribe la tabla consolidada y las curvas de escalado junto a las métricas.
+    void runSweep(const std::vector<particulas::Scenario>& scenarios) {
+        PARTICULAS_LOG(Info) << "Running " << scenarios.size() << " benchmark scenarios...";
+        startFrameLoop();
+        scenarioFrameSeconds_.reserve(MAX_RECORDED_FRAMES);
+        std::vector<particulas::ScenarioResult> results;
+        results.reserve(scenarios.size());
+        for (size_t i = 0; i < scenarios.size() && !window_->shouldClose(); ++i) {
+            if (i > 0) applyScenario(scenarios[i]);
+            PARTICULAS_LOG(Info) << "[Sweep] " << (i + 1) << "/" << scenarios.size() << ": " << scenario_.getLabel();
+            results.push_back(runScenario());
+            const particulas::ScenarioResult& result = results.back();
+            PARTICULAS_LOG(Info) << "[Sweep] " << scenario_.getLabel() << ": " << result.frames << " frames, "
+                                 << result.getFps() << " fps, p99 " << result.p99FrameMs << " ms";
+        }
+        if(device_) vkDeviceWaitIdle(device_->getLogicalDevice());
+        saveSweepResults(results);
+    }
 
-            // --- Medir y Registrar el Tiempo de drawFrame ---
-            auto renderStartTime = std::chrono::high_resolution_clock::now();
-            drawFrame(); // Ejecutar renderizado
-            auto renderEndTime = std::chrono::high_resolution_clock::now();
-            double renderDurationSeconds = std::chrono::duration<double>(renderEndTime - renderStartTime).count();
-            if (renderDurationSeconds > 1e-9) { // Evitar valores cero o negativos
-                frameRenderTimesSeconds_.push_back(renderDurationSeconds); // Guardar en segundos
+    particulas::ScenarioResult runScenario() {
+        size_t maxWorkers = threadPool_->getConcurrency() - 1;
+        size_t workers = scenario_.threads > 0 ? std::min(static_cast<size_t>(scenario_.threads - 1), maxWorkers) : maxWorkers;
+        threadPool_->setActiveWorkerCount(workers);
+
+        particulas::ScenarioResult result;
+        result.scenario = scenario_;
+        result.width = swapchain_->getExtent().width;
+        result.height = swapchain_->getExtent().height;
+        result.presentMode = particulas::presentModeName(swapchain_->getPresentMode());
+        result.threads = static_cast<int>(workers + 1);
+
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start = Clock::now();
+        const Clock::time_point measureStart = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(scenario_.warmupSeconds));
+        const Clock::time_point end = measureStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(scenario_.durationSeconds));
+        scenarioFrameSeconds_.clear();
+        double simulateMilliseconds = 0.0, particleUpdates = 0.0, liveParticles = 0.0, drawnParticles = 0.0;
+        bool measuring = false;
+        uint64_t decisionsAtMeasureStart = 0;
+        Clock::time_point lastFrameEnd = start;
+        FrameClock clock = makeFrameClock();
+        while (!window_->shouldClose()) {
+            Clock::time_point frameStart = Clock::now();
+            if (frameStart >= end) break;
+            if (!measuring && frameStart >= measureStart) {
+                measuring = true;
+                lastFrameEnd = frameStart;
+                decisionsAtMeasureStart = qualityController_ ? qualityController_->getDecisionCount() : 0;
             }
-            // ----------------------------------------------------
+            uint64_t stepsBefore = liveMetrics_.simulationSteps.load(std::memory_order_relaxed);
+            runFrame(clock);
+            if (!measuring) continue;
+            Clock::time_point frameEnd = Clock::now();
+            if (scenarioFrameSeconds_.size() < MAX_RECORDED_FRAMES) scenarioFrameSeconds_.push_back(std::chrono::duration<double>(frameEnd - lastFrameEnd).count());
+            lastFrameEnd = frameEnd;
+            double live = static_cast<double>(particleSystem_->getLiveParticleCount());
+            uint64_t steps = liveMetrics_.simulationSteps.load(std::memory_order_relaxed) - stepsBefore;
+            particleUpdates += live * static_cast<double>(steps);
+            liveParticles += live;
+            drawnParticles += drawnParticles_;
+            simulateMilliseconds += cpuPhaseMilliseconds_[CPU_SIMULATE];
+        }
+        if (measuring) result.seconds = std::chrono::duration<double>(lastFrameEnd - measureStart).count();
+        particulas::summarizeFrameTimes(scenarioFrameSeconds_, result);
+        if (result.frames > 0) {
+            double frames = static_cast<double>(result.frames);
+            result.meanSimulateMs = simulateMilliseconds / frames;
+            result.meanLiveParticles = liveParticles / frames;
+            result.meanDrawnParticles = drawnParticles / frames;
+        }
+        if (result.seconds > 0.0) result.particleUpdatesPerSecond = particleUpdates / result.seconds;
+        if (qualityController_) {
+            const particulas::QualityLevels& levels = qualityController_->getLevels();
+            result.qualityDecisions = qualityController_->getDecisionCount() - decisionsAtMeasureStart;
+            result.finalSubsteps = levels.substeps;
+            result.finalRenderScale = levels.renderScale;
+            result.finalDrawFraction = levels.drawFraction;
+        }
+        return result;
+    }
+
+    // Cambia al siguiente escenario: con la GPU parada, destruye la simulación, ajusta ventana y
+    // present mode si hace falta y la vuelve a crear
+    void applyScenario(const particulas::Scenario& scenario) {
+        vkDeviceWaitIdle(device_->getLogicalDevice());
+        destroySimulation();
+        bool resize = scenario.windowWidth != scenario_.windowWidth || scenario.windowHeight != scenario_.windowHeight;
+        bool presentModeChanged = scenario.presentMode != scenario_.presentMode;
+        scenario_ = scenario;
+        if (resize && !window_->setSize(static_cast<int>(scenario.windowWidth), static_cast<int>(scenario.windowHeight))) {
+            PARTICULAS_LOG(Warning) << "[Sweep] Window could not be resized to " << scenario.windowWidth << "x" << scenario.windowHeight
+                                    << "; using " << window_->getWidth() << "x" << window_->getHeight() << ".";
+        }
+        if (resize || presentModeChanged) rebuildSwapchain(scenario.presentMode);
+        initSimulation();
+        restartAllocationWarmup();
+    }
+
+    // Lo que crea initSimulation, en orden inverso. Solo con la GPU parada.
+    void destroySimulation() {
+        renderGraph_.reset();
+        simulatePass_ = splatPass_ = scenePass_ = capturePass_ = overlayPass_ = NO_PASS;
+        frameCapture_.reset();
+        hud_.reset();
+        splatRenderer_.reset();
+        gpuParticles_.reset();
+        particleRenderer_.reset();
+        cullGrid_.reset();
+        camera_.reset();
+        particleSystem_.reset();
+        ensemble_.reset();
+        qualityController_.reset();
+        drawnParticles_ = 0;
+    }
 
-            lastFrameEndTime = renderEndTime; // Actualizar tiempo final para el siguiente deltaTime
+    void saveSweepResults(const std::vector<particulas::ScenarioResult>& results) {
+        if (results.empty()) return;
+        particulas::Logger::flush();
+        particulas::printSweepSummary(std::cout, results);
+        try {
+            std::filesystem::path dirPath = "metrics_output";
+            std::filesystem::create_directories(dirPath);
+            std::string stem = std::filesystem::path(generateFilename()).stem().string();
+            std::filesystem::path resultsPath = dirPath / (stem + "_sweep.csv");
+            std::filesystem::path curvesPath = dirPath / (stem + "_scaling.csv");
+            std::ofstream resultsFile(resultsPath);
+            std::ofstream curvesFile(curvesPath);
+            if (!resultsFile.is_open() || !curvesFile.is_open()) {
+                PARTICULAS_LOG(Warning) << "[Sweep] Error opening " << resultsPath.string() << " or " << curvesPath.string();
+                return;
+            }
+            particulas::writeSweepResults(resultsFile, results);
+            particulas::writeScalingCurves(curvesFile, results);
+            PARTICULAS_LOG(Info) << "[Sweep] Results saved to " << resultsPath.string() << " and " << curvesPath.string();
+        } catch (const std::exception& e) {
+            PARTICULAS_LOG(Warning) << "[Sweep] Could not save results: " << e.what();
         }
-        std::cout << "Exiting Main Loop." << std::endl;
-        if(device_) { vkDeviceWaitIdle(device_->getLogicalDevice()); std::cout << "GPU Idle." << std::endl; }
     }
 
     // --- Limpieza ---
     void cleanup() {
-         std::cout << "Starting Cleanup..." << std::endl;
+         PARTICULAS_LOG(Info) << "Starting Cleanup...";
          if(device_) { vkDeviceWaitIdle(device_->getLogicalDevice()); }
 
            // --- Guardar métricas ANTES de destruir todo ---
         saveMetricsToFile(); //
+        printAllocationReport();
 
         cleanupSwapchainRelated();
 
         // Usar el tipo correcto particleRenderer_
-        if (particleRenderer_) { std::cout << "Cleaning up Particle Renderer..." << std::endl; particleRenderer_.reset(); } // <-- Usar .reset()
-        if (particleSystem_) { std::cout << "Cleaning up Particle System..." << std::endl; particleSystem_.reset(); }
-        if (sync_) { std::cout << "Cleaning up Sync Objects..." << std::endl; sync_.reset(); }
-
-        if (commandPool_ && device_ && !commandBuffers_.empty()) {
-            std::cout << "Freeing Command Buffers..." << std::endl;
-            vkFreeCommandBuffers(device_->getLogicalDevice(), commandPool_->get(), static_cast<uint32_t>(commandBuffers_.size()), commandBuffers_.data());
-            commandBuffers_.clear();
-        }
-        if (commandPool_) { std::cout << "Cleaning up Command Pool..." << std::endl; commandPool_.reset(); } // <-- Usar .reset()
-
-        if (pipeline_) { std::cout << "Cleaning up Pipeline..." << std::endl; pipeline_.reset(); } // Añadir limpieza pipeline explícita
-        if (renderPass_) { std::cout << "Cleaning up Render Pass..." << std::endl; renderPass_.reset(); }
-
-        if(device_) { std::cout << "Cleaning up Logical Device..." << std::endl; device_.reset(); }
+        printRenderModeStats();
+        if (renderGraph_) { particulas::Logger::flush(); renderGraph_->printReport(std::cout); renderGraph_.reset(); } // Tiempos medios por pase
+        if (hud_) { PARTICULAS_LOG(Info) << "Cleaning up Performance HUD..."; hud_.reset(); } // Antes que la ventana (restaura sus callbacks)
+        if (splatRenderer_) { PARTICULAS_LOG(Info) << "Cleaning up Splat Renderer..."; splatRenderer_.reset(); }
+        if (gpuParticles_) { PARTICULAS_LOG(Info) << "Cleaning up GPU Particle System..."; gpuParticles_.reset(); }
+        if (particleRenderer_) { PARTICULAS_LOG(Info) << "Cleaning up Particle Renderer..."; particleRenderer_.reset(); } // <-- Usar .reset()
+        if (particleSystem_) { PARTICULAS_LOG(Info) << "Cleaning up Particle System..."; particleSystem_.reset(); }
+        ensemble_.reset();
+        metricsServer_.reset(); // Deja de leer liveMetrics_ antes de que se destruya nada más
+        frameCapture_.reset(); // GPU parada: recoge las copias pendientes y espera a que el escritor las guarde
+        snapshotWriter_.reset(); // Marca el segmento como cerrado para los lectores y lo desvincula
+        perfCounters_.reset(); // Sus descriptores son de los hilos del pool
+        if (threadPool_) { PARTICULAS_LOG(Info) << "Cleaning up Thread Pool..."; threadPool_.reset(); }
+        if (sync_) { PARTICULAS_LOG(Info) << "Cleaning up Sync Objects..."; sync_.reset(); }
+
+        if (frameCommandPools_) { PARTICULAS_LOG(Info) << "Cleaning up Frame Command Pools..."; frameCommandPools_.reset(); } // Libera también sus command buffers
+        if (commandPool_) { PARTICULAS_LOG(Info) << "Cleaning up Command Pool..."; commandPool_.reset(); } // <-- Usar .reset()
+
+        cullGrid_.reset();
+        camera_.reset();
+
+        if (pipelineVariants_) { PARTICULAS_LOG(Info) << "Cleaning up Pipeline Variants..."; pipelineVariants_.reset(); } // Añadir limpieza pipeline explícita
+        if (speciesBuffer_) { PARTICULAS_LOG(Info) << "Cleaning up Species Buffer..."; speciesBuffer_.reset(); }
+        if (renderPass_) { PARTICULAS_LOG(Info) << "Cleaning up Render Pass..."; renderPass_.reset(); }
+        if (pipelineCache_) { PARTICULAS_LOG(Info) << "Saving and cleaning up Pipeline Cache..."; pipelineCache_.reset(); }
+
+        if(device_) { PARTICULAS_LOG(Info) << "Cleaning up Logical Device..."; device_.reset(); }
 
         if (instance_) {
             if (debugMessenger_ != VK_NULL_HANDLE) {
-                 std::cout << "Cleaning up Debug Messenger..." << std::endl;
+                 PARTICULAS_LOG(Info) << "Cleaning up Debug Messenger...";
                  particulas::debug::destroyDebugMessenger(instance_->get(), debugMessenger_, nullptr);
                  debugMessenger_ = VK_NULL_HANDLE;
             }
             if (surface_ != VK_NULL_HANDLE) {
-                 std::cout << "Cleaning up Surface..." << std::endl;
+                 PARTICULAS_LOG(Info) << "Cleaning up Surface...";
                 vkDestroySurfaceKHR(instance_->get(), surface_, nullptr);
                  surface_ = VK_NULL_HANDLE;
             }
         }
 
-        if (instance_) { std::cout << "Cleaning up Vulkan Instance..." << std::endl; instance_.reset(); }
-        if (window_) { std::cout << "Cleaning up Window..." << std::endl; window_.reset(); }
+        if (instance_) { PARTICULAS_LOG(Info) << "Cleaning up Vulkan Instance..."; instance_.reset(); }
+        if (window_) { PARTICULAS_LOG(Info) << "Cleaning up Window..."; window_.reset(); }
         else { glfwTerminate(); }
-        std::cout << "Cleanup Finished." << std::endl;
+        PARTICULAS_LOG(Info) << "Cleanup Finished.";
 
             /* --- Guardar métricas si no se han guardado ---
             if (!metricsSaved_ && !frameTimesSeconds_.empty()) {
@@ -260,8 +776,8 @@ private:
         #ifndef NDEBUG
         if (!instance_) return;
         VkResult result = particulas::debug::setupDebugMessenger(instance_->get(), &debugMessenger_);
-        if (result != VK_SUCCESS) { std::cerr << "Warning: Failed to set up debug messenger! Code: " << result << std::endl; debugMessenger_ = VK_NULL_HANDLE; }
-        else { std::cout << "Debug messenger set up successfully." << std::endl; }
+        if (result != VK_SUCCESS) { PARTICULAS_LOG(Warning) << "Failed to set up debug messenger! Code: " << result; debugMessenger_ = VK_NULL_HANDLE; }
+        else { PARTICULAS_LOG(Info) << "Debug messenger set up successfully."; }
         #endif
     }
 
@@ -276,9 +792,19 @@ private:
         device_ = std::make_unique<particulas::Device>(instance_->get(), surface_);
     }
 
+    void createPipelineCache() {
+        if (!device_) throw std::runtime_error("Device not initialized before creating pipeline cache.");
+        pipelineCache_ = std::make_unique<particulas::PipelineCache>(*device_);
+    }
+
+    // La captura copia desde las imágenes del swapchain
+    static VkImageUsageFlags getSwapchainExtraUsage() {
+        return ENABLE_FRAME_CAPTURE ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0;
+    }
+
     void createSwapchain() {
         if (!device_ || surface_ == VK_NULL_HANDLE || !window_) throw std::runtime_error("Cannot create swapchain: dependencies missing.");
-        swapchain_ = std::make_unique<particulas::Swapchain>(*device_, surface_, *window_);
+        swapchain_ = std::make_unique<particulas::Swapchain>(*device_, surface_, *window_, scenario_.presentMode, getSwapchainExtraUsage());
     }
 
     // findSupportedFormat y findDepthFormat
@@ -299,12 +825,20 @@ private:
     void createRenderPass() {
         if (!device_ || !swapchain_) throw std::runtime_error("Cannot create render pass: dependencies missing.");
         VkFormat depthFormat = findDepthFormat();
-        renderPass_ = std::make_unique<particulas::RenderPass>(device_->getLogicalDevice(), swapchain_->getImageFormat(), depthFormat);
+        renderPass_ = std::make_unique<particulas::RenderPass>(device_->getLogicalDevice(), swapchain_->getImageFormat(), depthFormat, DEPTH_MODE);
+    }
+
+    void createSpeciesBuffer() {
+        if (!device_) throw std::runtime_error("Device not initialized before creating species buffer.");
+        speciesBuffer_ = std::make_unique<particulas::SpeciesBuffer>(*device_);
     }
 
     void createGraphicsPipeline() {
-         if (!device_ || !renderPass_) throw std::runtime_error("Cannot create pipeline: dependencies missing.");
-        pipeline_ = std::make_unique<particulas::Pipeline>(device_->getLogicalDevice(), renderPass_->get());
+         if (!device_ || !renderPass_ || !speciesBuffer_) throw std::runtime_error("Cannot create pipeline: dependencies missing.");
+        // La transformación mundo -> NDC llega por push constants (Camera2D), no forma parte de la variante
+        particulas::PipelineVariantKey variant;
+        pipelineVariants_ = std::make_unique<particulas::PipelineVariantManager>(device_->getLogicalDevice(), renderPass_->get(),
+            speciesBuffer_->getDescriptorSetLayout(), pipelineCache_ ? pipelineCache_->get() : VK_NULL_HANDLE, variant);
     }
 
     // createImage, createImageView
@@ -330,23 +864,81 @@ private:
      }
 
     void createDepthResources() {
-        if (!device_ || !swapchain_) throw std::runtime_error("Cannot create depth resources: dependencies missing.");
+        if (!device_ || !swapchain_ || !renderPass_) throw std::runtime_error("Cannot create depth resources: dependencies missing.");
+        if (!renderPass_->hasDepth()) return; // DepthMode::None: sin imagen de profundidad
         VkFormat depthFormat = findDepthFormat();
         VkExtent2D swapChainExtent = swapchain_->getExtent();
-        createImage(swapChainExtent.width, swapChainExtent.height, depthFormat, VK_IMAGE_TILING_OPTIMAL,
-                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                    depthImage_, depthImageMemory_);
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        depthLazilyAllocated_ = false;
+        if (renderPass_->getDepthMode() == particulas::DepthMode::Transient) {
+            usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+            // En GPUs por teselas la memoria LAZILY_ALLOCATED no llega a comprometerse; si no existe, memoria normal
+            VkPhysicalDeviceMemoryProperties memProperties; vkGetPhysicalDeviceMemoryProperties(device_->getPhysicalDevice(), &memProperties);
+            for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i) {
+                if (memProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) { depthLazilyAllocated_ = true; break; }
+            }
+            if (depthLazilyAllocated_) properties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+        }
+        try {
+            createImage(swapChainExtent.width, swapChainExtent.height, depthFormat, VK_IMAGE_TILING_OPTIMAL,
+                        usage, properties, depthImage_, depthImageMemory_);
+        } catch (const std::exception&) {
+            if (!depthLazilyAllocated_) throw;
+            // El tipo lazily no es compatible con esta imagen: reintentar en memoria del dispositivo
+            if (depthImage_ != VK_NULL_HANDLE) { vkDestroyImage(device_->getLogicalDevice(), depthImage_, nullptr); depthImage_ = VK_NULL_HANDLE; }
+            depthLazilyAllocated_ = false;
+            createImage(swapChainExtent.width, swapChainExtent.height, depthFormat, VK_IMAGE_TILING_OPTIMAL,
+                        usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage_, depthImageMemory_);
+        }
         depthImageView_ = createImageView(depthImage_, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
     }
 
+    // Memoria y tráfico externo estimados de los attachments a varias resoluciones, comparados con la
+    // configuración anterior (D32 en memoria del dispositivo en todos los casos). Modelo: el color se
+    // escribe una vez por frame; la profundidad en memoria externa se lee y escribe una vez por píxel
+    // en el depth test salvo que sea transitoria en una GPU por teselas, y STORE añade una escritura.
+    void printAttachmentBandwidthReport() {
+        if (!device_ || !renderPass_ || !swapchain_) return;
+        const double bytesPerDepthTexel = 4.0; // D32_SFLOAT / D24_UNORM_S8_UINT
+        const double MB = 1024.0 * 1024.0;
+        particulas::DepthMode mode = renderPass_->getDepthMode();
+        bool onChip = mode == particulas::DepthMode::Transient && depthLazilyAllocated_;
+        particulas::Logger::flush(); // La tabla va directa a la consola
+        std::cout << "--- Attachment memory/bandwidth (depth " << particulas::depthModeName(mode)
+                  << (onChip ? ", lazily allocated" : "") << ") ---\n";
+        std::cout << std::left << std::setw(11) << "resolution" << std::right << std::setw(10) << "color MB" << std::setw(10) << "depth MB"
+                  << std::setw(16) << "depth MB/frame" << std::setw(14) << "saved MB" << std::setw(18) << "saved GB/s@60Hz" << "\n";
+        const std::array<VkExtent2D, 5> resolutions = {{ {1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160}, swapchain_->getExtent() }};
+        for (size_t i = 0; i < resolutions.size(); ++i) {
+            double pixels = static_cast<double>(resolutions[i].width) * resolutions[i].height;
+            double depthBytes = pixels * bytesPerDepthTexel;
+            double depthMemory = (mode == particulas::DepthMode::None || onChip) ? 0.0 : depthBytes;
+            double depthTraffic = 0.0;
+            if (mode != particulas::DepthMode::None && !onChip) depthTraffic += 2.0 * depthBytes;
+            if (mode == particulas::DepthMode::Stored) depthTraffic += depthBytes;
+            double baselineTraffic = 2.0 * depthBytes;
+            std::string label = std::to_string(resolutions[i].width) + "x" + std::to_string(resolutions[i].height) + (i + 1 == resolutions.size() ? "*" : "");
+            std::cout << std::left << std::setw(11) << label << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << pixels * 4.0 / MB << std::setw(10) << depthMemory / MB << std::setw(16) << depthTraffic / MB
+                      << std::setw(14) << (depthBytes - depthMemory) / MB
+                      << std::setw(18) << std::setprecision(2) << (baselineTraffic - depthTraffic) * 60.0 / (1024.0 * MB) << "\n";
+        }
+        if (depthImageMemory_ != VK_NULL_HANDLE && depthLazilyAllocated_) {
+            VkDeviceSize committed = 0; vkGetDeviceMemoryCommitment(device_->getLogicalDevice(), depthImageMemory_, &committed);
+            std::cout << "  depth image committed memory: " << committed << " bytes\n";
+        }
+        std::cout << "  (* = current swapchain)" << std::defaultfloat << std::endl;
+    }
+
     void createFramebuffers() {
-         if (!device_ || !renderPass_ || !swapchain_ || depthImageView_ == VK_NULL_HANDLE) throw std::runtime_error("Cannot create framebuffers: dependencies missing.");
+         if (!device_ || !renderPass_ || !swapchain_ || (renderPass_->hasDepth() && depthImageView_ == VK_NULL_HANDLE)) throw std::runtime_error("Cannot create framebuffers: dependencies missing.");
         swapchainFramebuffers_.resize(swapchain_->getImageViews().size());
         VkExtent2D swapChainExtent = swapchain_->getExtent();
         for (size_t i = 0; i < swapchain_->getImageViews().size(); i++) {
             std::array<VkImageView, 2> attachments = { swapchain_->getImageViews()[i], depthImageView_ };
             VkFramebufferCreateInfo framebufferInfo{}; framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO; framebufferInfo.renderPass = renderPass_->get();
-            framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size()); framebufferInfo.pAttachments = attachments.data();
+            framebufferInfo.attachmentCount = renderPass_->getAttachmentCount(); framebufferInfo.pAttachments = attachments.data(); // Sin profundidad solo el color
             framebufferInfo.width = swapChainExtent.width; framebufferInfo.height = swapChainExtent.height; framebufferInfo.layers = 1;
             particulas::debug::checkVkResult( vkCreateFramebuffer(device_->getLogicalDevice(), &framebufferInfo, nullptr, &swapchainFramebuffers_[i]),
                 "Framebuffer creation for swapchain image " + std::to_string(i) );
@@ -358,90 +950,901 @@ private:
         commandPool_ = std::make_unique<particulas::CommandPool>(device_->getLogicalDevice(), device_->getGraphicsQueueFamilyIndex());
     }
 
-    void createCommandBuffers() {
-         if (!device_ || !commandPool_) throw std::runtime_error("Cannot create command buffers: dependencies missing.");
-        commandBuffers_.resize(particulas::MAX_FRAMES_IN_FLIGHT); // Usar constante del namespace
-        VkCommandBufferAllocateInfo allocInfo{}; allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.commandPool = commandPool_->get(); allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandBufferCount = (uint32_t) commandBuffers_.size();
-        VkResult allocResult = vkAllocateCommandBuffers(device_->getLogicalDevice(), &allocInfo, commandBuffers_.data());
-        particulas::debug::checkVkResult(allocResult, "Command buffer allocation");
+    // Frame: simulación en GPU (o subida desde la CPU) -> splatting -> escena (render pass). El grafo deriva las barreras
+    // entre pases a partir de lo que cada uno lee y escribe (la salida de la simulación hacia los
+    // vértices/indirecto, el acumulador hacia el tone-map) y los temporales de la simulación y del
+    // splatting, que nunca están vivos a la vez, comparten memoria.
+    void createRenderGraph() {
+        renderGraph_ = std::make_unique<particulas::RenderGraph>(*device_, particulas::MAX_FRAMES_IN_FLIGHT);
+        particulas::RenderGraph& graph = *renderGraph_;
+        const VkPipelineStageFlags compute = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        const VkAccessFlags readWrite = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        std::vector<particulas::ResourceAccess> sceneReads;
+        std::vector<particulas::ResourceAccess> splatReads;
+        particulas::GraphResource scanOffsets = 0, particleBins = 0, binnedIndices = 0;
+
+        if (gpuParticles_) {
+            particulas::GraphResource visible = graph.importBuffer("visible", gpuParticles_->getVisibleBuffer());
+            particulas::GraphResource visibleIndirect = graph.importBuffer("visibleIndirect", gpuParticles_->getVisibleIndirectBuffer());
+            scanOffsets = graph.createTransientBuffer("scanOffsets", gpuParticles_->getScratchBytes(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+            simulatePass_ = graph.addPass("simulate", particulas::QueueClass::Compute, {},
+                {{visible, compute, VK_ACCESS_SHADER_WRITE_BIT}, {visibleIndirect, compute, VK_ACCESS_SHADER_WRITE_BIT}, {scanOffsets, compute, readWrite}},
+                [this](VkCommandBuffer commandBuffer) { executeSecondary(commandBuffer, RECORD_SIMULATION); });
+            sceneReads.push_back({visible, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT});
+            sceneReads.push_back({visibleIndirect, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT});
+            splatReads.push_back({visible, compute, VK_ACCESS_SHADER_READ_BIT});
+            splatReads.push_back({visibleIndirect, compute, VK_ACCESS_SHADER_READ_BIT});
+        } else {
+            // Simulación en CPU: copia desde el staging persistente del frame al buffer de vértices
+            particulas::GraphResource particles = graph.importBuffer("particles", particleRenderer_->getVertexBuffer());
+            graph.addPass("upload", particulas::QueueClass::Transfer, {},
+                {{particles, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT}},
+                [this](VkCommandBuffer commandBuffer) { particleRenderer_->recordUpload(commandBuffer, sync_->getCurrentFrameIndex()); });
+            sceneReads.push_back({particles, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT});
+            splatReads.push_back({particles, compute, VK_ACCESS_SHADER_READ_BIT});
+        }
+        if (splatRenderer_) {
+            particulas::GraphResource accumulator = graph.importImage("splatAccum", splatRenderer_->getAccumulationImage(),
+                VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_GENERAL);
+            particleBins = graph.createTransientBuffer("particleBins", splatRenderer_->getParticleBinsBytes(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+            binnedIndices = graph.createTransientBuffer("binnedIndices", splatRenderer_->getBinnedIndicesBytes(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+            splatPass_ = graph.addPass("splat", particulas::QueueClass::Compute, splatReads,
+                {{accumulator, compute, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL},
+                 {particleBins, compute, readWrite}, {binnedIndices, compute, readWrite}},
+                [this](VkCommandBuffer commandBuffer) { executeSecondary(commandBuffer, RECORD_SPLAT); });
+            sceneReads.push_back({accumulator, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL});
+        }
+        scenePass_ = graph.addPass("scene", particulas::QueueClass::Graphics, sceneReads, {},
+            [this](VkCommandBuffer commandBuffer) { recordScenePass(commandBuffer); });
+        if (frameCapture_) {
+            // Antes del HUD, para que no salga en las capturas. Sus barreras las pone FrameCapture
+            // (la imagen del swapchain cambia cada frame y el grafo no la gestiona).
+            capturePass_ = graph.addPass("capture", particulas::QueueClass::Transfer, {}, {},
+                [this](VkCommandBuffer commandBuffer) {
+                    frameCapture_->recordCopy(commandBuffer, sync_->getCurrentFrameIndex(), swapchain_->getImages()[frameImageIndex_],
+                                              VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+                });
+        }
+        if (hud_) {
+            // Render pass propio tras la escena (lo ordena su dependencia de subpass). Oculto, el pase
+            // se desactiva: ni render pass ni timestamps.
+            overlayPass_ = graph.addPass("overlay", particulas::QueueClass::Graphics, {}, {},
+                [this](VkCommandBuffer commandBuffer) { hud_->record(commandBuffer, frameImageIndex_); });
+            graph.setPassEnabled(overlayPass_, hud_->isVisible());
+        }
+        graph.compile();
+
+        // Aún no hay frames en vuelo: los renderers pasan a usar la memoria compartida del grafo
+        if (gpuParticles_) gpuParticles_->useScratchBuffer(graph.getBuffer(scanOffsets));
+        if (splatRenderer_) splatRenderer_->useScratchBuffers(graph.getBuffer(particleBins), graph.getBuffer(binnedIndices));
+        particulas::Logger::flush();
+        graph.printReport(std::cout);
+    }
+
+    // firstFrame/capturedFrames: al recrearla tras un cambio de tamaño, la secuencia y el límite siguen
+    void createFrameCapture(uint64_t firstFrame = 0, uint64_t capturedFrames = 0) {
+        if (!device_ || !swapchain_) throw std::runtime_error("Cannot create frame capture: dependencies missing.");
+        particulas::FrameCaptureSettings settings;
+        settings.format = FRAME_CAPTURE_FORMAT;
+        settings.output = FRAME_CAPTURE_OUTPUT;
+        settings.pipeCommand = FRAME_CAPTURE_PIPE;
+        settings.interval = FRAME_CAPTURE_INTERVAL;
+        settings.maxFrames = FRAME_CAPTURE_MAX_FRAMES > 0 ? FRAME_CAPTURE_MAX_FRAMES - capturedFrames : 0;
+        settings.firstFrame = firstFrame;
+        frameCapture_ = std::make_unique<particulas::FrameCapture>(*device_, swapchain_->getImageFormat(), swapchain_->getExtent(),
+            particulas::MAX_FRAMES_IN_FLIGHT, settings);
+    }
+
+    void createPerformanceHud() {
+        if (!instance_ || !device_ || !swapchain_ || !window_ || !pipelineCache_) throw std::runtime_error("Cannot create performance HUD: dependencies missing.");
+        hud_ = std::make_unique<particulas::PerformanceHud>(instance_->get(), *device_, window_->getGLFWWindow(),
+            swapchain_->getImageFormat(), swapchain_->getMinImageCount(), pipelineCache_->get());
+        hud_->createFramebuffers(swapchain_->getImageViews(), swapchain_->getExtent(), swapchain_->getMinImageCount());
+        hud_->setVisible(scenario_.hud);
+    }
+
+    // Un pool por frame en vuelo y por hilo del ThreadPool (incluido el hilo principal)
+    void createFrameCommandPools() {
+        if (!device_ || !threadPool_) throw std::runtime_error("Cannot create frame command pools: dependencies missing.");
+        frameCommandPools_ = std::make_unique<particulas::FrameCommandPools>(device_->getLogicalDevice(), device_->getGraphicsQueueFamilyIndex(),
+            particulas::MAX_FRAMES_IN_FLIGHT, threadPool_->getConcurrency());
     }
 
     void createSyncObjects() {
         if (!device_) throw std::runtime_error("Device not initialized before creating sync objects.");
-         sync_ = std::make_unique<particulas::Sync>(device_->getLogicalDevice());
+         sync_ = std::make_unique<particulas::Sync>(*device_, USE_TIMELINE_SEMAPHORES);
     }
 
     // --- Funciones de Renderizado ---
-    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
-        if (!renderPass_ || imageIndex >= swapchainFramebuffers_.size() || !pipeline_ || !particleRenderer_ || !particleSystem_ || !swapchain_) {
+    // Graba los secundarios en paralelo en el ThreadPool (cada hilo en su propio pool del frame) y
+    // el grafo los ejecuta desde el primario, con las barreras y timestamps entre pases. Todo lo
+    // que comparten las tareas (cámara, pipeline actual) se lee antes.
+    VkCommandBuffer recordCommandBuffer(uint32_t imageIndex) {
+        if (!renderPass_ || imageIndex >= swapchainFramebuffers_.size() || !pipelineVariants_ || !particleRenderer_ || !particleSystem_ || !swapchain_) {
              throw std::runtime_error("Cannot record command buffer: dependencies missing or imageIndex out of bounds.");
         }
+        uint32_t frameIndex = sync_->getCurrentFrameIndex();
+        frameCommandPools_->beginFrame(frameIndex); // La GPU ya terminó este slot (waitForFrame)
+
+        // Los passes de cómputo van fuera del render pass. El pase de culling de la GPU usa el
+        // rectángulo visible de este frame.
+        glm::vec2 viewMin, viewMax;
+        camera_->getVisibleRect(viewMin, viewMax, getCullMarginPixels());
+        if (gpuParticles_) gpuParticles_->setViewRect(viewMin, viewMax);
+        particulas::CameraPushConstants cameraConstants = camera_->getPushConstants();
+        glm::vec2 viewScale, viewOffset;
+        camera_->getPixelTransform(viewScale, viewOffset);
+        if (splatRenderer_) splatRenderer_->setView(viewScale, viewOffset);
+
+        // Partículas a dibujar: con simulación en GPU el número real solo lo conoce la GPU (se usa la capacidad)
+        uint32_t particleCount = gpuParticles_ ? gpuParticles_->getCapacity() : drawnParticles_;
+        bool splats = renderMode_ == RENDER_SPLATS && splatRenderer_;
+        timedRenderMode_[frameIndex] = splats ? RENDER_SPLATS : RENDER_POINTS;
+        timedParticles_[frameIndex] = particleCount;
+        const particulas::Pipeline& pipeline = pipelineVariants_->getCurrent(); // Nunca espera a una variante en compilación
+        VkRenderPass renderPass = renderPass_->get();
+        VkFramebuffer framebuffer = swapchainFramebuffers_[imageIndex];
+        VkExtent2D extent = swapchain_->getExtent();
+        // Salida del pase de culling de la GPU (recordSimulation alterna sus buffers internos, estos no)
+        VkBuffer gpuVisibleBuffer = gpuParticles_ ? gpuParticles_->getVisibleBuffer() : VK_NULL_HANDLE;
+        VkBuffer gpuVisibleIndirect = gpuParticles_ ? gpuParticles_->getVisibleIndirectBuffer() : VK_NULL_HANDLE;
+        if (splats) {
+            // Se actualiza el descriptor set aquí: la grabación paralela solo lo enlaza
+            VkBuffer source = gpuParticles_ ? gpuVisibleBuffer : particleRenderer_->getVertexBuffer();
+            splatRenderer_->setSources(frameIndex, source, gpuVisibleIndirect);
+        }
+
+        std::array<VkCommandBuffer, RECORD_TASK_COUNT> secondaries{};
+        std::array<std::exception_ptr, RECORD_TASK_COUNT> errors{};
+        threadPool_->parallelFor(0, RECORD_TASK_COUNT, 1, [&](size_t taskBegin, size_t taskEnd) {
+            size_t threadIndex = particulas::ThreadPool::getCurrentThreadIndex();
+            for (size_t task = taskBegin; task < taskEnd; ++task) {
+                try {
+                    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+                    if (task == RECORD_SIMULATION && gpuParticles_) {
+                        commandBuffer = frameCommandPools_->beginSecondary(frameIndex, threadIndex);
+                        gpuParticles_->recordSimulation(commandBuffer, gpuDeltaTime_);
+                        gpuParticles_->recordVisibleCountReadback(commandBuffer, frameIndex); // Partículas de verdad para ns/partícula
+                    } else if (task == RECORD_SPLAT && splats) {
+                        commandBuffer = frameCommandPools_->beginSecondary(frameIndex, threadIndex);
+                        splatRenderer_->recordSplat(commandBuffer, frameIndex, particleCount);
+                    } else if (task == RECORD_SCENE) {
+                        commandBuffer = frameCommandPools_->beginSecondary(frameIndex, threadIndex, renderPass, framebuffer);
+                        if (splats) {
+                            splatRenderer_->recordTonemap(commandBuffer, frameIndex);
+                        } else if (gpuParticles_) {
+                            particleRenderer_->recordCommandBuffer( commandBuffer, pipeline.getGraphicsPipeline(), pipeline.getPipelineLayout(),
+                                extent, cameraConstants, gpuVisibleBuffer,
+                                gpuVisibleIndirect ); // Número de visibles escrito por el pase de culling
+                        } else {
+                            particleRenderer_->recordCommandBuffer( commandBuffer, pipeline.getGraphicsPipeline(), pipeline.getPipelineLayout(),
+                                extent, cameraConstants, drawnParticles_ ); // Solo lo subido este frame
+                        }
+                    }
+                    if (commandBuffer != VK_NULL_HANDLE) {
+                        particulas::debug::checkVkResult(vkEndCommandBuffer(commandBuffer), "End secondary command buffer");
+                        secondaries[task] = commandBuffer;
+                    }
+                } catch (...) {
+                    errors[task] = std::current_exception(); // Los workers no pueden propagar excepciones
+                }
+            }
+        });
+        for (const std::exception_ptr& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+
+        frameSecondaries_ = secondaries;
+        frameFramebuffer_ = framebuffer;
+        frameImageIndex_ = imageIndex;
+        if (simulatePass_ != NO_PASS) renderGraph_->setPassEnabled(simulatePass_, secondaries[RECORD_SIMULATION] != VK_NULL_HANDLE);
+        if (splatPass_ != NO_PASS) renderGraph_->setPassEnabled(splatPass_, secondaries[RECORD_SPLAT] != VK_NULL_HANDLE);
+        if (capturePass_ != NO_PASS) renderGraph_->setPassEnabled(capturePass_, !frameCapture_->isFinished());
+
+        VkCommandBuffer commandBuffer = frameCommandPools_->getPrimary(frameIndex);
         VkCommandBufferBeginInfo beginInfo{}; beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
         particulas::debug::checkVkResult(vkBeginCommandBuffer(commandBuffer, &beginInfo), "Begin command buffer");
+        renderGraph_->execute(commandBuffer, frameIndex);
+        particulas::debug::checkVkResult(vkEndCommandBuffer(commandBuffer), "End command buffer");
+        return commandBuffer;
+    }
 
+    // Pases del grafo: cada uno ejecuta el secundario que le tocó en la grabación paralela
+    void executeSecondary(VkCommandBuffer commandBuffer, RecordTask task) {
+        if (frameSecondaries_[task] != VK_NULL_HANDLE) vkCmdExecuteCommands(commandBuffer, 1, &frameSecondaries_[task]);
+    }
+
+    void recordScenePass(VkCommandBuffer commandBuffer) {
         VkRenderPassBeginInfo renderPassInfo{}; renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO; renderPassInfo.renderPass = renderPass_->get();
-        renderPassInfo.framebuffer = swapchainFramebuffers_[imageIndex]; renderPassInfo.renderArea.offset = {0, 0}; renderPassInfo.renderArea.extent = swapchain_->getExtent();
+        renderPassInfo.framebuffer = frameFramebuffer_; renderPassInfo.renderArea.offset = {0, 0}; renderPassInfo.renderArea.extent = swapchain_->getExtent();
         std::array<VkClearValue, 2> clearValues{}; clearValues[0].color = {{0.1f, 0.1f, 0.1f, 1.0f}}; clearValues[1].depthStencil = {1.0f, 0};
-        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size()); renderPassInfo.pClearValues = clearValues.data();
+        renderPassInfo.clearValueCount = renderPass_->getAttachmentCount(); renderPassInfo.pClearValues = clearValues.data();
 
-        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-        // Usar el tipo correcto particleRenderer_ y ->
-        particleRenderer_->recordCommandBuffer( commandBuffer, pipeline_->getGraphicsPipeline(), pipeline_->getPipelineLayout(),
-            swapchain_->getExtent(), static_cast<uint32_t>(particleSystem_->getParticles().size()) ); // <-- Usar ->
+        // Con contenido SECONDARY_COMMAND_BUFFERS el subpass solo admite vkCmdExecuteCommands
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        executeSecondary(commandBuffer, RECORD_SCENE);
         vkCmdEndRenderPass(commandBuffer);
-        particulas::debug::checkVkResult(vkEndCommandBuffer(commandBuffer), "End command buffer");
     }
 
      void drawFrame() {
-         if (!sync_ || !device_ || !swapchain_ || commandBuffers_.empty() || !particleRenderer_ || !particleSystem_) {
-             std::cerr << "Warning: Skipping drawFrame, dependencies not ready." << std::endl;
+         if (!sync_ || !device_ || !swapchain_ || !frameCommandPools_ || !renderGraph_ || !particleRenderer_ || !particleSystem_) {
+             PARTICULAS_LOG(Warning) << "Skipping drawFrame, dependencies not ready.";
              std::this_thread::sleep_for(std::chrono::milliseconds(10)); return;
          }
-         sync_->waitForFence();
+         auto waitStartTime = std::chrono::steady_clock::now();
+         particulas::AllocationTracker::setPhase(CPU_WAIT);
+         sync_->waitForFrame();
+         collectRenderTiming(sync_->getCurrentFrameIndex());
+         if (frameCapture_) frameCapture_->collect(sync_->getCurrentFrameIndex()); // Su copia ya terminó: al escritor
+         cpuPhaseMilliseconds_[CPU_WAIT] = millisecondsSince(waitStartTime);
 
          uint32_t imageIndex;
+         particulas::AllocationTracker::setPhase(ALLOC_DRIVER);
          VkResult acquireResult = vkAcquireNextImageKHR(device_->getLogicalDevice(), swapchain_->get(),
                                                 std::numeric_limits<uint64_t>::max(),
                                                 sync_->getImageAvailableSemaphore(), VK_NULL_HANDLE, &imageIndex);
-         if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR || acquireResult == VK_SUBOPTIMAL_KHR || framebufferResized_) {
-             framebufferResized_ = false; recreateSwapchain(); return;
-         } else { particulas::debug::checkVkResult(acquireResult, "Acquire next image"); }
-
-         // Usar el tipo correcto particleRenderer_ y ->
-         particleRenderer_->updateBuffers(particleSystem_->getParticles()); // <-- Usar ->
-         sync_->resetFence();
-
-         uint32_t syncFrameIndex = sync_->getCurrentFrameIndex();
-         VkCommandBuffer currentCommandBuffer = commandBuffers_[syncFrameIndex];
-         vkResetCommandBuffer(currentCommandBuffer, 0);
-         recordCommandBuffer(currentCommandBuffer, imageIndex);
-
-         VkSubmitInfo submitInfo{}; submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-         VkSemaphore waitSemaphores[] = {sync_->getImageAvailableSemaphore()}; VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-         submitInfo.waitSemaphoreCount = 1; submitInfo.pWaitSemaphores = waitSemaphores; submitInfo.pWaitDstStageMask = waitStages;
-         submitInfo.commandBufferCount = 1;
-         submitInfo.pCommandBuffers = &currentCommandBuffer; // <-- CORREGIDO
+         // Obsoleto: no se adquirió imagen ni se señalará el semáforo. Subóptimo (o ventana
+         // redimensionada) sí adquirió: el frame se presenta y se recrea después del present.
+         if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) { recreateSwapchain(); return; }
+         if (acquireResult != VK_SUBOPTIMAL_KHR) particulas::debug::checkVkResult(acquireResult, "Acquire next image");
+
+         auto uploadStartTime = std::chrono::steady_clock::now();
+         particulas::AllocationTracker::setPhase(CPU_UPLOAD);
+         if (!gpuParticles_) {
+             beginPerfPhase();
+             uploadVisibleParticles(sync_->getCurrentFrameIndex());
+             endPerfPhase(PERF_PACK);
+         }
+         auto recordStartTime = std::chrono::steady_clock::now();
+         cpuPhaseMilliseconds_[CPU_UPLOAD] = std::chrono::duration<double, std::milli>(recordStartTime - uploadStartTime).count();
+
+         particulas::AllocationTracker::setPhase(CPU_RECORD);
+         beginPerfPhase();
+         VkCommandBuffer currentCommandBuffer = recordCommandBuffer(imageIndex); // Reinicia los pools del frame
+         endPerfPhase(PERF_RECORD);
+         auto presentStartTime = std::chrono::steady_clock::now();
+         cpuPhaseMilliseconds_[CPU_RECORD] = std::chrono::duration<double, std::milli>(presentStartTime - recordStartTime).count();
+
+         // Espera la imagen adquirida, señala renderFinished y el valor del frame (timeline) o la fence del slot
+         auto submitStartTime = std::chrono::steady_clock::now();
+         particulas::AllocationTracker::setPhase(CPU_PRESENT);
+         sync_->submit(device_->getGraphicsQueue(), currentCommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+         liveMetrics_.submitLatencySeconds.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - submitStartTime).count());
          VkSemaphore signalSemaphores[] = {sync_->getRenderFinishedSemaphore()};
-         submitInfo.signalSemaphoreCount = 1; submitInfo.pSignalSemaphores = signalSemaphores;
-
-         particulas::debug::checkVkResult( vkQueueSubmit(device_->getGraphicsQueue(), 1, &submitInfo, sync_->getInFlightFence()), "Queue submit");
 
          VkPresentInfoKHR presentInfo{}; presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR; presentInfo.waitSemaphoreCount = 1; presentInfo.pWaitSemaphores = signalSemaphores;
          VkSwapchainKHR swapChains[] = {swapchain_->get()};
          presentInfo.swapchainCount = 1; presentInfo.pSwapchains = swapChains; presentInfo.pImageIndices = &imageIndex;
+         particulas::AllocationTracker::setPhase(ALLOC_DRIVER);
          VkResult presentResult = vkQueuePresentKHR(device_->getPresentQueue(), &presentInfo);
-         if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || framebufferResized_) {
+         if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || acquireResult == VK_SUBOPTIMAL_KHR
+             || framebufferResized_) {
             framebufferResized_ = false; recreateSwapchain();
          } else if (presentResult != VK_SUCCESS) { particulas::debug::checkVkResult(presentResult, "Queue present"); }
+         cpuPhaseMilliseconds_[CPU_PRESENT] = millisecondsSince(presentStartTime);
 
          sync_->nextFrame();
     }
 
+    // Sube solo lo que cae en la vista (más un margen de tamaño de punto). La rejilla se reconstruye
+    // cada frame en O(N), pero la copia, la subida y el dibujo son proporcionales a lo visible.
+    void uploadVisibleParticles(uint32_t frameIndex) {
+        const std::vector<particulas::Particle>& particles = particleSystem_->getParticles();
+        size_t count = particleSystem_->getParticleCount();
+        if (!cullGrid_) {
+            if (drawFraction_ < 1.0f) {
+                size_t kept = thinParticles(particles, count, visibleParticles_);
+                particleRenderer_->updateBuffers(visibleParticles_, kept, frameIndex);
+                drawnParticles_ = static_cast<uint32_t>(kept);
+                return;
+            }
+            particleRenderer_->updateBuffers(particles, count, frameIndex); // Solo el rango vivo
+            drawnParticles_ = static_cast<uint32_t>(count);
+            return;
+        }
+        glm::vec2 viewMin, viewMax;
+        camera_->getVisibleRect(viewMin, viewMax, getCullMarginPixels());
+        cullGrid_->build(particles, count);
+        size_t visible = cullGrid_->gather(particles, viewMin, viewMax, visibleParticles_);
+        if (drawFraction_ < 1.0f) visible = thinParticles(visibleParticles_, visible, visibleParticles_);
+        particleRenderer_->updateBuffers(visibleParticles_, visible, frameIndex);
+        drawnParticles_ = static_cast<uint32_t>(visible);
+    }
+
+    // Se queda con drawFraction_ de las count primeras, repartidas a intervalos regulares: con el
+    // orden Morton la muestra cubre toda la escena y, al ser siempre la misma, no parpadea entre
+    // frames. source y target pueden ser el mismo vector.
+    size_t thinParticles(const std::vector<particulas::Particle>& source, size_t count, std::vector<particulas::Particle>& target) const {
+        size_t kept = 0;
+        float credit = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            credit += drawFraction_;
+            if (credit < 1.0f) continue;
+            credit -= 1.0f;
+            target[kept++] = source[i];
+        }
+        return kept;
+    }
+
+    // Un punto cuyo centro queda justo fuera de la vista aún puede pintar medio tamaño de punto dentro.
+    // El tamaño escala con el radio de la especie (radio 2 = pointSize), así que se usa el mayor.
+    float getCullMarginPixels() const {
+        float pointSize = pipelineVariants_ ? pipelineVariants_->getCurrent().getVariant().pointSize : 1.0f;
+        float maxRadius = particleSystem_ ? particleSystem_->getMaxSpeciesRadius() : 2.0f;
+        return pointSize * std::max(maxRadius * 0.5f, 1.0f);
+    }
+
+    // Flechas/WASD: desplazar; rueda: zoom alrededor del cursor; botón izquierdo: arrastrar; Home: reiniciar
+    void handleCameraInput(float deltaTime) {
+        if (!camera_ || !window_) return;
+        glm::vec2 direction(0.0f);
+        if (window_->isKeyPressed(GLFW_KEY_LEFT) || window_->isKeyPressed(GLFW_KEY_A)) direction.x -= 1.0f;
+        if (window_->isKeyPressed(GLFW_KEY_RIGHT) || window_->isKeyPressed(GLFW_KEY_D)) direction.x += 1.0f;
+        if (window_->isKeyPressed(GLFW_KEY_UP) || window_->isKeyPressed(GLFW_KEY_W)) direction.y -= 1.0f;
+        if (window_->isKeyPressed(GLFW_KEY_DOWN) || window_->isKeyPressed(GLFW_KEY_S)) direction.y += 1.0f;
+        if (direction.x != 0.0f || direction.y != 0.0f) camera_->pan(-direction * CAMERA_PAN_SPEED * deltaTime); // La vista avanza, el contenido retrocede
+
+        double cursorX = 0.0, cursorY = 0.0;
+        window_->getCursorPosition(cursorX, cursorY);
+        bool mouseOnHud = hud_ && hud_->wantsMouse(); // Arrastrar un control del HUD no mueve la cámara
+        bool dragging = !mouseOnHud && window_->isMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT);
+        if (dragging && cameraDragging_) {
+            // Arrastrar mueve el contenido con el cursor
+            camera_->pan(glm::vec2(static_cast<float>(cursorX - lastCursorX_), static_cast<float>(cursorY - lastCursorY_)));
+        }
+        cameraDragging_ = dragging;
+        lastCursorX_ = cursorX;
+        lastCursorY_ = cursorY;
+
+        double scroll = window_->consumeScrollDelta();
+        if (scroll != 0.0 && !mouseOnHud) {
+            camera_->zoomBy(std::pow(1.15f, static_cast<float>(scroll)), glm::vec2(static_cast<float>(cursorX), static_cast<float>(cursorY)));
+        }
+
+        bool resetKeyDown = window_->isKeyPressed(GLFW_KEY_HOME);
+        if (resetKeyDown && !cameraResetKeyDown_) camera_->reset();
+        cameraResetKeyDown_ = resetKeyDown;
+    }
+
+    // Opcional: si el puerto está ocupado se avisa y se sigue sin endpoint
+    void startMetricsEndpoint() {
+        try {
+            metricsServer_ = std::make_unique<particulas::MetricsServer>(liveMetrics_, METRICS_ENDPOINT_PORT);
+            PARTICULAS_LOG(Info) << "Metrics endpoint: http://127.0.0.1:" << metricsServer_->getPort() << "/metrics";
+        } catch (const std::exception& e) {
+            PARTICULAS_LOG(Warning) << e.what();
+        }
+    }
+
+    // Opcional como el endpoint: si no se puede crear el segmento se avisa y se sigue sin él.
+    // Los snapshots salen de la simulación en CPU; con SIMULATE_ON_GPU las partículas no vuelven al host.
+    void startSharedSnapshots() {
+        if (gpuParticles_) {
+            PARTICULAS_LOG(Warning) << "Shared snapshots need the CPU simulation; disabled with SIMULATE_ON_GPU.";
+            return;
+        }
+        try {
+            snapshotWriter_ = std::make_unique<particulas::SharedSnapshotWriter>(SHARED_SNAPSHOT_NAME, particleSystem_->getParticles().size(),
+                                                                                 SHARED_SNAPSHOT_SLOTS);
+            PARTICULAS_LOG(Info) << "Shared snapshots: " << SHARED_SNAPSHOT_NAME << " (" << SHARED_SNAPSHOT_SLOTS << " slots of "
+                                 << snapshotWriter_->getCapacity() << " particles)";
+        } catch (const std::exception& e) {
+            PARTICULAS_LOG(Warning) << e.what();
+        }
+    }
+
+    // Solo si la simulación ha avanzado este frame: con ritmo fijo puede haber frames sin pasos
+    void publishSnapshot() {
+        if (!snapshotWriter_) return;
+        uint64_t step = liveMetrics_.simulationSteps.load(std::memory_order_relaxed);
+        if (step == lastSnapshotStep_) return;
+        lastSnapshotStep_ = step;
+        snapshotWriter_->publish(particleSystem_->getParticles().data(), particleSystem_->getParticleCount(), step, threadPool_.get());
+    }
+
+    // Toda la memoria DEVICE_LOCAL que se reserva por slot de partícula, para decidir la capacidad
+    // antes de crear los buffers. Si no cabe, se reduce (o se aborta) aquí con un mensaje claro en
+    // vez de fallar con VK_ERROR_OUT_OF_DEVICE_MEMORY en mitad de la inicialización.
+    size_t planParticleCapacity(size_t requestedCapacity) {
+        VkDeviceSize bytesPerParticle = particulas::ParticleRenderer::getDeviceBytesPerParticle()
+                                      + particulas::SplatRenderer::getDeviceBytesPerParticle();
+        if (scenario_.simulateOnGpu) bytesPerParticle += particulas::GpuParticleSystem::getDeviceBytesPerParticle();
+        VkDeviceSize available = device_->getAvailableDeviceLocalBytes();
+        VkDeviceSize usable = static_cast<VkDeviceSize>(static_cast<double>(available) * (1.0 - GPU_MEMORY_HEADROOM));
+        size_t maxCapacity = static_cast<size_t>(usable / bytesPerParticle);
+        PARTICULAS_LOG(Info) << "GPU memory plan: " << bytesPerParticle << " B/particle, " << (available >> 20) << " MiB available ("
+                  << (device_->supportsMemoryBudget() ? "VK_EXT_memory_budget" : "estimated") << "), max safe capacity "
+                  << maxCapacity << ".";
+        if (requestedCapacity <= maxCapacity) return requestedCapacity;
+        if (!DOWNSCALE_CAPACITY_TO_GPU_BUDGET || maxCapacity == 0) {
+            throw std::runtime_error("Particle capacity " + std::to_string(requestedCapacity) + " needs "
+                + std::to_string((requestedCapacity * bytesPerParticle) >> 20) + " MiB of device memory; only "
+                + std::to_string(maxCapacity) + " particles fit in the current GPU memory budget.");
+        }
+        PARTICULAS_LOG(Warning) << "particle capacity reduced from " << requestedCapacity << " to " << maxCapacity
+                  << " to fit the GPU memory budget.";
+        return maxCapacity;
+    }
+
+    // Cada 30 frames: con VK_EXT_memory_budget la consulta es barata, pero no hace falta cada frame
+    void sampleGpuMemoryBudget() {
+        if (framesSinceBudgetSample_++ % 30 != 0) return;
+        gpuHeapCount_ = device_->queryMemoryBudget(gpuMemoryBudget_);
+        uint32_t heapCount = std::min<uint32_t>(gpuHeapCount_, particulas::LiveMetrics::MAX_GPU_HEAPS);
+        for (uint32_t heap = 0; heap < heapCount; ++heap) {
+            liveMetrics_.gpuHeapBudgetBytes[heap].store(gpuMemoryBudget_[heap].budget, std::memory_order_relaxed);
+            liveMetrics_.gpuHeapUsageBytes[heap].store(gpuMemoryBudget_[heap].usage, std::memory_order_relaxed);
+        }
+        liveMetrics_.gpuHeapCount.store(heapCount, std::memory_order_relaxed);
+        liveMetrics_.gpuBudgetReported.store(device_->supportsMemoryBudget(), std::memory_order_relaxed);
+    }
+
+    // Stores relajados de lo que ya se conoce en el frame; el ritmo de pasos se recalcula cada segundo
+    void publishLiveMetrics(std::chrono::high_resolution_clock::time_point now) {
+        liveMetrics_.frames.fetch_add(1, std::memory_order_relaxed);
+        liveMetrics_.liveParticles.store(particleSystem_->getLiveParticleCount(), std::memory_order_relaxed);
+        liveMetrics_.drawnParticles.store(drawnParticles_, std::memory_order_relaxed);
+        liveMetrics_.particleCapacity.store(particleSystem_->getCapacity(), std::memory_order_relaxed);
+        liveMetrics_.gpuParticleBytes.store(particleSystem_->getCapacity() * sizeof(particulas::Particle), std::memory_order_relaxed);
+        liveMetrics_.gpuTransientBytes.store(renderGraph_ ? renderGraph_->getTransientBytes() : 0, std::memory_order_relaxed);
+
+        double elapsed = std::chrono::duration<double>(now - lastRateSampleTime_).count();
+        if (elapsed >= 1.0) {
+            uint64_t steps = liveMetrics_.simulationSteps.load(std::memory_order_relaxed);
+            liveMetrics_.simulationStepsPerSecond.store(static_cast<double>(steps - stepsAtLastRateSample_) / elapsed, std::memory_order_relaxed);
+            stepsAtLastRateSample_ = steps;
+            lastRateSampleTime_ = now;
+        }
+    }
+
+    // Con PARTICULAS_TRACK_ALLOCATIONS se cuentan las reservas del hilo principal y de los del pool
+    void startAllocationTracking() {
+        if (!particulas::AllocationTracker::isEnabled()) return;
+        threadPool_->runOnEachThread([](size_t) { particulas::AllocationTracker::trackCurrentThread(); });
+        for (size_t phase = 0; phase < ALLOC_PHASE_COUNT; ++phase) allocationsAtFrameStart_[phase] = particulas::AllocationTracker::getCounts(phase);
+        PARTICULAS_LOG(Info) << "[Alloc] Tracking allocations; frames after " << ALLOCATION_WARMUP_FRAMES << " must not allocate.";
+    }
+
+    // Crear la simulación de otro escenario reserva memoria: su calentamiento empieza de nuevo
+    void restartAllocationWarmup() {
+        if (!particulas::AllocationTracker::isEnabled()) return;
+        for (size_t phase = 0; phase < ALLOC_PHASE_COUNT; ++phase) allocationsAtFrameStart_[phase] = particulas::AllocationTracker::getCounts(phase);
+        allocationFrames_ = 0;
+    }
+
+    // Reservas del frame por fase. Tras el calentamiento cualquier reserva fuera de las llamadas al
+    // WSI se avisa (los primeros frames) y se suma al resumen; con FAIL_ON_STEADY_STATE_ALLOCATION
+    // el primer frame que reserve aborta la ejecución.
+    void checkFrameAllocations() {
+        if (!particulas::AllocationTracker::isEnabled()) return;
+        std::array<particulas::AllocationCounts, ALLOC_PHASE_COUNT> current;
+        for (size_t phase = 0; phase < ALLOC_PHASE_COUNT; ++phase) current[phase] = particulas::AllocationTracker::getCounts(phase);
+        if (++allocationFrames_ > ALLOCATION_WARMUP_FRAMES) {
+            bool allocated = false;
+            for (size_t phase = 0; phase < ALLOC_PHASE_COUNT; ++phase) {
+                particulas::AllocationCounts frame = current[phase] - allocationsAtFrameStart_[phase];
+                steadyStateAllocations_[phase] += frame;
+                if (phase != ALLOC_DRIVER && !frame.isZero()) allocated = true;
+            }
+            if (allocated && framesWithAllocations_++ < 10) {
+                for (size_t phase = 0; phase < ALLOC_PHASE_COUNT; ++phase) {
+                    particulas::AllocationCounts frame = current[phase] - allocationsAtFrameStart_[phase];
+                    if (phase == ALLOC_DRIVER || frame.isZero()) continue;
+                    PARTICULAS_LOG(Warning) << "[Alloc] Steady-state frame " << allocationFrames_ << " allocated in " << getAllocationPhaseName(phase)
+                                            << ": " << frame.heapAllocations << " heap (" << frame.heapBytes << " B) + " << frame.deviceAllocations << " device";
+                }
+            }
+            if (allocated && FAIL_ON_STEADY_STATE_ALLOCATION) {
+                throw std::runtime_error("Steady-state frame " + std::to_string(allocationFrames_) + " allocated memory.");
+            }
+            if (allocated) { // El aviso también puede reservar: que no cuente en el frame siguiente
+                for (size_t phase = 0; phase < ALLOC_PHASE_COUNT; ++phase) current[phase] = particulas::AllocationTracker::getCounts(phase);
+            }
+        }
+        allocationsAtFrameStart_ = current;
+    }
+
+    void printAllocationReport() const {
+        if (!particulas::AllocationTracker::isEnabled()) return;
+        particulas::Logger::flush();
+        if (allocationFrames_ <= ALLOCATION_WARMUP_FRAMES) {
+            std::cout << "[Alloc] Only " << allocationFrames_ << " frames: no steady state reached." << std::endl;
+            return;
+        }
+        uint64_t steadyFrames = allocationFrames_ - ALLOCATION_WARMUP_FRAMES;
+        std::cout << "[Alloc] Steady state: " << framesWithAllocations_ << " of " << steadyFrames << " frames allocated"
+                  << (framesWithAllocations_ == 0 ? " (OK)" : "") << ". Per phase (heap allocations / bytes / device allocations):" << std::endl;
+        for (size_t phase = 0; phase < ALLOC_PHASE_COUNT; ++phase) {
+            const particulas::AllocationCounts& counts = steadyStateAllocations_[phase];
+            std::cout << "  " << std::left << std::setw(18) << getAllocationPhaseName(phase) << std::right << counts.heapAllocations
+                      << " / " << counts.heapBytes << " / " << counts.deviceAllocations << (phase == ALLOC_DRIVER ? "  (WSI, not checked)" : "") << std::endl;
+        }
+    }
+
+    static const char* getAllocationPhaseName(size_t phase) {
+        static const char* const NAMES[ALLOC_PHASE_COUNT] = {"simulate", "wait frame", "cull + upload", "record", "submit + present",
+                                                              "hud", "acquire/present", "other"};
+        return phase < ALLOC_PHASE_COUNT ? NAMES[phase] : "?";
+    }
+
+    // Los contadores se abren en cada hilo del pool; si el kernel no lo permite se sigue sin ellos
+    void createPerfCounters() {
+        perfCounters_ = std::make_unique<particulas::PerfCounters>(*threadPool_, PERF_PHASE_COUNT);
+        PARTICULAS_LOG(Info) << "Perf counters: " << perfCounters_->getStatus();
+        if (!perfCounters_->isAvailable()) { perfCounters_.reset(); return; }
+        perfFrames_.reserve(MAX_RECORDED_PERF_FRAMES);
+    }
+
+    void beginPerfPhase() {
+        if (perfCounters_) perfCounters_->beginPhase();
+    }
+
+    void endPerfPhase(PerfPhase phase) {
+        if (perfCounters_) perfFrame_.phases[phase] = perfCounters_->endPhase(phase);
+    }
+
+    // Una fila por frame y fase, con IPC y fallos por partícula. Los totales por hilo van en la cabecera.
+    void savePerfCountersToFile(const std::filesystem::path& path) {
+        static const char* const PHASE_NAMES[PERF_PHASE_COUNT] = {"simulate", "pack", "record"};
+        std::ofstream outFile(path);
+        if (!outFile.is_open()) {
+            PARTICULAS_LOG(Warning) << "[Metrics] Error opening file for writing: " << path.string();
+            return;
+        }
+        outFile << "# PERF COUNTERS (user space, summed over " << perfCounters_->getThreadCount() << " threads)\n"
+                << "# " << perfCounters_->getStatus() << "\n"
+                << "# Per-thread totals: Thread,Phase,Cycles,Instructions,CacheMisses,BranchMisses,IPC\n";
+        for (size_t thread = 0; thread < perfCounters_->getThreadCount(); ++thread) {
+            for (size_t phase = 0; phase < PERF_PHASE_COUNT; ++phase) {
+                const particulas::PerfSample& total = perfCounters_->getThreadTotal(thread, phase);
+                outFile << "# " << thread << "," << PHASE_NAMES[phase];
+                for (uint64_t value : total.values) outFile << "," << value;
+                outFile << "," << std::fixed << std::setprecision(4) << total.getIpc() << "\n";
+            }
+        }
+        outFile << "\nFrame,Phase,Particles,Cycles,Instructions,CacheMisses,BranchMisses,IPC,CacheMissesPerParticle,BranchMissesPerParticle\n";
+        for (size_t frame = 0; frame < perfFrames_.size(); ++frame) {
+            const PerfFrameSample& sample = perfFrames_[frame];
+            double particles = static_cast<double>(std::max<size_t>(sample.particles, 1));
+            for (size_t phase = 0; phase < PERF_PHASE_COUNT; ++phase) {
+                const particulas::PerfSample& counters = sample.phases[phase];
+                outFile << frame << "," << PHASE_NAMES[phase] << "," << sample.particles;
+                for (uint64_t value : counters.values) outFile << "," << value;
+                outFile << "," << counters.getIpc()
+                        << "," << static_cast<double>(counters.get(particulas::PerfCounter::CacheMisses)) / particles
+                        << "," << static_cast<double>(counters.get(particulas::PerfCounter::BranchMisses)) / particles << "\n";
+            }
+        }
+        PARTICULAS_LOG(Info) << "[Metrics] Perf counters saved to " << path.string() << " (" << perfFrames_.size() << " frames).";
+    }
+
+    // Una fila por miembro del conjunto (ver Ensemble::writeMetricsCsv)
+    void saveEnsembleMetricsToFile(const std::filesystem::path& path) {
+        std::ofstream outFile(path);
+        if (!outFile.is_open()) { PARTICULAS_LOG(Warning) << "[Metrics] Error opening file for writing: " << path.string(); return; }
+        ensemble_->writeMetricsCsv(outFile);
+        PARTICULAS_LOG(Info) << "[Metrics] Ensemble metrics saved to " << path.string() << " (" << ensemble_->getMemberCount() << " members).";
+    }
+
+    // Sin ritmo fijo, un paso de deltaTime por frame. Con ritmo fijo (control del HUD), tantos pasos
+    // de 1/ritmo como quepan en el tiempo acumulado, hasta MAX_SIMULATION_STEPS_PER_FRAME.
+    void advanceSimulation(float deltaTime) {
+        float stepDelta = deltaTime;
+        int steps = 1;
+        if (simulationRateHz_ > 0.0f) {
+            stepDelta = 1.0f / simulationRateHz_;
+            simulationAccumulator_ += deltaTime;
+            steps = std::min(static_cast<int>(simulationAccumulator_ / stepDelta), MAX_SIMULATION_STEPS_PER_FRAME);
+            simulationAccumulator_ = std::min(simulationAccumulator_ - static_cast<float>(steps) * stepDelta, stepDelta);
+        }
+        if (stepDelta > 0.0f) liveMetrics_.simulationSteps.fetch_add(static_cast<uint64_t>(steps), std::memory_order_relaxed);
+        if (gpuParticles_) {
+            gpuDeltaTime_ = stepDelta * static_cast<float>(steps); // Un único dispatch por frame, se graba en su command buffer
+        } else if (ensemble_) {
+            if (stepDelta <= 0.0f || steps == 0) return; // particleSystem_ es solo la rejilla: nunca se actualiza
+            for (int step = 0; step < steps; ++step) ensemble_->step(stepDelta);
+            ensemble_->packTiled(*particleSystem_);
+        } else if (particleSystem_ && stepDelta > 0.0f) {
+            for (int step = 0; step < steps; ++step) particleSystem_->update(stepDelta);
+        }
+    }
+
+    // --- Controlador de calidad ---
+    // Con presupuesto de frame, parte de calidad completa y la ajusta según el p95 del intervalo
+    // entre frames. Los subpasos son los del solver de restricciones (la tela), de los de la escena
+    // hacia abajo; sin solver la palanca no existe. Con simulación en GPU solo queda la escala de
+    // los splats: la fracción dibujada es de la ruta de CPU.
+    void createQualityController() {
+        particulas::ConstraintSolver* solver = getQualitySolver();
+        simulationSubsteps_ = solver ? solver->getSubsteps() : 1;
+        drawFraction_ = 1.0f;
+        qualityController_.reset();
+        if (scenario_.frameBudgetMs <= 0.0) {
+            applyQualityLevels();
+            return;
+        }
+        const bool cpuPath = !gpuParticles_;
+        particulas::QualitySettings settings;
+        settings.frameBudgetMs = scenario_.frameBudgetMs;
+        settings.minimum = {1, QUALITY_MIN_RENDER_SCALE, QUALITY_MIN_DRAW_FRACTION};
+        settings.maximum = {simulationSubsteps_, 1.0f, 1.0f};
+        qualityController_ = std::make_unique<particulas::QualityController>(settings);
+        qualityController_->setLeverAvailable(particulas::QualityLever::Substeps, solver != nullptr);
+        qualityController_->setLeverAvailable(particulas::QualityLever::DrawFraction, cpuPath);
+        applyQualityLevels();
+        PARTICULAS_LOG(Info) << "[Quality] Frame budget " << settings.frameBudgetMs << " ms (p95); substeps 1-" << settings.maximum.substeps
+                             << ", render scale " << QUALITY_MIN_RENDER_SCALE << "-1, draw fraction "
+                             << (cpuPath ? QUALITY_MIN_DRAW_FRACTION : 1.0f) << "-1.";
+    }
+
+    void updateQualityController(double frameIntervalSeconds) {
+        if (!qualityController_) return;
+        // La escala solo abarata algo con los splats: con puntos no se toca
+        qualityController_->setLeverAvailable(particulas::QualityLever::RenderScale, renderMode_ == RENDER_SPLATS && splatRenderer_);
+        double runSeconds = std::chrono::duration<double>(std::chrono::system_clock::now() - runStartTime_).count();
+        if (!qualityController_->addFrameTime(frameIntervalSeconds * 1000.0, runSeconds)) return;
+        applyQualityLevels();
+        const particulas::QualityDecision& decision = *qualityController_->getLastDecision();
+        PARTICULAS_LOG(Info) << "[Quality] Frame " << decision.frame << ": " << (decision.lowered ? "lowering " : "raising ")
+                             << particulas::qualityLeverName(decision.lever) << " (p95 " << decision.p95Ms << " ms, mean " << decision.meanMs
+                             << " ms) -> substeps " << decision.after.substeps << ", render scale " << decision.after.renderScale
+                             << ", draw fraction " << decision.after.drawFraction;
+    }
+
+    // Solver cuyos subpasos ajusta el controlador (con simulación en GPU o en conjunto no se usa)
+    particulas::ConstraintSolver* getQualitySolver() const {
+        if (gpuParticles_ || ensemble_ || !particleSystem_) return nullptr;
+        return particleSystem_->getConstraintSolver();
+    }
+
+    void applyQualityLevels() {
+        particulas::QualityLevels levels = qualityController_ ? qualityController_->getLevels()
+                                                              : particulas::QualityLevels{simulationSubsteps_, 1.0f, 1.0f};
+        simulationSubsteps_ = levels.substeps;
+        if (particulas::ConstraintSolver* solver = getQualitySolver()) solver->setSubsteps(levels.substeps);
+        drawFraction_ = levels.drawFraction;
+        if (splatRenderer_) splatRenderer_->setRenderScale(levels.renderScale); // Push constants: vale desde el siguiente frame grabado
+        liveMetrics_.qualityDecisions.store(qualityController_ ? qualityController_->getDecisionCount() : 0, std::memory_order_relaxed);
+        liveMetrics_.qualitySubsteps.store(static_cast<uint32_t>(levels.substeps), std::memory_order_relaxed);
+        liveMetrics_.qualityRenderScale.store(levels.renderScale, std::memory_order_relaxed);
+        liveMetrics_.qualityDrawFraction.store(levels.drawFraction, std::memory_order_relaxed);
+    }
+
+    void saveQualityDecisionsToFile(const std::filesystem::path& path) {
+        std::ofstream outFile(path);
+        if (!outFile.is_open()) { PARTICULAS_LOG(Warning) << "[Metrics] Error opening file for writing: " << path.string(); return; }
+        qualityController_->writeDecisionsCsv(outFile);
+        PARTICULAS_LOG(Info) << "[Metrics] Quality decisions saved to " << path.string() << " (" << qualityController_->getDecisions().size()
+                             << " of " << qualityController_->getDecisionCount() << ").";
+    }
+
+    // --- HUD de rendimiento ---
+    // F1: mostrar/ocultar. Oculto no cuesta nada: ni build de ImGui ni pase de overlay en el grafo.
+    void handleHudToggle() {
+        if (!hud_) return;
+        bool keyDown = window_->isKeyPressed(GLFW_KEY_F1);
+        if (keyDown && !hudToggleKeyDown_) {
+            hud_->setVisible(!hud_->isVisible());
+            if (overlayPass_ != NO_PASS) renderGraph_->setPassEnabled(overlayPass_, hud_->isVisible());
+        }
+        hudToggleKeyDown_ = keyDown;
+    }
+
+    // Rellena las estadísticas del frame anterior, construye el HUD y aplica los controles que el
+    // usuario haya cambiado. Los controles parten cada frame del estado real (el número de partículas
+    // cambia solo con los emisores), así que solo se aplica lo que el HUD modificó.
+    void updateHud() {
+        if (!hud_ || !hud_->isVisible()) return;
+        particulas::HudFrameStats stats;
+        stats.addCpuPhase("simulate", cpuPhaseMilliseconds_[CPU_SIMULATE]);
+        stats.addCpuPhase("wait frame", cpuPhaseMilliseconds_[CPU_WAIT]);
+        stats.addCpuPhase("cull + upload", cpuPhaseMilliseconds_[CPU_UPLOAD]);
+        stats.addCpuPhase("record", cpuPhaseMilliseconds_[CPU_RECORD]);
+        stats.addCpuPhase("submit + present", cpuPhaseMilliseconds_[CPU_PRESENT]);
+        stats.addCpuPhase("hud", hud_->getBuildMilliseconds());
+        stats.graph = renderGraph_.get();
+        stats.particleCapacity = particleSystem_->getCapacity();
+        stats.countsOnGpu = gpuParticles_ != nullptr;
+        stats.liveParticles = particleSystem_->getLiveParticleCount();
+        stats.drawnParticles = drawnParticles_;
+        stats.particleBytes = particleSystem_->getCapacity() * sizeof(particulas::Particle);
+        stats.transientBytes = renderGraph_ ? renderGraph_->getTransientBytes() : 0;
+        stats.unaliasedBytes = renderGraph_ ? renderGraph_->getUnaliasedBytes() : 0;
+        if (hudFramesSinceMemorySample_++ % 30 == 0) residentBytes_ = getResidentBytes(); // Leer /proc no es gratis
+        stats.residentBytes = residentBytes_;
+        stats.deviceBudgetReported = device_->supportsMemoryBudget();
+        if (qualityController_) {
+            stats.frameBudgetMs = qualityController_->getSettings().frameBudgetMs;
+            stats.substeps = simulationSubsteps_;
+            stats.renderScale = qualityController_->getLevels().renderScale;
+            stats.drawFraction = drawFraction_;
+            stats.qualityDecisions = qualityController_->getDecisionCount();
+        }
+        for (uint32_t heap = 0; heap < gpuHeapCount_; ++heap) {
+            if (!gpuMemoryBudget_[heap].deviceLocal) continue;
+            stats.deviceLocalUsage += gpuMemoryBudget_[heap].usage;
+            stats.deviceLocalBudget += gpuMemoryBudget_[heap].budget;
+        }
+
+        particulas::HudControls& controls = hudControls_;
+        const int particleCount = static_cast<int>(particleSystem_->getLiveParticleCount());
+        const int workerThreads = static_cast<int>(threadPool_->getActiveWorkerCount());
+        const VkPresentModeKHR presentMode = swapchain_->getPresentMode();
+        controls.particleCount = particleCount;
+        controls.maxParticleCount = static_cast<int>(particleSystem_->getCapacity());
+        controls.particleCountEditable = !gpuParticles_ && !ensemble_; // El estado de la GPU no vuelve a la CPU; el conjunto se fija al crearlo
+        controls.workerThreads = workerThreads;
+        controls.maxWorkerThreads = static_cast<int>(threadPool_->getConcurrency() - 1);
+        controls.presentMode = presentMode;
+        controls.presentModes = &swapchain_->getSupportedPresentModes();
+        controls.simulationRateHz = simulationRateHz_;
+        hud_->build(stats, controls);
+
+        if (controls.particleCount != particleCount && controls.particleCountEditable) particleSystem_->setParticleCount(static_cast<size_t>(controls.particleCount));
+        if (controls.workerThreads != workerThreads) threadPool_->setActiveWorkerCount(static_cast<size_t>(controls.workerThreads));
+        if (controls.simulationRateHz != simulationRateHz_) { simulationRateHz_ = controls.simulationRateHz; simulationAccumulator_ = 0.0f; }
+        if (controls.presentMode != presentMode) switchPresentMode(controls.presentMode);
+    }
+
+    // Solo cambia el modo de presentación: mismo formato y tamaño, así que el render pass, la
+    // profundidad y los recursos del splatting siguen valiendo. Se recrean el swapchain y sus framebuffers.
+    void switchPresentMode(VkPresentModeKHR presentMode) {
+        rebuildSwapchain(presentMode);
+    }
+
+    // Swapchain nuevo con el tamaño actual de la ventana. Si el tamaño cambió, también la
+    // profundidad; lo que depende del tamaño en la simulación (splatting, cámara) lo recrea quien
+    // llama (applyScenario lo hace con la simulación destruida).
+    void rebuildSwapchain(VkPresentModeKHR presentMode) {
+        VkDevice device = device_->getLogicalDevice();
+        vkDeviceWaitIdle(device);
+        VkExtent2D previousExtent = swapchain_->getExtent();
+        for (VkFramebuffer framebuffer : swapchainFramebuffers_) vkDestroyFramebuffer(device, framebuffer, nullptr);
+        swapchainFramebuffers_.clear();
+        swapchain_.reset(); // La superficie no admite dos swapchains vivos sin oldSwapchain
+        swapchain_ = std::make_unique<particulas::Swapchain>(*device_, surface_, *window_, presentMode, getSwapchainExtraUsage());
+        VkExtent2D extent = swapchain_->getExtent();
+        if (extent.width != previousExtent.width || extent.height != previousExtent.height) {
+            destroyDepthResources();
+            createDepthResources();
+        }
+        createFramebuffers();
+        if (hud_) hud_->createFramebuffers(swapchain_->getImageViews(), swapchain_->getExtent(), swapchain_->getMinImageCount());
+        PARTICULAS_LOG(Info) << "[Render] Present mode: " << particulas::presentModeName(swapchain_->getPresentMode())
+                             << ", " << extent.width << "x" << extent.height;
+    }
+
+    void destroyDepthResources() {
+        VkDevice device = device_->getLogicalDevice();
+        if (depthImageView_ != VK_NULL_HANDLE) { vkDestroyImageView(device, depthImageView_, nullptr); depthImageView_ = VK_NULL_HANDLE; }
+        if (depthImage_ != VK_NULL_HANDLE) { vkDestroyImage(device, depthImage_, nullptr); depthImage_ = VK_NULL_HANDLE; }
+        if (depthImageMemory_ != VK_NULL_HANDLE) { vkFreeMemory(device, depthImageMemory_, nullptr); depthImageMemory_ = VK_NULL_HANDLE; }
+    }
+
+    static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // --- Comparación puntos vs splats ---
+    void handleRenderModeToggle() {
+        bool keyDown = window_->isKeyPressed(GLFW_KEY_R);
+        if (keyDown && !renderToggleKeyDown_ && splatRenderer_) {
+            printRenderModeStats();
+            renderMode_ = renderMode_ == RENDER_POINTS ? RENDER_SPLATS : RENDER_POINTS;
+            PARTICULAS_LOG(Info) << "[Render] Switched to " << (renderMode_ == RENDER_SPLATS ? "splat" : "point-list") << " renderer.";
+        }
+        renderToggleKeyDown_ = keyDown;
+    }
+
+    // P: cambia el tamaño de punto, B: el modo de mezcla. La variante se compila en segundo plano
+    // y se adopta en cuanto está lista; hasta entonces se sigue dibujando con la actual.
+    void handlePipelineVariantKeys() {
+        if (!pipelineVariants_) return;
+        bool pointKeyDown = window_->isKeyPressed(GLFW_KEY_P);
+        bool blendKeyDown = window_->isKeyPressed(GLFW_KEY_B);
+        particulas::PipelineVariantKey variant = pipelineVariants_->getRequested();
+        if (pointKeyDown && !pointSizeKeyDown_) {
+            variant.pointSize = variant.pointSize >= 8.0f ? 1.0f : variant.pointSize * 2.0f;
+            pipelineVariants_->request(variant);
+        }
+        if (blendKeyDown && !blendKeyDown_) {
+            variant.blendMode = static_cast<particulas::BlendMode>((static_cast<uint32_t>(variant.blendMode) + 1) % 3);
+            pipelineVariants_->request(variant);
+        }
+        pointSizeKeyDown_ = pointKeyDown;
+        blendKeyDown_ = blendKeyDown;
+        if (pipelineVariants_->update()) {
+            const particulas::PipelineVariantKey& current = pipelineVariants_->getCurrent().getVariant();
+            PARTICULAS_LOG(Info) << "[Render] Pipeline variant: point size " << current.pointSize << ", blend mode "
+                      << static_cast<uint32_t>(current.blendMode) << " (" << pipelineVariants_->getVariantCount() << " compiled).";
+        }
+    }
+
+    // Tras la fence del frame: acumula el tiempo de GPU del renderizado en el modo con el que se grabó
+    void collectRenderTiming(uint32_t frameIndex) {
+        if (!renderGraph_ || !renderGraph_->isTimingSupported()) return;
+        renderGraph_->resolveTimings(frameIndex);
+        // Coste del renderizado: splatting (si se grabó) + escena; la simulación va aparte
+        double milliseconds = renderGraph_->getPassMilliseconds(scenePass_);
+        if (milliseconds <= 0.0) return; // Slot aún sin frame grabado
+        if (splatPass_ != NO_PASS) milliseconds += renderGraph_->getPassMilliseconds(splatPass_);
+        // En GPU se grabó la capacidad; el número dibujado llega por la copia del frame, ya terminado
+        if (gpuParticles_) timedParticles_[frameIndex] = gpuParticles_->getVisibleCount(frameIndex);
+        RenderModeStats& stats = renderStats_[timedRenderMode_[frameIndex]];
+        stats.gpuMilliseconds += milliseconds;
+        stats.particles += timedParticles_[frameIndex];
+        ++stats.frames;
+    }
+
+    void printRenderModeStats() const {
+        particulas::Logger::flush();
+        const char* names[RENDER_MODE_COUNT] = {"point-list", "splat"};
+        for (int mode = 0; mode < RENDER_MODE_COUNT; ++mode) {
+            const RenderModeStats& stats = renderStats_[mode];
+            if (stats.frames == 0) continue;
+            std::cout << "[Render] " << names[mode] << ": frames=" << stats.frames
+                      << " avgGpuMs=" << std::fixed << std::setprecision(3) << stats.gpuMilliseconds / stats.frames
+                      << " nsPerParticle=" << std::setprecision(4) << (stats.particles > 0.0 ? stats.gpuMilliseconds * 1e6 / stats.particles : 0.0)
+                      << std::defaultfloat << std::endl;
+        }
+    }
+
     // --- Recreación del Swapchain ---
-    void cleanupSwapchainRelated() { /* ... (código como antes) ... */ }
-    void recreateSwapchain() { /* ... (código como antes) ... */ }
+    void cleanupSwapchainRelated() {
+        if (!device_) return;
+        VkDevice device = device_->getLogicalDevice();
+        for (VkFramebuffer framebuffer : swapchainFramebuffers_) vkDestroyFramebuffer(device, framebuffer, nullptr);
+        swapchainFramebuffers_.clear();
+        destroyDepthResources();
+    }
+
+    // Swapchain obsoleto o subóptimo (p. ej. al minimizar o cambiar de pantalla). Minimizada, el
+    // framebuffer mide 0x0 y no se puede crear un swapchain: se espera a que vuelva a tener tamaño.
+    void recreateSwapchain() {
+        VkExtent2D framebufferExtent = window_->getFramebufferExtent();
+        while ((framebufferExtent.width == 0 || framebufferExtent.height == 0) && !window_->shouldClose()) {
+            window_->waitEvents();
+            framebufferExtent = window_->getFramebufferExtent();
+        }
+        if (window_->shouldClose()) return;
+        VkExtent2D previousExtent = swapchain_->getExtent();
+        rebuildSwapchain(swapchain_->getPresentMode());
+        VkExtent2D extent = swapchain_->getExtent();
+        if (extent.width != previousExtent.width || extent.height != previousExtent.height) resizeSimulationViews();
+    }
+
+    // Lo que depende del tamaño del swapchain en la simulación: la vista de la cámara, el
+    // acumulador de splats (y con él el grafo, que importa su imagen y dimensiona sus scratch) y
+    // las copias de la captura. Con la GPU parada (tras rebuildSwapchain).
+    void resizeSimulationViews() {
+        if (!particleSystem_) return; // Sin simulación (applyScenario la crea ya con el tamaño nuevo)
+        VkExtent2D extent = swapchain_->getExtent();
+        camera_->setViewportSize(static_cast<float>(extent.width), static_cast<float>(extent.height));
+        renderGraph_.reset();
+        simulatePass_ = splatPass_ = scenePass_ = capturePass_ = overlayPass_ = NO_PASS;
+        if (splatRenderer_) {
+            glm::vec2 domainSize(particleSystem_->getWidth(), particleSystem_->getHeight());
+            splatRenderer_.reset();
+            splatRenderer_ = std::make_unique<particulas::SplatRenderer>(*device_, *commandPool_, renderPass_->get(), extent,
+                static_cast<uint32_t>(particleSystem_->getCapacity()), domainSize, *speciesBuffer_, pipelineCache_->get());
+        }
+        if (frameCapture_) {
+            // Las copias pendientes del tamaño anterior se escriben al destruirla. Un flujo crudo no
+            // puede cambiar de tamaño a mitad: ahí la captura termina.
+            uint64_t seenFrames = frameCapture_->getSeenFrames();
+            uint64_t capturedFrames = frameCapture_->getRequestedFrames();
+            bool finished = frameCapture_->isFinished();
+            frameCapture_.reset();
+            if (FRAME_CAPTURE_FORMAT != particulas::CaptureFormat::PngSequence) {
+                PARTICULAS_LOG(Warning) << "[Capture] Swapchain resized to " << extent.width << "x" << extent.height << "; raw capture stopped.";
+            } else if (!finished) {
+                createFrameCapture(seenFrames, capturedFrames);
+            }
+        }
+        createRenderGraph();
+        applyQualityLevels(); // La escala de render del controlador, en el acumulador nuevo
+    }
 
     // --- Implementación de Funciones Auxiliares para Métricas --- NUEVO ---
 
@@ -476,6 +1879,23 @@ private:
         #endif
     }
 
+    // Memoria residente del proceso (Linux: /proc/self/statm); 0 si no se puede leer. Con read() y
+    // un buffer en la pila: se llama desde el bucle de frame y un ifstream reservaría memoria.
+    uint64_t getResidentBytes() {
+        #ifdef __linux__
+            int fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return 0;
+            char buffer[128];
+            ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+            close(fd);
+            if (length <= 0) return 0;
+            buffer[length] = '\0';
+            unsigned long long totalPages = 0, residentPages = 0;
+            if (std::sscanf(buffer, "%llu %llu", &totalPages, &residentPages) == 2) return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        #endif
+        return 0;
+    }
+
     std::string generateFilename() {
         std::string timestamp = getTimestamp(runStartTime_);
         std::string username = getUsername();
@@ -486,13 +1906,13 @@ private:
     }
 
     void saveMetricsToFile() {
-        std::cout << "[Metrics] Entering saveMetricsToFile(). "
-                  << "metricsSaved_ = " << std::boolalpha << metricsSaved_
-                  << ", frameRenderTimesSeconds_.empty() = " << std::boolalpha <<frameRenderTimesSeconds_.empty();
+        PARTICULAS_LOG(Info) << "[Metrics] Entering saveMetricsToFile(). "
+                  << "metricsSaved_ = " << metricsSaved_
+                  << ", frameRenderTimesSeconds_.empty() = " << frameRenderTimesSeconds_.empty();
                 //  << ", frameTimesSeconds_.size() = " << frameTimesSeconds_.size() << std::endl;
     
          if (metricsSaved_ || frameRenderTimesSeconds_.empty()) {
-            std::cout << "[Metrics] Skipping: " << (metricsSaved_ ? "Metrics already saved." : "No frame times recorded.") << std::endl;
+            PARTICULAS_LOG(Info) << "[Metrics] Skipping: " << (metricsSaved_ ? "Metrics already saved." : "No frame times recorded.");
             return; // Salir si ya se guardó o no hay datos
         }
     
@@ -501,30 +1921,30 @@ private:
         
         try {
             std::filesystem::path dirPath = metricsDir;
-            std::cout << "[Metrics] Checking directory existence: " << dirPath.string() << std::endl;
+            PARTICULAS_LOG(Info) << "[Metrics] Checking directory existence: " << dirPath.string();
     
             if (!std::filesystem::exists(dirPath)) {
-                std::cout << "[Metrics] Directory does not exist. Attempting to create..." << std::endl;
+                PARTICULAS_LOG(Info) << "[Metrics] Directory does not exist. Attempting to create...";
                 if (std::filesystem::create_directory(dirPath)) {
-                    std::cout << "[Metrics] Created directory: " << dirPath.string() << std::endl;
+                    PARTICULAS_LOG(Info) << "[Metrics] Created directory: " << dirPath.string();
                 } else {
-                    std::cerr << "[Metrics] Error: Could not create directory. Saving in the current directory." << std::endl;
+                    PARTICULAS_LOG(Warning) << "[Metrics] Error: Could not create directory. Saving in the current directory.";
                     metricsDir = "."; // Fallback to current directory
                     dirPath = metricsDir;
                 }
             } else {
-                std::cout << "[Metrics] Directory exists." << std::endl;
+                PARTICULAS_LOG(Info) << "[Metrics] Directory exists.";
             }
     
             std::filesystem::path fullPath = dirPath / filename;
-            std::cout << "[Metrics] Full file path: " << fullPath.string() << std::endl;
+            PARTICULAS_LOG(Info) << "[Metrics] Full file path: " << fullPath.string();
     
             std::ofstream outFile(fullPath);
             if (!outFile.is_open()) {
-                std::cerr << "[Metrics] Error opening file for writing: " << fullPath.string() << std::endl;
+                PARTICULAS_LOG(Warning) << "[Metrics] Error opening file for writing: " << fullPath.string();
                 return;
             } else {
-                std::cout << "[Metrics] File opened successfully." << std::endl;
+                PARTICULAS_LOG(Info) << "[Metrics] File opened successfully.";
             }
     
             outFile << "# METRICS DATA\n" 
@@ -533,9 +1953,17 @@ private:
                     << "# User: " << getUsername() << "\n" 
                     << "# Hostname: " << getHostname() << "\n" 
                     << "# GPU: " << gpuName_ << "\n"
-                    << "# Requested Particle Count: " << PARTICLE_COUNT << "\n" 
-                    << "# Actual Particle Count: " << (particleSystem_ ? std::to_string(particleSystem_->getParticleCount()) : "N/A") << "\n"
-                    << "# Frame Count Recorded: " << frameRenderTimesSeconds_.size() << "\n\n"
+                    << "# Requested Particle Count: " << scenario_.particleCount << "\n" 
+                    << "# Actual Particle Count: " << (particleSystem_ ? std::to_string(particleSystem_->getLiveParticleCount()) : "N/A") << "\n"
+                    << "# Particle Capacity: " << (particleSystem_ ? std::to_string(particleSystem_->getCapacity()) : "N/A") << "\n";
+            for (uint32_t heap = 0; heap < gpuHeapCount_; ++heap) {
+                outFile << "# GPU Heap " << heap << (gpuMemoryBudget_[heap].deviceLocal ? " (device local)" : "") << ": usage "
+                        << (gpuMemoryBudget_[heap].usage >> 20) << " MiB / budget " << (gpuMemoryBudget_[heap].budget >> 20) << " MiB / size "
+                        << (gpuMemoryBudget_[heap].size >> 20) << " MiB" << (device_ && device_->supportsMemoryBudget() ? "" : " (estimated)") << "\n";
+            }
+            outFile
+                    << "# Frame Count Recorded: " << frameRenderTimesSeconds_.size() << "\n"
+                    << "# Frames Not Recorded (buffer full): " << unrecordedFrames_ << "\n\n"
                     << "FrameRenderTime_s\n";
     
             outFile << std::fixed << std::setprecision(20);
@@ -545,25 +1973,49 @@ private:
     
             outFile.close();
             metricsSaved_ = true;
-            std::cout << "[Metrics] Metrics saved successfully (" <<  frameRenderTimesSeconds_.size() << " frames)." << std::endl;
+            if (perfCounters_) savePerfCountersToFile(dirPath / (fullPath.stem().string() + "_perf.csv"));
+            if (ensemble_) saveEnsembleMetricsToFile(dirPath / (fullPath.stem().string() + "_ensemble.csv"));
+            if (qualityController_) saveQualityDecisionsToFile(dirPath / (fullPath.stem().string() + "_quality.csv"));
+            PARTICULAS_LOG(Info) << "[Metrics] Metrics saved successfully (" <<  frameRenderTimesSeconds_.size() << " frames).";
     
         } catch (const std::filesystem::filesystem_error& fs_err) {
-            std::cerr << "[Metrics] Filesystem error: " << fs_err.what() << " Path1: " << fs_err.path1().string() << " Path2: " << fs_err.path2().string() << std::endl;
+            PARTICULAS_LOG(Warning) << "[Metrics] Filesystem error: " << fs_err.what() << " Path1: " << fs_err.path1().string() << " Path2: " << fs_err.path2().string();
         } catch (const std::exception& e) {
-            std::cerr << "[Metrics] Exception: " << e.what() << std::endl;
+            PARTICULAS_LOG(Warning) << "[Metrics] Exception: " << e.what();
         } catch (...) {
-            std::cerr << "[Metrics] Unknown error." << std::endl;
+            PARTICULAS_LOG(Warning) << "[Metrics] Unknown error.";
         }
     }
 
 }; // Fin de la clase ParticleSimulationApp
 
 // --- Punto de Entrada ---
-int main() {
+// ParticleSimulation [escenarios.txt]: sin argumentos, modo interactivo con las constantes de arriba;
+// con un fichero de escenarios, los ejecuta todos seguidos y guarda la tabla de resultados
+int main(int argc, char** argv) {
+    if (argc > 2) {
+        std::cerr << "Usage: " << argv[0] << " [scenarios.txt]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<particulas::Scenario> scenarios;
+    if (argc == 2) {
+        // Antes de crear la ventana: un error de sintaxis no debe costar el arranque de Vulkan
+        try { scenarios = particulas::loadScenarios(argv[1]); }
+        catch (const std::exception& e) { std::cerr << "Error: " << e.what() << std::endl; return EXIT_FAILURE; }
+        std::cout << "Loaded " << scenarios.size() << " scenarios from " << argv[1] << std::endl;
+    }
+    if (RUN_CONSTRAINT_BENCHMARK) {
+        particulas::ThreadPool benchmarkPool;
+        particulas::runConstraintBenchmark(&benchmarkPool);
+    }
+    if (RUN_MORTON_BENCHMARK) {
+        particulas::ThreadPool benchmarkPool;
+        particulas::runMortonBenchmark(&benchmarkPool);
+    }
     ParticleSimulationApp app;
-    try { app.run(); }
-    catch (const std::exception& e) { std::cerr << "FATAL ERROR (std::exception): " << e.what() << std::endl; return EXIT_FAILURE; }
-    catch (...) { std::cerr << "FATAL ERROR: Unknown exception caught!" << std::endl; return EXIT_FAILURE; }
-    std::cout << "Application finished successfully." << std::endl;
+    try { app.run(scenarios); }
+    catch (const std::exception& e) { PARTICULAS_LOG(Error) << "FATAL ERROR (std::exception): " << e.what(); return EXIT_FAILURE; }
+    catch (...) { PARTICULAS_LOG(Error) << "FATAL ERROR: Unknown exception caught!"; return EXIT_FAILURE; }
+    PARTICULAS_LOG(Info) << "Application finished successfully.";
     return EXIT_SUCCESS;
 }
\ No newline at end of file
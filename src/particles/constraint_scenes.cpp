@@ -0,0 +1,130 @@
+#include "constraint_scenes.hpp"
+#include "particle_system.hpp"
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+constexpr int GRID_SHADE_BANDS = 4; // Especies (bandas de color) de la malla, de arriba abajo
+
+Particle makeStaticParticle(glm::vec2 position, SpeciesId species) {
+    Particle particle{};
+    particle.position = position;
+    particle.velocity = glm::vec2(0.0f, 0.0f);
+    particle.species = species;
+    return particle;
+}
+
+Species makeSceneSpecies(glm::vec4 color) {
+    Species species;
+    species.color = color;
+    return species;
+}
+}
+
+ConstraintScene makeChainScene(int chainCount, int linksPerChain, float width, float height) {
+    if (chainCount <= 0 || linksPerChain < 2) throw std::invalid_argument("Chain scene needs at least one chain of two links.");
+    ConstraintScene scene;
+    scene.species.push_back(makeSceneSpecies({0.9f, 0.7f, 0.2f, 1.0f}));
+    scene.particles.reserve(static_cast<size_t>(chainCount) * linksPerChain);
+    scene.constraints.reserve(static_cast<size_t>(chainCount) * (linksPerChain - 1));
+
+    float spacingX = width / static_cast<float>(chainCount + 1);
+    float linkLength = std::min(4.0f, (height * 0.8f) / static_cast<float>(linksPerChain));
+    for (int chain = 0; chain < chainCount; ++chain) {
+        float x = spacingX * static_cast<float>(chain + 1);
+        uint32_t first = static_cast<uint32_t>(scene.particles.size());
+        for (int link = 0; link < linksPerChain; ++link) {
+            scene.particles.push_back(makeStaticParticle({x, 4.0f + linkLength * link}, 0));
+            if (link > 0) {
+                uint32_t index = first + static_cast<uint32_t>(link);
+                scene.constraints.push_back({index - 1, index, linkLength, 0.0f});
+            }
+        }
+        scene.pinnedParticles.push_back(first);
+    }
+    return scene;
+}
+
+ConstraintScene makeGridScene(int columns, int rows, float width, float height) {
+    if (columns < 2 || rows < 2) throw std::invalid_argument("Grid scene needs at least 2x2 particles.");
+    ConstraintScene scene;
+    for (int band = 0; band < GRID_SHADE_BANDS; ++band) {
+        float shade = 0.4f + 0.6f * static_cast<float>(band) / static_cast<float>(GRID_SHADE_BANDS - 1);
+        scene.species.push_back(makeSceneSpecies({0.2f, shade, 0.9f, 1.0f}));
+    }
+    scene.particles.reserve(static_cast<size_t>(columns) * rows);
+    scene.constraints.reserve(static_cast<size_t>(columns) * rows * 2);
+
+    float spacing = std::min(width * 0.8f / static_cast<float>(columns - 1), height * 0.8f / static_cast<float>(rows - 1));
+    glm::vec2 origin = {(width - spacing * (columns - 1)) * 0.5f, height * 0.05f};
+    auto indexOf = [columns](int column, int row) { return static_cast<uint32_t>(row * columns + column); };
+
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            SpeciesId band = static_cast<SpeciesId>(row * GRID_SHADE_BANDS / rows);
+            scene.particles.push_back(makeStaticParticle(origin + glm::vec2(column * spacing, row * spacing), band));
+            if (column > 0) scene.constraints.push_back({indexOf(column - 1, row), indexOf(column, row), spacing, 1e-7f});
+            if (row > 0) scene.constraints.push_back({indexOf(column, row - 1), indexOf(column, row), spacing, 1e-7f});
+        }
+    }
+    scene.pinnedParticles.push_back(indexOf(0, 0));
+    scene.pinnedParticles.push_back(indexOf(columns - 1, 0));
+    return scene;
+}
+
+void applyScene(const ConstraintScene& scene, ConstraintSolver& solver) {
+    solver.clear();
+    for (const auto& c : scene.constraints) solver.addDistanceConstraint(c.a, c.b, c.restLength, c.compliance);
+    for (uint32_t pinned : scene.pinnedParticles) solver.setInverseMass(pinned, 0.0f);
+}
+
+void runConstraintBenchmark(ThreadPool* threadPool, int frames) {
+    const float width = 1920.0f, height = 1080.0f;
+    const float frameDelta = 1.0f / 60.0f;
+
+    struct BenchmarkCase { const char* name; ConstraintScene scene; };
+    std::vector<BenchmarkCase> cases;
+    cases.push_back({"chains 1000x256", makeChainScene(1000, 256, width, height)});
+    cases.push_back({"grid 1024x1024", makeGridScene(1024, 1024, width, height)});
+
+    std::cout << "[ConstraintBenchmark] Threads: " << (threadPool ? threadPool->getConcurrency() : 1) << std::endl;
+    for (auto& benchmarkCase : cases) {
+        size_t constraintCount = benchmarkCase.scene.constraints.size();
+        auto solver = std::make_unique<ConstraintSolver>(threadPool);
+        applyScene(benchmarkCase.scene, *solver);
+        ConstraintSolver* solverView = solver.get();
+
+        ParticleSystem system(std::move(benchmarkCase.scene.particles), width, height, 0, std::move(benchmarkCase.scene.species));
+        system.setGravity({0.0f, 98.0f});
+        system.setConstraintSolver(std::move(solver));
+
+        uint64_t totalSolves = 0;
+        double totalSolveSeconds = 0.0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            system.update(frameDelta);
+            totalSolves += solverView->getLastSolveCount();
+            totalSolveSeconds += solverView->getLastSolveSeconds();
+        }
+        double wallSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::cout << "[ConstraintBenchmark] " << std::left << std::setw(18) << benchmarkCase.name << std::right
+                  << " constraints=" << constraintCount
+                  << " colors=" << solverView->getColorCount()
+                  << " solves/frame=" << (frames > 0 ? totalSolves / frames : 0)
+                  << " Msolves/s=" << std::fixed << std::setprecision(2)
+                  << (totalSolveSeconds > 0.0 ? totalSolves / totalSolveSeconds / 1e6 : 0.0)
+                  << " ms/frame=" << (frames > 0 ? wallSeconds * 1000.0 / frames : 0.0)
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+} // namespace particulas
@@ -0,0 +1,36 @@
+#ifndef PARTICULAS_PARTICLES_CONSTRAINT_SCENES_HPP
+#define PARTICULAS_PARTICLES_CONSTRAINT_SCENES_HPP
+
+#include "particle.hpp"
+#include "constraint_solver.hpp"
+
+#include <vector>
+
+namespace particulas {
+
+class ThreadPool;
+
+// Escena de prueba para el solver de restricciones: partículas + restricciones + partículas fijas
+struct ConstraintScene {
+    std::vector<Species> species;     // Tabla de especies a la que apuntan las partículas
+    std::vector<Particle> particles;
+    std::vector<DistanceConstraint> constraints;
+    std::vector<uint32_t> pinnedParticles;
+};
+
+// chainCount cuerdas verticales de linksPerChain eslabones, colgadas del borde superior
+ConstraintScene makeChainScene(int chainCount, int linksPerChain, float width, float height);
+
+// Malla tipo tela de columns x rows con restricciones horizontales y verticales,
+// fijada por las esquinas superiores
+ConstraintScene makeGridScene(int columns, int rows, float width, float height);
+
+// Copia restricciones y masas fijas de la escena al solver
+void applyScene(const ConstraintScene& scene, ConstraintSolver& solver);
+
+// Ejecuta frames de simulación sin ventana e imprime el rendimiento en resoluciones/segundo
+void runConstraintBenchmark(ThreadPool* threadPool, int frames = 120);
+
+} // namespace particulas
+
+#endif // PARTICULAS_PARTICLES_CONSTRAINT_SCENES_HPP
@@ -0,0 +1,205 @@
+#include "constraint_solver.hpp"
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+// Tamaño de bloque para repartir un lote de color entre hilos.
+// Lo bastante grande para amortizar el reparto, lo bastante pequeño para balancear.
+constexpr size_t SOLVE_GRAIN_SIZE = 2048;
+}
+
+ConstraintSolver::ConstraintSolver(ThreadPool* threadPool)
+    : threadPool_(threadPool) {}
+
+void ConstraintSolver::addDistanceConstraint(uint32_t a, uint32_t b, float restLength, float compliance) {
+    if (a == b) throw std::invalid_argument("Distance constraint needs two different particles.");
+    if (restLength < 0.0f || compliance < 0.0f) throw std::invalid_argument("Rest length and compliance must be non-negative.");
+    constraints_.push_back({a, b, restLength, compliance});
+    coloringDirty_ = true;
+}
+
+void ConstraintSolver::clear() {
+    constraints_.clear();
+    colored_.clear();
+    lambdas_.clear();
+    colorOffsets_.clear();
+    inverseMasses_.clear();
+    constrainedParticles_.clear();
+    coloringDirty_ = true;
+}
+
+size_t ConstraintSolver::getColorCount() const {
+    return colorOffsets_.empty() ? 0 : colorOffsets_.size() - 1;
+}
+
+void ConstraintSolver::remapParticles(const std::vector<uint32_t>& newIndexOf, size_t oldCount) {
+    constexpr uint32_t removed = 0xFFFFFFFFu;
+    auto mapIndex = [&](uint32_t index) { return index < oldCount ? newIndexOf[index] : removed; };
+
+    size_t write = 0;
+    for (const auto& c : constraints_) {
+        uint32_t a = mapIndex(c.a), b = mapIndex(c.b);
+        if (a == removed || b == removed) continue;
+        constraints_[write++] = {a, b, c.restLength, c.compliance};
+    }
+    constraints_.resize(write);
+
+    remappedMasses_.clear();
+    for (size_t old = 0; old < inverseMasses_.size(); ++old) {
+        uint32_t target = mapIndex(static_cast<uint32_t>(old));
+        if (target == removed) continue;
+        if (target >= remappedMasses_.size()) remappedMasses_.resize(target + 1, 1.0f);
+        remappedMasses_[target] = inverseMasses_[old];
+    }
+    inverseMasses_.swap(remappedMasses_);
+    coloringDirty_ = true;
+}
+
+void ConstraintSolver::setInverseMass(uint32_t particle, float inverseMass) {
+    if (inverseMass < 0.0f) throw std::invalid_argument("Inverse mass must be non-negative.");
+    if (particle >= inverseMasses_.size()) inverseMasses_.resize(particle + 1, 1.0f);
+    inverseMasses_[particle] = inverseMass;
+}
+
+float ConstraintSolver::inverseMassOf(uint32_t particle) const {
+    return particle < inverseMasses_.size() ? inverseMasses_[particle] : 1.0f;
+}
+
+// Coloreado voraz: cada restricción toma el menor color que no use ninguna de sus dos partículas.
+// Las máscaras de colores usados se guardan por partícula en palabras de 64 bits; si algún nodo
+// supera el número de colores disponibles se repite con más palabras.
+void ConstraintSolver::rebuildColoring() {
+    uint32_t particleCount = 0;
+    for (const auto& c : constraints_) particleCount = std::max(particleCount, std::max(c.a, c.b) + 1);
+
+    std::vector<uint32_t>& colorOf = colorOf_;
+    colorOf.assign(constraints_.size(), 0);
+    uint32_t colorCount = 0;
+    for (size_t words = 1;; words *= 2) {
+        std::vector<uint64_t>& used = usedColors_;
+        used.assign(static_cast<size_t>(particleCount) * words, 0);
+        bool overflow = false;
+        colorCount = 0;
+        for (size_t i = 0; i < constraints_.size() && !overflow; ++i) {
+            uint64_t* maskA = &used[constraints_[i].a * words];
+            uint64_t* maskB = &used[constraints_[i].b * words];
+            overflow = true;
+            for (size_t w = 0; w < words; ++w) {
+                uint64_t freeBits = ~(maskA[w] | maskB[w]);
+                if (freeBits == 0) continue;
+                uint32_t bit = 0;
+                while (!(freeBits & (uint64_t{1} << bit))) ++bit;
+                uint32_t color = static_cast<uint32_t>(w * 64 + bit);
+                maskA[w] |= uint64_t{1} << bit;
+                maskB[w] |= uint64_t{1} << bit;
+                colorOf[i] = color;
+                colorCount = std::max(colorCount, color + 1);
+                overflow = false;
+                break;
+            }
+        }
+        if (!overflow) break;
+    }
+
+    // Ordenar por color (counting sort estable) para que cada lote sea contiguo en memoria
+    colorOffsets_.assign(colorCount + 1, 0);
+    for (uint32_t color : colorOf) ++colorOffsets_[color + 1];
+    for (uint32_t c = 0; c < colorCount; ++c) colorOffsets_[c + 1] += colorOffsets_[c];
+    std::vector<size_t>& cursor = colorCursor_;
+    cursor.assign(colorOffsets_.begin(), colorOffsets_.end() - 1);
+    colored_.resize(constraints_.size());
+    for (size_t i = 0; i < constraints_.size(); ++i) colored_[cursor[colorOf[i]]++] = constraints_[i];
+    lambdas_.assign(colored_.size(), 0.0f);
+
+    // Lista de partículas con al menos una restricción (para endSubstep)
+    std::vector<uint8_t>& touched = touched_;
+    touched.assign(particleCount, 0);
+    for (const auto& c : constraints_) { touched[c.a] = 1; touched[c.b] = 1; }
+    constrainedParticles_.clear();
+    for (uint32_t i = 0; i < particleCount; ++i) if (touched[i]) constrainedParticles_.push_back(i);
+    coloringDirty_ = false;
+}
+
+void ConstraintSolver::beginSubstep(const std::vector<Particle>& particles) {
+    previousPositions_.resize(particles.size());
+    for (size_t i = 0; i < particles.size(); ++i) previousPositions_[i] = particles[i].position;
+}
+
+void ConstraintSolver::solveRange(std::vector<Particle>& particles, size_t begin, size_t end, float alphaScale) {
+    for (size_t i = begin; i < end; ++i) {
+        const DistanceConstraint& c = colored_[i];
+        Particle& pa = particles[c.a];
+        Particle& pb = particles[c.b];
+        float wa = inverseMassOf(c.a);
+        float wb = inverseMassOf(c.b);
+        float alpha = c.compliance * alphaScale;
+        float wSum = wa + wb + alpha;
+        if (wSum <= 0.0f) continue;
+
+        glm::vec2 delta = pa.position - pb.position;
+        float length = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+        if (length < 1e-6f) continue;
+        glm::vec2 normal = delta / length;
+
+        float constraintError = length - c.restLength;
+        float deltaLambda = (-constraintError - alpha * lambdas_[i]) / wSum;
+        lambdas_[i] += deltaLambda;
+        pa.position += normal * (wa * deltaLambda);
+        pb.position -= normal * (wb * deltaLambda);
+    }
+}
+
+void ConstraintSolver::solve(std::vector<Particle>& particles, float substepDelta) {
+    if (constraints_.empty() || substepDelta <= 0.0f) return;
+    if (coloringDirty_) rebuildColoring();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::fill(lambdas_.begin(), lambdas_.end(), 0.0f);
+    float alphaScale = 1.0f / (substepDelta * substepDelta); // alpha~ = compliance / h^2
+
+    for (int iteration = 0; iteration < iterations_; ++iteration) {
+        for (size_t color = 0; color + 1 < colorOffsets_.size(); ++color) {
+            size_t begin = colorOffsets_[color];
+            size_t end = colorOffsets_[color + 1];
+            if (threadPool_) {
+                threadPool_->parallelFor(begin, end, SOLVE_GRAIN_SIZE, [&](size_t chunkBegin, size_t chunkEnd) {
+                    solveRange(particles, chunkBegin, chunkEnd, alphaScale);
+                });
+            } else {
+                solveRange(particles, begin, end, alphaScale);
+            }
+        }
+    }
+
+    lastSolveCount_ += static_cast<uint64_t>(colored_.size()) * iterations_;
+    lastSolveSeconds_ += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void ConstraintSolver::endSubstep(std::vector<Particle>& particles, float substepDelta) {
+    if (substepDelta <= 0.0f || previousPositions_.size() != particles.size() || coloringDirty_) return;
+    float invDelta = 1.0f / substepDelta;
+    // Solo las partículas con restricciones derivan su velocidad de la corrección;
+    // las libres conservan la velocidad (y el rebote en los bordes) del integrador normal.
+    auto body = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t index = constrainedParticles_[i];
+            Particle& p = particles[index];
+            if (inverseMassOf(index) == 0.0f) {
+                p.position = previousPositions_[index]; // Partícula fija
+                p.velocity = glm::vec2(0.0f, 0.0f);
+            } else {
+                p.velocity = (p.position - previousPositions_[index]) * invDelta;
+            }
+        }
+    };
+    if (threadPool_) threadPool_->parallelFor(0, constrainedParticles_.size(), SOLVE_GRAIN_SIZE, body);
+    else body(0, constrainedParticles_.size());
+}
+
+} // namespace particulas
@@ -0,0 +1,90 @@
+#ifndef PARTICULAS_PARTICLES_CONSTRAINT_SOLVER_HPP
+#define PARTICULAS_PARTICLES_CONSTRAINT_SOLVER_HPP
+
+#include "particle.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace particulas {
+
+class ThreadPool;
+
+// Restricción de distancia entre dos partículas (cuerdas, telas, cuerpos blandos)
+struct DistanceConstraint {
+    uint32_t a;          // Índice de la primera partícula
+    uint32_t b;          // Índice de la segunda partícula
+    float restLength;    // Distancia de reposo
+    float compliance;    // Inversa de la rigidez (XPBD). 0 = restricción rígida (PBD clásico)
+};
+
+// Solver XPBD con grafo de restricciones coloreado.
+// Dos restricciones del mismo color nunca comparten partícula, así que cada lote de color
+// se resuelve en paralelo sin atómicos.
+class ConstraintSolver {
+public:
+    explicit ConstraintSolver(ThreadPool* threadPool = nullptr);
+
+    // --- Almacén de restricciones ---
+    void addDistanceConstraint(uint32_t a, uint32_t b, float restLength, float compliance = 0.0f);
+    void clear();
+    bool empty() const { return constraints_.empty(); }
+    size_t getConstraintCount() const { return constraints_.size(); }
+    size_t getColorCount() const;
+
+    // Reasigna índices tras una compactación: newIndexOf[old] (0xFFFFFFFF = eliminada).
+    // Las restricciones que tocan partículas eliminadas se descartan.
+    void remapParticles(const std::vector<uint32_t>& newIndexOf, size_t oldCount);
+
+    // Masa inversa por partícula (0 = partícula fija). Por defecto 1.
+    void setInverseMass(uint32_t particle, float inverseMass);
+
+    // --- Configuración ---
+    void setIterations(int iterations) { iterations_ = iterations > 0 ? iterations : 1; }
+    void setSubsteps(int substeps) { substeps_ = substeps > 0 ? substeps : 1; }
+    int getIterations() const { return iterations_; }
+    int getSubsteps() const { return substeps_; }
+
+    // --- Paso de simulación (llamado por ParticleSystem en cada subpaso) ---
+    // beginSubstep guarda las posiciones previas; solve proyecta las restricciones;
+    // endSubstep deriva las velocidades de la corrección de posición.
+    void beginSubstep(const std::vector<Particle>& particles);
+    void solve(std::vector<Particle>& particles, float substepDelta);
+    void endSubstep(std::vector<Particle>& particles, float substepDelta);
+
+    // --- Estadísticas del último frame ---
+    uint64_t getLastSolveCount() const { return lastSolveCount_; }
+    double getLastSolveSeconds() const { return lastSolveSeconds_; }
+    void resetFrameStats() { lastSolveCount_ = 0; lastSolveSeconds_ = 0.0; }
+
+private:
+    void rebuildColoring();
+    void solveRange(std::vector<Particle>& particles, size_t begin, size_t end, float alphaScale);
+    float inverseMassOf(uint32_t particle) const;
+
+    ThreadPool* threadPool_;
+    std::vector<DistanceConstraint> constraints_;    // Orden de inserción
+    std::vector<DistanceConstraint> colored_;        // Ordenadas por color (contiguas)
+    std::vector<float> lambdas_;                     // Multiplicadores XPBD (paralelos a colored_)
+    std::vector<size_t> colorOffsets_;               // colored_[colorOffsets_[c], colorOffsets_[c+1])
+    std::vector<float> inverseMasses_;
+    std::vector<uint32_t> constrainedParticles_;     // Partículas con al menos una restricción
+    std::vector<glm::vec2> previousPositions_;
+    bool coloringDirty_ = true;
+    // Temporales de remapParticles y rebuildColoring: se reutilizan para no reservar en cada compactación
+    std::vector<float> remappedMasses_;
+    std::vector<uint32_t> colorOf_;
+    std::vector<uint64_t> usedColors_;
+    std::vector<size_t> colorCursor_;
+    std::vector<uint8_t> touched_;
+
+    int iterations_ = 4;
+    int substeps_ = 2;
+
+    uint64_t lastSolveCount_ = 0;
+    double lastSolveSeconds_ = 0.0;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_PARTICLES_CONSTRAINT_SOLVER_HPP
@@ -0,0 +1,193 @@
+#include "domain_decomposition.hpp"
+#include "particle_system.hpp"
+#include "utils/domain_transport.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace particulas {
+
+static_assert(std::is_trivially_copyable<Particle>::value, "Particles travel between processes as raw bytes");
+
+DomainDecomposition::DomainDecomposition(ParticleSystem& system, DomainTransport& transport, const DomainDecompositionSettings& settings)
+    : system_(system), transport_(transport), settings_(settings),
+      rank_(transport.getRank()), rankCount_(transport.getRankCount()) {
+    if (system.getConstraintSolver() && !system.getConstraintSolver()->empty()) {
+        throw std::invalid_argument("Domain decomposition does not support constraints between particles.");
+    }
+    if (settings.haloWidth < 0.0f || settings.histogramBins == 0) {
+        throw std::invalid_argument("Domain decomposition: halo width must be non-negative and the histogram needs bins.");
+    }
+    boundaries_ = makeUniformBoundaries(system.getWidth(), rankCount_);
+    if (rank_ > 0) neighbors_.push_back(rank_ - 1);
+    if (rank_ + 1 < rankCount_) neighbors_.push_back(rank_ + 1);
+    migrants_.resize(neighbors_.size());
+    outgoingGhosts_.resize(neighbors_.size());
+    outgoing_.resize(neighbors_.size());
+    histogram_.reserve(settings.histogramBins);
+    globalHistogram_.reserve(settings.histogramBins);
+}
+
+std::vector<float> DomainDecomposition::makeUniformBoundaries(float width, int rankCount) {
+    std::vector<float> boundaries(rankCount + 1);
+    for (int rank = 0; rank < rankCount; ++rank) boundaries[rank] = width * static_cast<float>(rank) / static_cast<float>(rankCount);
+    boundaries[rankCount] = width;
+    return boundaries;
+}
+
+// Recorre el histograma acumulado y corta donde cada franja alcanza total * r / rankCount,
+// interpolando dentro de la cubeta. Cada franja mide al menos una cubeta.
+std::vector<float> DomainDecomposition::makeBalancedBoundaries(const std::vector<uint64_t>& histogram, float width, int rankCount) {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) total += count;
+    if (total == 0 || histogram.empty()) return makeUniformBoundaries(width, rankCount);
+
+    const float binWidth = width / static_cast<float>(histogram.size());
+    std::vector<float> boundaries(rankCount + 1);
+    boundaries[0] = 0.0f;
+    boundaries[rankCount] = width;
+    size_t bin = 0;
+    uint64_t before = 0; // Partículas en las cubetas anteriores a bin
+    for (int rank = 1; rank < rankCount; ++rank) {
+        double target = static_cast<double>(total) * rank / rankCount;
+        while (bin + 1 < histogram.size() && static_cast<double>(before + histogram[bin]) < target) before += histogram[bin++];
+        double fraction = histogram[bin] > 0 ? (target - static_cast<double>(before)) / static_cast<double>(histogram[bin]) : 0.0;
+        float boundary = (static_cast<float>(bin) + static_cast<float>(std::clamp(fraction, 0.0, 1.0))) * binWidth;
+        float lowest = boundaries[rank - 1] + binWidth;
+        float highest = width - static_cast<float>(rankCount - rank) * binWidth;
+        boundaries[rank] = std::clamp(boundary, lowest, std::max(lowest, highest));
+    }
+    return boundaries;
+}
+
+void DomainDecomposition::setBoundaries(const std::vector<float>& boundaries) {
+    if (boundaries.size() != static_cast<size_t>(rankCount_) + 1 || !std::is_sorted(boundaries.begin(), boundaries.end())) {
+        throw std::invalid_argument("Domain decomposition: expected " + std::to_string(rankCount_ + 1) + " ascending boundaries.");
+    }
+    boundaries_ = boundaries;
+}
+
+void DomainDecomposition::step(float deltaTime) {
+    system_.update(deltaTime);
+    exchangeWithNeighbors();
+    ++steps_;
+    if (settings_.rebalanceInterval > 0 && steps_ % settings_.rebalanceInterval == 0) rebalance();
+}
+
+void DomainDecomposition::exchangeWithNeighbors() {
+    const int left = rank_ > 0 ? 0 : -1;
+    const int right = rank_ + 1 < rankCount_ ? (left + 1) : -1;
+    const float begin = getSlabBegin();
+    const float end = getSlabEnd();
+    for (size_t i = 0; i < neighbors_.size(); ++i) { migrants_[i].clear(); outgoingGhosts_[i].clear(); }
+
+    // Una pasada: lo que ha salido de la franja se va (al vecino de ese lado, que lo reenvía si
+    // tampoco es suyo) y lo que queda cerca de un borde se copia como fantasma
+    const std::vector<Particle>& particles = system_.getParticles();
+    const size_t particleCount = system_.getParticleCount();
+    for (size_t slot = 0; slot < particleCount; ++slot) {
+        const Particle& particle = particles[slot];
+        if (!particle.alive) continue;
+        float x = particle.position.x;
+        if (left >= 0 && x < begin) {
+            migrants_[left].push_back(particle);
+            system_.removeParticle(static_cast<uint32_t>(slot));
+        } else if (right >= 0 && x >= end) {
+            migrants_[right].push_back(particle);
+            system_.removeParticle(static_cast<uint32_t>(slot));
+        } else {
+            if (left >= 0 && x < begin + settings_.haloWidth) outgoingGhosts_[left].push_back(particle);
+            if (right >= 0 && x >= end - settings_.haloWidth) outgoingGhosts_[right].push_back(particle);
+        }
+    }
+
+    for (size_t i = 0; i < neighbors_.size(); ++i) {
+        MessageHeader header{static_cast<uint32_t>(migrants_[i].size()), static_cast<uint32_t>(outgoingGhosts_[i].size())};
+        std::vector<uint8_t>& message = outgoing_[i];
+        message.resize(sizeof(header) + (migrants_[i].size() + outgoingGhosts_[i].size()) * sizeof(Particle));
+        std::memcpy(message.data(), &header, sizeof(header));
+        std::memcpy(message.data() + sizeof(header), migrants_[i].data(), migrants_[i].size() * sizeof(Particle));
+        std::memcpy(message.data() + sizeof(header) + migrants_[i].size() * sizeof(Particle), outgoingGhosts_[i].data(),
+                    outgoingGhosts_[i].size() * sizeof(Particle));
+        migratedOut_ += migrants_[i].size();
+    }
+
+    transport_.exchange(neighbors_, outgoing_, incoming_);
+
+    ghosts_.clear();
+    for (size_t i = 0; i < neighbors_.size(); ++i) {
+        const std::vector<uint8_t>& message = incoming_[i];
+        MessageHeader header{};
+        if (message.size() >= sizeof(header)) std::memcpy(&header, message.data(), sizeof(header));
+        if (message.size() != sizeof(header) + (static_cast<size_t>(header.migrantCount) + header.ghostCount) * sizeof(Particle)) {
+            throw std::runtime_error("Domain decomposition: malformed message from rank " + std::to_string(neighbors_[i]));
+        }
+        const uint8_t* data = message.data() + sizeof(header);
+        for (uint32_t m = 0; m < header.migrantCount; ++m, data += sizeof(Particle)) {
+            Particle particle;
+            std::memcpy(&particle, data, sizeof(Particle));
+            if (system_.addParticle(particle)) ++migratedIn_;
+            else ++droppedMigrations_;
+        }
+        size_t ghostStart = ghosts_.size();
+        ghosts_.resize(ghostStart + header.ghostCount);
+        std::memcpy(ghosts_.data() + ghostStart, data, static_cast<size_t>(header.ghostCount) * sizeof(Particle));
+    }
+}
+
+// Todos los rangos reciben los mismos histogramas y hacen la misma cuenta, así que llegan a las
+// mismas fronteras sin otra ronda de mensajes
+void DomainDecomposition::rebalance() {
+    const uint32_t bins = settings_.histogramBins;
+    const float width = system_.getWidth();
+    histogram_.assign(bins, 0);
+    const std::vector<Particle>& particles = system_.getParticles();
+    for (size_t slot = 0; slot < system_.getParticleCount(); ++slot) {
+        if (!particles[slot].alive) continue;
+        int bin = static_cast<int>(particles[slot].position.x / width * static_cast<float>(bins));
+        ++histogram_[std::clamp(bin, 0, static_cast<int>(bins) - 1)];
+    }
+    histogramMessage_.resize(bins * sizeof(uint64_t));
+    std::memcpy(histogramMessage_.data(), histogram_.data(), histogramMessage_.size());
+    transport_.allGather(histogramMessage_, gathered_);
+
+    globalHistogram_.assign(bins, 0);
+    uint64_t total = 0, heaviest = 0;
+    for (const std::vector<uint8_t>& message : gathered_) {
+        if (message.size() != histogramMessage_.size()) throw std::runtime_error("Domain decomposition: ranks disagree on histogram size");
+        uint64_t rankTotal = 0;
+        for (uint32_t bin = 0; bin < bins; ++bin) {
+            uint64_t count;
+            std::memcpy(&count, message.data() + bin * sizeof(uint64_t), sizeof(count));
+            globalHistogram_[bin] += count;
+            rankTotal += count;
+        }
+        total += rankTotal;
+        heaviest = std::max(heaviest, rankTotal);
+    }
+    double mean = static_cast<double>(total) / rankCount_;
+    lastImbalance_ = mean > 0.0 ? static_cast<float>(static_cast<double>(heaviest) / mean) : 1.0f;
+    if (lastImbalance_ > settings_.rebalanceThreshold) {
+        boundaries_ = makeBalancedBoundaries(globalHistogram_, width, rankCount_);
+        ++rebalanceCount_;
+    }
+}
+
+uint64_t DomainDecomposition::getGlobalParticleCount() {
+    uint64_t local = system_.getLiveParticleCount();
+    std::vector<uint8_t> message(sizeof(local));
+    std::memcpy(message.data(), &local, sizeof(local));
+    transport_.allGather(message, gathered_);
+    uint64_t total = 0;
+    for (const std::vector<uint8_t>& received : gathered_) {
+        uint64_t count = 0;
+        if (received.size() == sizeof(count)) std::memcpy(&count, received.data(), sizeof(count));
+        total += count;
+    }
+    return total;
+}
+
+} // namespace particulas
@@ -0,0 +1,105 @@
+#ifndef PARTICULAS_PARTICLES_DOMAIN_DECOMPOSITION_HPP
+#define PARTICULAS_PARTICLES_DOMAIN_DECOMPOSITION_HPP
+
+#include "particle.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace particulas {
+
+class ParticleSystem;
+class DomainTransport;
+
+struct DomainDecompositionSettings {
+    float haloWidth = 8.0f;          // Ancho de la franja fantasma que se copia a cada vecino
+    uint32_t rebalanceInterval = 60; // Pasos entre comprobaciones de carga (0 = nunca)
+    float rebalanceThreshold = 1.25f; // Reparte de nuevo si el proceso más cargado supera media * umbral
+    uint32_t histogramBins = 1024;   // Resolución en x del reparto
+};
+
+// Reparte el dominio width x height de un ParticleSystem entre varios procesos, en franjas
+// verticales [boundaries[r], boundaries[r + 1]) una por rango. Cada proceso tiene su propio
+// ParticleSystem con las dimensiones globales (los bordes del dominio siguen siendo paredes) que
+// solo contiene las partículas de su franja; los bordes internos no son paredes.
+//
+// En cada step(), tras el update local, un único intercambio con los dos vecinos lleva:
+//  - las partículas que han salido de la franja (migración: dejan de existir aquí y se insertan
+//    allí). Una partícula que cruza más de una franja avanza una por paso, así que siempre tiene
+//    exactamente un dueño y el total se conserva;
+//  - las que están a menos de haloWidth del borde común (fantasmas de solo lectura para
+//    consultas de vecindad; no incluyen las que llegan en ese mismo paso).
+// Cada rebalanceInterval pasos los procesos comparten un histograma en x de sus partículas y,
+// si la carga está descompensada, todos calculan las mismas fronteras nuevas con el mismo
+// número de partículas por franja; las que quedan fuera migran en los pasos siguientes.
+//
+// El solver de restricciones no se admite (una restricción no puede cruzar procesos) y los
+// emisores deben configurarse solo en el rango que posee su posición. Todas las llamadas son
+// colectivas: todos los rangos deben hacer los mismos step() en el mismo orden.
+class DomainDecomposition {
+public:
+    DomainDecomposition(ParticleSystem& system, DomainTransport& transport, const DomainDecompositionSettings& settings = {});
+
+    // Franjas del mismo ancho (rankCount + 1 fronteras, de 0 a width)
+    static std::vector<float> makeUniformBoundaries(float width, int rankCount);
+    // Fronteras con el mismo número de partículas por franja según un histograma en x de [0, width)
+    static std::vector<float> makeBalancedBoundaries(const std::vector<uint64_t>& histogram, float width, int rankCount);
+    // Todos los rangos deben pasar las mismas fronteras
+    void setBoundaries(const std::vector<float>& boundaries);
+    const std::vector<float>& getBoundaries() const { return boundaries_; }
+
+    // update(deltaTime) local + migración y fantasmas + reparto periódico
+    void step(float deltaTime);
+
+    // Colectiva: partículas vivas en todos los procesos
+    uint64_t getGlobalParticleCount();
+
+    const std::vector<Particle>& getGhostParticles() const { return ghosts_; }
+    float getSlabBegin() const { return boundaries_[rank_]; }
+    float getSlabEnd() const { return boundaries_[rank_ + 1]; }
+    uint64_t getStepCount() const { return steps_; }
+    uint64_t getMigratedOut() const { return migratedOut_; }
+    uint64_t getMigratedIn() const { return migratedIn_; }
+    // Llegadas que no cupieron en el pool local (se pierden: la capacidad debe cubrir el peor reparto)
+    uint64_t getDroppedMigrations() const { return droppedMigrations_; }
+    uint32_t getRebalanceCount() const { return rebalanceCount_; }
+    float getLastImbalance() const { return lastImbalance_; } // Máximo / media en la última comprobación
+
+private:
+    // Mensaje a un vecino: [migrantes][fantasmas] + partículas
+    struct MessageHeader {
+        uint32_t migrantCount;
+        uint32_t ghostCount;
+    };
+
+    void exchangeWithNeighbors();
+    void rebalance();
+
+    ParticleSystem& system_;
+    DomainTransport& transport_;
+    DomainDecompositionSettings settings_;
+    int rank_;
+    int rankCount_;
+    std::vector<float> boundaries_;
+    std::vector<int> neighbors_;                  // Rango a la izquierda y/o a la derecha
+    std::vector<std::vector<Particle>> migrants_;       // Por vecino, reutilizados entre pasos
+    std::vector<std::vector<Particle>> outgoingGhosts_; // Ídem
+    std::vector<std::vector<uint8_t>> outgoing_;
+    std::vector<std::vector<uint8_t>> incoming_;
+    std::vector<Particle> ghosts_;
+    std::vector<uint64_t> histogram_;             // Local
+    std::vector<uint64_t> globalHistogram_;       // Suma de todos los rangos
+    std::vector<uint8_t> histogramMessage_;
+    std::vector<std::vector<uint8_t>> gathered_;
+    uint64_t steps_ = 0;
+    uint64_t migratedOut_ = 0;
+    uint64_t migratedIn_ = 0;
+    uint64_t droppedMigrations_ = 0;
+    uint32_t rebalanceCount_ = 0;
+    float lastImbalance_ = 1.0f;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_PARTICLES_DOMAIN_DECOMPOSITION_HPP
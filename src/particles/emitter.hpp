@@ -0,0 +1,27 @@
+#ifndef PARTICULAS_PARTICLES_EMITTER_HPP
+#define PARTICULAS_PARTICLES_EMITTER_HPP
+
+#include "species.hpp"
+
+#include <glm/glm.hpp>
+
+namespace particulas {
+
+// Emisor continuo de partículas con vida limitada
+struct Emitter {
+    glm::vec2 position = {0.0f, 0.0f};      // Punto de emisión en coordenadas de simulación
+    glm::vec2 direction = {0.0f, -1.0f};    // Dirección central de emisión (normalizada)
+    float spreadRadians = 0.5f;             // Apertura del cono de emisión (ángulo total)
+    float speed = 100.0f;                   // Velocidad inicial media
+    float speedJitter = 0.2f;               // Variación relativa de la velocidad [0, 1]
+    float rate = 1000.0f;                   // Partículas por segundo
+    float particleLifetime = 2.0f;          // Vida de cada partícula en segundos (> 0)
+    SpeciesId species = 0;                  // Especie de las partículas emitidas
+    bool enabled = true;
+
+    float accumulator = 0.0f;               // Fracción de partícula pendiente (uso interno)
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_PARTICLES_EMITTER_HPP
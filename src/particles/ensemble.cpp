@@ -0,0 +1,178 @@
+#include "ensemble.hpp"
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+
+namespace particulas {
+
+Ensemble::Ensemble(float width, float height, std::vector<EnsembleMemberConfig> configs, size_t speciesCount,
+                   ThreadPool* threadPool)
+    : width_(width), height_(height), threadPool_(threadPool), configs_(std::move(configs)) {
+    if (configs_.empty()) throw std::invalid_argument("Ensemble needs at least one member.");
+    bool anyEmitter = std::any_of(configs_.begin(), configs_.end(),
+                                  [](const EnsembleMemberConfig& config) { return config.emitterRate > 0.0f; });
+
+    members_.reserve(configs_.size());
+    for (const EnsembleMemberConfig& config : configs_) {
+        if (config.emitterRate < 0.0f || config.emitterLifetime <= 0.0f) {
+            throw std::invalid_argument("Ensemble member emitter needs a non-negative rate and a positive lifetime.");
+        }
+        size_t capacity = config.capacity;
+        if (capacity == 0) {
+            // Régimen estable del emisor (rate * lifetime) con un 10 % de margen para las ráfagas
+            capacity = static_cast<size_t>(config.particleCount)
+                     + static_cast<size_t>(std::ceil(config.emitterRate * config.emitterLifetime * 1.1f));
+        }
+        auto member = std::make_unique<ParticleSystem>(config.particleCount, width_, height_, capacity, speciesCount, config.seed);
+        member->setGravity(config.gravity);
+        if (anyEmitter) {
+            // Misma tabla en todos los miembros, emitan o no: packTiled los junta en un único sistema
+            Species spark;
+            spark.color = {1.0f, 0.6f, 0.2f, 1.0f};
+            spark.radius = 1.5f;
+            spark.drag = 0.5f;
+            SpeciesId sparkId = member->addSpecies(spark);
+            if (config.emitterRate > 0.0f) {
+                Emitter emitter;
+                emitter.species = sparkId;
+                emitter.position = {width_ * 0.5f, height_ * 0.5f};
+                emitter.spreadRadians = 6.2831853f; // Emisión radial
+                emitter.speed = config.emitterSpeed;
+                emitter.rate = config.emitterRate;
+                emitter.particleLifetime = config.emitterLifetime;
+                member->addEmitter(emitter);
+            }
+        }
+        member->enableMortonReorder(nullptr); // Sin pool: el paralelismo está entre miembros
+        members_.push_back(std::move(member));
+    }
+    stats_.resize(members_.size());
+    order_.resize(members_.size());
+    for (size_t i = 0; i < order_.size(); ++i) order_[i] = static_cast<uint32_t>(i);
+
+    // Rejilla lo más cuadrada posible en pantalla: el dominio ya trae su relación de aspecto
+    columns_ = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(members_.size()))));
+    rows_ = static_cast<uint32_t>((members_.size() + columns_ - 1) / columns_);
+}
+
+std::vector<EnsembleMemberConfig> Ensemble::makeGravitySweep(size_t members, int particleCount, float maxGravity,
+                                                             float emitterRate, uint32_t baseSeed) {
+    std::vector<EnsembleMemberConfig> configs(members);
+    for (size_t i = 0; i < members; ++i) {
+        EnsembleMemberConfig& config = configs[i];
+        config.seed = baseSeed + static_cast<uint32_t>(i);
+        config.particleCount = particleCount;
+        config.gravity = {0.0f, members > 1 ? maxGravity * static_cast<float>(i) / static_cast<float>(members - 1) : 0.0f};
+        config.emitterRate = (i % 2 == 1) ? emitterRate : 0.0f;
+    }
+    return configs;
+}
+
+void Ensemble::stepMember(size_t index, float deltaTime) {
+    auto start = std::chrono::high_resolution_clock::now();
+    members_[index]->update(deltaTime);
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    EnsembleMemberStats& stats = stats_[index];
+    ++stats.steps;
+    stats.simulateSeconds += seconds;
+    stats.lastStepSeconds = seconds;
+}
+
+void Ensemble::step(float deltaTime) {
+    // Primero los más caros (LPT): con reparto dinámico, los baratos rellenan los huecos del final
+    std::sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b) {
+        if (stats_[a].lastStepSeconds != stats_[b].lastStepSeconds) return stats_[a].lastStepSeconds > stats_[b].lastStepSeconds;
+        return a < b;
+    });
+    if (!threadPool_ || members_.size() == 1) {
+        for (uint32_t index : order_) stepMember(index, deltaTime);
+        return;
+    }
+    threadPool_->parallelFor(0, order_.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) stepMember(order_[i], deltaTime);
+    });
+}
+
+void Ensemble::run(uint64_t steps, float deltaTime) {
+    for (uint64_t i = 0; i < steps; ++i) step(deltaTime);
+}
+
+size_t Ensemble::getTotalCapacity() const {
+    size_t total = 0;
+    for (const auto& member : members_) total += member->getCapacity();
+    return total;
+}
+
+size_t Ensemble::getTotalLiveParticles() const {
+    size_t total = 0;
+    for (const auto& member : members_) total += member->getLiveParticleCount();
+    return total;
+}
+
+glm::vec2 Ensemble::getTiledSize() const {
+    float gap = width_ * TILE_GAP_FRACTION;
+    return {columns_ * width_ + (columns_ - 1) * gap, rows_ * height_ + (rows_ - 1) * gap};
+}
+
+glm::vec2 Ensemble::getTileOrigin(size_t index) const {
+    float gap = width_ * TILE_GAP_FRACTION;
+    uint32_t column = static_cast<uint32_t>(index % columns_);
+    uint32_t row = static_cast<uint32_t>(index / columns_);
+    return {column * (width_ + gap), row * (height_ + gap)};
+}
+
+void Ensemble::packTiled(ParticleSystem& target) const {
+    if (target.getCapacity() < getTotalCapacity()) throw std::invalid_argument("Tiled target is smaller than the ensemble capacity.");
+    target.setParticleCount(0);
+    for (size_t index = 0; index < members_.size(); ++index) {
+        glm::vec2 origin = getTileOrigin(index);
+        const std::vector<Particle>& particles = members_[index]->getParticles();
+        size_t count = members_[index]->getParticleCount();
+        for (size_t i = 0; i < count; ++i) {
+            if (!particles[i].alive) continue;
+            Particle particle = particles[i];
+            particle.position += origin;
+            target.addParticle(particle);
+        }
+    }
+}
+
+void Ensemble::writeMetricsCsv(std::ostream& out) const {
+    out << "member,seed,initial_particles,capacity,gravity_x,gravity_y,emitter_rate,steps,simulate_ms,mean_step_us,"
+           "live_particles,dropped_spawns,mean_speed,kinetic_energy,center_x,center_y\n";
+    out << std::fixed << std::setprecision(3);
+    for (size_t index = 0; index < members_.size(); ++index) {
+        const EnsembleMemberConfig& config = configs_[index];
+        const EnsembleMemberStats& stats = stats_[index];
+        const ParticleSystem& member = *members_[index];
+
+        // Estado final sobre las vivas: velocidad media, energía cinética (masa 1) y centro de masas
+        const std::vector<Particle>& particles = member.getParticles();
+        double speedSum = 0.0, energy = 0.0, centerX = 0.0, centerY = 0.0;
+        for (size_t i = 0; i < member.getParticleCount(); ++i) {
+            const Particle& particle = particles[i];
+            if (!particle.alive) continue;
+            double speed2 = static_cast<double>(particle.velocity.x) * particle.velocity.x
+                          + static_cast<double>(particle.velocity.y) * particle.velocity.y;
+            speedSum += std::sqrt(speed2);
+            energy += 0.5 * speed2;
+            centerX += particle.position.x;
+            centerY += particle.position.y;
+        }
+        size_t live = member.getLiveParticleCount();
+        double liveDivisor = live > 0 ? static_cast<double>(live) : 1.0;
+        double meanStepMicroseconds = stats.steps > 0 ? stats.simulateSeconds * 1e6 / static_cast<double>(stats.steps) : 0.0;
+
+        out << index << ',' << config.seed << ',' << config.particleCount << ',' << member.getCapacity() << ','
+            << config.gravity.x << ',' << config.gravity.y << ',' << config.emitterRate << ','
+            << stats.steps << ',' << stats.simulateSeconds * 1000.0 << ',' << meanStepMicroseconds << ','
+            << live << ',' << member.getDroppedSpawnCount() << ','
+            << speedSum / liveDivisor << ',' << energy << ',' << centerX / liveDivisor << ',' << centerY / liveDivisor << '\n';
+    }
+}
+
+} // namespace particulas
@@ -0,0 +1,96 @@
+#ifndef PARTICULAS_PARTICLES_ENSEMBLE_HPP
+#define PARTICULAS_PARTICLES_ENSEMBLE_HPP
+
+#include "particle_system.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace particulas {
+
+class ThreadPool;
+
+// Parámetros de un miembro del conjunto. Todos comparten dominio y tabla de especies.
+struct EnsembleMemberConfig {
+    uint32_t seed = 1;                  // Misma semilla y parámetros = misma trayectoria
+    int particleCount = 2000;
+    size_t capacity = 0;                // 0 = particleCount más lo que el emisor mantiene vivo
+    glm::vec2 gravity = {0.0f, 0.0f};
+    float emitterRate = 0.0f;           // Partículas por segundo desde el centro (0 = sin emisor)
+    float emitterLifetime = 2.0f;
+    float emitterSpeed = 100.0f;
+};
+
+struct EnsembleMemberStats {
+    uint64_t steps = 0;
+    double simulateSeconds = 0.0;  // Acumulado de update() de este miembro
+    double lastStepSeconds = 0.0;  // Último paso: ordena el reparto del siguiente
+};
+
+// Conjunto de simulaciones independientes (barridos de parámetros) en un mismo proceso: cada
+// step avanza todos los miembros repartiéndolos entre los hilos del pool, un miembro por bloque,
+// empezando por los que más tardaron en el paso anterior para que el último en terminar no sea
+// uno largo. Los miembros no usan el pool por dentro (parallelFor no admite anidarse).
+// Para verlos juntos se colocan en una rejilla de mosaicos sobre un único dominio (packTiled).
+class Ensemble {
+public:
+    // threadPool nulo = miembros en secuencia en el hilo que llama. Lanza std::invalid_argument
+    // si configs está vacío o algún miembro no es válido.
+    Ensemble(float width, float height, std::vector<EnsembleMemberConfig> configs,
+             size_t speciesCount = ParticleSystem::DEFAULT_SPECIES_COUNT, ThreadPool* threadPool = nullptr);
+
+    // Barrido típico: semillas baseSeed.. y gravedad hacia abajo de 0 a maxGravity; los miembros
+    // impares llevan un emisor de emitterRate partículas/s
+    static std::vector<EnsembleMemberConfig> makeGravitySweep(size_t members, int particleCount, float maxGravity,
+                                                              float emitterRate, uint32_t baseSeed = 1000);
+
+    void step(float deltaTime);
+    void run(uint64_t steps, float deltaTime);
+
+    size_t getMemberCount() const { return members_.size(); }
+    const ParticleSystem& getMember(size_t index) const { return *members_.at(index); }
+    const EnsembleMemberConfig& getConfig(size_t index) const { return configs_.at(index); }
+    const EnsembleMemberStats& getStats(size_t index) const { return stats_.at(index); }
+    size_t getTotalCapacity() const;
+    size_t getTotalLiveParticles() const;
+    const std::vector<Species>& getSpecies() const { return members_.front()->getSpecies(); }
+
+    // --- Rejilla de mosaicos ---
+    uint32_t getColumns() const { return columns_; }
+    uint32_t getRows() const { return rows_; }
+    glm::vec2 getTiledSize() const;
+    glm::vec2 getTileOrigin(size_t index) const;
+    // Sustituye el contenido de target (dominio getTiledSize, capacidad >= getTotalCapacity y la
+    // misma tabla de especies) por las partículas vivas de todos los miembros desplazadas a su
+    // mosaico, para subirlas y dibujarlas con una sola pasada. No reserva memoria.
+    void packTiled(ParticleSystem& target) const;
+
+    // Una fila por miembro: parámetros, coste medido y estado final (CSV con cabecera)
+    void writeMetricsCsv(std::ostream& out) const;
+
+    Ensemble(const Ensemble&) = delete;
+    Ensemble& operator=(const Ensemble&) = delete;
+
+private:
+    static constexpr float TILE_GAP_FRACTION = 0.04f; // Separación entre mosaicos (fracción del ancho)
+
+    void stepMember(size_t index, float deltaTime);
+
+    float width_;
+    float height_;
+    ThreadPool* threadPool_;
+    std::vector<EnsembleMemberConfig> configs_;
+    std::vector<std::unique_ptr<ParticleSystem>> members_;
+    std::vector<EnsembleMemberStats> stats_;
+    std::vector<uint32_t> order_;  // Miembros por coste del último paso, de mayor a menor
+    uint32_t columns_ = 1;
+    uint32_t rows_ = 1;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_PARTICLES_ENSEMBLE_HPP
@@ -0,0 +1,57 @@
+#ifndef PARTICULAS_PARTICLES_MORTON_REORDER_HPP
+#define PARTICULAS_PARTICLES_MORTON_REORDER_HPP
+
+#include "particle.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace particulas {
+
+class ThreadPool;
+
+// Código Morton (curva Z) de 32 bits: 16 bits por eje tras cuantizar la posición al dominio
+uint32_t mortonCode2D(const glm::vec2& position, const glm::vec2& domainSize);
+
+// Reordena el almacenamiento de partículas según su código Morton para que partículas
+// cercanas en el espacio queden cercanas en memoria. Radix sort LSD paralelo (4 pasadas de
+// 8 bits) sobre pares (código, índice) con buffers ping-pong reservados una sola vez.
+class MortonReorder {
+public:
+    explicit MortonReorder(ThreadPool* threadPool = nullptr);
+
+    // Dimensiona los buffers para hasta capacity partículas (la del pool): reorder no vuelve a
+    // reservar memoria mientras count <= capacity.
+    void reserve(size_t capacity);
+
+    // Ordena particles[0, count). newIndexOf[antiguo] = nuevo índice (debe tener tamaño >= count).
+    void reorder(std::vector<Particle>& particles, size_t count, const glm::vec2& domainSize,
+                 std::vector<uint32_t>& newIndexOf);
+
+    // Métrica de localidad: distancia media entre partículas consecutivas en memoria,
+    // relativa a la diagonal del dominio (muestreada, O(min(count, 4096))). Menor es mejor.
+    static float measureLocality(const std::vector<Particle>& particles, size_t count, const glm::vec2& domainSize);
+
+    double getLastReorderSeconds() const { return lastReorderSeconds_; }
+
+private:
+    using Histogram = std::array<uint32_t, 256>;
+
+    ThreadPool* threadPool_;
+    std::vector<uint64_t> keys_;      // (código << 32) | índice original
+    std::vector<uint64_t> keysScratch_;
+    std::vector<Particle> sorted_;
+    std::vector<Histogram> histograms_; // Uno por bloque de trabajo
+    double lastReorderSeconds_ = 0.0;
+};
+
+// Mide una pasada de vecindad (rejilla uniforme) antes y después de reordenar e imprime
+// tiempo, throughput y fallos de caché (perf_event en Linux si está disponible)
+void runMortonBenchmark(ThreadPool* threadPool, size_t particleCount = 500000);
+
+} // namespace particulas
+
+#endif // PARTICULAS_PARTICLES_MORTON_REORDER_HPP
@@ -1,17 +1,25 @@
 #ifndef PARTICULAS_PARTICLES_PARTICLE_HPP
 #define PARTICULAS_PARTICLES_PARTICLE_HPP
 
+#include "species.hpp"
+
 #include <glm/glm.hpp> // Asegúrate de que GLM esté accesible
+#include <cstdint>
 
 namespace particulas {
 
+// Color, radio y comportamiento viven en la tabla de especies (species.hpp): cada partícula
+// solo guarda su índice. 32 bytes, mismo layout que Particle en particle_struct.glsl (std430).
 struct Particle {
     glm::vec2 position;  // Posición de la partícula en el espacio 2D
     glm::vec2 velocity;  // Velocidad de la partícula (dirección y magnitud)
-    glm::vec4 color;     // Color de la partícula (RGBA)
-    float radius;        // Radio de la partícula (usado para colisiones)
+    float age = 0.0f;      // Segundos vivos desde que se emitió
+    float lifetime = 0.0f; // Vida total en segundos (0 = inmortal)
+    SpeciesId species = 0; // Índice en la tabla de especies del sistema
+    uint16_t reserved = 0; // Relleno (los shaders leen species como los 16 bits bajos de un uint)
+    uint32_t alive = 1;    // 1 = slot ocupado, 0 = slot libre del pool
 };
 
 } // namespace particulas
 
-#endif // PARTICULAS_PARTICLES_PARTICLE_HPP
\ No newline at end of file
+#endif // PARTICULAS_PARTICLES_PARTICLE_HPP
@@ -0,0 +1,81 @@
+#include "particle_distribution.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+constexpr size_t CLUSTER_COUNT = 8;
+constexpr float CLUSTER_SIGMA = 0.04f;   // Desviación de cada grumo (fracción del lado menor)
+constexpr float RING_RADIUS = 0.35f;     // Radio medio del anillo (fracción del lado menor)
+constexpr float RING_WIDTH = 0.05f;
+constexpr float BASE_SPEED = 50.0f;      // Misma velocidad base que ParticleSystem::randomizeParticle
+} // namespace
+
+const char* distributionName(ParticleDistribution distribution) {
+    switch (distribution) {
+        case ParticleDistribution::Uniform: return "uniform";
+        case ParticleDistribution::Clusters: return "clusters";
+        case ParticleDistribution::Ring: return "ring";
+    }
+    return "unknown";
+}
+
+bool parseDistribution(const std::string& name, ParticleDistribution& distribution) {
+    for (ParticleDistribution candidate : {ParticleDistribution::Uniform, ParticleDistribution::Clusters, ParticleDistribution::Ring}) {
+        if (name == distributionName(candidate)) { distribution = candidate; return true; }
+    }
+    return false;
+}
+
+std::vector<Particle> makeDistributedParticles(ParticleDistribution distribution, size_t count, float width, float height,
+                                               size_t speciesCount, uint32_t seed) {
+    if (count == 0 || speciesCount == 0) throw std::invalid_argument("Distribution needs at least one particle and one species.");
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<uint32_t> species(0, static_cast<uint32_t>(speciesCount - 1));
+    const float minSide = std::min(width, height);
+    const glm::vec2 center(width * 0.5f, height * 0.5f);
+
+    std::vector<glm::vec2> clusterCenters;
+    if (distribution == ParticleDistribution::Clusters) {
+        for (size_t i = 0; i < CLUSTER_COUNT; ++i) {
+            clusterCenters.push_back({width * (0.1f + 0.8f * unit(random)), height * (0.1f + 0.8f * unit(random))});
+        }
+    }
+    std::normal_distribution<float> clusterOffset(0.0f, CLUSTER_SIGMA * minSide);
+
+    std::vector<Particle> particles(count);
+    for (Particle& particle : particles) {
+        float angle = unit(random) * 6.2831853f;
+        glm::vec2 direction(std::cos(angle), std::sin(angle));
+        switch (distribution) {
+            case ParticleDistribution::Uniform:
+                particle.position = {unit(random) * (width - 2.0f) + 1.0f, unit(random) * (height - 2.0f) + 1.0f};
+                particle.velocity = direction * BASE_SPEED;
+                break;
+            case ParticleDistribution::Clusters: {
+                const glm::vec2& clusterCenter = clusterCenters[random() % CLUSTER_COUNT];
+                particle.position = clusterCenter + glm::vec2(clusterOffset(random), clusterOffset(random));
+                particle.velocity = direction * BASE_SPEED;
+                break;
+            }
+            case ParticleDistribution::Ring: {
+                float radius = minSide * (RING_RADIUS + RING_WIDTH * (unit(random) - 0.5f));
+                particle.position = center + direction * radius;
+                particle.velocity = glm::vec2(-direction.y, direction.x) * BASE_SPEED; // Tangente: el anillo gira
+                break;
+            }
+        }
+        // Dentro del dominio, sin tocar los bordes (como randomizeParticle)
+        particle.position.x = std::min(std::max(particle.position.x, 1.0f), width - 1.0f);
+        particle.position.y = std::min(std::max(particle.position.y, 1.0f), height - 1.0f);
+        particle.species = static_cast<SpeciesId>(species(random));
+    }
+    return particles;
+}
+
+} // namespace particulas
@@ -0,0 +1,30 @@
+#ifndef PARTICULAS_PARTICLES_PARTICLE_DISTRIBUTION_HPP
+#define PARTICULAS_PARTICLES_PARTICLE_DISTRIBUTION_HPP
+
+#include "particle.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace particulas {
+
+// Reparto inicial de las partículas en el dominio (escenarios de benchmark)
+enum class ParticleDistribution {
+    Uniform,  // Todo el dominio, como ParticleSystem(particleCount, ...)
+    Clusters, // Grumos gaussianos: muchas partículas por celda, peor caso para el culling y el splatting
+    Ring      // Anillo centrado girando sobre sí mismo: densidad alta y movimiento coherente
+};
+
+const char* distributionName(ParticleDistribution distribution);
+// false si name no es uniform, clusters o ring
+bool parseDistribution(const std::string& name, ParticleDistribution& distribution);
+
+// count partículas inmortales repartidas entre speciesCount especies, reproducibles con seed
+std::vector<Particle> makeDistributedParticles(ParticleDistribution distribution, size_t count, float width, float height,
+                                               size_t speciesCount, uint32_t seed);
+
+} // namespace particulas
+
+#endif // PARTICULAS_PARTICLES_PARTICLE_DISTRIBUTION_HPP
@@ -1,15 +1,15 @@
 #include "particle_system.hpp"
 
-#include <cstdlib>  // Para std::rand(), std::srand()
-#include <ctime>    // Para std::time()
 #include <cmath>    // Para std::sqrt(), std::pow() (aunque no se usan aquí directamente)
 #include <iostream> // Para depuración si es necesario (std::cout, std::endl)
 #include <stdexcept> // Para excepciones si fueran necesarias
+#include <algorithm>
+#include <limits>
 
 namespace particulas {
 
-ParticleSystem::ParticleSystem(int particleCount, float width, float height)
-    : width_(width), height_(height) {
+ParticleSystem::ParticleSystem(int particleCount, float width, float height, size_t capacity, size_t speciesCount, uint32_t seed)
+    : species_(makeDefaultSpecies(speciesCount)), width_(width), height_(height) {
     if (particleCount <= 0) {
         throw std::invalid_argument("Particle count must be positive.");
     }
@@ -17,44 +17,104 @@ ParticleSystem::ParticleSystem(int particleCount, float width, float height)
        throw std::invalid_argument("Width and height must be positive.");
     }
 
-    // Inicializar la semilla del generador de números aleatorios una sola vez
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+    setRandomSeed(seed);
 
+    particles_.reserve(std::max(capacity, static_cast<size_t>(particleCount)));
     particles_.resize(particleCount);
     initializeParticles();
+    initializePool(capacity);
 }
 
-void ParticleSystem::initializeParticles() {
-    for (auto& particle : particles_) {
-        // Posición aleatoria dentro del cuadro (evitando los bordes exactos inicialmente)
-        particle.position = {
-            (static_cast<float>(std::rand()) / RAND_MAX * (width_ - 2.0f)) + 1.0f, // Evita 0 y width
-            (static_cast<float>(std::rand()) / RAND_MAX * (height_ - 2.0f)) + 1.0f // Evita 0 y height
-        };
-
-        // Velocidad aleatoria en el rango [-1, 1] en ambas direcciones, con una magnitud base
-        float speed_factor = 50.0f; // Ajusta esta velocidad base
-        particle.velocity = glm::normalize(glm::vec2(
-            (static_cast<float>(std::rand()) / RAND_MAX * 2.0f - 1.0f),
-            (static_cast<float>(std::rand()) / RAND_MAX * 2.0f - 1.0f)
-        )) * speed_factor;
-
-         // Asegurarse de que la velocidad no sea cero
-        if (glm::length(particle.velocity) < 0.01f) {
-             particle.velocity = glm::vec2(speed_factor, 0.0f);
+ParticleSystem::ParticleSystem(std::vector<Particle> particles, float width, float height, size_t capacity,
+                               std::vector<Species> species)
+    : particles_(std::move(particles)), species_(species.empty() ? makeDefaultSpecies(1) : std::move(species)),
+      width_(width), height_(height) {
+    if (particles_.empty()) {
+        throw std::invalid_argument("Particle count must be positive.");
+    }
+    if (width <= 0.0f || height <= 0.0f) {
+       throw std::invalid_argument("Width and height must be positive.");
+    }
+    validateSpecies();
+    initializePool(capacity);
+    setRandomSeed(RANDOM_SEED);
+}
+
+void ParticleSystem::setRandomSeed(uint32_t seed) {
+    random_.seed(seed == RANDOM_SEED ? std::random_device{}() : seed);
+}
+
+void ParticleSystem::validateSpecies() const {
+    if (species_.size() > MAX_SPECIES) throw std::invalid_argument("Too many species (MAX_SPECIES).");
+    for (const Particle& particle : particles_) {
+        if (particle.alive && particle.species >= species_.size()) {
+            throw std::invalid_argument("Particle references a species that is not in the table.");
         }
+    }
+}
+
+// Las partículas iniciales ocupan [0, n); el resto hasta la capacidad son slots libres.
+// Toda la memoria del pool se reserva aquí: emitir/morir nunca realoca.
+void ParticleSystem::initializePool(size_t capacity) {
+    if (capacity > std::numeric_limits<uint32_t>::max()) throw std::invalid_argument("Particle capacity exceeds 32-bit slot indices.");
+    liveEnd_ = particles_.size();
+    liveCount_ = particles_.size();
+    if (capacity > particles_.size()) {
+        Particle freeSlot{};
+        freeSlot.alive = 0;
+        particles_.resize(capacity, freeSlot);
+    }
+    freeSlots_.reserve(particles_.size());
+    compactionRemap_.resize(particles_.size());
+    speciesSteps_.reserve(MAX_SPECIES);
+}
+
+void ParticleSystem::initializeParticles() {
+    for (auto& particle : particles_) randomizeParticle(particle);
+}
 
+void ParticleSystem::randomizeParticle(Particle& particle) {
+    // Posición aleatoria dentro del cuadro (evitando los bordes exactos inicialmente)
+    float x = randomUnit() * (width_ - 2.0f) + 1.0f; // Evita 0 y width
+    float y = randomUnit() * (height_ - 2.0f) + 1.0f; // Evita 0 y height
+    particle.position = {x, y};
 
-        // Color aleatorio (RGBA), asegurando que no sea completamente negro
-        particle.color = {
-            (static_cast<float>(std::rand()) / RAND_MAX * 0.8f) + 0.2f, // Rango [0.2, 1.0]
-            (static_cast<float>(std::rand()) / RAND_MAX * 0.8f) + 0.2f, // Rango [0.2, 1.0]
-            (static_cast<float>(std::rand()) / RAND_MAX * 0.8f) + 0.2f, // Rango [0.2, 1.0]
-            1.0f // Alfa opaco
-        };
+    // Velocidad aleatoria en el rango [-1, 1] en ambas direcciones, con una magnitud base
+    float speed_factor = 50.0f; // Ajusta esta velocidad base
+    float vx = randomUnit() * 2.0f - 1.0f;
+    float vy = randomUnit() * 2.0f - 1.0f;
+    particle.velocity = glm::normalize(glm::vec2(vx, vy)) * speed_factor;
 
-        // Radio fijo para las partículas
-        particle.radius = 2.0f; // Ajusta el tamaño visual de las partículas
+     // Asegurarse de que la velocidad no sea cero
+    if (glm::length(particle.velocity) < 0.01f) {
+         particle.velocity = glm::vec2(speed_factor, 0.0f);
+    }
+
+    // Especie aleatoria: color, radio y comportamiento salen de la tabla
+    particle.species = static_cast<SpeciesId>(random_() % species_.size());
+}
+
+SpeciesId ParticleSystem::addSpecies(const Species& species) {
+    if (species_.size() >= MAX_SPECIES) throw std::invalid_argument("Species table is full (MAX_SPECIES).");
+    species_.push_back(species);
+    return static_cast<SpeciesId>(species_.size() - 1);
+}
+
+float ParticleSystem::getMaxSpeciesRadius() const {
+    float maxRadius = 0.0f;
+    for (const Species& species : species_) maxRadius = std::max(maxRadius, species.radius);
+    return maxRadius;
+}
+
+void ParticleSystem::prepareSpeciesSteps(float deltaTime) {
+    speciesSteps_.resize(species_.size()); // Sin realocar: reservado con MAX_SPECIES
+    for (size_t i = 0; i < species_.size(); ++i) {
+        const Species& species = species_[i];
+        SpeciesStep& step = speciesSteps_[i];
+        step.gravityDelta = gravity_ * species.gravityScale * deltaTime;
+        step.velocityScale = species.drag > 0.0f ? std::exp(-species.drag * deltaTime) : 1.0f;
+        step.radius = species.radius;
+        step.restitution = species.restitution;
     }
 }
 
@@ -64,35 +124,248 @@ void ParticleSystem::update(float deltaTime) {
     // float max_dt = 0.1f; // Límite superior opcional para deltaTime
     // deltaTime = std::min(deltaTime, max_dt);
 
-    for (auto& particle : particles_) {
-        // 1. Actualizar posición según la velocidad
+    if (!constraintSolver_ || constraintSolver_->empty()) {
+        integrate(deltaTime);
+    } else {
+        // XPBD con subpasos: predecir posiciones, proyectar restricciones y derivar velocidades
+        constraintSolver_->resetFrameStats();
+        int substeps = constraintSolver_->getSubsteps();
+        float substepDelta = deltaTime / static_cast<float>(substeps);
+        for (int step = 0; step < substeps; ++step) {
+            constraintSolver_->beginSubstep(particles_);
+            integrate(substepDelta);
+            constraintSolver_->solve(particles_, substepDelta);
+            constraintSolver_->endSubstep(particles_, substepDelta);
+        }
+    }
+
+    emit(deltaTime);
+
+    // Compactar periódicamente, o antes si los huecos superan un cuarto del rango vivo
+    ++updatesSinceCompaction_;
+    bool intervalReached = compactionInterval_ > 0 && updatesSinceCompaction_ >= compactionInterval_;
+    if (!freeSlots_.empty() && (intervalReached || freeSlots_.size() * 4 > liveEnd_)) {
+        compact();
+    }
+
+    if (mortonReorder_) {
+        ++updatesSinceReorder_;
+        lastLocality_ = MortonReorder::measureLocality(particles_, liveEnd_, {width_, height_});
+        bool reorderDue = mortonInterval_ > 0 && updatesSinceReorder_ >= mortonInterval_;
+        bool degraded = mortonDegradeFactor_ > 0.0f && lastLocality_ > sortedLocality_ * mortonDegradeFactor_;
+        if (reorderDue || degraded) reorderMorton();
+    }
+}
+
+void ParticleSystem::integrate(float deltaTime) {
+    prepareSpeciesSteps(deltaTime);
+    for (size_t slot = 0; slot < liveEnd_; ++slot) {
+        Particle& particle = particles_[slot];
+        if (!particle.alive) continue;
+
+        // 0. Envejecer y retirar las partículas con vida limitada
+        if (particle.lifetime > 0.0f) {
+            particle.age += deltaTime;
+            if (particle.age >= particle.lifetime) { kill(static_cast<uint32_t>(slot)); continue; }
+        }
+
+        // 1. Actualizar velocidad (gravedad y rozamiento de la especie) y posición
+        const SpeciesStep& step = speciesSteps_[particle.species];
+        particle.velocity = (particle.velocity + step.gravityDelta) * step.velocityScale;
         particle.position += particle.velocity * deltaTime;
 
-        // 2. Manejar colisiones con los bordes
+        // 2. Manejar colisiones con los bordes (radio y restitución de la especie)
+        float radius = step.radius;
         // Colisión con borde izquierdo
-        if (particle.position.x - particle.radius < 0.0f) {
-            particle.position.x = particle.radius; // Corregir posición para evitar que se quede pegada
-            particle.velocity.x = std::abs(particle.velocity.x); // Asegurar velocidad positiva en X
+        if (particle.position.x - radius < 0.0f) {
+            particle.position.x = radius; // Corregir posición para evitar que se quede pegada
+            particle.velocity.x = std::abs(particle.velocity.x) * step.restitution; // Asegurar velocidad positiva en X
         }
         // Colisión con borde derecho
-        else if (particle.position.x + particle.radius > width_) {
-            particle.position.x = width_ - particle.radius; // Corregir posición
-            particle.velocity.x = -std::abs(particle.velocity.x); // Asegurar velocidad negativa en X
+        else if (particle.position.x + radius > width_) {
+            particle.position.x = width_ - radius; // Corregir posición
+            particle.velocity.x = -std::abs(particle.velocity.x) * step.restitution; // Asegurar velocidad negativa en X
         }
 
         // Colisión con borde superior (y=0)
-        if (particle.position.y - particle.radius < 0.0f) {
-            particle.position.y = particle.radius; // Corregir posición
-            particle.velocity.y = std::abs(particle.velocity.y); // Asegurar velocidad positiva en Y
+        if (particle.position.y - radius < 0.0f) {
+            particle.position.y = radius; // Corregir posición
+            particle.velocity.y = std::abs(particle.velocity.y) * step.restitution; // Asegurar velocidad positiva en Y
         }
         // Colisión con borde inferior
-        else if (particle.position.y + particle.radius > height_) {
-            particle.position.y = height_ - particle.radius; // Corregir posición
-            particle.velocity.y = -std::abs(particle.velocity.y); // Asegurar velocidad negativa en Y
+        else if (particle.position.y + radius > height_) {
+            particle.position.y = height_ - radius; // Corregir posición
+            particle.velocity.y = -std::abs(particle.velocity.y) * step.restitution; // Asegurar velocidad negativa en Y
         }
     }
 }
 
+size_t ParticleSystem::addEmitter(const Emitter& emitter) {
+    if (emitter.rate < 0.0f || emitter.particleLifetime <= 0.0f) {
+        throw std::invalid_argument("Emitter rate must be non-negative and particle lifetime positive.");
+    }
+    if (emitter.species >= species_.size()) throw std::invalid_argument("Emitter species is not in the species table.");
+    emitters_.push_back(emitter);
+    return emitters_.size() - 1;
+}
+
+void ParticleSystem::emit(float deltaTime) {
+    for (auto& emitter : emitters_) {
+        if (!emitter.enabled) continue;
+        emitter.accumulator += emitter.rate * deltaTime;
+        int toSpawn = static_cast<int>(emitter.accumulator);
+        emitter.accumulator -= static_cast<float>(toSpawn);
+        for (int i = 0; i < toSpawn; ++i) spawn(emitter);
+    }
+}
+
+void ParticleSystem::setParticleCount(size_t count) {
+    count = std::min(count, particles_.size());
+    if (count > liveCount_) {
+        // Rellena primero los huecos y luego extiende el rango vivo, como spawn()
+        while (liveCount_ < count) {
+            uint32_t slot;
+            if (!acquireSlot(slot)) break; // No ocurre: count está acotado por la capacidad
+            Particle& particle = particles_[slot];
+            randomizeParticle(particle);
+            particle.age = 0.0f;
+            particle.lifetime = 0.0f;
+            particle.alive = 1;
+            ++liveCount_;
+        }
+        return;
+    }
+    if (count == liveCount_) return;
+
+    // Con el rango denso, las sobrantes son exactamente [count, liveEnd_)
+    if (!freeSlots_.empty()) compact();
+    size_t previousEnd = liveEnd_;
+    for (size_t slot = 0; slot < previousEnd; ++slot) {
+        compactionRemap_[slot] = slot < count ? static_cast<uint32_t>(slot) : INVALID_SLOT;
+    }
+    for (size_t slot = count; slot < previousEnd; ++slot) {
+        particles_[slot].alive = 0;
+        particles_[slot].velocity = glm::vec2(0.0f, 0.0f);
+    }
+    liveEnd_ = count;
+    liveCount_ = count;
+    if (constraintSolver_ && !constraintSolver_->empty()) {
+        constraintSolver_->remapParticles(compactionRemap_, previousEnd);
+    }
+}
+
+// Toma primero un hueco de la lista libre; si no hay, extiende el rango vivo. Un hueco aún
+// conserva las restricciones de la partícula muerta (el solver solo las descarta al compactar):
+// con restricciones se compacta antes de reutilizar, para que la nueva no herede su cuerda o tela.
+bool ParticleSystem::acquireSlot(uint32_t& slot) {
+    if (!freeSlots_.empty() && constraintSolver_ && !constraintSolver_->empty()) compact();
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else if (liveEnd_ < particles_.size()) {
+        slot = static_cast<uint32_t>(liveEnd_++);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void ParticleSystem::spawn(const Emitter& emitter) {
+    uint32_t slot;
+    if (!acquireSlot(slot)) {
+        ++droppedSpawns_; // Pool lleno
+        return;
+    }
+
+    float angle = std::atan2(emitter.direction.y, emitter.direction.x) + (randomUnit() - 0.5f) * emitter.spreadRadians;
+    float speed = emitter.speed * (1.0f + (randomUnit() * 2.0f - 1.0f) * emitter.speedJitter);
+
+    Particle& particle = particles_[slot];
+    particle.position = emitter.position;
+    particle.velocity = glm::vec2(std::cos(angle), std::sin(angle)) * speed;
+    particle.species = emitter.species;
+    particle.age = 0.0f;
+    particle.lifetime = emitter.particleLifetime;
+    particle.alive = 1;
+    ++liveCount_;
+}
+
+bool ParticleSystem::addParticle(const Particle& particle) {
+    if (particle.species >= species_.size()) throw std::invalid_argument("Particle references a species that is not in the table.");
+    uint32_t slot;
+    if (!acquireSlot(slot)) return false;
+    particles_[slot] = particle;
+    particles_[slot].alive = 1;
+    ++liveCount_;
+    return true;
+}
+
+void ParticleSystem::removeParticle(uint32_t slot) {
+    if (slot < liveEnd_ && particles_[slot].alive) kill(slot);
+}
+
+// El slot queda como hueco invisible (alive = 0) hasta que se reutilice o se compacte.
+void ParticleSystem::kill(uint32_t slot) {
+    Particle& particle = particles_[slot];
+    particle.alive = 0;
+    particle.velocity = glm::vec2(0.0f, 0.0f);
+    freeSlots_.push_back(slot);
+    --liveCount_;
+}
+
+// Compactación estable: mueve las vivas al principio conservando su orden relativo,
+// de modo que update y la subida a GPU recorren un rango denso.
+void ParticleSystem::compact() {
+    size_t write = 0;
+    for (size_t read = 0; read < liveEnd_; ++read) {
+        if (particles_[read].alive) {
+            compactionRemap_[read] = static_cast<uint32_t>(write);
+            if (write != read) particles_[write] = particles_[read];
+            ++write;
+        } else {
+            compactionRemap_[read] = INVALID_SLOT;
+        }
+    }
+    for (size_t slot = write; slot < liveEnd_; ++slot) {
+        particles_[slot].alive = 0;
+    }
+
+    if (constraintSolver_ && !constraintSolver_->empty()) {
+        constraintSolver_->remapParticles(compactionRemap_, liveEnd_);
+    }
+
+    liveEnd_ = write;
+    liveCount_ = write;
+    freeSlots_.clear();
+    updatesSinceCompaction_ = 0;
+}
+
+void ParticleSystem::enableMortonReorder(ThreadPool* threadPool, uint32_t interval, float degradeFactor) {
+    if (degradeFactor < 0.0f) throw std::invalid_argument("Morton degrade factor must be non-negative.");
+    mortonReorder_ = std::make_unique<MortonReorder>(threadPool);
+    mortonReorder_->reserve(particles_.size()); // Capacidad del pool: ordenar no reserva en el bucle de frame
+    mortonInterval_ = interval;
+    mortonDegradeFactor_ = degradeFactor;
+    updatesSinceReorder_ = 0;
+    sortedLocality_ = lastLocality_ = MortonReorder::measureLocality(particles_, liveEnd_, {width_, height_});
+}
+
+// Ordena el rango vivo por código Morton. Primero se compacta para ordenar solo partículas vivas;
+// compactionRemap_ (reservado con la capacidad) sirve también como tabla antiguo -> nuevo.
+void ParticleSystem::reorderMorton() {
+    if (!mortonReorder_) mortonReorder_ = std::make_unique<MortonReorder>();
+    if (!freeSlots_.empty()) compact();
+
+    mortonReorder_->reorder(particles_, liveEnd_, {width_, height_}, compactionRemap_);
+    if (constraintSolver_ && !constraintSolver_->empty()) {
+        constraintSolver_->remapParticles(compactionRemap_, liveEnd_); // Invalida el coloreado: se recalcula en el siguiente solve
+    }
+
+    sortedLocality_ = lastLocality_ = MortonReorder::measureLocality(particles_, liveEnd_, {width_, height_});
+    updatesSinceReorder_ = 0;
+    ++mortonReorderCount_;
+}
+
 const std::vector<Particle>& ParticleSystem::getParticles() const {
     return particles_;
 }
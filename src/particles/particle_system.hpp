@@ -2,33 +2,152 @@
 #define PARTICULAS_PARTICLES_PARTICLE_SYSTEM_HPP
 
 #include "particle.hpp" // Incluye la definición de Particle
+#include "constraint_solver.hpp"
+#include "emitter.hpp"
+#include "morton_reorder.hpp"
+#include <memory>
+#include <random>
 #include <vector>
 
 namespace particulas {
 
 class ParticleSystem {
 public:
-    // Constructor: inicializa el sistema con un número de partículas y las dimensiones del área
-    ParticleSystem(int particleCount, float width, float height);
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    static constexpr size_t DEFAULT_SPECIES_COUNT = 8;
+    static constexpr uint32_t RANDOM_SEED = 0xFFFFFFFFu; // Semilla distinta en cada ejecución
+
+    // Constructor: inicializa el sistema con un número de partículas y las dimensiones del área.
+    // capacity reserva slots extra para emisores (0 = solo particleCount). El almacenamiento
+    // se reserva una única vez; emitir y morir nunca realoca el vector.
+    // Las partículas iniciales se reparten al azar entre speciesCount especies por defecto.
+    // Con la misma seed, la escena inicial y las emisiones se repiten exactamente.
+    ParticleSystem(int particleCount, float width, float height, size_t capacity = 0,
+                   size_t speciesCount = DEFAULT_SPECIES_COUNT, uint32_t seed = RANDOM_SEED);
+
+    // Constructor: usa partículas ya preparadas (p.ej. escenas de restricciones). species vacío =
+    // una única especie por defecto; los índices de las partículas deben existir en la tabla.
+    ParticleSystem(std::vector<Particle> particles, float width, float height, size_t capacity = 0,
+                   std::vector<Species> species = {});
 
     // Actualiza el estado de todas las partículas (posición, colisiones con bordes)
     void update(float deltaTime);
 
-    // Devuelve una referencia constante al vector de partículas (para renderización)
+    // Devuelve una referencia constante al vector de partículas (para renderización).
+    // Su tamaño es la capacidad del pool; solo [0, getParticleCount()) contiene datos útiles.
     const std::vector<Particle>& getParticles() const;
 
     
     // --- NUEVO GETTER ---
-    // Devuelve el número actual de partículas
-    size_t getParticleCount() const { return particles_.size(); }
+    // Devuelve el tamaño del rango vivo [0, n) que se sube y se dibuja.
+    // Puede contener huecos (alive == 0) hasta la siguiente compactación.
+    size_t getParticleCount() const { return liveEnd_; }
+    size_t getLiveParticleCount() const { return liveCount_; }
+    size_t getCapacity() const { return particles_.size(); }
+    uint64_t getDroppedSpawnCount() const { return droppedSpawns_; }
+
+    // --- Especies ---
+    // La tabla es pequeña (<= MAX_SPECIES) y se consulta por índice en cada update y en la GPU
+    SpeciesId addSpecies(const Species& species);
+    const std::vector<Species>& getSpecies() const { return species_; }
+    size_t getSpeciesCount() const { return species_.size(); }
+    float getMaxSpeciesRadius() const;
+
+    // --- Emisores ---
+    size_t addEmitter(const Emitter& emitter);
+    Emitter& getEmitter(size_t index) { return emitters_.at(index); }
+    size_t getEmitterCount() const { return emitters_.size(); }
+    const std::vector<Emitter>& getEmitters() const { return emitters_; }
+
+    // Dimensiones del área de simulación
+    float getWidth() const { return width_; }
+    float getHeight() const { return height_; }
+
+    // Ajusta el número de partículas vivas (acotado a la capacidad): añade partículas aleatorias
+    // inmortales o retira las del final del rango vivo tras compactar. No realoca.
+    void setParticleCount(size_t count);
+
+    // Inserta una partícula ya preparada en un slot libre (p. ej. la que llega de otro proceso al
+    // migrar). Devuelve false si el pool está lleno. No realoca.
+    bool addParticle(const Particle& particle);
+    // Retira la partícula de slot (queda como hueco hasta la siguiente compactación)
+    void removeParticle(uint32_t slot);
+
+    // Compactación estable del rango vivo cada N updates (0 = solo por umbral de huecos)
+    void setCompactionInterval(uint32_t updates) { compactionInterval_ = updates; }
+    void compact();
+
+    // Solver de restricciones (PBD/XPBD) opcional. Si existe, update() usa sus subpasos.
+    void setConstraintSolver(std::unique_ptr<ConstraintSolver> solver) { constraintSolver_ = std::move(solver); }
+    ConstraintSolver* getConstraintSolver() const { return constraintSolver_.get(); }
+
+    // Reordenación Morton opcional del rango vivo para localidad de caché. Se ejecuta cada
+    // interval updates (0 = sin intervalo) o cuando la métrica de localidad supera degradeFactor
+    // veces la medida tras la última ordenación (0 = sin umbral).
+    void enableMortonReorder(ThreadPool* threadPool, uint32_t interval = 600, float degradeFactor = 2.0f);
+    void reorderMorton();
+    uint32_t getMortonReorderCount() const { return mortonReorderCount_; }
+    double getLastMortonReorderSeconds() const { return mortonReorder_ ? mortonReorder_->getLastReorderSeconds() : 0.0; }
+    float getLocalityMetric() const { return lastLocality_; }
+
+    // Aceleración constante aplicada a todas las partículas (por defecto ninguna)
+    void setGravity(const glm::vec2& gravity) { gravity_ = gravity; }
+    const glm::vec2& getGravity() const { return gravity_; }
+
+    // Generador propio (no std::rand): varios sistemas pueden avanzar a la vez en hilos distintos
+    // sin compartir estado y cada uno es reproducible con su semilla
+    void setRandomSeed(uint32_t seed);
 
 private:
     // Inicializa las partículas con posiciones, velocidades y colores aleatorios
     void initializeParticles();
+    void randomizeParticle(Particle& particle);
+    float randomUnit() { return std::uniform_real_distribution<float>(0.0f, 1.0f)(random_); } // [0, 1)
+
+    // Integra posiciones, envejece y resuelve colisiones con los bordes
+    void integrate(float deltaTime);
+    void emit(float deltaTime);
+    void spawn(const Emitter& emitter);
+    bool acquireSlot(uint32_t& slot); // false = pool lleno
+    void kill(uint32_t slot);
+    void initializePool(size_t capacity);
+    void validateSpecies() const;
+    void prepareSpeciesSteps(float deltaTime);
 
-    std::vector<Particle> particles_; // Almacenamiento de las partículas
+    // Coeficientes por especie precalculados para un paso de integración: el bucle por
+    // partícula solo indexa esta tabla (cabe en L1) en lugar de recalcular exp() o la gravedad.
+    struct SpeciesStep {
+        glm::vec2 gravityDelta; // gravedad * gravityScale * dt
+        float velocityScale;    // exp(-drag * dt)
+        float radius;
+        float restitution;
+    };
+
+    std::vector<Particle> particles_; // Almacenamiento de las partículas (tamaño = capacidad)
+    std::vector<uint32_t> freeSlots_; // Pila de huecos libres dentro de [0, liveEnd_)
+    std::vector<uint32_t> compactionRemap_; // Índice antiguo -> nuevo (reservado con la capacidad)
+    size_t liveEnd_ = 0;              // Fin del rango vivo
+    size_t liveCount_ = 0;            // Partículas vivas dentro del rango
+    uint64_t droppedSpawns_ = 0;      // Emisiones descartadas por pool lleno
+    uint32_t compactionInterval_ = 120;
+    uint32_t updatesSinceCompaction_ = 0;
+    std::vector<Emitter> emitters_;
+    std::vector<Species> species_;
+    std::vector<SpeciesStep> speciesSteps_; // Reservado con MAX_SPECIES
     float width_;                     // Ancho del área de simulación
     float height_;                    // Alto del área de simulación
+    glm::vec2 gravity_ = {0.0f, 0.0f};
+    std::unique_ptr<ConstraintSolver> constraintSolver_;
+    std::mt19937 random_;
+
+    std::unique_ptr<MortonReorder> mortonReorder_;
+    uint32_t mortonInterval_ = 0;
+    float mortonDegradeFactor_ = 0.0f;
+    uint32_t updatesSinceReorder_ = 0;
+    uint32_t mortonReorderCount_ = 0;
+    float sortedLocality_ = 0.0f;     // Métrica justo tras la última ordenación
+    float lastLocality_ = 0.0f;       // Última métrica medida
 };
 
 } // namespace particulas
@@ -0,0 +1,75 @@
+#include "spatial_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace particulas {
+
+SpatialGrid::SpatialGrid(const glm::vec2& domainSize, float cellSize, size_t capacity)
+    : domainSize_(domainSize) {
+    if (cellSize <= 0.0f || domainSize.x <= 0.0f || domainSize.y <= 0.0f) throw std::invalid_argument("SpatialGrid needs a positive cell size and domain.");
+    inverseCellSize_ = 1.0f / cellSize;
+    cellsX_ = std::max(1u, static_cast<uint32_t>(std::ceil(domainSize.x * inverseCellSize_)));
+    cellsY_ = std::max(1u, static_cast<uint32_t>(std::ceil(domainSize.y * inverseCellSize_)));
+    size_t cellCount = static_cast<size_t>(cellsX_) * cellsY_;
+    cellStart_.assign(cellCount + 1, 0);
+    cellCursor_.assign(cellCount, 0);
+    cellOfParticle_.resize(capacity);
+    sortedIndices_.resize(capacity);
+}
+
+uint32_t SpatialGrid::cellOf(const glm::vec2& position) const {
+    int x = static_cast<int>(position.x * inverseCellSize_);
+    int y = static_cast<int>(position.y * inverseCellSize_);
+    x = std::clamp(x, 0, static_cast<int>(cellsX_) - 1);
+    y = std::clamp(y, 0, static_cast<int>(cellsY_) - 1);
+    return static_cast<uint32_t>(y) * cellsX_ + static_cast<uint32_t>(x);
+}
+
+void SpatialGrid::build(const std::vector<Particle>& particles, size_t count) {
+    count = std::min({count, particles.size(), cellOfParticle_.size()});
+    std::fill(cellStart_.begin(), cellStart_.end(), 0u);
+    for (size_t i = 0; i < count; ++i) {
+        if (particles[i].alive == 0) { cellOfParticle_[i] = UINT32_MAX; continue; }
+        uint32_t cell = cellOf(particles[i].position);
+        cellOfParticle_[i] = cell;
+        ++cellStart_[cell + 1];
+    }
+    for (size_t c = 1; c < cellStart_.size(); ++c) cellStart_[c] += cellStart_[c - 1];
+    std::copy(cellStart_.begin(), cellStart_.end() - 1, cellCursor_.begin());
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t cell = cellOfParticle_[i];
+        if (cell != UINT32_MAX) sortedIndices_[cellCursor_[cell]++] = static_cast<uint32_t>(i);
+    }
+}
+
+size_t SpatialGrid::gather(const std::vector<Particle>& particles, const glm::vec2& rectMin, const glm::vec2& rectMax,
+                           std::vector<Particle>& out) const {
+    lastVisitedCells_ = 0;
+    // Las posiciones fuera del dominio están en las celdas del borde, que nunca son interiores
+    auto toCell = [&](float value, float inverse, uint32_t cells) {
+        return static_cast<uint32_t>(std::clamp(static_cast<int>(std::floor(value * inverse)), 0, static_cast<int>(cells) - 1));
+    };
+    uint32_t x0 = toCell(rectMin.x, inverseCellSize_, cellsX_), x1 = toCell(rectMax.x, inverseCellSize_, cellsX_);
+    uint32_t y0 = toCell(rectMin.y, inverseCellSize_, cellsY_), y1 = toCell(rectMax.y, inverseCellSize_, cellsY_);
+
+    size_t written = 0;
+    for (uint32_t y = y0; y <= y1; ++y) {
+        for (uint32_t x = x0; x <= x1; ++x) {
+            uint32_t cell = y * cellsX_ + x;
+            ++lastVisitedCells_;
+            // Las celdas interiores están enteras dentro del rectángulo: copiar sin comprobar
+            bool interior = x > x0 && x < x1 && y > y0 && y < y1;
+            for (uint32_t k = cellStart_[cell]; k < cellStart_[cell + 1]; ++k) {
+                const Particle& particle = particles[sortedIndices_[k]];
+                if (!interior && (particle.position.x < rectMin.x || particle.position.x > rectMax.x ||
+                                  particle.position.y < rectMin.y || particle.position.y > rectMax.y)) continue;
+                if (written < out.size()) out[written++] = particle;
+            }
+        }
+    }
+    return written;
+}
+
+} // namespace particulas
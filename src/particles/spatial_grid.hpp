@@ -0,0 +1,48 @@
+#ifndef PARTICULAS_PARTICLES_SPATIAL_GRID_HPP
+#define PARTICULAS_PARTICLES_SPATIAL_GRID_HPP
+
+#include "particle.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace particulas {
+
+// Rejilla uniforme sobre el dominio (counting sort de índices por celda). Sirve para consultas
+// por rectángulo: gather() solo visita las celdas que tocan el rectángulo, así que su coste es
+// proporcional a lo visible y no al total. Los buffers se reservan con la capacidad.
+class SpatialGrid {
+public:
+    SpatialGrid(const glm::vec2& domainSize, float cellSize, size_t capacity);
+
+    // Reparte particles[0, count) vivas en celdas. Las posiciones fuera del dominio van al borde.
+    void build(const std::vector<Particle>& particles, size_t count);
+
+    // Copia a out[0, n) las partículas vivas dentro de [rectMin, rectMax] y devuelve n.
+    // out debe tener tamaño >= count de build (no se realoca).
+    size_t gather(const std::vector<Particle>& particles, const glm::vec2& rectMin, const glm::vec2& rectMax,
+                  std::vector<Particle>& out) const;
+
+    uint32_t getCellsX() const { return cellsX_; }
+    uint32_t getCellsY() const { return cellsY_; }
+    size_t getLastVisitedCells() const { return lastVisitedCells_; }
+
+private:
+    uint32_t cellOf(const glm::vec2& position) const;
+
+    glm::vec2 domainSize_;
+    float inverseCellSize_;
+    uint32_t cellsX_;
+    uint32_t cellsY_;
+    std::vector<uint32_t> cellStart_;   // Prefijo: celda c ocupa [cellStart_[c], cellStart_[c + 1])
+    std::vector<uint32_t> cellCursor_;
+    std::vector<uint32_t> cellOfParticle_;
+    std::vector<uint32_t> sortedIndices_;
+    mutable size_t lastVisitedCells_ = 0;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_PARTICLES_SPATIAL_GRID_HPP
@@ -0,0 +1,39 @@
+#include "species.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+// HSV con saturación y valor fijos -> RGB; evita colores demasiado oscuros
+glm::vec4 hueToColor(float hue) {
+    float h = (hue - std::floor(hue)) * 6.0f;
+    float x = 1.0f - std::abs(std::fmod(h, 2.0f) - 1.0f);
+    glm::vec3 rgb;
+    if (h < 1.0f) rgb = {1.0f, x, 0.0f};
+    else if (h < 2.0f) rgb = {x, 1.0f, 0.0f};
+    else if (h < 3.0f) rgb = {0.0f, 1.0f, x};
+    else if (h < 4.0f) rgb = {0.0f, x, 1.0f};
+    else if (h < 5.0f) rgb = {x, 0.0f, 1.0f};
+    else rgb = {1.0f, 0.0f, x};
+    rgb = rgb * 0.8f + glm::vec3(0.2f);
+    return {rgb.x, rgb.y, rgb.z, 1.0f};
+}
+}
+
+std::vector<Species> makeDefaultSpecies(size_t count) {
+    if (count == 0 || count > MAX_SPECIES) throw std::invalid_argument("Species count must be in [1, MAX_SPECIES].");
+    std::vector<Species> species(count);
+    for (size_t i = 0; i < count; ++i) {
+        float t = count > 1 ? static_cast<float>(i) / static_cast<float>(count - 1) : 0.0f;
+        species[i].color = hueToColor(static_cast<float>(i) / static_cast<float>(count));
+        species[i].radius = 1.5f + 1.5f * t;                 // De partículas finas a gruesas
+        species[i].drag = (i % 2 == 0) ? 0.0f : 0.15f;      // La mitad se frena poco a poco
+        species[i].restitution = 1.0f - 0.3f * t;           // Las grandes rebotan menos
+    }
+    return species;
+}
+
+} // namespace particulas
@@ -0,0 +1,29 @@
+#ifndef PARTICULAS_PARTICLES_SPECIES_HPP
+#define PARTICULAS_PARTICLES_SPECIES_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace particulas {
+
+using SpeciesId = uint16_t;
+constexpr uint32_t MAX_SPECIES = 256; // Tamaño de la tabla en GPU (MAX_SPECIES en species.glsl)
+
+// Parámetros compartidos por todas las partículas de una especie. Mismo layout que Species en
+// species.glsl (std140, 32 bytes): la tabla se sube tal cual a un uniform buffer.
+struct Species {
+    glm::vec4 color = {1.0f, 1.0f, 1.0f, 1.0f};
+    float radius = 2.0f;        // Colisiones con los bordes y tamaño de punto relativo (2 = POINT_SIZE)
+    float drag = 0.0f;          // Amortiguación de la velocidad por segundo (v *= exp(-drag * dt))
+    float gravityScale = 1.0f;  // Multiplica la gravedad global del sistema
+    float restitution = 1.0f;   // Fracción de la velocidad normal conservada al rebotar
+};
+
+// Paleta por defecto: count especies con tonos repartidos y radios/comportamientos distintos
+std::vector<Species> makeDefaultSpecies(size_t count);
+
+} // namespace particulas
+
+#endif // PARTICULAS_PARTICLES_SPECIES_HPP
@@ -0,0 +1,67 @@
+#include "camera.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+constexpr float MIN_ZOOM = 0.25f;
+constexpr float MAX_ZOOM = 1000.0f;
+}
+
+Camera2D::Camera2D(const glm::vec2& domainSize)
+    : domainSize_(domainSize), center_(domainSize * 0.5f) {
+    if (domainSize.x <= 0.0f || domainSize.y <= 0.0f) throw std::invalid_argument("Camera2D needs a non-empty domain.");
+}
+
+void Camera2D::setViewportSize(float width, float height) {
+    viewportSize_ = {std::max(width, 1.0f), std::max(height, 1.0f)};
+}
+
+void Camera2D::reset() {
+    center_ = domainSize_ * 0.5f;
+    zoom_ = 1.0f;
+}
+
+float Camera2D::getPixelsPerUnit() const {
+    float fit = std::min(viewportSize_.x / domainSize_.x, viewportSize_.y / domainSize_.y);
+    return fit * zoom_;
+}
+
+void Camera2D::pan(const glm::vec2& pixels) {
+    center_ -= pixels / getPixelsPerUnit();
+}
+
+void Camera2D::zoomBy(float factor, const glm::vec2& anchorPixel) {
+    glm::vec2 scale, offset;
+    getPixelTransform(scale, offset);
+    glm::vec2 anchorWorld = (anchorPixel - offset) / scale;
+    zoom_ = std::clamp(zoom_ * factor, MIN_ZOOM, MAX_ZOOM);
+    // Recolocar el centro para que anchorWorld siga bajo anchorPixel
+    center_ = anchorWorld - (anchorPixel - viewportSize_ * 0.5f) / getPixelsPerUnit();
+}
+
+void Camera2D::getVisibleRect(glm::vec2& min, glm::vec2& max, float marginPixels) const {
+    glm::vec2 halfExtent = (viewportSize_ * 0.5f + glm::vec2(marginPixels)) / getPixelsPerUnit();
+    min = center_ - halfExtent;
+    max = center_ + halfExtent;
+}
+
+void Camera2D::getPixelTransform(glm::vec2& scale, glm::vec2& offset) const {
+    float pixelsPerUnit = getPixelsPerUnit();
+    scale = glm::vec2(pixelsPerUnit);
+    offset = viewportSize_ * 0.5f - center_ * pixelsPerUnit;
+}
+
+CameraPushConstants Camera2D::getPushConstants() const {
+    // ndc = pixel / viewport * 2 - 1
+    glm::vec2 scale, offset;
+    getPixelTransform(scale, offset);
+    CameraPushConstants constants{};
+    constants.scale = scale * 2.0f / viewportSize_;
+    constants.offset = offset * 2.0f / viewportSize_ - glm::vec2(1.0f);
+    return constants;
+}
+
+} // namespace particulas
@@ -0,0 +1,47 @@
+#ifndef PARTICULAS_RENDERING_CAMERA_HPP
+#define PARTICULAS_RENDERING_CAMERA_HPP
+
+#include <glm/glm.hpp>
+
+namespace particulas {
+
+// Push constants de particle.vert (CameraParams): ndc = position * scale + offset
+struct CameraPushConstants {
+    glm::vec2 scale;
+    glm::vec2 offset;
+};
+
+// Cámara 2D en coordenadas del dominio de simulación, independiente del tamaño de la ventana.
+// zoom = 1 encaja el dominio completo en el viewport; el centro es un punto del mundo.
+// Y crece hacia abajo en pantalla, igual que en el dominio.
+class Camera2D {
+public:
+    explicit Camera2D(const glm::vec2& domainSize);
+
+    void setViewportSize(float width, float height);
+    void reset(); // Dominio completo centrado
+
+    void pan(const glm::vec2& pixels);                      // Desplaza el contenido en píxeles de pantalla
+    void zoomBy(float factor, const glm::vec2& anchorPixel); // Mantiene fijo el punto bajo anchorPixel
+
+    float getZoom() const { return zoom_; }
+    const glm::vec2& getCenter() const { return center_; }
+    float getPixelsPerUnit() const; // Píxeles de pantalla por unidad del mundo
+
+    // Rectángulo visible del mundo, ampliado marginPixels por cada lado (p.ej. el tamaño de punto)
+    void getVisibleRect(glm::vec2& min, glm::vec2& max, float marginPixels = 0.0f) const;
+
+    // Transformación mundo -> píxeles (pixel = position * scale + offset) y mundo -> NDC
+    void getPixelTransform(glm::vec2& scale, glm::vec2& offset) const;
+    CameraPushConstants getPushConstants() const;
+
+private:
+    glm::vec2 domainSize_;
+    glm::vec2 viewportSize_ = {1.0f, 1.0f};
+    glm::vec2 center_;
+    float zoom_ = 1.0f;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_RENDERING_CAMERA_HPP
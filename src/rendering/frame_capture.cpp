@@ -0,0 +1,270 @@
+#include "frame_capture.hpp"
+#include "utils/png_writer.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+namespace particulas {
+
+namespace {
+
+std::FILE* openPipe(const std::string& command) {
+#ifndef _WIN32
+    return popen(command.c_str(), "w");
+#else
+    return _popen(command.c_str(), "wb");
+#endif
+}
+
+void closePipe(std::FILE* pipe) {
+#ifndef _WIN32
+    pclose(pipe);
+#else
+    _pclose(pipe);
+#endif
+}
+
+} // namespace
+
+bool FrameCapture::isSupportedFormat(VkFormat format) {
+    return format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB ||
+           format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB;
+}
+
+FrameCapture::FrameCapture(const Device& device, VkFormat imageFormat, VkExtent2D extent, uint32_t slotCount,
+                           const FrameCaptureSettings& settings)
+    : settings_(settings), extent_(extent), frameCounter_(settings.firstFrame) {
+    if (!isSupportedFormat(imageFormat)) throw std::invalid_argument("Frame capture: only 8-bit RGBA/BGRA images are supported.");
+    if (extent.width == 0 || extent.height == 0 || slotCount == 0 || settings.interval == 0) {
+        throw std::invalid_argument("Frame capture: extent, slot count and interval must be non-zero.");
+    }
+    swapRedBlue_ = imageFormat == VK_FORMAT_B8G8R8A8_UNORM || imageFormat == VK_FORMAT_B8G8R8A8_SRGB;
+    frameBytes_ = static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+
+    // Memoria cacheada si existe: el escritor lee cada byte y la no cacheada es muy lenta de leer
+    const uint32_t bufferCount = std::max(settings.bufferCount, slotCount + 1);
+    VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    readbacks_.resize(bufferCount);
+    for (uint32_t i = 0; i < bufferCount; ++i) {
+        if (i == 0) {
+            try {
+                readbacks_[i].buffer = std::make_unique<Buffer>(device, frameBytes_, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                                properties | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+                properties |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            } catch (const std::runtime_error&) {
+                readbacks_[i].buffer = std::make_unique<Buffer>(device, frameBytes_, VK_BUFFER_USAGE_TRANSFER_DST_BIT, properties);
+            }
+        } else {
+            readbacks_[i].buffer = std::make_unique<Buffer>(device, frameBytes_, VK_BUFFER_USAGE_TRANSFER_DST_BIT, properties);
+        }
+        readbacks_[i].mapped = static_cast<const uint8_t*>(readbacks_[i].buffer->map());
+    }
+    freeReadbacks_.reserve(bufferCount);
+    for (uint32_t i = bufferCount; i > 0; --i) freeReadbacks_.push_back(i - 1);
+    readyReadbacks_.resize(bufferCount);
+    slotReadback_.assign(slotCount, NO_BUFFER);
+
+    const size_t pixelCount = static_cast<size_t>(extent.width) * extent.height;
+    if (settings.format == CaptureFormat::PngSequence) {
+        std::error_code error;
+        std::filesystem::create_directories(settings.output, error);
+        if (error) throw std::runtime_error("Frame capture: cannot create directory '" + settings.output + "': " + error.message());
+        pixels_.resize(pixelCount * 3);
+        encoded_.reserve(getMaxPngBytes(extent.width, extent.height, 3));
+    } else {
+        if (swapRedBlue_) pixels_.resize(pixelCount * 4);
+        if (!settings.pipeCommand.empty()) {
+#ifndef _WIN32
+            std::signal(SIGPIPE, SIG_IGN); // Si el comando termina antes, fwrite falla en vez de matar el proceso
+#endif
+            rawOutput_ = openPipe(settings.pipeCommand);
+            if (!rawOutput_) throw std::runtime_error("Frame capture: cannot start '" + settings.pipeCommand + "'");
+            rawOutputIsPipe_ = true;
+        }
+    }
+
+    writer_ = std::thread([this]() { writerLoop(); });
+    PARTICULAS_LOG(Info) << "[Capture] " << (settings.format == CaptureFormat::PngSequence ? "PNG sequence in '" : "Raw RGBA frames to '")
+                         << (rawOutputIsPipe_ ? settings.pipeCommand : settings.output) << "' (" << extent.width << "x" << extent.height
+                         << ", every " << settings.interval << " frame(s), " << bufferCount << " readback buffers"
+                         << ((properties & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) ? ", host-cached)" : ")");
+}
+
+FrameCapture::~FrameCapture() {
+    for (uint32_t slot = 0; slot < slotReadback_.size(); ++slot) collect(slot); // La GPU ya está parada
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (writer_.joinable()) writer_.join();
+    closeRawOutput();
+    PARTICULAS_LOG(Info) << "[Capture] " << getWrittenFrames() << " frames written, " << getDroppedFrames() << " dropped.";
+}
+
+bool FrameCapture::isFinished() const {
+    return settings_.maxFrames > 0 && requestedFrames_ >= settings_.maxFrames;
+}
+
+void FrameCapture::collect(uint32_t slot) {
+    uint32_t index = slotReadback_[slot];
+    if (index == NO_BUFFER) return;
+    slotReadback_[slot] = NO_BUFFER;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        readyReadbacks_[(readyHead_ + readyCount_) % readyReadbacks_.size()] = index;
+        ++readyCount_;
+    }
+    wake_.notify_one();
+}
+
+void FrameCapture::recordCopy(VkCommandBuffer commandBuffer, uint32_t slot, VkImage image, VkImageLayout layout) {
+    uint64_t frameNumber = frameCounter_++;
+    if (frameNumber % settings_.interval != 0 || isFinished() || slotReadback_[slot] != NO_BUFFER) return;
+    uint32_t index;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (freeReadbacks_.empty()) { droppedFrames_.fetch_add(1, std::memory_order_relaxed); return; }
+        index = freeReadbacks_.back();
+        freeReadbacks_.pop_back();
+    }
+    ++requestedFrames_;
+    readbacks_[index].frameNumber = frameNumber;
+    slotReadback_[slot] = index;
+
+    VkImageMemoryBarrier toTransfer{}; toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransfer.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT; toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    toTransfer.oldLayout = layout; toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = image;
+    toTransfer.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &toTransfer);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = {extent_.width, extent_.height, 1};
+    vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbacks_[index].buffer->get(), 1, &region);
+
+    // La imagen vuelve a su layout (la lectura solo necesita dependencia de ejecución) y la copia
+    // se hace visible al host para cuando la fence del slot se señale
+    VkImageMemoryBarrier restore = toTransfer;
+    restore.srcAccessMask = 0; restore.dstAccessMask = 0;
+    restore.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL; restore.newLayout = layout;
+    VkBufferMemoryBarrier hostRead{}; hostRead.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    hostRead.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT; hostRead.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    hostRead.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; hostRead.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostRead.buffer = readbacks_[index].buffer->get(); hostRead.offset = 0; hostRead.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0,
+                         0, nullptr, 1, &hostRead, 1, &restore);
+}
+
+void FrameCapture::writerLoop() {
+#ifdef __linux__
+    // Mismo criterio que el servidor de métricas: el escritor cede la CPU al bucle de frame
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+    for (;;) {
+        uint32_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return readyCount_ > 0 || stopping_; });
+            if (readyCount_ == 0) return; // Parando y sin nada pendiente
+            index = readyReadbacks_[readyHead_];
+            readyHead_ = (readyHead_ + 1) % readyReadbacks_.size();
+            --readyCount_;
+        }
+        if (!failed_ && writeFrame(readbacks_[index])) writtenFrames_.fetch_add(1, std::memory_order_relaxed);
+        else droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex_);
+        freeReadbacks_.push_back(index);
+    }
+}
+
+bool FrameCapture::writeFrame(const Readback& readback) {
+    const uint8_t* source = readback.mapped;
+    const size_t pixelCount = static_cast<size_t>(extent_.width) * extent_.height;
+    const size_t red = swapRedBlue_ ? 2 : 0, blue = swapRedBlue_ ? 0 : 2;
+
+    if (settings_.format == CaptureFormat::PngSequence) {
+        uint8_t* rgb = pixels_.data();
+        for (size_t i = 0; i < pixelCount; ++i, source += 4, rgb += 3) {
+            rgb[0] = source[red]; rgb[1] = source[1]; rgb[2] = source[blue];
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%06llu.png", static_cast<unsigned long long>(readback.frameNumber));
+        std::string path = (std::filesystem::path(settings_.output) / name).string();
+        if (!writePng(path, pixels_.data(), extent_.width, extent_.height, 3, encoded_)) {
+            PARTICULAS_LOG(Error) << "[Capture] Cannot write '" << path << "'; capture stopped.";
+            failed_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    if (!rawOutput_ && !openRawOutput()) return false;
+    if (swapRedBlue_) {
+        uint8_t* rgba = pixels_.data();
+        for (size_t i = 0; i < pixelCount; ++i, source += 4, rgba += 4) {
+            rgba[0] = source[2]; rgba[1] = source[1]; rgba[2] = source[0]; rgba[3] = source[3];
+        }
+        source = pixels_.data();
+    }
+    if (std::fwrite(source, 1, pixelCount * 4, rawOutput_) != pixelCount * 4) {
+        PARTICULAS_LOG(Error) << "[Capture] Raw output closed or full; capture stopped.";
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+// Una FIFO sin lector no se abre (en POSIX, sin bloquear): el frame se descarta y se reintenta
+// con el siguiente, así el escritor nunca se queda parado esperando a un lector que no llega
+bool FrameCapture::openRawOutput() {
+#ifndef _WIN32
+    int fd = open(settings_.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_NONBLOCK | O_CLOEXEC, 0644);
+    if (fd == -1 && errno == ENXIO) {
+        if (!waitingForReader_) {
+            PARTICULAS_LOG(Info) << "[Capture] Waiting for a reader on '" << settings_.output << "'...";
+            waitingForReader_ = true;
+        }
+        return false;
+    }
+    if (fd != -1) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+        rawOutput_ = fdopen(fd, "wb");
+        if (!rawOutput_) close(fd);
+    }
+#else
+    rawOutput_ = std::fopen(settings_.output.c_str(), "wb");
+#endif
+    if (!rawOutput_) {
+        PARTICULAS_LOG(Error) << "[Capture] Cannot open '" << settings_.output << "'; capture stopped.";
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+void FrameCapture::closeRawOutput() {
+    if (!rawOutput_) return;
+    if (rawOutputIsPipe_) closePipe(rawOutput_); // Espera a que el comando termine de procesar los frames
+    else std::fclose(rawOutput_);
+    rawOutput_ = nullptr;
+}
+
+} // namespace particulas
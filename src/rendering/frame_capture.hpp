@@ -0,0 +1,117 @@
+#ifndef PARTICULAS_RENDERING_FRAME_CAPTURE_HPP
+#define PARTICULAS_RENDERING_FRAME_CAPTURE_HPP
+
+#include "core/device.hpp"
+#include "core/buffer.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace particulas {
+
+enum class CaptureFormat {
+    PngSequence, // <output>/frame_NNNNNN.png (RGB); el número es el del frame, así que los descartes dejan huecos
+    RawVideo     // RGBA de 8 bits, un frame tras otro, a un fichero, una FIFO o la entrada de pipeCommand
+};
+
+struct FrameCaptureSettings {
+    CaptureFormat format = CaptureFormat::PngSequence;
+    std::string output = "capture"; // PNG: directorio (se crea). Crudo: fichero o FIFO (se abre al llegar el primer frame)
+    // Crudo: si no está vacío, los frames van a la entrada estándar de este comando (popen), p. ej.
+    // "ffmpeg -f rawvideo -pixel_format rgba -video_size 1920x1080 -framerate 60 -i - -y capture.mp4"
+    std::string pipeCommand;
+    uint32_t interval = 1;   // Un frame de cada interval
+    uint64_t maxFrames = 0;  // Frames a capturar (0 = sin límite)
+    uint32_t bufferCount = 6; // Buffers de lectura: frames en vuelo + margen para el escritor
+    uint64_t firstFrame = 0;  // Número del primer frame: al recrear la captura con otro tamaño, la secuencia sigue
+};
+
+// Captura de frames renderizados sin parar el pipeline. recordCopy añade al final del command
+// buffer del frame una copia de la imagen (swapchain o destino sin ventana) a uno de los buffers
+// host-visible del anillo; collect, llamado cuando la fence/timeline de ese slot ya se ha
+// señalado, pasa el buffer al hilo escritor, que convierte y escribe directamente desde la
+// memoria mapeada y lo devuelve al anillo. El hilo principal no copia píxeles ni espera: si no
+// queda un buffer libre (el escritor va por detrás) el frame no se captura y se cuenta como
+// descartado. La imagen debe admitir TRANSFER_SRC y ser B8G8R8A8 o R8G8B8A8 (UNORM o SRGB).
+// Destruir con la GPU parada: el destructor recoge lo pendiente y espera a que se escriba.
+class FrameCapture {
+public:
+    // slotCount: frames en vuelo (índices de recordCopy/collect). Lanza std::invalid_argument si
+    // el formato no se admite y std::runtime_error si no puede preparar la salida.
+    FrameCapture(const Device& device, VkFormat imageFormat, VkExtent2D extent, uint32_t slotCount,
+                 const FrameCaptureSettings& settings);
+    ~FrameCapture();
+
+    static bool isSupportedFormat(VkFormat format);
+
+    // Tras la espera del slot: entrega al escritor la copia que se grabó en él
+    void collect(uint32_t slot);
+    // Al final del frame (fuera de un render pass). image está en layout, que se restaura tras la copia.
+    void recordCopy(VkCommandBuffer commandBuffer, uint32_t slot, VkImage image, VkImageLayout layout);
+
+    uint64_t getWrittenFrames() const { return writtenFrames_.load(std::memory_order_relaxed); }
+    uint64_t getDroppedFrames() const { return droppedFrames_.load(std::memory_order_relaxed); }
+    uint64_t getSeenFrames() const { return frameCounter_; }        // Siguiente número de frame
+    uint64_t getRequestedFrames() const { return requestedFrames_; } // Copias grabadas (cuentan para maxFrames)
+    bool isFinished() const; // Alcanzado maxFrames
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+private:
+    static constexpr uint32_t NO_BUFFER = UINT32_MAX;
+
+    struct Readback {
+        std::unique_ptr<Buffer> buffer;
+        const uint8_t* mapped = nullptr;
+        uint64_t frameNumber = 0;
+    };
+
+    void writerLoop();
+    bool writeFrame(const Readback& readback);
+    bool openRawOutput();
+    void closeRawOutput();
+
+    FrameCaptureSettings settings_;
+    VkExtent2D extent_;
+    bool swapRedBlue_ = false;  // Origen BGRA
+    VkDeviceSize frameBytes_ = 0;
+    std::vector<Readback> readbacks_;
+    std::vector<uint32_t> slotReadback_;    // Buffer con la copia grabada en cada slot (NO_BUFFER si ninguna)
+    uint64_t frameCounter_ = 0;            // Frames vistos por recordCopy
+    uint64_t requestedFrames_ = 0;         // Copias grabadas
+
+    // Anillo compartido con el escritor (capacidad fija: no se reserva memoria por frame)
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<uint32_t> freeReadbacks_;
+    std::vector<uint32_t> readyReadbacks_;  // Cola circular en orden de frame
+    size_t readyHead_ = 0;
+    size_t readyCount_ = 0;
+    bool stopping_ = false;
+
+    // Solo el hilo escritor
+    std::vector<uint8_t> pixels_;   // Frame convertido a RGB/RGBA
+    std::vector<uint8_t> encoded_;  // PNG codificado
+    std::FILE* rawOutput_ = nullptr;
+    bool rawOutputIsPipe_ = false;
+    bool waitingForReader_ = false;
+    bool failed_ = false;
+
+    std::atomic<uint64_t> writtenFrames_{0};
+    std::atomic<uint64_t> droppedFrames_{0};
+    std::thread writer_;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_RENDERING_FRAME_CAPTURE_HPP
@@ -0,0 +1,320 @@
+#include "gpu_particle_system.hpp"
+#include "utils/vulkan_debug.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+constexpr uint32_t GROUP_SIZE = 256; // PARTICLE_GROUP_SIZE en particle_common.glsl
+constexpr uint32_t BINDING_COUNT = 9;
+constexpr uint32_t SCAN_OFFSETS_BINDING = 4; // ScanOffsets en particle_common.glsl
+
+uint32_t groupsFor(uint32_t count) { return (count + GROUP_SIZE - 1) / GROUP_SIZE; }
+}
+
+// El layout de Particle se comparte tal cual con los shaders (std430)
+static_assert(sizeof(Particle) == 32, "Particle must match the std430 layout in particle_struct.glsl");
+static_assert(sizeof(GpuParticleParams) == 84, "GpuParticleParams must match the push constant block");
+
+// --- Constructor ---
+GpuParticleSystem::GpuParticleSystem(const Device& device, CommandPool& commandPool, const ParticleSystem& initialState,
+                                     const SpeciesBuffer& species, VkPipelineCache pipelineCache)
+    : device_(device.getLogicalDevice()),
+      queue_(device.getGraphicsQueue()),
+      capacity_(static_cast<uint32_t>(initialState.getCapacity())),
+      groupCount_(groupsFor(static_cast<uint32_t>(initialState.getCapacity()))),
+      domainSize_(initialState.getWidth(), initialState.getHeight()),
+      gravity_(initialState.getGravity()),
+      viewRect_(0.0f, 0.0f, initialState.getWidth(), initialState.getHeight()),
+      emitters_(initialState.getEmitters()),
+      speciesDescriptorSet_(species.getDescriptorSet())
+{
+    // La cola gráfica debe admitir cómputo (la especificación lo garantiza para alguna familia gráfica)
+    uint32_t familyCount = 0; vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount); vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, families.data());
+    if (!(families[device.getGraphicsQueueFamilyIndex()].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        throw std::runtime_error("GPU particle simulation requires a graphics queue with compute support.");
+    }
+
+    try {
+        createBuffers(device, commandPool, initialState);
+        createDescriptors();
+        createPipelines(pipelineCache, species.getDescriptorSetLayout());
+    } catch (...) {
+        if (pipelineLayout_ != VK_NULL_HANDLE) vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
+        if (descriptorPool_ != VK_NULL_HANDLE) vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+        if (descriptorSetLayout_ != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
+        throw;
+    }
+    PARTICULAS_LOG(Info) << "GPU particle system created. Capacity: " << capacity_ << " (" << groupCount_ << " groups).";
+}
+
+// --- Destructor ---
+GpuParticleSystem::~GpuParticleSystem() {
+    simulatePipeline_.reset(); emitPipeline_.reset(); scanLocalPipeline_.reset();
+    scanBlocksPipeline_.reset(); compactPipeline_.reset(); finalizePipeline_.reset(); cullPipeline_.reset();
+    if (pipelineLayout_ != VK_NULL_HANDLE) vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
+    if (descriptorPool_ != VK_NULL_HANDLE) vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+    if (descriptorSetLayout_ != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
+}
+
+// --- createBuffers ---
+void GpuParticleSystem::createBuffers(const Device& device, CommandPool& commandPool, const ParticleSystem& initialState) {
+    VkDeviceSize particleBytes = sizeof(Particle) * capacity_;
+    for (auto& buffer : particleBuffers_) {
+        buffer = std::make_unique<Buffer>(device, particleBytes,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+    countersBuffer_ = std::make_unique<Buffer>(device, sizeof(GpuParticleCounters),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    freeListBuffer_ = std::make_unique<Buffer>(device, sizeof(uint32_t) * capacity_,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    scanOffsetsBuffer_ = std::make_unique<Buffer>(device, getScratchBytes(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    blockSumsBuffer_ = std::make_unique<Buffer>(device, sizeof(uint32_t) * groupCount_,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    indirectBuffer_ = std::make_unique<Buffer>(device, sizeof(VkDrawIndirectCommand),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    visibleBuffer_ = std::make_unique<Buffer>(device, particleBytes,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    visibleIndirectBuffer_ = std::make_unique<Buffer>(device, sizeof(VkDrawIndirectCommand),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+            | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    visibleCountReadback_ = std::make_unique<Buffer>(device, sizeof(uint32_t) * MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    void* readback = visibleCountReadback_->map();
+    std::memset(readback, 0, sizeof(uint32_t) * MAX_FRAMES_IN_FLIGHT);
+    visibleCounts_ = static_cast<const uint32_t*>(readback);
+
+    // Estado inicial: el rango vivo de la CPU, contadores y comando indirecto coherentes
+    uint32_t initialCount = static_cast<uint32_t>(initialState.getParticleCount());
+    GpuParticleCounters counters{initialCount, initialCount, 0, 0, 0};
+    VkDrawIndirectCommand drawCommand{initialCount, 1, 0, 0};
+    VkDeviceSize initialBytes = sizeof(Particle) * std::max<uint32_t>(initialCount, 1);
+    VkDeviceSize stagingSize = initialBytes + sizeof(counters) + sizeof(drawCommand);
+
+    Buffer staging(device, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    char* data = static_cast<char*>(staging.map());
+    if (initialCount > 0) memcpy(data, initialState.getParticles().data(), sizeof(Particle) * initialCount);
+    memcpy(data + initialBytes, &counters, sizeof(counters));
+    memcpy(data + initialBytes + sizeof(counters), &drawCommand, sizeof(drawCommand));
+    staging.unmap();
+
+    VkCommandBuffer commandBuffer = commandPool.beginSingleTimeCommands();
+    if (initialCount > 0) {
+        VkBufferCopy particlesRegion{0, 0, sizeof(Particle) * initialCount};
+        vkCmdCopyBuffer(commandBuffer, staging.get(), particleBuffers_[0]->get(), 1, &particlesRegion);
+    }
+    VkBufferCopy countersRegion{initialBytes, 0, sizeof(counters)};
+    vkCmdCopyBuffer(commandBuffer, staging.get(), countersBuffer_->get(), 1, &countersRegion);
+    VkBufferCopy indirectRegion{initialBytes + sizeof(counters), 0, sizeof(drawCommand)};
+    vkCmdCopyBuffer(commandBuffer, staging.get(), indirectBuffer_->get(), 1, &indirectRegion);
+    vkCmdFillBuffer(commandBuffer, visibleIndirectBuffer_->get(), 0, VK_WHOLE_SIZE, 0); // Nada visible hasta el primer frame
+    commandPool.endSingleTimeCommands(commandBuffer, queue_);
+    current_ = 0;
+}
+
+// --- createDescriptors ---
+void GpuParticleSystem::createDescriptors() {
+    std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings{};
+    for (uint32_t i = 0; i < BINDING_COUNT; ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo layoutInfo{}; layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = BINDING_COUNT; layoutInfo.pBindings = bindings.data();
+    particulas::debug::checkVkResult(vkCreateDescriptorSetLayout(device_, &layoutInfo, nullptr, &descriptorSetLayout_), "GPU particles descriptor set layout");
+
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, BINDING_COUNT * 2};
+    VkDescriptorPoolCreateInfo poolInfo{}; poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 2; poolInfo.poolSizeCount = 1; poolInfo.pPoolSizes = &poolSize;
+    particulas::debug::checkVkResult(vkCreateDescriptorPool(device_, &poolInfo, nullptr, &descriptorPool_), "GPU particles descriptor pool");
+
+    std::array<VkDescriptorSetLayout, 2> layouts = {descriptorSetLayout_, descriptorSetLayout_};
+    VkDescriptorSetAllocateInfo allocInfo{}; allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = descriptorPool_; allocInfo.descriptorSetCount = 2; allocInfo.pSetLayouts = layouts.data();
+    particulas::debug::checkVkResult(vkAllocateDescriptorSets(device_, &allocInfo, descriptorSets_.data()), "GPU particles descriptor sets");
+
+    for (uint32_t set = 0; set < 2; ++set) {
+        std::array<VkDescriptorBufferInfo, BINDING_COUNT> bufferInfos = {{
+            {particleBuffers_[set]->get(), 0, VK_WHOLE_SIZE},
+            {particleBuffers_[1 - set]->get(), 0, VK_WHOLE_SIZE},
+            {countersBuffer_->get(), 0, VK_WHOLE_SIZE},
+            {freeListBuffer_->get(), 0, VK_WHOLE_SIZE},
+            {scanOffsetsBuffer_->get(), 0, VK_WHOLE_SIZE},
+            {blockSumsBuffer_->get(), 0, VK_WHOLE_SIZE},
+            {indirectBuffer_->get(), 0, VK_WHOLE_SIZE},
+            {visibleBuffer_->get(), 0, VK_WHOLE_SIZE},
+            {visibleIndirectBuffer_->get(), 0, VK_WHOLE_SIZE},
+        }};
+        std::array<VkWriteDescriptorSet, BINDING_COUNT> writes{};
+        for (uint32_t i = 0; i < BINDING_COUNT; ++i) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = descriptorSets_[set];
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &bufferInfos[i];
+        }
+        vkUpdateDescriptorSets(device_, BINDING_COUNT, writes.data(), 0, nullptr);
+    }
+}
+
+// --- useScratchBuffer ---
+void GpuParticleSystem::useScratchBuffer(VkBuffer scanOffsets) {
+    for (VkDescriptorSet set : descriptorSets_) {
+        VkDescriptorBufferInfo bufferInfo{scanOffsets, 0, VK_WHOLE_SIZE};
+        VkWriteDescriptorSet write{}; write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set; write.dstBinding = SCAN_OFFSETS_BINDING; write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER; write.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(device_, 1, &write, 0, nullptr);
+    }
+    scanOffsetsBuffer_.reset(); // Ningún set lo referencia ya
+}
+
+// --- createPipelines ---
+void GpuParticleSystem::createPipelines(VkPipelineCache pipelineCache, VkDescriptorSetLayout speciesLayout) {
+    VkPushConstantRange pushRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GpuParticleParams)};
+    std::array<VkDescriptorSetLayout, 2> setLayouts = {descriptorSetLayout_, speciesLayout}; // Set 1: tabla de especies
+    VkPipelineLayoutCreateInfo layoutInfo{}; layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size()); layoutInfo.pSetLayouts = setLayouts.data();
+    layoutInfo.pushConstantRangeCount = 1; layoutInfo.pPushConstantRanges = &pushRange;
+    particulas::debug::checkVkResult(vkCreatePipelineLayout(device_, &layoutInfo, nullptr, &pipelineLayout_), "GPU particles pipeline layout");
+
+    simulatePipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/particle_simulate.comp.spv", pipelineLayout_, pipelineCache);
+    emitPipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/particle_emit.comp.spv", pipelineLayout_, pipelineCache);
+    scanLocalPipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/particle_scan_local.comp.spv", pipelineLayout_, pipelineCache);
+    scanBlocksPipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/particle_scan_blocks.comp.spv", pipelineLayout_, pipelineCache);
+    compactPipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/particle_compact.comp.spv", pipelineLayout_, pipelineCache);
+    finalizePipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/particle_finalize.comp.spv", pipelineLayout_, pipelineCache);
+    cullPipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/particle_cull.comp.spv", pipelineLayout_, pipelineCache);
+}
+
+// Barrera cómputo -> cómputo entre passes (escrituras visibles para lecturas y atómicos)
+void GpuParticleSystem::computeBarrier(VkCommandBuffer commandBuffer) const {
+    VkMemoryBarrier barrier{}; barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+// --- recordSimulation ---
+void GpuParticleSystem::recordSimulation(VkCommandBuffer commandBuffer, float deltaTime) {
+    // El frame anterior leyó vértices y el comando indirecto de estos buffers: esperar antes de escribir
+    VkMemoryBarrier entryBarrier{}; entryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    entryBarrier.srcAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    entryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &entryBarrier, 0, nullptr, 0, nullptr);
+
+    GpuParticleParams params{};
+    params.domainSize = domainSize_;
+    params.gravity = gravity_;
+    params.viewRect = viewRect_;
+    params.deltaTime = deltaTime;
+    params.capacity = capacity_;
+    params.seed = ++frameSeed_ * 0x9E3779B9u;
+
+    std::array<VkDescriptorSet, 2> sets = {descriptorSets_[current_], speciesDescriptorSet_};
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout_, 0, static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+    auto pushParams = [&]() {
+        vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GpuParticleParams), &params);
+    };
+
+    // 1. Integrar, envejecer y matar (apila huecos en la free list)
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, simulatePipeline_->get());
+    pushParams();
+    vkCmdDispatch(commandBuffer, groupCount_, 1, 1);
+    computeBarrier(commandBuffer);
+
+    // 2. Emitir: el número por emisor se calcula en CPU a partir de la tasa, sin leer nada de la GPU
+    bool emitted = false;
+    for (auto& emitter : emitters_) {
+        if (!emitter.enabled) continue;
+        emitter.accumulator += emitter.rate * deltaTime;
+        uint32_t emitCount = static_cast<uint32_t>(emitter.accumulator);
+        emitter.accumulator -= static_cast<float>(emitCount);
+        emitCount = std::min(emitCount, capacity_);
+        if (emitCount == 0) continue;
+
+        if (!emitted) vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, emitPipeline_->get());
+        params.emitterSpecies = emitter.species;
+        params.emitterPosition = emitter.position;
+        params.emitterDirection = emitter.direction;
+        params.spreadRadians = emitter.spreadRadians;
+        params.speed = emitter.speed;
+        params.speedJitter = emitter.speedJitter;
+        params.particleLifetime = emitter.particleLifetime;
+        params.emitCount = emitCount;
+        params.seed = params.seed * 1664525u + 1013904223u;
+        pushParams();
+        vkCmdDispatch(commandBuffer, groupsFor(emitCount), 1, 1);
+        computeBarrier(commandBuffer); // Los atómicos del siguiente emisor dependen de este
+        emitted = true;
+    }
+
+    // 3. Compactación por prefix scan: flags por bloque -> offsets de bloque -> dispersión al destino
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, scanLocalPipeline_->get());
+    pushParams();
+    vkCmdDispatch(commandBuffer, groupCount_, 1, 1);
+    computeBarrier(commandBuffer);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, scanBlocksPipeline_->get());
+    pushParams();
+    vkCmdDispatch(commandBuffer, 1, 1, 1);
+    computeBarrier(commandBuffer);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, compactPipeline_->get());
+    pushParams();
+    vkCmdDispatch(commandBuffer, groupCount_, 1, 1);
+    computeBarrier(commandBuffer);
+
+    // 4. Escribir el número de vivas en el comando indirecto y preparar el siguiente frame
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, finalizePipeline_->get());
+    pushParams();
+    vkCmdDispatch(commandBuffer, 1, 1, 1);
+    computeBarrier(commandBuffer);
+
+    // 5. Culling por vista: solo las visibles llegan al buffer que se dibuja
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline_->get());
+    pushParams();
+    vkCmdDispatch(commandBuffer, groupCount_, 1, 1);
+    // Sin barrera de salida: quien consuma los buffers visibles la pone (el grafo de frame la deriva)
+
+    current_ = 1 - current_; // El destino denso pasa a ser la fuente del siguiente frame
+}
+
+// --- recordVisibleCountReadback ---
+void GpuParticleSystem::recordVisibleCountReadback(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    if (frameIndex >= static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT)) return;
+    VkMemoryBarrier cullBarrier{}; cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    cullBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+    VkBufferCopy region{0, sizeof(uint32_t) * frameIndex, sizeof(uint32_t)}; // vertexCount del comando indirecto
+    vkCmdCopyBuffer(commandBuffer, visibleIndirectBuffer_->get(), visibleCountReadback_->get(), 1, &region);
+    VkMemoryBarrier hostBarrier{}; hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+}
+
+uint32_t GpuParticleSystem::getVisibleCount(uint32_t frameIndex) const {
+    return frameIndex < static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) ? visibleCounts_[frameIndex] : 0;
+}
+
+} // namespace particulas
@@ -0,0 +1,142 @@
+#ifndef PARTICULAS_RENDERING_GPU_PARTICLE_SYSTEM_HPP
+#define PARTICULAS_RENDERING_GPU_PARTICLE_SYSTEM_HPP
+
+#include "core/device.hpp"
+#include "core/command_pool.hpp"
+#include "core/buffer.hpp"
+#include "core/compute_pipeline.hpp"
+#include "core/sync.hpp"
+#include "particles/particle_system.hpp"
+#include "rendering/species_buffer.hpp"
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace particulas {
+
+// Contadores en GPU (mismo layout que ParticleCounters en particle_common.glsl)
+struct GpuParticleCounters {
+    uint32_t rangeEnd;
+    uint32_t liveCount;
+    uint32_t freeCount;
+    uint32_t freeConsumed;
+    uint32_t dropped;
+};
+
+// Push constants compartidas por todos los passes (GpuParticleParams en particle_common.glsl)
+struct GpuParticleParams {
+    glm::vec4 viewRect; // min.xy, max.xy del rectángulo visible (culling)
+    glm::vec2 emitterPosition;
+    glm::vec2 emitterDirection;
+    glm::vec2 domainSize;
+    glm::vec2 gravity;  // ParticleSystem::getGravity(); cada especie la escala con gravityScale
+    float deltaTime;
+    float spreadRadians;
+    float speed;
+    float speedJitter;
+    float particleLifetime;
+    uint32_t emitCount;
+    uint32_t capacity;
+    uint32_t seed;
+    uint32_t emitterSpecies;
+};
+
+// Simulación, emisión y compactación de partículas enteramente en GPU.
+// Cada frame: simulate (integra y mata, apilando huecos en una free list) -> emit (atómicos sobre
+// la free list y el fin del rango) -> scan por bloques -> scan de bloques -> compactación a un
+// buffer denso -> finalize (escribe el VkDrawIndirectCommand) -> cull (copia las visibles a un buffer
+// aparte con su propio comando indirecto). El número de vivas nunca vuelve a la CPU.
+class GpuParticleSystem {
+public:
+    // Copia las partículas iniciales y los emisores de initialState. La capacidad es la del pool.
+    // species: tabla de especies ya subida (set 1 de los passes de cómputo)
+    GpuParticleSystem(const Device& device, CommandPool& commandPool, const ParticleSystem& initialState,
+                      const SpeciesBuffer& species, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+    ~GpuParticleSystem();
+
+    // Graba los passes de cómputo del frame (fuera de cualquier render pass) y alterna los buffers.
+    // No sincroniza la salida: antes de leer los buffers visibles (vértices, indirecto o cómputo)
+    // hace falta una barrera desde COMPUTE_SHADER/SHADER_WRITE.
+    void recordSimulation(VkCommandBuffer commandBuffer, float deltaTime);
+
+    // Offsets del scan: solo se usan dentro de recordSimulation, así que pueden vivir en memoria
+    // compartida con otros temporales del frame. useScratchBuffer los redirige a un buffer externo
+    // (STORAGE, al menos getScratchBytes()) y libera el propio. Solo sin frames en vuelo.
+    VkDeviceSize getScratchBytes() const { return sizeof(uint32_t) * capacity_; }
+    void useScratchBuffer(VkBuffer scanOffsets);
+
+    // Memoria DEVICE_LOCAL por slot de capacidad: ping-pong y visibles, lista libre y offsets del scan
+    static constexpr VkDeviceSize getDeviceBytesPerParticle() { return 3 * sizeof(Particle) + 2 * sizeof(uint32_t); }
+
+    // Buffer denso de partículas (vértices) y comando de dibujo indirecto del último frame grabado
+    VkBuffer getVertexBuffer() const { return particleBuffers_[current_]->get(); }
+    VkBuffer getIndirectBuffer() const { return indirectBuffer_->get(); }
+
+    // Rectángulo visible del mundo para el siguiente recordSimulation (por defecto, todo el dominio)
+    void setViewRect(const glm::vec2& min, const glm::vec2& max) { viewRect_ = glm::vec4(min.x, min.y, max.x, max.y); }
+    // Solo las partículas dentro del rectángulo, y su comando de dibujo indirecto
+    VkBuffer getVisibleBuffer() const { return visibleBuffer_->get(); }
+    VkBuffer getVisibleIndirectBuffer() const { return visibleIndirectBuffer_->get(); }
+    // Copia el número de visibles del frame a memoria del host (grabar tras recordSimulation, en el
+    // mismo command buffer). Se lee con getVisibleCount(frameIndex) cuando la fence de ese frame ya
+    // se ha esperado: un frame tarde, sin bloquear la GPU.
+    void recordVisibleCountReadback(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+    uint32_t getVisibleCount(uint32_t frameIndex) const;
+    uint32_t getCapacity() const { return capacity_; }
+    // Aceleración constante (la de initialState al construirse), como ParticleSystem::setGravity
+    void setGravity(const glm::vec2& gravity) { gravity_ = gravity; }
+    const glm::vec2& getGravity() const { return gravity_; }
+
+    GpuParticleSystem(const GpuParticleSystem&) = delete;
+    GpuParticleSystem& operator=(const GpuParticleSystem&) = delete;
+
+private:
+    void createBuffers(const Device& device, CommandPool& commandPool, const ParticleSystem& initialState);
+    void createDescriptors();
+    void createPipelines(VkPipelineCache pipelineCache, VkDescriptorSetLayout speciesLayout);
+    void computeBarrier(VkCommandBuffer commandBuffer) const;
+
+    VkDevice device_;
+    VkQueue queue_;
+    uint32_t capacity_;
+    uint32_t groupCount_;
+    glm::vec2 domainSize_;
+    glm::vec2 gravity_;
+    glm::vec4 viewRect_;
+    std::vector<Emitter> emitters_;
+    uint32_t frameSeed_ = 0;
+
+    std::array<std::unique_ptr<Buffer>, 2> particleBuffers_; // Ping-pong: fuente / destino denso
+    std::unique_ptr<Buffer> countersBuffer_;
+    std::unique_ptr<Buffer> freeListBuffer_;
+    std::unique_ptr<Buffer> scanOffsetsBuffer_;
+    std::unique_ptr<Buffer> blockSumsBuffer_;
+    std::unique_ptr<Buffer> indirectBuffer_;
+    std::unique_ptr<Buffer> visibleBuffer_;
+    std::unique_ptr<Buffer> visibleIndirectBuffer_;
+    std::unique_ptr<Buffer> visibleCountReadback_; // HOST_VISIBLE, un uint por frame en vuelo
+    const uint32_t* visibleCounts_ = nullptr;       // Mapeado durante toda la vida del sistema
+    uint32_t current_ = 0; // Índice del buffer que contiene el conjunto denso actual
+
+    VkDescriptorSetLayout descriptorSetLayout_ = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool_ = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, 2> descriptorSets_{}; // [i]: fuente = buffer i, destino = buffer 1-i
+    VkDescriptorSet speciesDescriptorSet_; // Propiedad de SpeciesBuffer
+    VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
+
+    std::unique_ptr<ComputePipeline> simulatePipeline_;
+    std::unique_ptr<ComputePipeline> emitPipeline_;
+    std::unique_ptr<ComputePipeline> scanLocalPipeline_;
+    std::unique_ptr<ComputePipeline> scanBlocksPipeline_;
+    std::unique_ptr<ComputePipeline> compactPipeline_;
+    std::unique_ptr<ComputePipeline> finalizePipeline_;
+    std::unique_ptr<ComputePipeline> cullPipeline_;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_RENDERING_GPU_PARTICLE_SYSTEM_HPP
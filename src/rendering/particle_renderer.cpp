@@ -1,111 +1,126 @@
 #include "particle_renderer.hpp"    // <-- Incluir la propia declaración PRIMERO
 #include "particles/particle.hpp" // <-- Incluir Particle (necesario para sizeof, offsetof)
 #include "utils/vulkan_debug.hpp" // Para checkVkResult
+#include "utils/logger.hpp"
 
 #include <stdexcept>
 #include <cstring> // Para memcpy
-#include <iostream>
 #include <vector>
 #include <array>
+#include <algorithm>
 
 namespace particulas {
 
 // --- Constructor ---
-ParticleRenderer::ParticleRenderer(const Device& device, const CommandPool& commandPool)
+ParticleRenderer::ParticleRenderer(const Device& device, const CommandPool& commandPool, VkDescriptorSet speciesDescriptorSet)
     : deviceRef_(device),
       device_(device.getLogicalDevice()),
       physicalDevice_(device.getPhysicalDevice()),
       commandPool_(commandPool.get()),
-      graphicsQueue_(device.getGraphicsQueue())
+      graphicsQueue_(device.getGraphicsQueue()),
+      speciesDescriptorSet_(speciesDescriptorSet)
 {}
 
 // --- Destructor ---
 ParticleRenderer::~ParticleRenderer() {
+    destroyBuffers();
+}
+
+// --- destroyBuffers ---
+void ParticleRenderer::destroyBuffers() {
     if (vertexBuffer_ != VK_NULL_HANDLE) vkDestroyBuffer(device_, vertexBuffer_, nullptr);
     if (vertexBufferMemory_ != VK_NULL_HANDLE) vkFreeMemory(device_, vertexBufferMemory_, nullptr);
+    vertexBuffer_ = VK_NULL_HANDLE; vertexBufferMemory_ = VK_NULL_HANDLE; currentBufferSize_ = 0;
+    for (size_t slot = 0; slot < stagingBuffers_.size(); ++slot) {
+        if (stagingMapped_[slot] != nullptr) vkUnmapMemory(device_, stagingMemories_[slot]);
+        if (stagingBuffers_[slot] != VK_NULL_HANDLE) vkDestroyBuffer(device_, stagingBuffers_[slot], nullptr);
+        if (stagingMemories_[slot] != VK_NULL_HANDLE) vkFreeMemory(device_, stagingMemories_[slot], nullptr);
+        stagingBuffers_[slot] = VK_NULL_HANDLE; stagingMemories_[slot] = VK_NULL_HANDLE; stagingMapped_[slot] = nullptr;
+        stagedBytes_[slot] = 0;
+    }
 }
 
 // --- createBuffers ---
 void ParticleRenderer::createBuffers(const std::vector<Particle>& particles) {
+    destroyBuffers();
     if (particles.empty()) {
-         if (vertexBuffer_ != VK_NULL_HANDLE) vkDestroyBuffer(device_, vertexBuffer_, nullptr);
-         if (vertexBufferMemory_ != VK_NULL_HANDLE) vkFreeMemory(device_, vertexBufferMemory_, nullptr);
-         vertexBuffer_ = VK_NULL_HANDLE; vertexBufferMemory_ = VK_NULL_HANDLE; currentBufferSize_ = 0;
-         std::cout << "Warning: ParticleRenderer::createBuffers called with empty particle vector.\n"; return;
+         PARTICULAS_LOG(Warning) << "ParticleRenderer::createBuffers called with empty particle vector."; return;
     }
     VkDeviceSize bufferSize = sizeof(Particle) * particles.size();
-    if (vertexBuffer_ != VK_NULL_HANDLE) vkDestroyBuffer(device_, vertexBuffer_, nullptr);
-    if (vertexBufferMemory_ != VK_NULL_HANDLE) vkFreeMemory(device_, vertexBufferMemory_, nullptr);
-    vertexBuffer_ = VK_NULL_HANDLE; vertexBufferMemory_ = VK_NULL_HANDLE;
-
-    VkBuffer stagingBuffer = VK_NULL_HANDLE; VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
-    VkBuffer tempVertexBuffer = VK_NULL_HANDLE; VkDeviceMemory tempVertexBufferMemory = VK_NULL_HANDLE; // Usar temporales
     try {
-        createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-        void* data;
-        particulas::debug::checkVkResult(vkMapMemory(device_, stagingBufferMemory, 0, bufferSize, 0, &data), "Map staging buffer memory");
-        memcpy(data, particles.data(), (size_t)bufferSize);
-        vkUnmapMemory(device_, stagingBufferMemory);
-
-        createBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, tempVertexBuffer, tempVertexBufferMemory);
-        copyBuffer(stagingBuffer, tempVertexBuffer, bufferSize);
-
-        // Asignar a miembros solo si todo fue exitoso
-        vertexBuffer_ = tempVertexBuffer;
-        vertexBufferMemory_ = tempVertexBufferMemory;
+        for (size_t slot = 0; slot < stagingBuffers_.size(); ++slot) {
+            createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                         stagingBuffers_[slot], stagingMemories_[slot]);
+            particulas::debug::checkVkResult(vkMapMemory(device_, stagingMemories_[slot], 0, bufferSize, 0, &stagingMapped_[slot]), "Map staging buffer memory");
+        }
+        createBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer_, vertexBufferMemory_);
         currentBufferSize_ = bufferSize;
-        tempVertexBuffer = VK_NULL_HANDLE; // Evitar doble liberación en catch/finally
-        tempVertexBufferMemory = VK_NULL_HANDLE;
-
+        // Contenido inicial: aún no hay frames en vuelo, se copia de forma síncrona desde el primer staging
+        memcpy(stagingMapped_[0], particles.data(), (size_t)bufferSize);
+        copyBuffer(stagingBuffers_[0], vertexBuffer_, bufferSize);
     } catch (...) {
-         if (tempVertexBuffer != VK_NULL_HANDLE) vkDestroyBuffer(device_, tempVertexBuffer, nullptr); // Limpiar temporal si falla
-         if (tempVertexBufferMemory != VK_NULL_HANDLE) vkFreeMemory(device_, tempVertexBufferMemory, nullptr);
-         if (stagingBuffer != VK_NULL_HANDLE) vkDestroyBuffer(device_, stagingBuffer, nullptr);
-         if (stagingBufferMemory != VK_NULL_HANDLE) vkFreeMemory(device_, stagingBufferMemory, nullptr);
-         throw;
+        destroyBuffers();
+        throw;
     }
-    // Limpieza final del staging buffer
-    if (stagingBuffer != VK_NULL_HANDLE) vkDestroyBuffer(device_, stagingBuffer, nullptr);
-    if (stagingBufferMemory != VK_NULL_HANDLE) vkFreeMemory(device_, stagingBufferMemory, nullptr);
 
-    std::cout << "Particle vertex buffer created. Size: " << currentBufferSize_ << " bytes.\n";
+    PARTICULAS_LOG(Info) << "Particle vertex buffer created. Size: " << currentBufferSize_ << " bytes (+" << stagingBuffers_.size()
+              << " persistent staging buffers).";
 }
 
 // --- updateBuffers ---
-void ParticleRenderer::updateBuffers(const std::vector<Particle>& particles) {
+void ParticleRenderer::updateBuffers(const std::vector<Particle>& particles, size_t liveCount, uint32_t frameIndex) {
+    stagedBytes_.at(frameIndex) = 0;
     if (vertexBuffer_ == VK_NULL_HANDLE) return; // No se puede actualizar si no existe
-    if (particles.empty()) return; // No hacer nada si no hay datos
+    liveCount = std::min(liveCount, particles.size());
+    VkDeviceSize bufferSize = sizeof(Particle) * liveCount; // Coste proporcional a las vivas, no a la capacidad
+    if (bufferSize > currentBufferSize_) throw std::runtime_error("ParticleRenderer::updateBuffers: live range exceeds the buffer capacity.");
+    if (bufferSize == 0) return;
+    memcpy(stagingMapped_[frameIndex], particles.data(), (size_t)bufferSize);
+    stagedBytes_[frameIndex] = bufferSize;
+}
 
-    VkDeviceSize bufferSize = sizeof(Particle) * particles.size();
-    if (bufferSize != currentBufferSize_) { createBuffers(particles); return; } // Recrear si cambia tamaño
-
-    VkBuffer stagingBuffer = VK_NULL_HANDLE; VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
-     try {
-        createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-        void* data;
-        particulas::debug::checkVkResult(vkMapMemory(device_, stagingBufferMemory, 0, bufferSize, 0, &data), "Map staging buffer memory (update)");
-        memcpy(data, particles.data(), (size_t)bufferSize);
-        vkUnmapMemory(device_, stagingBufferMemory);
-        copyBuffer(stagingBuffer, vertexBuffer_, bufferSize); // Copiar a buffer existente
-     } catch (...) {
-        if (stagingBuffer != VK_NULL_HANDLE) vkDestroyBuffer(device_, stagingBuffer, nullptr);
-        if (stagingBufferMemory != VK_NULL_HANDLE) vkFreeMemory(device_, stagingBufferMemory, nullptr); throw;
-     }
-     if (stagingBuffer != VK_NULL_HANDLE) vkDestroyBuffer(device_, stagingBuffer, nullptr);
-     if (stagingBufferMemory != VK_NULL_HANDLE) vkFreeMemory(device_, stagingBufferMemory, nullptr);
+// --- recordUpload ---
+void ParticleRenderer::recordUpload(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    VkDeviceSize size = stagedBytes_.at(frameIndex);
+    if (size == 0) return;
+    // WAR: el frame anterior puede seguir leyendo el buffer de vértices (dibujo o splatting). Basta
+    // una dependencia de ejecución: la lectura no deja escrituras que hacer visibles.
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+    VkBufferCopy copyRegion{}; copyRegion.size = size;
+    vkCmdCopyBuffer(commandBuffer, stagingBuffers_[frameIndex], vertexBuffer_, 1, &copyRegion);
 }
 
 // --- recordCommandBuffer ---
-void ParticleRenderer::recordCommandBuffer(VkCommandBuffer commandBuffer, VkPipeline pipeline, VkPipelineLayout pipelineLayout, VkExtent2D swapChainExtent, uint32_t particleCount) {
+void ParticleRenderer::recordCommandBuffer(VkCommandBuffer commandBuffer, VkPipeline pipeline, VkPipelineLayout pipelineLayout, VkExtent2D swapChainExtent,
+                                           const CameraPushConstants& camera, uint32_t particleCount) {
     if (vertexBuffer_ == VK_NULL_HANDLE || particleCount == 0) return;
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
     VkViewport viewport{}; viewport.width = (float)swapChainExtent.width; viewport.height = (float)swapChainExtent.height; viewport.maxDepth = 1.0f;
     vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
     VkRect2D scissor{}; scissor.extent = swapChainExtent;
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(CameraPushConstants), &camera);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &speciesDescriptorSet_, 0, nullptr);
     VkBuffer vertexBuffers[] = {vertexBuffer_}; VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-    vkCmdDraw(commandBuffer, particleCount, 1, 0, 0);
+    vkCmdDraw(commandBuffer, particleCount, 1, 0, 0); // Todas las especies en un único dibujo
+}
+
+// --- recordCommandBuffer (indirecto) ---
+void ParticleRenderer::recordCommandBuffer(VkCommandBuffer commandBuffer, VkPipeline pipeline, VkPipelineLayout pipelineLayout, VkExtent2D swapChainExtent,
+                                           const CameraPushConstants& camera, VkBuffer vertexBuffer, VkBuffer indirectBuffer) {
+    if (vertexBuffer == VK_NULL_HANDLE || indirectBuffer == VK_NULL_HANDLE) return;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    VkViewport viewport{}; viewport.width = (float)swapChainExtent.width; viewport.height = (float)swapChainExtent.height; viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    VkRect2D scissor{}; scissor.extent = swapChainExtent;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(CameraPushConstants), &camera);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &speciesDescriptorSet_, 0, nullptr);
+    VkBuffer vertexBuffers[] = {vertexBuffer}; VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+    vkCmdDrawIndirect(commandBuffer, indirectBuffer, 0, 1, sizeof(VkDrawIndirectCommand));
 }
 
 // --- createBuffer ---
@@ -160,20 +175,24 @@ VkVertexInputBindingDescription ParticleRenderer::getBindingDescription() {
     return bindingDescription; // <-- Return
 }
 
-std::array<VkVertexInputAttributeDescription, 3> ParticleRenderer::getAttributeDescriptions() {
-    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+std::array<VkVertexInputAttributeDescription, 4> ParticleRenderer::getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions{};
     // Location 0: Position
     attributeDescriptions[0].location = 0; attributeDescriptions[0].binding = 0;
     attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT;
     attributeDescriptions[0].offset = offsetof(Particle, position); // <-- Usar Particle::
-    // Location 1: Color
+    // Location 1: Especie (uint de 32 bits: species + reserved; el shader usa los 16 bits bajos)
     attributeDescriptions[1].location = 1; attributeDescriptions[1].binding = 0;
-    attributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-    attributeDescriptions[1].offset = offsetof(Particle, color); // <-- Usar Particle::
+    attributeDescriptions[1].format = VK_FORMAT_R32_UINT;
+    attributeDescriptions[1].offset = offsetof(Particle, species);
     // Location 2: Velocity
     attributeDescriptions[2].location = 2; attributeDescriptions[2].binding = 0;
     attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
     attributeDescriptions[2].offset = offsetof(Particle, velocity); // <-- Usar Particle::
+    // Location 3: Alive (los huecos del pool se descartan en el fragment shader)
+    attributeDescriptions[3].location = 3; attributeDescriptions[3].binding = 0;
+    attributeDescriptions[3].format = VK_FORMAT_R32_UINT;
+    attributeDescriptions[3].offset = offsetof(Particle, alive);
     return attributeDescriptions; // <-- Return
 }
 
@@ -4,6 +4,8 @@
 #include "core/device.hpp"       // <-- ASEGÚRATE QUE ES .hpp
 #include "core/command_pool.hpp" // <-- ASEGÚRATE QUE ES .hpp
 #include "particles/particle.hpp"// <-- ASEGÚRATE QUE ES .hpp
+#include "rendering/camera.hpp"
+#include "core/sync.hpp"          // MAX_FRAMES_IN_FLIGHT
 
 #include <vulkan/vulkan.h>
 #include <vector>
@@ -13,31 +15,59 @@ namespace particulas {
 
 class ParticleRenderer {
 public:
-    ParticleRenderer(const Device& device, const CommandPool& commandPool);
+    // speciesDescriptorSet: tabla de especies (SpeciesBuffer), set 0 del pipeline de puntos
+    ParticleRenderer(const Device& device, const CommandPool& commandPool, VkDescriptorSet speciesDescriptorSet);
     ~ParticleRenderer();
 
+    // Dimensiona el buffer de vértices y los staging de cada frame en vuelo con particles.size()
+    // (capacidad) y sube el contenido inicial.
     void createBuffers(const std::vector<Particle>& particles);
-    void updateBuffers(const std::vector<Particle>& particles);
-    void recordCommandBuffer(VkCommandBuffer commandBuffer, VkPipeline pipeline, VkPipelineLayout pipelineLayout, VkExtent2D swapChainExtent, uint32_t particleCount);
+    // Copia el rango vivo [0, liveCount) al staging del frame (mapeado de forma persistente): no
+    // crea buffers, no reserva memoria y no espera a la GPU. La copia al buffer de vértices la graba
+    // recordUpload en el command buffer del mismo frame.
+    void updateBuffers(const std::vector<Particle>& particles, size_t liveCount, uint32_t frameIndex);
+    // Barrera WAR contra el dibujo/splatting de frames anteriores y copia staging -> vértices.
+    // Fuera de cualquier render pass; la barrera hacia el dibujo la pone el grafo.
+    void recordUpload(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+    void recordCommandBuffer(VkCommandBuffer commandBuffer, VkPipeline pipeline, VkPipelineLayout pipelineLayout, VkExtent2D swapChainExtent,
+                             const CameraPushConstants& camera, uint32_t particleCount);
+    // Dibuja desde un buffer externo (simulación en GPU); el número de vértices lo escribe la GPU
+    void recordCommandBuffer(VkCommandBuffer commandBuffer, VkPipeline pipeline, VkPipelineLayout pipelineLayout, VkExtent2D swapChainExtent,
+                             const CameraPushConstants& camera, VkBuffer vertexBuffer, VkBuffer indirectBuffer);
+
+    // Buffer de vértices actual (también STORAGE para el renderizador de splats)
+    VkBuffer getVertexBuffer() const { return vertexBuffer_; }
+
+    // Memoria DEVICE_LOCAL por slot de capacidad (el buffer de vértices), para planificar la capacidad
+    static constexpr VkDeviceSize getDeviceBytesPerParticle() { return sizeof(Particle); }
 
     static VkVertexInputBindingDescription getBindingDescription();
-    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
+    static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions();
 
 private:
     void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
     void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
     VkCommandBuffer beginSingleTimeCommands();
     void endSingleTimeCommands(VkCommandBuffer commandBuffer);
+    void destroyBuffers();
 
     const Device& deviceRef_; // Guardar referencia a Device
     VkDevice device_;
     VkPhysicalDevice physicalDevice_;
     VkCommandPool commandPool_;
     VkQueue graphicsQueue_;
+    VkDescriptorSet speciesDescriptorSet_;
 
     VkBuffer vertexBuffer_ = VK_NULL_HANDLE;
     VkDeviceMemory vertexBufferMemory_ = VK_NULL_HANDLE;
     VkDeviceSize currentBufferSize_ = 0;
+
+    // Un staging por frame en vuelo: la CPU escribe el del frame actual mientras la GPU aún puede
+    // estar copiando desde el del anterior (waitForFrame protege la reutilización de cada slot)
+    std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> stagingBuffers_{};
+    std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> stagingMemories_{};
+    std::array<void*, MAX_FRAMES_IN_FLIGHT> stagingMapped_{};
+    std::array<VkDeviceSize, MAX_FRAMES_IN_FLIGHT> stagedBytes_{}; // Pendiente de copiar en cada slot
 };
 
 } // namespace particulas
@@ -0,0 +1,307 @@
+#include "performance_hud.hpp"
+#include "core/sync.hpp"
+#include "core/swapchain.hpp"
+#include "utils/vulkan_debug.hpp"
+
+#include <imgui.h>
+#include <imgui_impl_glfw.h>
+#include <imgui_impl_vulkan.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace particulas {
+
+namespace {
+
+void checkImGuiVkResult(VkResult result) {
+    particulas::debug::checkVkResult(result, "ImGui Vulkan backend");
+}
+
+double toMiB(uint64_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+PerformanceHud::PerformanceHud(VkInstance instance, const Device& device, GLFWwindow* window, VkFormat colorFormat,
+                               uint32_t minImageCount, VkPipelineCache pipelineCache)
+    : device_(device.getLogicalDevice()), minImageCount_(std::max(minImageCount, 2u)) {
+    try {
+        createRenderPass(colorFormat);
+        createDescriptorPool();
+
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGui::GetIO().IniFilename = nullptr; // Sin imgui.ini junto al ejecutable
+        ImGui::StyleColorsDark();
+        // Con callbacks instalados ImGui encadena los que ya tenía la ventana (la rueda de la cámara)
+        ImGui_ImplGlfw_InitForVulkan(window, true);
+
+        ImGui_ImplVulkan_InitInfo initInfo{};
+        initInfo.Instance = instance;
+        initInfo.PhysicalDevice = device.getPhysicalDevice();
+        initInfo.Device = device_;
+        initInfo.QueueFamily = device.getGraphicsQueueFamilyIndex();
+        initInfo.Queue = device.getGraphicsQueue();
+        initInfo.PipelineCache = pipelineCache;
+        initInfo.DescriptorPool = descriptorPool_;
+        initInfo.RenderPass = renderPass_;
+        initInfo.Subpass = 0;
+        initInfo.MinImageCount = minImageCount_;
+        // El backend rota sus buffers de vértices en cada RenderDrawData: uno por frame en vuelo basta
+        initInfo.ImageCount = std::max(minImageCount_, static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT));
+        initInfo.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+        initInfo.CheckVkResultFn = checkImGuiVkResult;
+        ImGui_ImplVulkan_Init(&initInfo);
+        imguiInitialized_ = true;
+        ImGui_ImplVulkan_CreateFontsTexture(); // Ahora, sin frames en vuelo, y no en el primer NewFrame
+    } catch (...) {
+        destroy();
+        throw;
+    }
+}
+
+PerformanceHud::~PerformanceHud() {
+    destroy();
+}
+
+void PerformanceHud::destroy() {
+    if (imguiInitialized_) {
+        ImGui_ImplVulkan_Shutdown();
+        ImGui_ImplGlfw_Shutdown();
+        imguiInitialized_ = false;
+    }
+    if (ImGui::GetCurrentContext() != nullptr) ImGui::DestroyContext();
+    destroyFramebuffers();
+    if (descriptorPool_ != VK_NULL_HANDLE) { vkDestroyDescriptorPool(device_, descriptorPool_, nullptr); descriptorPool_ = VK_NULL_HANDLE; }
+    if (renderPass_ != VK_NULL_HANDLE) { vkDestroyRenderPass(device_, renderPass_, nullptr); renderPass_ = VK_NULL_HANDLE; }
+}
+
+// Un único attachment de color que conserva lo dibujado por la escena (LOAD) y vuelve a dejarlo
+// listo para presentar. La dependencia externa ordena este pase tras el de la escena.
+void PerformanceHud::createRenderPass(VkFormat colorFormat) {
+    VkAttachmentDescription colorAttachment{};
+    colorAttachment.format = colorFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; // finalLayout del pase de la escena
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    VkAttachmentReference colorAttachmentRef{};
+    colorAttachmentRef.attachment = 0;
+    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorAttachmentRef;
+
+    VkSubpassDependency dependency{};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT; // Escrituras de la escena
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT; // Mezcla alfa
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &colorAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = 1;
+    renderPassInfo.pDependencies = &dependency;
+    particulas::debug::checkVkResult(vkCreateRenderPass(device_, &renderPassInfo, nullptr, &renderPass_), "HUD render pass creation");
+}
+
+void PerformanceHud::createDescriptorPool() {
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1};
+    VkDescriptorPoolCreateInfo poolInfo{}; poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT; // El backend libera el set de la fuente
+    poolInfo.maxSets = 1; poolInfo.poolSizeCount = 1; poolInfo.pPoolSizes = &poolSize;
+    particulas::debug::checkVkResult(vkCreateDescriptorPool(device_, &poolInfo, nullptr, &descriptorPool_), "HUD descriptor pool");
+}
+
+void PerformanceHud::createFramebuffers(const std::vector<VkImageView>& imageViews, VkExtent2D extent, uint32_t minImageCount) {
+    destroyFramebuffers();
+    minImageCount = std::max(minImageCount, 2u);
+    if (minImageCount != minImageCount_) {
+        ImGui_ImplVulkan_SetMinImageCount(minImageCount);
+        minImageCount_ = minImageCount;
+    }
+    extent_ = extent;
+    framebuffers_.resize(imageViews.size(), VK_NULL_HANDLE);
+    for (size_t i = 0; i < imageViews.size(); ++i) {
+        VkFramebufferCreateInfo framebufferInfo{}; framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = renderPass_; framebufferInfo.attachmentCount = 1; framebufferInfo.pAttachments = &imageViews[i];
+        framebufferInfo.width = extent.width; framebufferInfo.height = extent.height; framebufferInfo.layers = 1;
+        particulas::debug::checkVkResult(vkCreateFramebuffer(device_, &framebufferInfo, nullptr, &framebuffers_[i]),
+            "HUD framebuffer creation for swapchain image " + std::to_string(i));
+    }
+}
+
+void PerformanceHud::destroyFramebuffers() {
+    for (VkFramebuffer framebuffer : framebuffers_) {
+        if (framebuffer != VK_NULL_HANDLE) vkDestroyFramebuffer(device_, framebuffer, nullptr);
+    }
+    framebuffers_.clear();
+}
+
+void PerformanceHud::addFrameTime(double milliseconds) {
+    frameTimes_[frameTimeNext_] = static_cast<float>(milliseconds);
+    frameTimeNext_ = (frameTimeNext_ + 1) % HUD_HISTORY_SIZE;
+    frameTimeCount_ = std::min(frameTimeCount_ + 1, HUD_HISTORY_SIZE);
+}
+
+bool PerformanceHud::wantsMouse() const {
+    return visible_ && ImGui::GetCurrentContext() != nullptr && ImGui::GetIO().WantCaptureMouse;
+}
+
+// Percentiles sobre la ventana de HUD_HISTORY_SIZE frames. nth_element sobre la copia: primero el
+// p99 en todo el rango y después el resto en la parte ya separada por debajo.
+void PerformanceHud::updatePercentiles() {
+    size_t count = frameTimeCount_;
+    if (count == 0) return;
+    std::copy(frameTimes_.begin(), frameTimes_.begin() + count, sortScratch_.begin());
+    float* values = sortScratch_.data();
+    auto rank = [count](double quantile) { return std::min(count - 1, static_cast<size_t>(quantile * static_cast<double>(count))); };
+    size_t i99 = rank(0.99), i95 = rank(0.95), i50 = rank(0.50);
+    maxFrameTime_ = *std::max_element(values, values + count);
+    std::nth_element(values, values + i99, values + count); p99_ = values[i99];
+    std::nth_element(values, values + i95, values + i99); p95_ = values[i95];
+    std::nth_element(values, values + i50, values + i95); p50_ = values[i50];
+
+    p50History_[percentileNext_] = p50_;
+    p99History_[percentileNext_] = p99_;
+    percentileNext_ = (percentileNext_ + 1) % HUD_HISTORY_SIZE;
+    percentileCount_ = std::min(percentileCount_ + 1, HUD_HISTORY_SIZE);
+}
+
+void PerformanceHud::build(const HudFrameStats& stats, HudControls& controls) {
+    if (!visible_) return;
+    auto begin = std::chrono::steady_clock::now();
+    ImGui_ImplVulkan_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+    updatePercentiles();
+
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.8f);
+    if (ImGui::Begin("Performance (F1)", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+        drawFrameTimes();
+        drawTimings(stats);
+        drawCounters(stats);
+        drawControls(controls);
+    }
+    ImGui::End();
+    ImGui::Render();
+    buildMilliseconds_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void PerformanceHud::drawFrameTimes() {
+    if (frameTimeCount_ == 0) return;
+    const ImVec2 graphSize(360.0f, 70.0f);
+    float last = frameTimes_[(frameTimeNext_ + HUD_HISTORY_SIZE - 1) % HUD_HISTORY_SIZE];
+    float scaleMax = std::max(p99_ * 1.5f, 1.0f);
+    char overlay[64];
+    std::snprintf(overlay, sizeof(overlay), "%.2f ms (%.0f fps)", last, last > 0.0f ? 1000.0f / last : 0.0f);
+    // Con el historial lleno el más antiguo está en frameTimeNext_
+    int frameOffset = frameTimeCount_ == HUD_HISTORY_SIZE ? static_cast<int>(frameTimeNext_) : 0;
+    ImGui::PlotLines("Frame", frameTimes_.data(), static_cast<int>(frameTimeCount_), frameOffset, overlay, 0.0f, scaleMax, graphSize);
+    ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", p50_, p95_, p99_, maxFrameTime_);
+
+    int percentileOffset = percentileCount_ == HUD_HISTORY_SIZE ? static_cast<int>(percentileNext_) : 0;
+    std::snprintf(overlay, sizeof(overlay), "p99 %.2f ms", p99_);
+    ImGui::PlotLines("p99", p99History_.data(), static_cast<int>(percentileCount_), percentileOffset, overlay, 0.0f, scaleMax, ImVec2(graphSize.x, 40.0f));
+    std::snprintf(overlay, sizeof(overlay), "p50 %.2f ms", p50_);
+    ImGui::PlotLines("p50", p50History_.data(), static_cast<int>(percentileCount_), percentileOffset, overlay, 0.0f, scaleMax, ImVec2(graphSize.x, 40.0f));
+}
+
+void PerformanceHud::drawTimings(const HudFrameStats& stats) {
+    ImGui::SeparatorText("CPU (ms)");
+    if (ImGui::BeginTable("cpuPhases", 2, ImGuiTableFlags_SizingFixedFit)) {
+        for (size_t i = 0; i < stats.cpuPhaseCount; ++i) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.cpuPhaseNames[i]);
+            ImGui::TableNextColumn(); ImGui::Text("%7.3f", stats.cpuPhaseMilliseconds[i]);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::SeparatorText("GPU (ms)");
+    if (!stats.graph || !stats.graph->isTimingSupported()) {
+        ImGui::TextDisabled("Timestamps not supported");
+        return;
+    }
+    double total = 0.0;
+    if (ImGui::BeginTable("gpuPasses", 2, ImGuiTableFlags_SizingFixedFit)) {
+        for (uint32_t pass = 0; pass < stats.graph->getPassCount(); ++pass) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.graph->getPassName(pass).c_str());
+            ImGui::TableNextColumn();
+            if (!stats.graph->isPassEnabled(pass)) { ImGui::TextDisabled("    off"); continue; }
+            double milliseconds = stats.graph->getPassMilliseconds(pass);
+            total += milliseconds;
+            ImGui::Text("%7.3f", milliseconds);
+        }
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn(); ImGui::TextUnformatted("total");
+        ImGui::TableNextColumn(); ImGui::Text("%7.3f", total);
+        ImGui::EndTable();
+    }
+}
+
+void PerformanceHud::drawCounters(const HudFrameStats& stats) {
+    ImGui::SeparatorText("Particles");
+    if (stats.countsOnGpu) ImGui::Text("simulated on GPU  capacity %zu", stats.particleCapacity);
+    else ImGui::Text("live %zu  drawn %zu  capacity %zu", stats.liveParticles, stats.drawnParticles, stats.particleCapacity);
+    if (stats.frameBudgetMs > 0.0) {
+        ImGui::SeparatorText("Quality");
+        ImGui::Text("budget %.1f ms  decisions %llu", stats.frameBudgetMs, static_cast<unsigned long long>(stats.qualityDecisions));
+        ImGui::Text("substeps %d  render scale %.3f  drawn %.0f%%", stats.substeps, stats.renderScale, stats.drawFraction * 100.0f);
+    }
+    ImGui::SeparatorText("Memory (MiB)");
+    ImGui::Text("particle pool %.2f", toMiB(stats.particleBytes));
+    ImGui::Text("graph transients %.2f (%.2f unaliased)", toMiB(stats.transientBytes), toMiB(stats.unaliasedBytes));
+    if (stats.residentBytes > 0) ImGui::Text("process resident %.1f", toMiB(stats.residentBytes));
+    if (stats.deviceBudgetReported) ImGui::Text("device local %.1f / %.1f budget", toMiB(stats.deviceLocalUsage), toMiB(stats.deviceLocalBudget));
+    else if (stats.deviceLocalBudget > 0) ImGui::Text("device local budget ~%.1f (usage unknown)", toMiB(stats.deviceLocalBudget));
+}
+
+void PerformanceHud::drawControls(HudControls& controls) {
+    ImGui::SeparatorText("Controls");
+    ImGui::BeginDisabled(!controls.particleCountEditable);
+    ImGui::SliderInt("Particles", &controls.particleCount, 0, controls.maxParticleCount);
+    ImGui::EndDisabled();
+    ImGui::SliderInt("Worker threads", &controls.workerThreads, 0, controls.maxWorkerThreads);
+    if (controls.presentModes && ImGui::BeginCombo("Present mode", presentModeName(controls.presentMode))) {
+        for (VkPresentModeKHR mode : *controls.presentModes) {
+            bool selected = mode == controls.presentMode;
+            if (ImGui::Selectable(presentModeName(mode), selected)) controls.presentMode = mode;
+            if (selected) ImGui::SetItemDefaultFocus();
+        }
+        ImGui::EndCombo();
+    }
+    ImGui::SliderFloat("Sim rate", &controls.simulationRateHz, 0.0f, 480.0f,
+                       controls.simulationRateHz > 0.0f ? "%.0f Hz" : "per frame");
+}
+
+void PerformanceHud::record(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+    ImDrawData* drawData = ImGui::GetDrawData();
+    if (!visible_ || drawData == nullptr || imageIndex >= framebuffers_.size()) return;
+    VkRenderPassBeginInfo renderPassInfo{}; renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = renderPass_; renderPassInfo.framebuffer = framebuffers_[imageIndex];
+    renderPassInfo.renderArea.offset = {0, 0}; renderPassInfo.renderArea.extent = extent_;
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    ImGui_ImplVulkan_RenderDrawData(drawData, commandBuffer);
+    vkCmdEndRenderPass(commandBuffer);
+}
+
+} // namespace particulas
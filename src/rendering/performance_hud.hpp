@@ -0,0 +1,132 @@
+#ifndef PARTICULAS_RENDERING_PERFORMANCE_HUD_HPP
+#define PARTICULAS_RENDERING_PERFORMANCE_HUD_HPP
+
+#include "core/device.hpp"
+#include "core/render_graph.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct GLFWwindow;
+
+namespace particulas {
+
+// Frames que guardan las gráficas del HUD (~8 s a 60 fps)
+constexpr size_t HUD_HISTORY_SIZE = 512;
+
+// Lo que la aplicación mide en cada frame y entrega al HUD. Tamaño fijo: rellenarla no reserva memoria.
+struct HudFrameStats {
+    static constexpr size_t MAX_CPU_PHASES = 8;
+    std::array<const char*, MAX_CPU_PHASES> cpuPhaseNames{};
+    std::array<double, MAX_CPU_PHASES> cpuPhaseMilliseconds{};
+    size_t cpuPhaseCount = 0;
+    const RenderGraph* graph = nullptr; // Tiempos de GPU por pase (último frame resuelto)
+    size_t liveParticles = 0;
+    size_t drawnParticles = 0;
+    size_t particleCapacity = 0;
+    bool countsOnGpu = false;     // Simulación en GPU: la CPU no conoce vivas ni dibujadas
+    uint64_t particleBytes = 0;   // Pool de partículas en CPU
+    uint64_t transientBytes = 0;  // Temporales del grafo (con aliasing)
+    uint64_t unaliasedBytes = 0;  // Los mismos temporales sin compartir memoria
+    uint64_t residentBytes = 0;   // Memoria residente del proceso (0 si no se conoce)
+    uint64_t deviceLocalUsage = 0;  // Heaps DEVICE_LOCAL: uso del proceso y presupuesto
+    uint64_t deviceLocalBudget = 0;
+    bool deviceBudgetReported = false; // false: presupuesto estimado y uso desconocido
+    double frameBudgetMs = 0.0;   // > 0: controlador de calidad activo, con sus niveles
+    int substeps = 1;
+    float renderScale = 1.0f;
+    float drawFraction = 1.0f;
+    uint64_t qualityDecisions = 0;
+
+    void addCpuPhase(const char* name, double milliseconds) {
+        if (cpuPhaseCount == MAX_CPU_PHASES) return;
+        cpuPhaseNames[cpuPhaseCount] = name;
+        cpuPhaseMilliseconds[cpuPhaseCount] = milliseconds;
+        ++cpuPhaseCount;
+    }
+};
+
+// Controles en vivo. El HUD edita los valores y la aplicación aplica los que difieren de su estado.
+struct HudControls {
+    int particleCount = 0;
+    int maxParticleCount = 0;
+    bool particleCountEditable = true;  // Con simulación en GPU el número lo decide la GPU
+    int workerThreads = 0;
+    int maxWorkerThreads = 0;
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    const std::vector<VkPresentModeKHR>* presentModes = nullptr; // Modos que admite la superficie
+    float simulationRateHz = 0.0f;       // Pasos fijos por segundo (0 = un paso por frame)
+};
+
+// Overlay de rendimiento con Dear ImGui: intervalo entre frames y sus percentiles (gráficas
+// deslizantes), tiempos de CPU por fase y de GPU por pase del grafo, partículas, memoria y los
+// controles de HudControls. Se dibuja en su propio render pass (LOAD sobre la imagen ya
+// presentable), así que es un pase más del grafo: oculto, el pase se desactiva y no se construye
+// ni se graba nada.
+class PerformanceHud {
+public:
+    // colorFormat y minImageCount: los del swapchain. Llamar a createFramebuffers antes de grabar.
+    PerformanceHud(VkInstance instance, const Device& device, GLFWwindow* window, VkFormat colorFormat,
+                   uint32_t minImageCount, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+    ~PerformanceHud();
+
+    // Un framebuffer por imagen del swapchain. Al crear el HUD y cada vez que se recrea el swapchain.
+    void createFramebuffers(const std::vector<VkImageView>& imageViews, VkExtent2D extent, uint32_t minImageCount);
+
+    void setVisible(bool visible) { visible_ = visible; }
+    bool isVisible() const { return visible_; }
+
+    // Cada frame, visible o no: intervalo entre frames para las gráficas
+    void addFrameTime(double milliseconds);
+
+    // Construye la interfaz del frame (solo si es visible). Los cambios quedan en controls.
+    void build(const HudFrameStats& stats, HudControls& controls);
+    double getBuildMilliseconds() const { return buildMilliseconds_; }
+
+    // Graba el overlay construido en el último build(). Fuera de cualquier render pass.
+    void record(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+
+    // ImGui usa el ratón (la cámara no debe arrastrar ni hacer zoom)
+    bool wantsMouse() const;
+
+    PerformanceHud(const PerformanceHud&) = delete;
+    PerformanceHud& operator=(const PerformanceHud&) = delete;
+
+private:
+    void createRenderPass(VkFormat colorFormat);
+    void createDescriptorPool();
+    void destroyFramebuffers();
+    void destroy();
+    void updatePercentiles();
+    void drawFrameTimes();
+    void drawTimings(const HudFrameStats& stats);
+    void drawCounters(const HudFrameStats& stats);
+    void drawControls(HudControls& controls);
+
+    VkDevice device_;
+    VkRenderPass renderPass_ = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool_ = VK_NULL_HANDLE; // Solo la textura de la fuente
+    std::vector<VkFramebuffer> framebuffers_;
+    VkExtent2D extent_ = {0, 0};
+    uint32_t minImageCount_;
+    bool imguiInitialized_ = false;
+    bool visible_ = true;
+    double buildMilliseconds_ = 0.0;
+
+    // Historiales circulares: intervalos entre frames y percentiles calculados en cada build()
+    std::array<float, HUD_HISTORY_SIZE> frameTimes_{};
+    std::array<float, HUD_HISTORY_SIZE> p50History_{};
+    std::array<float, HUD_HISTORY_SIZE> p99History_{};
+    std::array<float, HUD_HISTORY_SIZE> sortScratch_{}; // Copia para nth_element
+    size_t frameTimeNext_ = 0, frameTimeCount_ = 0;
+    size_t percentileNext_ = 0, percentileCount_ = 0;
+    float p50_ = 0.0f, p95_ = 0.0f, p99_ = 0.0f, maxFrameTime_ = 0.0f;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_RENDERING_PERFORMANCE_HUD_HPP
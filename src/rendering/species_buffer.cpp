@@ -0,0 +1,63 @@
+#include "species_buffer.hpp"
+#include "utils/vulkan_debug.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace particulas {
+
+// El layout std140 de la tabla coincide con Species (vec4 + 4 floats)
+static_assert(sizeof(Species) == 32, "Species must match the std140 layout in species.glsl");
+
+SpeciesBuffer::SpeciesBuffer(const Device& device)
+    : device_(device.getLogicalDevice()) {
+    VkDeviceSize size = sizeof(Species) * MAX_SPECIES;
+    buffer_ = std::make_unique<Buffer>(device, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    mapped_ = buffer_->map();
+    std::memset(mapped_, 0, static_cast<size_t>(size));
+
+    try {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+        VkDescriptorSetLayoutCreateInfo layoutInfo{}; layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1; layoutInfo.pBindings = &binding;
+        particulas::debug::checkVkResult(vkCreateDescriptorSetLayout(device_, &layoutInfo, nullptr, &descriptorSetLayout_), "Species descriptor set layout");
+
+        VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1};
+        VkDescriptorPoolCreateInfo poolInfo{}; poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = 1; poolInfo.poolSizeCount = 1; poolInfo.pPoolSizes = &poolSize;
+        particulas::debug::checkVkResult(vkCreateDescriptorPool(device_, &poolInfo, nullptr, &descriptorPool_), "Species descriptor pool");
+
+        VkDescriptorSetAllocateInfo allocInfo{}; allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = descriptorPool_; allocInfo.descriptorSetCount = 1; allocInfo.pSetLayouts = &descriptorSetLayout_;
+        particulas::debug::checkVkResult(vkAllocateDescriptorSets(device_, &allocInfo, &descriptorSet_), "Species descriptor set");
+    } catch (...) {
+        if (descriptorPool_ != VK_NULL_HANDLE) vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+        if (descriptorSetLayout_ != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
+        throw;
+    }
+
+    VkDescriptorBufferInfo bufferInfo{buffer_->get(), 0, VK_WHOLE_SIZE};
+    VkWriteDescriptorSet write{}; write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptorSet_; write.dstBinding = 0; write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(device_, 1, &write, 0, nullptr);
+}
+
+SpeciesBuffer::~SpeciesBuffer() {
+    if (descriptorPool_ != VK_NULL_HANDLE) vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+    if (descriptorSetLayout_ != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
+    buffer_.reset(); // Desmapea y libera
+}
+
+void SpeciesBuffer::upload(const std::vector<Species>& species) {
+    if (species.size() > MAX_SPECIES) throw std::invalid_argument("Species table exceeds MAX_SPECIES.");
+    std::memcpy(mapped_, species.data(), sizeof(Species) * species.size());
+    speciesCount_ = static_cast<uint32_t>(species.size());
+}
+
+} // namespace particulas
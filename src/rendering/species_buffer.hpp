@@ -0,0 +1,48 @@
+#ifndef PARTICULAS_RENDERING_SPECIES_BUFFER_HPP
+#define PARTICULAS_RENDERING_SPECIES_BUFFER_HPP
+
+#include "core/device.hpp"
+#include "core/buffer.hpp"
+#include "particles/species.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <vector>
+
+namespace particulas {
+
+// Tabla de especies en GPU: uniform buffer de MAX_SPECIES entradas (SpeciesTable en species.glsl)
+// con su propio descriptor set. El pipeline de puntos lo usa como set 0 y los passes de cómputo
+// (simulación en GPU y splats) como set 1, así todos leen el color/radio de la misma tabla.
+class SpeciesBuffer {
+public:
+    explicit SpeciesBuffer(const Device& device);
+    ~SpeciesBuffer();
+
+    // Copia la tabla al buffer (memoria host-coherent). No hay doble buffer: llamar solo cuando
+    // ningún frame en vuelo la está leyendo (al iniciar o tras vkDeviceWaitIdle).
+    void upload(const std::vector<Species>& species);
+
+    VkBuffer get() const { return buffer_->get(); }
+    VkDescriptorSetLayout getDescriptorSetLayout() const { return descriptorSetLayout_; }
+    VkDescriptorSet getDescriptorSet() const { return descriptorSet_; }
+    uint32_t getSpeciesCount() const { return speciesCount_; }
+
+    SpeciesBuffer(const SpeciesBuffer&) = delete;
+    SpeciesBuffer& operator=(const SpeciesBuffer&) = delete;
+
+private:
+    VkDevice device_;
+    std::unique_ptr<Buffer> buffer_;
+    void* mapped_ = nullptr;
+    uint32_t speciesCount_ = 0;
+
+    VkDescriptorSetLayout descriptorSetLayout_ = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool_ = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet_ = VK_NULL_HANDLE;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_RENDERING_SPECIES_BUFFER_HPP
@@ -0,0 +1,378 @@
+#include "splat_renderer.hpp"
+#include "core/shader_module.hpp"
+#include "core/sync.hpp"
+#include "utils/vulkan_debug.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+constexpr uint32_t TILE_SIZE = 16;   // SPLAT_TILE_SIZE en splat_common.glsl
+constexpr uint32_t GROUP_SIZE = 256; // SPLAT_GROUP_SIZE
+constexpr uint32_t BINDING_COUNT = 7;
+constexpr uint32_t PARTICLE_BINS_BINDING = 4; // BinnedIndices le sigue en el 5
+constexpr uint32_t ACCUM_BINDING = 6;
+constexpr VkShaderStageFlags PUSH_STAGES = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+}
+
+static_assert(sizeof(SplatParams) == 64, "SplatParams must match the push constant block in splat_params.glsl");
+
+// --- Constructor ---
+SplatRenderer::SplatRenderer(const Device& device, CommandPool& commandPool, VkRenderPass renderPass,
+                             VkExtent2D extent, uint32_t capacity, glm::vec2 domainSize, const SpeciesBuffer& species,
+                             VkPipelineCache pipelineCache)
+    : device_(device.getLogicalDevice()),
+      extent_(extent),
+      capacity_(capacity),
+      domainSize_(domainSize),
+      viewScale_(static_cast<float>(extent.width) / domainSize.x, static_cast<float>(extent.height) / domainSize.y),
+      tilesX_((extent.width + TILE_SIZE - 1) / TILE_SIZE),
+      tilesY_((extent.height + TILE_SIZE - 1) / TILE_SIZE),
+      speciesDescriptorSet_(species.getDescriptorSet())
+{
+    if (capacity == 0 || extent.width == 0 || extent.height == 0) throw std::invalid_argument("SplatRenderer needs a non-empty capacity and extent.");
+    try {
+        createResources(device, commandPool);
+        createDescriptors();
+        createPipelines(renderPass, pipelineCache, species.getDescriptorSetLayout());
+    } catch (...) {
+        if (tonemapPipeline_ != VK_NULL_HANDLE) vkDestroyPipeline(device_, tonemapPipeline_, nullptr);
+        if (pipelineLayout_ != VK_NULL_HANDLE) vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
+        if (descriptorPool_ != VK_NULL_HANDLE) vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+        if (descriptorSetLayout_ != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
+        if (accumImageView_ != VK_NULL_HANDLE) vkDestroyImageView(device_, accumImageView_, nullptr);
+        if (accumImage_ != VK_NULL_HANDLE) vkDestroyImage(device_, accumImage_, nullptr);
+        if (accumImageMemory_ != VK_NULL_HANDLE) vkFreeMemory(device_, accumImageMemory_, nullptr);
+        throw;
+    }
+    PARTICULAS_LOG(Info) << "Splat renderer created. Tiles: " << tilesX_ << "x" << tilesY_ << ", capacity: " << capacity_;
+}
+
+// --- Destructor ---
+SplatRenderer::~SplatRenderer() {
+    binPipeline_.reset(); scanPipeline_.reset(); scatterPipeline_.reset(); rasterPipeline_.reset();
+    if (tonemapPipeline_ != VK_NULL_HANDLE) vkDestroyPipeline(device_, tonemapPipeline_, nullptr);
+    if (pipelineLayout_ != VK_NULL_HANDLE) vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
+    if (descriptorPool_ != VK_NULL_HANDLE) vkDestroyDescriptorPool(device_, descriptorPool_, nullptr);
+    if (descriptorSetLayout_ != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(device_, descriptorSetLayout_, nullptr);
+    if (accumImageView_ != VK_NULL_HANDLE) vkDestroyImageView(device_, accumImageView_, nullptr);
+    if (accumImage_ != VK_NULL_HANDLE) vkDestroyImage(device_, accumImage_, nullptr);
+    if (accumImageMemory_ != VK_NULL_HANDLE) vkFreeMemory(device_, accumImageMemory_, nullptr);
+}
+
+// --- createResources ---
+void SplatRenderer::createResources(const Device& device, CommandPool& commandPool) {
+    uint32_t tileCount = tilesX_ * tilesY_;
+    tileCountsBuffer_ = std::make_unique<Buffer>(device, sizeof(uint32_t) * tileCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    tileOffsetsBuffer_ = std::make_unique<Buffer>(device, sizeof(uint32_t) * tileCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    particleBinsBuffer_ = std::make_unique<Buffer>(device, getParticleBinsBytes(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    binnedIndicesBuffer_ = std::make_unique<Buffer>(device, getBinnedIndicesBytes(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    // Acumulador: rgb = color medio, a = densidad. RGBA32F admite STORAGE_IMAGE en todo dispositivo Vulkan.
+    VkImageCreateInfo imageInfo{}; imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO; imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {extent_.width, extent_.height, 1}; imageInfo.mipLevels = 1; imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R32G32B32A32_SFLOAT; imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL; imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT; imageInfo.samples = VK_SAMPLE_COUNT_1_BIT; imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    particulas::debug::checkVkResult(vkCreateImage(device_, &imageInfo, nullptr, &accumImage_), "Splat accumulation image creation");
+    VkMemoryRequirements memRequirements; vkGetImageMemoryRequirements(device_, accumImage_, &memRequirements);
+    VkMemoryAllocateInfo allocInfo{}; allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO; allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = device.findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    particulas::debug::checkVkResult(vkAllocateMemory(device_, &allocInfo, nullptr, &accumImageMemory_), "Splat accumulation image memory");
+    particulas::debug::checkVkResult(vkBindImageMemory(device_, accumImage_, accumImageMemory_, 0), "Bind splat accumulation image memory");
+
+    VkImageViewCreateInfo viewInfo{}; viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO; viewInfo.image = accumImage_;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D; viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    particulas::debug::checkVkResult(vkCreateImageView(device_, &viewInfo, nullptr, &accumImageView_), "Splat accumulation image view");
+
+    // La imagen vive en GENERAL (escritura en cómputo, lectura en el tone-map)
+    VkCommandBuffer commandBuffer = commandPool.beginSingleTimeCommands();
+    VkImageMemoryBarrier barrier{}; barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED; barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = accumImage_; barrier.subresourceRange = viewInfo.subresourceRange;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+    commandPool.endSingleTimeCommands(commandBuffer, device.getGraphicsQueue());
+}
+
+// --- createDescriptors ---
+void SplatRenderer::createDescriptors() {
+    std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings{};
+    for (uint32_t i = 0; i < BINDING_COUNT; ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i == ACCUM_BINDING ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = i == ACCUM_BINDING ? PUSH_STAGES : VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo layoutInfo{}; layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = BINDING_COUNT; layoutInfo.pBindings = bindings.data();
+    particulas::debug::checkVkResult(vkCreateDescriptorSetLayout(device_, &layoutInfo, nullptr, &descriptorSetLayout_), "Splat descriptor set layout");
+
+    uint32_t setCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    std::array<VkDescriptorPoolSize, 2> poolSizes = {{
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (BINDING_COUNT - 1) * setCount},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, setCount},
+    }};
+    VkDescriptorPoolCreateInfo poolInfo{}; poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = setCount; poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size()); poolInfo.pPoolSizes = poolSizes.data();
+    particulas::debug::checkVkResult(vkCreateDescriptorPool(device_, &poolInfo, nullptr, &descriptorPool_), "Splat descriptor pool");
+
+    std::vector<VkDescriptorSetLayout> layouts(setCount, descriptorSetLayout_);
+    descriptorSets_.resize(setCount);
+    frameHasSource_.assign(setCount, 0);
+    frameUsesCountBuffer_.assign(setCount, 0);
+    VkDescriptorSetAllocateInfo allocInfo{}; allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = descriptorPool_; allocInfo.descriptorSetCount = setCount; allocInfo.pSetLayouts = layouts.data();
+    particulas::debug::checkVkResult(vkAllocateDescriptorSets(device_, &allocInfo, descriptorSets_.data()), "Splat descriptor sets");
+
+    // Bindings fijos (2..6); la fuente de partículas (0, 1) se escribe en cada recordSplat
+    std::array<VkDescriptorBufferInfo, 4> bufferInfos = {{
+        {tileCountsBuffer_->get(), 0, VK_WHOLE_SIZE},
+        {tileOffsetsBuffer_->get(), 0, VK_WHOLE_SIZE},
+        {particleBinsBuffer_->get(), 0, VK_WHOLE_SIZE},
+        {binnedIndicesBuffer_->get(), 0, VK_WHOLE_SIZE},
+    }};
+    VkDescriptorImageInfo imageInfo{VK_NULL_HANDLE, accumImageView_, VK_IMAGE_LAYOUT_GENERAL};
+    for (VkDescriptorSet set : descriptorSets_) {
+        std::array<VkWriteDescriptorSet, 5> writes{};
+        for (uint32_t i = 0; i < writes.size(); ++i) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = set;
+            writes[i].dstBinding = 2 + i;
+            writes[i].descriptorCount = 1;
+            if (2 + i == ACCUM_BINDING) {
+                writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                writes[i].pImageInfo = &imageInfo;
+            } else {
+                writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[i].pBufferInfo = &bufferInfos[i];
+            }
+        }
+        vkUpdateDescriptorSets(device_, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+// --- useScratchBuffers ---
+void SplatRenderer::useScratchBuffers(VkBuffer particleBins, VkBuffer binnedIndices) {
+    std::array<VkDescriptorBufferInfo, 2> bufferInfos = {{
+        {particleBins, 0, VK_WHOLE_SIZE},
+        {binnedIndices, 0, VK_WHOLE_SIZE},
+    }};
+    for (VkDescriptorSet set : descriptorSets_) {
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (uint32_t i = 0; i < writes.size(); ++i) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = set;
+            writes[i].dstBinding = PARTICLE_BINS_BINDING + i; // ParticleBins, BinnedIndices
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &bufferInfos[i];
+        }
+        vkUpdateDescriptorSets(device_, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+    particleBinsBuffer_.reset();
+    binnedIndicesBuffer_.reset();
+}
+
+// --- createPipelines ---
+void SplatRenderer::createPipelines(VkRenderPass renderPass, VkPipelineCache pipelineCache, VkDescriptorSetLayout speciesLayout) {
+    VkPushConstantRange pushRange{PUSH_STAGES, 0, sizeof(SplatParams)};
+    std::array<VkDescriptorSetLayout, 2> setLayouts = {descriptorSetLayout_, speciesLayout}; // Set 1: tabla de especies
+    VkPipelineLayoutCreateInfo layoutInfo{}; layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size()); layoutInfo.pSetLayouts = setLayouts.data();
+    layoutInfo.pushConstantRangeCount = 1; layoutInfo.pPushConstantRanges = &pushRange;
+    particulas::debug::checkVkResult(vkCreatePipelineLayout(device_, &layoutInfo, nullptr, &pipelineLayout_), "Splat pipeline layout");
+
+    binPipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/splat_bin.comp.spv", pipelineLayout_, pipelineCache);
+    scanPipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/splat_scan.comp.spv", pipelineLayout_, pipelineCache);
+    scatterPipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/splat_scatter.comp.spv", pipelineLayout_, pipelineCache);
+    rasterPipeline_ = std::make_unique<ComputePipeline>(device_, "shaders/splat_raster.comp.spv", pipelineLayout_, pipelineCache);
+
+    // Tone-map: triángulo a pantalla completa sin vértices, sin profundidad ni blending
+    VkShaderModule vertShaderModule = createShaderModule(device_, "shaders/splat_tonemap.vert.spv");
+    VkShaderModule fragShaderModule = VK_NULL_HANDLE;
+    try { fragShaderModule = createShaderModule(device_, "shaders/splat_tonemap.frag.spv"); }
+    catch (...) { vkDestroyShaderModule(device_, vertShaderModule, nullptr); throw; }
+
+    VkPipelineShaderStageCreateInfo shaderStages[2]{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO; shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT; shaderStages[0].module = vertShaderModule; shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO; shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT; shaderStages[1].module = fragShaderModule; shaderStages[1].pName = "main";
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{}; vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{}; inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO; inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPipelineViewportStateCreateInfo viewportState{}; viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO; viewportState.viewportCount = 1; viewportState.scissorCount = 1;
+    VkPipelineRasterizationStateCreateInfo rasterizer{}; rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO; rasterizer.polygonMode = VK_POLYGON_MODE_FILL; rasterizer.lineWidth = 1.0f; rasterizer.cullMode = VK_CULL_MODE_NONE; rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    VkPipelineMultisampleStateCreateInfo multisampling{}; multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO; multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    VkPipelineDepthStencilStateCreateInfo depthStencil{}; depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO; depthStencil.depthTestEnable = VK_FALSE; depthStencil.depthWriteEnable = VK_FALSE;
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{}; colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    VkPipelineColorBlendStateCreateInfo colorBlending{}; colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO; colorBlending.attachmentCount = 1; colorBlending.pAttachments = &colorBlendAttachment;
+    std::array<VkDynamicState, 2> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicStateInfo{}; dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO; dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()); dynamicStateInfo.pDynamicStates = dynamicStates.data();
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2; pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicStateInfo;
+    pipelineInfo.layout = pipelineLayout_;
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = 0;
+
+    VkResult result = vkCreateGraphicsPipelines(device_, pipelineCache, 1, &pipelineInfo, nullptr, &tonemapPipeline_);
+    vkDestroyShaderModule(device_, fragShaderModule, nullptr);
+    vkDestroyShaderModule(device_, vertShaderModule, nullptr);
+    particulas::debug::checkVkResult(result, "Create splat tone-map pipeline");
+}
+
+void SplatRenderer::computeBarrier(VkCommandBuffer commandBuffer) const {
+    VkMemoryBarrier barrier{}; barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void SplatRenderer::setRenderScale(float scale) {
+    if (!(scale > 0.0f)) throw std::invalid_argument("SplatRenderer render scale must be positive.");
+    renderScale_ = std::min(scale, 1.0f);
+}
+
+VkExtent2D SplatRenderer::getScaledExtent() const {
+    if (renderScale_ >= 1.0f) return extent_;
+    return {std::max(1u, static_cast<uint32_t>(std::lround(extent_.width * renderScale_))),
+            std::max(1u, static_cast<uint32_t>(std::lround(extent_.height * renderScale_)))};
+}
+
+// Los shaders solo ven el extent escalado: las teselas y los píxeles fuera de él no se tocan
+SplatParams SplatRenderer::makeParams(uint32_t particleCount, bool useCountBuffer) const {
+    VkExtent2D extent = getScaledExtent();
+    uint32_t tilesX = (extent.width + TILE_SIZE - 1) / TILE_SIZE;
+    uint32_t tilesY = (extent.height + TILE_SIZE - 1) / TILE_SIZE;
+    SplatParams params{};
+    params.background = {0.1f, 0.1f, 0.1f, 1.0f}; // Mismo fondo que el clear del render pass
+    params.viewScale = viewScale_ * renderScale_;
+    params.viewOffset = viewOffset_ * renderScale_;
+    params.extentWidth = extent.width;
+    params.extentHeight = extent.height;
+    params.tilesX = tilesX;
+    params.tileCount = tilesX * tilesY;
+    params.particleCount = particleCount;
+    params.useCountBuffer = useCountBuffer ? 1u : 0u;
+    params.exposure = exposure_ * renderScale_ * renderScale_; // Un píxel escalado junta 1/scale² píxeles de pantalla
+    params.renderScale = renderScale_;
+    return params;
+}
+
+// --- setSources ---
+void SplatRenderer::setSources(uint32_t frameIndex, VkBuffer particleBuffer, VkBuffer countBuffer) {
+    if (frameIndex >= descriptorSets_.size()) return;
+    frameHasSource_[frameIndex] = particleBuffer != VK_NULL_HANDLE;
+    if (particleBuffer == VK_NULL_HANDLE) return;
+    bool useCountBuffer = countBuffer != VK_NULL_HANDLE;
+    frameUsesCountBuffer_[frameIndex] = useCountBuffer;
+    VkDescriptorSet set = descriptorSets_[frameIndex];
+
+    // La fence de este frame ya se esperó: el set no está en uso y puede reescribirse
+    std::array<VkDescriptorBufferInfo, 2> sourceInfos = {{
+        {particleBuffer, 0, VK_WHOLE_SIZE},
+        {useCountBuffer ? countBuffer : tileCountsBuffer_->get(), 0, VK_WHOLE_SIZE}, // Sin buffer de conteo: enlace de relleno
+    }};
+    std::array<VkWriteDescriptorSet, 2> writes{};
+    for (uint32_t i = 0; i < writes.size(); ++i) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &sourceInfos[i];
+    }
+    vkUpdateDescriptorSets(device_, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+// --- recordSplat ---
+void SplatRenderer::recordSplat(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t particleCount) {
+    particleCount = std::min(particleCount, capacity_);
+    if (frameIndex >= descriptorSets_.size() || !frameHasSource_[frameIndex]) return;
+    bool useCountBuffer = frameUsesCountBuffer_[frameIndex] != 0;
+    VkDescriptorSet set = descriptorSets_[frameIndex];
+
+    // El frame anterior escribió los temporales y leyó el acumulador en el tone-map: esperar
+    // a ambos antes de reutilizar los buffers
+    VkMemoryBarrier entryBarrier{}; entryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    entryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    entryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &entryBarrier, 0, nullptr, 0, nullptr);
+
+    vkCmdFillBuffer(commandBuffer, tileCountsBuffer_->get(), 0, VK_WHOLE_SIZE, 0);
+    VkMemoryBarrier fillBarrier{}; fillBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    fillBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    fillBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &fillBarrier, 0, nullptr, 0, nullptr);
+
+    SplatParams params = makeParams(particleCount, useCountBuffer);
+    uint32_t particleGroups = (particleCount + GROUP_SIZE - 1) / GROUP_SIZE;
+    std::array<VkDescriptorSet, 2> sets = {set, speciesDescriptorSet_};
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout_, 0, static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+    vkCmdPushConstants(commandBuffer, pipelineLayout_, PUSH_STAGES, 0, sizeof(SplatParams), &params);
+
+    if (particleGroups > 0) {
+        // 1-3. Binning por teselas: contar, prefijo, dispersar índices
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, binPipeline_->get());
+        vkCmdDispatch(commandBuffer, particleGroups, 1, 1);
+        computeBarrier(commandBuffer);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, scanPipeline_->get());
+        vkCmdDispatch(commandBuffer, 1, 1, 1);
+        computeBarrier(commandBuffer);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, scatterPipeline_->get());
+        vkCmdDispatch(commandBuffer, particleGroups, 1, 1);
+        computeBarrier(commandBuffer);
+    } else {
+        // Sin partículas el raster solo necesita offsets válidos (todos los contadores son 0)
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, scanPipeline_->get());
+        vkCmdDispatch(commandBuffer, 1, 1, 1);
+        computeBarrier(commandBuffer);
+    }
+
+    // 4. Acumulación por tesela (escribe todos los píxeles del extent escalado)
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, rasterPipeline_->get());
+    uint32_t tileGroupsY = params.tileCount / params.tilesX;
+    vkCmdDispatch(commandBuffer, params.tilesX, tileGroupsY, 1);
+    // La barrera hacia el tone-map (fragment) la pone quien ordena los passes (el grafo de frame)
+}
+
+// --- recordTonemap ---
+void SplatRenderer::recordTonemap(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    if (frameIndex >= descriptorSets_.size()) return;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, tonemapPipeline_);
+    VkViewport viewport{}; viewport.width = (float)extent_.width; viewport.height = (float)extent_.height; viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    VkRect2D scissor{}; scissor.extent = extent_;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 0, 1, &descriptorSets_[frameIndex], 0, nullptr);
+    SplatParams params = makeParams(0, false);
+    vkCmdPushConstants(commandBuffer, pipelineLayout_, PUSH_STAGES, 0, sizeof(SplatParams), &params);
+    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+} // namespace particulas
@@ -0,0 +1,129 @@
+#ifndef PARTICULAS_RENDERING_SPLAT_RENDERER_HPP
+#define PARTICULAS_RENDERING_SPLAT_RENDERER_HPP
+
+#include "core/device.hpp"
+#include "core/command_pool.hpp"
+#include "core/buffer.hpp"
+#include "core/compute_pipeline.hpp"
+#include "rendering/species_buffer.hpp"
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace particulas {
+
+// Push constants del splatting (SplatParams en splat_params.glsl)
+struct SplatParams {
+    glm::vec4 background;
+    glm::vec2 viewScale;
+    glm::vec2 viewOffset;
+    uint32_t extentWidth;
+    uint32_t extentHeight;
+    uint32_t tilesX;
+    uint32_t tileCount;
+    uint32_t particleCount;
+    uint32_t useCountBuffer;
+    float exposure;
+    float renderScale;
+};
+
+// Renderizador alternativo para muchas partículas pequeñas: en lugar de rasterizar puntos,
+// un compute shader agrupa las partículas por teselas de pantalla (bin -> scan -> scatter) y
+// cada tesela acumula color y densidad con atómicos en memoria compartida, escribiendo una
+// imagen de almacenamiento. Un pase de tone-map a pantalla completa la lleva al swapchain.
+class SplatRenderer {
+public:
+    // capacity: máximo de partículas por frame; extent: tamaño del swapchain.
+    // El color de cada partícula sale de la tabla de especies (set 1 de los passes de cómputo).
+    SplatRenderer(const Device& device, CommandPool& commandPool, VkRenderPass renderPass,
+                  VkExtent2D extent, uint32_t capacity, glm::vec2 domainSize, const SpeciesBuffer& species,
+                  VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+    ~SplatRenderer();
+
+    // Enlaza las partículas de origen en el descriptor set del frame. Llamar antes de grabar
+    // recordSplat/recordTonemap de ese frame (pueden grabarse a la vez en hilos distintos, pero
+    // ninguno puede actualizar el set mientras el otro lo enlaza). countBuffer != VK_NULL_HANDLE:
+    // el número de partículas se lee de su primer uint (VkDrawIndirectCommand de la simulación en GPU).
+    void setSources(uint32_t frameIndex, VkBuffer particleBuffer, VkBuffer countBuffer);
+
+    // Graba el splatting (fuera del render pass). Con buffer de conteo, particleCount actúa como máximo.
+    void recordSplat(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t particleCount);
+
+    // Graba el tone-map dentro del render pass (dibuja un triángulo a pantalla completa)
+    void recordTonemap(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    // Acumulador (RGBA32F, siempre en GENERAL): recordSplat lo escribe en cómputo y recordTonemap
+    // lo lee en el fragment shader. La barrera entre ambos es del llamante.
+    VkImage getAccumulationImage() const { return accumImage_; }
+
+    // Bins y los índices ordenados solo viven dentro de recordSplat: pueden compartir memoria
+    // con otros temporales del frame. useScratchBuffers los redirige a buffers externos (STORAGE,
+    // de al menos los tamaños indicados) y libera los propios. Solo sin frames en vuelo.
+    VkDeviceSize getParticleBinsBytes() const { return sizeof(uint32_t) * 2 * capacity_; }
+    VkDeviceSize getBinnedIndicesBytes() const { return sizeof(uint32_t) * capacity_; }
+    void useScratchBuffers(VkBuffer particleBins, VkBuffer binnedIndices);
+    // Memoria DEVICE_LOCAL por slot de capacidad (bins e índices ordenados, aunque vivan en el grafo)
+    static constexpr VkDeviceSize getDeviceBytesPerParticle() { return 3 * sizeof(uint32_t); }
+
+    void setExposure(float exposure) { exposure_ = exposure; }
+    // Fracción de la resolución del extent a la que se acumula (0 < scale <= 1): el splatting
+    // trabaja sobre la esquina superior izquierda del acumulador y el tone-map la amplía. La
+    // exposición se corrige para que la densidad por píxel se vea igual. Entre frames, sin esperas.
+    void setRenderScale(float scale);
+    float getRenderScale() const { return renderScale_; }
+    // Transformación mundo -> píxeles de la cámara (Camera2D::getPixelTransform). Por defecto el
+    // dominio completo se estira al extent.
+    void setView(const glm::vec2& scale, const glm::vec2& offset) { viewScale_ = scale; viewOffset_ = offset; }
+
+    SplatRenderer(const SplatRenderer&) = delete;
+    SplatRenderer& operator=(const SplatRenderer&) = delete;
+
+private:
+    void createResources(const Device& device, CommandPool& commandPool);
+    void createDescriptors();
+    void createPipelines(VkRenderPass renderPass, VkPipelineCache pipelineCache, VkDescriptorSetLayout speciesLayout);
+    void computeBarrier(VkCommandBuffer commandBuffer) const;
+    SplatParams makeParams(uint32_t particleCount, bool useCountBuffer) const;
+    VkExtent2D getScaledExtent() const;
+
+    VkDevice device_;
+    VkExtent2D extent_;
+    uint32_t capacity_;
+    glm::vec2 domainSize_;
+    glm::vec2 viewScale_;
+    glm::vec2 viewOffset_ = {0.0f, 0.0f};
+    uint32_t tilesX_;
+    uint32_t tilesY_;
+    float exposure_ = 0.6f;
+    float renderScale_ = 1.0f;
+
+    std::unique_ptr<Buffer> tileCountsBuffer_;
+    std::unique_ptr<Buffer> tileOffsetsBuffer_;
+    std::unique_ptr<Buffer> particleBinsBuffer_;
+    std::unique_ptr<Buffer> binnedIndicesBuffer_;
+    VkImage accumImage_ = VK_NULL_HANDLE;
+    VkDeviceMemory accumImageMemory_ = VK_NULL_HANDLE;
+    VkImageView accumImageView_ = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout descriptorSetLayout_ = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool_ = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets_; // Uno por frame en vuelo (la fuente cambia por frame)
+    std::vector<uint8_t> frameHasSource_;         // setSources ya enlazó partículas en el set del frame
+    std::vector<uint8_t> frameUsesCountBuffer_;
+    VkDescriptorSet speciesDescriptorSet_; // Propiedad de SpeciesBuffer
+    VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
+
+    std::unique_ptr<ComputePipeline> binPipeline_;
+    std::unique_ptr<ComputePipeline> scanPipeline_;
+    std::unique_ptr<ComputePipeline> scatterPipeline_;
+    std::unique_ptr<ComputePipeline> rasterPipeline_;
+    VkPipeline tonemapPipeline_ = VK_NULL_HANDLE;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_RENDERING_SPLAT_RENDERER_HPP
@@ -0,0 +1,181 @@
+// Prueba sin ventana del estado estacionario sin reservas: ejecuta las piezas del frame que se
+// pueden usar sin Vulkan (update con emisor y compactación, altas y bajas del pool, reordenación
+// Morton, solver de restricciones, parallelFor del pool y el registro) durante unos frames de
+// calentamiento y después otros tantos con cada pieza en su fase de AllocationTracker. Se compila
+// siempre con PARTICULAS_TRACK_ALLOCATIONS: tras el calentamiento ninguna fase puede reservar
+// memoria dinámica. El calentamiento dura al menos los frames pedidos y además hasta que el rango
+// vivo lleva STABLE_FRAMES frames sin marcar un máximo nuevo (el emisor alcanzó su régimen), así
+// que el resultado no depende del ritmo del emisor. Lo ejecuta ctest (allocation_steady_state).
+//
+//   AllocationHarness [frames=600] [calentamiento mínimo=60] [hilos=0]
+//
+// Devuelve 0 si ninguna fase reservó memoria tras el calentamiento.
+
+#include "particles/constraint_scenes.hpp"
+#include "particles/morton_reorder.hpp"
+#include "particles/particle_system.hpp"
+#include "utils/allocation_tracker.hpp"
+#include "utils/logger.hpp"
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <vector>
+
+namespace {
+
+constexpr float DOMAIN_WIDTH = 1920.0f;
+constexpr float DOMAIN_HEIGHT = 1080.0f;
+constexpr float STEP_SECONDS = 1.0f / 60.0f;
+constexpr int SYSTEM_PARTICLES = 20000;
+constexpr size_t SYSTEM_CAPACITY = 30000;      // Margen para el régimen del emisor (rate * lifetime)
+constexpr size_t POOL_CHURN = 500;             // Altas y bajas por frame con setParticleCount
+constexpr size_t PARALLEL_ITEMS = 1 << 16;
+constexpr int CLOTH_SIDE = 64;
+constexpr int LOG_INTERVAL = 30;               // Frames entre mensajes del registro
+constexpr int STABLE_FRAMES = 120;             // Frames sin crecer el rango vivo para dar por acabado el calentamiento
+constexpr int MAX_WARMUP_FRAMES = 20000;       // Si el rango vivo no se estabiliza, la prueba falla
+
+// La fase 0 (calentamiento y construcción) no se comprueba
+enum Phase { PHASE_SETUP, PHASE_UPDATE, PHASE_EMIT_COMPACT, PHASE_MORTON, PHASE_CONSTRAINTS, PHASE_PARALLEL_FOR, PHASE_LOGGER, PHASE_COUNT };
+const char* const PHASE_NAMES[PHASE_COUNT] = {"setup", "ParticleSystem::update", "emit + compact", "MortonReorder::reorder",
+                                              "ConstraintSolver::solve", "ThreadPool::parallelFor", "Logger"};
+
+struct Workload {
+    explicit Workload(particulas::ThreadPool& threadPool)
+        : pool(threadPool),
+          system(SYSTEM_PARTICLES, DOMAIN_WIDTH, DOMAIN_HEIGHT, SYSTEM_CAPACITY, particulas::ParticleSystem::DEFAULT_SPECIES_COUNT, 1234),
+          reorder(&threadPool), solver(&threadPool), values(PARALLEL_ITEMS, 1.0f) {
+        particulas::Emitter emitter;
+        emitter.position = {DOMAIN_WIDTH * 0.5f, DOMAIN_HEIGHT * 0.5f};
+        emitter.spreadRadians = 6.28f;
+        emitter.rate = 3000.0f;
+        emitter.particleLifetime = 2.0f;
+        system.addEmitter(emitter);
+        system.setGravity({0.0f, 98.0f});
+        system.setCompactionInterval(30);
+        system.enableMortonReorder(&threadPool, 90);
+
+        // Copia fija para la reordenación directa: siempre la misma escena desordenada
+        const std::vector<particulas::Particle>& source = system.getParticles();
+        mortonSource.assign(source.begin(), source.begin() + SYSTEM_PARTICLES);
+        mortonParticles = mortonSource;
+        newIndexOf.resize(mortonParticles.size());
+
+        particulas::ConstraintScene scene = particulas::makeGridScene(CLOTH_SIDE, CLOTH_SIDE, DOMAIN_WIDTH, DOMAIN_HEIGHT);
+        particulas::applyScene(scene, solver);
+        cloth = std::move(scene.particles);
+    }
+
+    void frame(uint64_t index, bool measured) {
+        setPhase(PHASE_UPDATE, measured);
+        system.update(STEP_SECONDS);
+
+        setPhase(PHASE_EMIT_COMPACT, measured);
+        size_t live = system.getLiveParticleCount();
+        system.setParticleCount(live + POOL_CHURN);
+        system.setParticleCount(live);
+        system.compact();
+
+        setPhase(PHASE_MORTON, measured);
+        std::copy(mortonSource.begin(), mortonSource.end(), mortonParticles.begin());
+        reorder.reorder(mortonParticles, mortonParticles.size(), {DOMAIN_WIDTH, DOMAIN_HEIGHT}, newIndexOf);
+
+        setPhase(PHASE_CONSTRAINTS, measured);
+        float substepDelta = STEP_SECONDS / static_cast<float>(solver.getSubsteps());
+        for (int step = 0; step < solver.getSubsteps(); ++step) {
+            solver.beginSubstep(cloth);
+            for (particulas::Particle& particle : cloth) particle.position += particle.velocity * substepDelta;
+            solver.solve(cloth, substepDelta);
+            solver.endSubstep(cloth, substepDelta);
+        }
+
+        setPhase(PHASE_PARALLEL_FOR, measured);
+        pool.parallelFor(0, values.size(), 4096, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) values[i] = values[i] * 0.5f + 1.0f;
+        });
+
+        setPhase(PHASE_LOGGER, measured);
+        if (index % LOG_INTERVAL == 0) {
+            PARTICULAS_LOG(Info) << "[AllocationHarness] Frame " << index << ": " << system.getLiveParticleCount() << " live, "
+                                 << solver.getConstraintCount() << " constraints, value " << values[0];
+        }
+        setPhase(PHASE_SETUP, measured);
+    }
+
+    static void setPhase(Phase phase, bool measured) {
+        particulas::AllocationTracker::setPhase(measured ? phase : PHASE_SETUP);
+    }
+
+    particulas::ThreadPool& pool;
+    particulas::ParticleSystem system;
+    particulas::MortonReorder reorder;
+    std::vector<particulas::Particle> mortonSource;
+    std::vector<particulas::Particle> mortonParticles;
+    std::vector<uint32_t> newIndexOf;
+    particulas::ConstraintSolver solver;
+    std::vector<particulas::Particle> cloth;
+    std::vector<float> values;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+    int minWarmupFrames = argc > 2 ? std::atoi(argv[2]) : 60;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    if (frames < 1 || minWarmupFrames < 1 || threads < 0) {
+        std::fprintf(stderr, "Usage: %s [frames >= 1] [warmup >= 1] [threads >= 0]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!particulas::AllocationTracker::isEnabled()) {
+        std::fprintf(stderr, "AllocationHarness must be built with PARTICULAS_TRACK_ALLOCATIONS.\n");
+        return EXIT_FAILURE;
+    }
+
+    try {
+        particulas::ThreadPool pool(static_cast<size_t>(threads));
+        pool.runOnEachThread([](size_t) { particulas::AllocationTracker::trackCurrentThread(); });
+        particulas::AllocationTracker::setPhase(PHASE_SETUP);
+        Workload workload(pool);
+
+        uint64_t index = 0;
+        // Calentamiento: hasta que el rango vivo (lo que ordenan Morton y la compactación) deja de crecer
+        int warmupFrames = 0;
+        int framesSincePeak = 0;
+        size_t peakParticles = 0;
+        while (warmupFrames < minWarmupFrames || framesSincePeak < STABLE_FRAMES) {
+            if (warmupFrames == MAX_WARMUP_FRAMES) {
+                std::fprintf(stderr, "AllocationHarness: particle range still growing after %d frames\n", warmupFrames);
+                return EXIT_FAILURE;
+            }
+            workload.frame(index++, false);
+            ++warmupFrames;
+            size_t particles = workload.system.getParticleCount();
+            if (particles > peakParticles) { peakParticles = particles; framesSincePeak = 0; }
+            else ++framesSincePeak;
+        }
+        for (int frame = 0; frame < frames; ++frame) workload.frame(index++, true);
+        particulas::Logger::flush();
+
+        bool clean = true;
+        std::printf("%-26s %12s %12s %12s\n", "phase", "heap allocs", "heap bytes", "device allocs");
+        for (size_t phase = PHASE_UPDATE; phase < PHASE_COUNT; ++phase) {
+            particulas::AllocationCounts counts = particulas::AllocationTracker::getCounts(phase);
+            std::printf("%-26s %12llu %12llu %12llu\n", PHASE_NAMES[phase], static_cast<unsigned long long>(counts.heapAllocations),
+                        static_cast<unsigned long long>(counts.heapBytes), static_cast<unsigned long long>(counts.deviceAllocations));
+            if (counts.heapAllocations != 0) clean = false;
+        }
+        if (!clean) {
+            std::fprintf(stderr, "AllocationHarness: heap allocations after %d warmup frames\n", warmupFrames);
+            return EXIT_FAILURE;
+        }
+        std::printf("AllocationHarness: %d frames with no heap allocations after %d warmup frames\n", frames, warmupFrames);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "AllocationHarness: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+// Prueba local de la descomposición en dominios con varios procesos: lanza N procesos hijos
+// (fork) conectados por socketpair o por memoria compartida, simula con una gravedad lateral que
+// amontona las partículas a la izquierda (para forzar migraciones y repartos de carga) y comprueba
+// periódicamente que el número total de partículas entre todos los procesos no cambia.
+//
+//   DomainHarness [procesos=4] [pasos=600] [socket|shm] [partículas=20000]
+//
+// Devuelve 0 si el total se conserva en todas las comprobaciones.
+
+#include "particles/domain_decomposition.hpp"
+#include "particles/particle_system.hpp"
+#include "utils/domain_transport.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr float DOMAIN_WIDTH = 1920.0f;
+constexpr float DOMAIN_HEIGHT = 1080.0f;
+constexpr float STEP_SECONDS = 1.0f / 60.0f;
+constexpr uint32_t CHECK_INTERVAL = 100;        // Pasos entre comprobaciones del total
+constexpr unsigned SCENE_SEED = 12345;          // Todos los procesos generan la misma escena
+const char* const SHARED_SEGMENT_NAME = "/particulas_domain_harness";
+
+struct HarnessOptions {
+    int ranks = 4;
+    int steps = 600;
+    bool sharedMemory = false;
+    int particles = 20000;
+};
+
+// Cada proceso genera la escena completa y se queda con las partículas de su franja inicial
+std::vector<particulas::Particle> makeSlabParticles(const HarnessOptions& options, float begin, float end, size_t speciesCount) {
+    std::mt19937 random(SCENE_SEED);
+    std::uniform_real_distribution<float> x(1.0f, DOMAIN_WIDTH - 1.0f), y(1.0f, DOMAIN_HEIGHT - 1.0f), direction(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> species(0, static_cast<int>(speciesCount) - 1);
+    std::vector<particulas::Particle> slab;
+    for (int i = 0; i < options.particles; ++i) {
+        particulas::Particle particle{};
+        particle.position = {x(random), y(random)};
+        particle.velocity = glm::vec2(direction(random), direction(random)) * 60.0f;
+        particle.species = static_cast<particulas::SpeciesId>(species(random));
+        if (particle.position.x >= begin && particle.position.x < end) slab.push_back(particle);
+    }
+    return slab;
+}
+
+int runRank(const HarnessOptions& options, int rank, std::unique_ptr<particulas::DomainTransport> transport) {
+    const size_t speciesCount = 4;
+    std::vector<float> boundaries = particulas::DomainDecomposition::makeUniformBoundaries(DOMAIN_WIDTH, options.ranks);
+    std::vector<particulas::Particle> slab = makeSlabParticles(options, boundaries[rank], boundaries[rank + 1], speciesCount);
+    if (slab.empty()) throw std::runtime_error("rank " + std::to_string(rank) + " starts without particles; use more particles");
+
+    // Capacidad para el peor caso: todas las partículas en este proceso
+    particulas::ParticleSystem system(std::move(slab), DOMAIN_WIDTH, DOMAIN_HEIGHT, static_cast<size_t>(options.particles),
+                                      particulas::makeDefaultSpecies(speciesCount));
+    system.setGravity({-120.0f, 0.0f});
+    particulas::DomainDecomposition decomposition(system, *transport);
+    decomposition.setBoundaries(boundaries);
+
+    const uint64_t expected = decomposition.getGlobalParticleCount();
+    bool conserved = expected == static_cast<uint64_t>(options.particles);
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 1; step <= options.steps && conserved; ++step) {
+        decomposition.step(STEP_SECONDS);
+        if (step % CHECK_INTERVAL != 0 && step != options.steps) continue;
+        uint64_t total = decomposition.getGlobalParticleCount(); // Colectiva: todos los rangos llegan al mismo resultado
+        conserved = total == expected;
+        if (rank == 0) {
+            std::printf("step %4d: total %llu%s, imbalance %.2f, rebalances %u, boundaries", step, static_cast<unsigned long long>(total),
+                        conserved ? "" : " (MISMATCH)", decomposition.getLastImbalance(), decomposition.getRebalanceCount());
+            for (float boundary : decomposition.getBoundaries()) std::printf(" %.0f", boundary);
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("rank %d: %zu particles in [%.0f, %.0f), %zu ghosts, migrated out %llu / in %llu, dropped %llu, %.3f ms/step\n", rank,
+                system.getLiveParticleCount(), decomposition.getSlabBegin(), decomposition.getSlabEnd(), decomposition.getGhostParticles().size(),
+                static_cast<unsigned long long>(decomposition.getMigratedOut()), static_cast<unsigned long long>(decomposition.getMigratedIn()),
+                static_cast<unsigned long long>(decomposition.getDroppedMigrations()), seconds * 1000.0 / options.steps);
+    std::fflush(stdout);
+    return conserved && decomposition.getDroppedMigrations() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    HarnessOptions options;
+    if (argc > 1) options.ranks = std::atoi(argv[1]);
+    if (argc > 2) options.steps = std::atoi(argv[2]);
+    if (argc > 3) options.sharedMemory = std::string(argv[3]) == "shm";
+    if (argc > 4) options.particles = std::atoi(argv[4]);
+    if (options.ranks < 1 || options.steps < 1 || options.particles < options.ranks) {
+        std::fprintf(stderr, "Usage: %s [ranks >= 1] [steps >= 1] [socket|shm] [particles >= ranks]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    std::printf("Domain harness: %d processes, %d steps, %d particles, %s transport\n", options.ranks, options.steps, options.particles,
+                options.sharedMemory ? "shared memory" : "socket");
+    std::fflush(stdout);
+
+    std::vector<std::vector<int>> mesh;
+    try {
+        if (options.sharedMemory) particulas::SharedMemoryTransport::createSegment(SHARED_SEGMENT_NAME, options.ranks);
+        else mesh = particulas::SocketTransport::createLocalMesh(options.ranks);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    std::vector<pid_t> children;
+    for (int rank = 0; rank < options.ranks; ++rank) {
+        pid_t pid = fork();
+        if (pid == -1) { std::perror("fork"); break; }
+        if (pid == 0) {
+            int result = EXIT_FAILURE;
+            try {
+                std::unique_ptr<particulas::DomainTransport> transport;
+                if (options.sharedMemory) {
+                    transport = std::make_unique<particulas::SharedMemoryTransport>(SHARED_SEGMENT_NAME, rank, options.ranks);
+                } else {
+                    particulas::SocketTransport::closeOtherRanks(mesh, rank);
+                    transport = std::make_unique<particulas::SocketTransport>(rank, mesh[rank]);
+                }
+                result = runRank(options, rank, std::move(transport));
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "rank %d: %s\n", rank, e.what()); // Los demás fallan al cerrarse su conexión
+            }
+            std::fflush(stdout);
+            _exit(result);
+        }
+        children.push_back(pid);
+    }
+    for (auto& fds : mesh) for (int fd : fds) if (fd >= 0) close(fd); // Solo los hijos los usan
+
+    // Si un proceso falla, los demás podrían quedarse esperando sus mensajes (con memoria
+    // compartida no hay conexión que se cierre): se terminan
+    bool passed = static_cast<int>(children.size()) == options.ranks;
+    if (!passed) for (pid_t child : children) kill(child, SIGTERM);
+    for (size_t remaining = children.size(); remaining > 0; --remaining) {
+        int status = 0;
+        if (waitpid(-1, &status, 0) == -1) break;
+        if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) continue;
+        if (passed) for (pid_t child : children) kill(child, SIGTERM);
+        passed = false;
+    }
+    if (options.sharedMemory) particulas::SharedMemoryTransport::removeSegment(SHARED_SEGMENT_NAME);
+    std::printf("%s: particle count %s\n", passed ? "PASSED" : "FAILED", passed ? "conserved" : "not conserved or a process failed");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
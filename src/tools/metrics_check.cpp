@@ -0,0 +1,175 @@
+// Prueba del endpoint de métricas sin ventana ni GPU: rellena un LiveMetrics con valores
+// conocidos, arranca MetricsServer en un puerto efímero de 127.0.0.1 y hace GET /metrics y
+// GET de una ruta desconocida como lo haría un scrape de Prometheus. Comprueba:
+//   - el estado 200 y que cada muestra tiene su línea "# TYPE"
+//   - en cada histograma, _count igual a la cubeta le="+Inf" y al número de observaciones
+//   - los valores de algunos contadores y gauges
+//   - el 404 de cualquier otra ruta
+//
+//   MetricsCheck
+//
+// Devuelve 0 si todas las comprobaciones pasan.
+
+#include "utils/metrics_server.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS
+#endif
+
+namespace {
+
+constexpr int FRAME_OBSERVATIONS = 250;  // Incluye algunas por encima del último límite (+Inf)
+constexpr int SUBMIT_OBSERVATIONS = 40;
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (condition) return;
+    std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+    ++failures;
+}
+
+// Petición HTTP/1.1 completa; el servidor cierra la conexión al terminar la respuesta
+std::string httpGet(uint16_t port, const char* path) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd == -1) throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    timeval timeout{5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        std::string error = std::strerror(errno);
+        close(fd);
+        throw std::runtime_error("connect to 127.0.0.1:" + std::to_string(port) + ": " + error);
+    }
+    std::string request = std::string("GET ") + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n";
+    send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+    std::string response;
+    char buffer[4096];
+    for (;;) {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) break;
+        response.append(buffer, static_cast<size_t>(received));
+    }
+    close(fd);
+    return response;
+}
+
+std::string statusLine(const std::string& response) {
+    return response.substr(0, response.find("\r\n"));
+}
+
+std::string body(const std::string& response) {
+    size_t headerEnd = response.find("\r\n\r\n");
+    return headerEnd == std::string::npos ? std::string() : response.substr(headerEnd + 4);
+}
+
+// Nombre de la familia de una muestra: sin etiquetas y, en los histogramas, sin el sufijo
+std::string familyName(const std::string& sample, const std::map<std::string, std::string>& types) {
+    std::string name = sample.substr(0, sample.find_first_of("{ "));
+    for (const char* suffix : {"_bucket", "_sum", "_count"}) {
+        size_t length = std::strlen(suffix);
+        if (name.size() > length && name.compare(name.size() - length, length, suffix) == 0) {
+            std::string base = name.substr(0, name.size() - length);
+            auto type = types.find(base);
+            if (type != types.end() && type->second == "histogram") return base;
+        }
+    }
+    return name;
+}
+
+void checkMetrics(const std::string& text) {
+    std::map<std::string, std::string> types;       // Familia -> tipo
+    std::map<std::string, std::string> samples;     // Muestra completa (con etiquetas) -> valor
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.empty()) continue;
+        if (line.compare(0, 7, "# TYPE ") == 0) {
+            std::istringstream fields(line.substr(7));
+            std::string name, type;
+            fields >> name >> type;
+            check(types.emplace(name, type).second, "duplicate # TYPE for " + name);
+            continue;
+        }
+        if (line[0] == '#') continue;
+        size_t separator = line.rfind(' ');
+        check(separator != std::string::npos, "malformed sample line: " + line);
+        if (separator == std::string::npos) continue;
+        std::string sample = line.substr(0, separator);
+        samples[sample] = line.substr(separator + 1);
+        std::string family = familyName(sample, types);
+        check(types.count(family) == 1, "sample without a preceding # TYPE line: " + sample);
+    }
+
+    const std::pair<const char*, int> histograms[] = {{"particulas_frame_time_seconds", FRAME_OBSERVATIONS},
+                                                      {"particulas_queue_submit_seconds", SUBMIT_OBSERVATIONS}};
+    for (const auto& [name, observations] : histograms) {
+        std::string family = name;
+        check(types[family] == "histogram", family + " is not typed as a histogram");
+        std::string count = samples[family + "_count"];
+        std::string infinity = samples[family + "_bucket{le=\"+Inf\"}"];
+        check(!count.empty() && count == infinity, family + ": _count (" + count + ") != +Inf bucket (" + infinity + ")");
+        check(count == std::to_string(observations), family + ": _count " + count + ", expected " + std::to_string(observations));
+    }
+    check(types["particulas_frames_total"] == "counter", "particulas_frames_total is not a counter");
+    check(samples["particulas_frames_total"] == "1234", "particulas_frames_total = " + samples["particulas_frames_total"]);
+    check(samples["particulas_particles_live"] == "5000", "particulas_particles_live = " + samples["particulas_particles_live"]);
+    check(samples["particulas_gpu_heap_usage_bytes{heap=\"1\"}"] == "2048", "heap 1 usage missing or wrong");
+}
+
+} // namespace
+
+int main() {
+    try {
+        particulas::LiveMetrics metrics;
+        for (int i = 0; i < FRAME_OBSERVATIONS; ++i) metrics.frameTimeSeconds.observe(0.001 * (i % 300)); // Hasta 0,299 s > 0,25
+        for (int i = 0; i < SUBMIT_OBSERVATIONS; ++i) metrics.submitLatencySeconds.observe(20e-6 * (i + 1));
+        metrics.frames.store(1234);
+        metrics.simulationSteps.store(1234);
+        metrics.liveParticles.store(5000);
+        metrics.drawnParticles.store(4000);
+        metrics.particleCapacity.store(8192);
+        metrics.gpuHeapCount.store(2);
+        metrics.gpuHeapBudgetBytes[0].store(1u << 20);
+        metrics.gpuHeapBudgetBytes[1].store(1u << 16);
+        metrics.gpuHeapUsageBytes[0].store(4096);
+        metrics.gpuHeapUsageBytes[1].store(2048);
+
+        particulas::MetricsServer server(metrics, 0);
+        check(server.getPort() != 0, "the ephemeral port was not reported");
+        std::printf("Metrics endpoint on 127.0.0.1:%u\n", static_cast<unsigned>(server.getPort()));
+
+        std::string response = httpGet(server.getPort(), "/metrics");
+        check(statusLine(response) == "HTTP/1.1 200 OK", "GET /metrics: '" + statusLine(response) + "'");
+        checkMetrics(body(response));
+
+        std::string missing = httpGet(server.getPort(), "/nope");
+        check(statusLine(missing) == "HTTP/1.1 404 Not Found", "GET /nope: '" + statusLine(missing) + "'");
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "MetricsCheck: %s\n", e.what());
+        return 1;
+    }
+    if (failures > 0) {
+        std::fprintf(stderr, "MetricsCheck: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("MetricsCheck: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Consumidor de ejemplo de los snapshots compartidos: se engancha al segmento que publica
+// ParticleSimulation (ENABLE_SHARED_SNAPSHOTS en main.cpp) y cada segundo imprime cuántos
+// snapshots ha leído, cuántos se saltó y algunas estadísticas calculadas en el sitio, sin copiar.
+//
+//   SnapshotConsumer [nombre del segmento]   (por defecto /particulas_snapshots)
+
+#include "utils/shared_snapshot_reader.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct SnapshotStats {
+    size_t alive = 0;
+    double centroidX = 0.0, centroidY = 0.0;
+    double meanSpeed = 0.0;
+};
+
+SnapshotStats computeStats(const particulas::SnapshotView& view) {
+    SnapshotStats stats;
+    for (size_t i = 0; i < view.particleCount; ++i) {
+        const particulas::SharedParticle& particle = view.particles[i];
+        if (particle.alive == 0) continue;
+        ++stats.alive;
+        stats.centroidX += particle.positionX;
+        stats.centroidY += particle.positionY;
+        stats.meanSpeed += std::sqrt(particle.velocityX * particle.velocityX + particle.velocityY * particle.velocityY);
+    }
+    if (stats.alive > 0) {
+        stats.centroidX /= static_cast<double>(stats.alive);
+        stats.centroidY /= static_cast<double>(stats.alive);
+        stats.meanSpeed /= static_cast<double>(stats.alive);
+    }
+    return stats;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string name = argc > 1 ? argv[1] : "/particulas_snapshots";
+    try {
+        std::unique_ptr<particulas::SharedSnapshotReader> reader;
+        std::printf("Waiting for %s...\n", name.c_str());
+        while (!(reader = particulas::SharedSnapshotReader::tryOpen(name))) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+        std::printf("Attached to %s (writer pid %llu, %u slots of %zu particles)\n", name.c_str(),
+                    static_cast<unsigned long long>(reader->getWriterPid()), reader->getSlotCount(), reader->getCapacity());
+
+        uint64_t read = 0, skipped = 0, torn = 0, lastFrame = 0;
+        SnapshotStats stats;
+        particulas::SnapshotView view;
+        auto reportTime = std::chrono::steady_clock::now();
+        while (!reader->isWriterClosed()) {
+            if (!reader->acquireLatest(view)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            } else {
+                SnapshotStats current = computeStats(view);
+                if (!reader->isStillValid(view)) {
+                    ++torn; // El escritor reutilizó el slot mientras lo recorríamos: se descarta
+                } else {
+                    stats = current;
+                    if (lastFrame != 0 && view.frame > lastFrame + 1) skipped += view.frame - lastFrame - 1;
+                    lastFrame = view.frame;
+                    ++read;
+                }
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - reportTime >= std::chrono::seconds(1)) {
+                std::printf("frame %llu step %llu: %zu alive, centroid (%.2f, %.2f), mean speed %.3f | read %llu, skipped %llu, torn %llu\n",
+                            static_cast<unsigned long long>(lastFrame), static_cast<unsigned long long>(view.simulationStep),
+                            stats.alive, stats.centroidX, stats.centroidY, stats.meanSpeed, static_cast<unsigned long long>(read),
+                            static_cast<unsigned long long>(skipped), static_cast<unsigned long long>(torn));
+                std::fflush(stdout);
+                read = skipped = torn = 0;
+                reportTime = now;
+            }
+        }
+        std::printf("Writer closed %s.\n", name.c_str());
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "utils/allocation_tracker.hpp"
+
+#include <array>
+#include <atomic>
+
+#ifdef PARTICULAS_TRACK_ALLOCATIONS
+    #include <cstdlib>
+    #include <new>
+    #ifdef __linux__
+        #include <vulkan/vulkan.h>
+        #include <dlfcn.h> // dlsym(RTLD_NEXT) para llegar al vkAllocateMemory del loader
+    #endif
+    #ifdef _WIN32
+        #include <malloc.h> // _aligned_malloc
+    #endif
+#endif
+
+namespace particulas {
+
+namespace {
+
+// Contadores por fase: atómicos relajados, los incrementan a la vez el hilo principal y los del pool
+struct PhaseCounters {
+    std::atomic<uint64_t> heapAllocations{0};
+    std::atomic<uint64_t> heapBytes{0};
+    std::atomic<uint64_t> deviceAllocations{0};
+};
+
+std::array<PhaseCounters, AllocationTracker::MAX_PHASES> phaseCounters;
+std::atomic<size_t> currentPhase{0};
+thread_local bool threadTracked = false; // Trivial: leerlo desde malloc no reserva nada
+
+[[maybe_unused]] void countHeapAllocation(size_t size) {
+    if (!threadTracked) return;
+    PhaseCounters& counters = phaseCounters[currentPhase.load(std::memory_order_relaxed)];
+    counters.heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.heapBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+[[maybe_unused]] void countDeviceAllocation() {
+    if (!threadTracked) return;
+    phaseCounters[currentPhase.load(std::memory_order_relaxed)].deviceAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+bool AllocationTracker::isEnabled() {
+#ifdef PARTICULAS_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocationTracker::trackCurrentThread(bool tracked) {
+    threadTracked = tracked;
+}
+
+void AllocationTracker::setPhase(size_t phase) {
+    currentPhase.store(phase < MAX_PHASES ? phase : MAX_PHASES - 1, std::memory_order_relaxed);
+}
+
+AllocationCounts AllocationTracker::getCounts(size_t phase) {
+    const PhaseCounters& counters = phaseCounters.at(phase);
+    return {counters.heapAllocations.load(std::memory_order_relaxed), counters.heapBytes.load(std::memory_order_relaxed),
+            counters.deviceAllocations.load(std::memory_order_relaxed)};
+}
+
+} // namespace particulas
+
+#ifdef PARTICULAS_TRACK_ALLOCATIONS
+
+// --- Memoria sin contar ---
+// En glibc malloc también se sustituye, así que operator new va directo a las funciones internas
+// de la libc para no contar dos veces la misma reserva.
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+namespace {
+void* rawMalloc(size_t size) { return __libc_malloc(size); }
+void* rawAlignedMalloc(size_t size, size_t alignment) { return __libc_memalign(alignment, size); }
+void rawFree(void* pointer) { __libc_free(pointer); }
+void rawAlignedFree(void* pointer) { __libc_free(pointer); }
+} // namespace
+#elif defined(_WIN32)
+namespace {
+void* rawMalloc(size_t size) { return std::malloc(size); }
+void* rawAlignedMalloc(size_t size, size_t alignment) { return _aligned_malloc(size, alignment); }
+void rawFree(void* pointer) { std::free(pointer); }
+void rawAlignedFree(void* pointer) { _aligned_free(pointer); }
+} // namespace
+#else
+namespace {
+void* rawMalloc(size_t size) { return std::malloc(size); }
+void* rawAlignedMalloc(size_t size, size_t alignment) {
+    void* pointer = nullptr;
+    return posix_memalign(&pointer, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) == 0 ? pointer : nullptr;
+}
+void rawFree(void* pointer) { std::free(pointer); }
+void rawAlignedFree(void* pointer) { std::free(pointer); }
+} // namespace
+#endif
+
+// --- operator new/delete globales ---
+// Las variantes de array, nothrow y con tamaño de la biblioteca estándar acaban en estas.
+void* operator new(size_t size) {
+    particulas::countHeapAllocation(size);
+    void* pointer = rawMalloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    particulas::countHeapAllocation(size);
+    void* pointer = rawAlignedMalloc(size == 0 ? 1 : size, static_cast<size_t>(alignment));
+    if (pointer == nullptr) throw std::bad_alloc();
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept { rawFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { rawFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { rawAlignedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { rawAlignedFree(pointer); }
+
+// --- malloc de la libc (solo glibc, que exporta las funciones internas para interponerlas) ---
+#if defined(__GLIBC__)
+extern "C" {
+void* malloc(size_t size) noexcept {
+    particulas::countHeapAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    particulas::countHeapAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept {
+    if (size != 0) particulas::countHeapAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) noexcept { __libc_free(pointer); }
+}
+#endif
+
+// --- vkAllocateMemory ---
+// La definición del ejecutable tiene prioridad sobre la del loader de Vulkan; la original se
+// busca con RTLD_NEXT la primera vez.
+#ifdef __linux__
+extern "C" VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(VkDevice device, const VkMemoryAllocateInfo* pAllocateInfo,
+                                                           const VkAllocationCallbacks* pAllocator, VkDeviceMemory* pMemory) {
+    static const PFN_vkAllocateMemory next = reinterpret_cast<PFN_vkAllocateMemory>(dlsym(RTLD_NEXT, "vkAllocateMemory"));
+    if (next == nullptr) return VK_ERROR_INITIALIZATION_FAILED;
+    particulas::countDeviceAllocation();
+    return next(device, pAllocateInfo, pAllocator, pMemory);
+}
+#endif
+
+#endif // PARTICULAS_TRACK_ALLOCATIONS
@@ -0,0 +1,45 @@
+#ifndef PARTICULAS_UTILS_ALLOCATION_TRACKER_HPP
+#define PARTICULAS_UTILS_ALLOCATION_TRACKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace particulas {
+
+struct AllocationCounts {
+    uint64_t heapAllocations = 0;   // operator new, malloc, calloc y realloc
+    uint64_t heapBytes = 0;
+    uint64_t deviceAllocations = 0; // vkAllocateMemory
+
+    bool isZero() const { return heapAllocations == 0 && deviceAllocations == 0; }
+    AllocationCounts operator-(const AllocationCounts& other) const {
+        return {heapAllocations - other.heapAllocations, heapBytes - other.heapBytes, deviceAllocations - other.deviceAllocations};
+    }
+    AllocationCounts& operator+=(const AllocationCounts& other) {
+        heapAllocations += other.heapAllocations; heapBytes += other.heapBytes; deviceAllocations += other.deviceAllocations;
+        return *this;
+    }
+};
+
+// Instrumentación de depuración: cuenta las reservas de memoria por fase del frame. Compilando con
+// PARTICULAS_TRACK_ALLOCATIONS (opción de CMake) se sustituyen los operator new/delete globales,
+// en glibc también malloc/calloc/realloc/free, y en Linux se intercepta vkAllocateMemory. Solo
+// cuentan los hilos marcados con trackCurrentThread (el principal y los del ThreadPool): los hilos
+// propios del driver, del compilador de pipelines o del servidor de métricas no ensucian la cuenta.
+// Las reservas que hace el driver dentro de una llamada de Vulkan se atribuyen a la fase que la hizo.
+// Sin la opción, isEnabled() es false y los contadores se quedan a cero.
+class AllocationTracker {
+public:
+    static constexpr size_t MAX_PHASES = 16;
+
+    static bool isEnabled();
+    static void trackCurrentThread(bool tracked = true);
+    // Fase a la que se atribuyen las reservas de todos los hilos marcados (la fija el hilo principal)
+    static void setPhase(size_t phase);
+    // Acumulado desde el arranque
+    static AllocationCounts getCounts(size_t phase);
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_ALLOCATION_TRACKER_HPP
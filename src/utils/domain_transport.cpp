@@ -0,0 +1,404 @@
+#include "domain_transport.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: sin SIGPIPE por envío
+#endif
+#endif
+
+namespace particulas {
+
+namespace {
+
+constexpr size_t FRAME_HEADER_BYTES = sizeof(uint64_t); // Longitud del mensaje delante de sus bytes
+constexpr uint32_t SHARED_TRANSPORT_MAGIC = 0x50445452; // "PDTR"
+
+// Estado de un intercambio con un peer: bytes movidos contando la cabecera
+struct PeerProgress {
+    uint64_t sendLength = 0;
+    uint64_t receiveLength = 0;
+    size_t sent = 0;
+    size_t received = 0;
+    bool sendDone = false;
+    bool receiveDone = false;
+};
+
+} // namespace
+
+// --- DomainTransport ---
+DomainTransport::DomainTransport(int rank, int rankCount) : rank_(rank), rankCount_(rankCount) {
+    if (rankCount <= 0 || rank < 0 || rank >= rankCount) {
+        throw std::invalid_argument("Domain transport: rank " + std::to_string(rank) + " out of range for " + std::to_string(rankCount) + " ranks");
+    }
+    for (int peer = 0; peer < rankCount; ++peer) {
+        if (peer != rank) allPeers_.push_back(peer);
+    }
+    allOutgoing_.resize(allPeers_.size());
+}
+
+void DomainTransport::exchange(const std::vector<int>& peers, const std::vector<std::vector<uint8_t>>& outgoing,
+                               std::vector<std::vector<uint8_t>>& incoming) {
+    if (outgoing.size() != peers.size()) throw std::invalid_argument("Domain transport: one outgoing message per peer is required");
+    incoming.resize(peers.size());
+    std::vector<PeerProgress> progress(peers.size());
+    size_t pending = 0;
+    for (size_t i = 0; i < peers.size(); ++i) {
+        if (peers[i] < 0 || peers[i] >= rankCount_ || peers[i] == rank_) throw std::invalid_argument("Domain transport: invalid peer rank");
+        progress[i].sendLength = outgoing[i].size();
+        pending += 2;
+    }
+
+    // Enviar y recibir a la vez: si todos enviaran primero, dos mensajes mayores que el buffer
+    // del medio se bloquearían el uno al otro
+    while (pending > 0) {
+        bool progressed = false;
+        for (size_t i = 0; i < peers.size(); ++i) {
+            PeerProgress& state = progress[i];
+            if (!state.sendDone) {
+                size_t moved;
+                if (state.sent < FRAME_HEADER_BYTES) {
+                    moved = trySend(peers[i], reinterpret_cast<const uint8_t*>(&state.sendLength) + state.sent, FRAME_HEADER_BYTES - state.sent);
+                } else {
+                    size_t offset = state.sent - FRAME_HEADER_BYTES;
+                    moved = trySend(peers[i], outgoing[i].data() + offset, outgoing[i].size() - offset);
+                }
+                state.sent += moved;
+                progressed |= moved > 0;
+                if (state.sent == FRAME_HEADER_BYTES + outgoing[i].size()) { state.sendDone = true; --pending; }
+            }
+            if (!state.receiveDone) {
+                size_t moved;
+                if (state.received < FRAME_HEADER_BYTES) {
+                    moved = tryReceive(peers[i], reinterpret_cast<uint8_t*>(&state.receiveLength) + state.received, FRAME_HEADER_BYTES - state.received);
+                    if (state.received + moved == FRAME_HEADER_BYTES) incoming[i].resize(state.receiveLength);
+                } else {
+                    size_t offset = state.received - FRAME_HEADER_BYTES;
+                    moved = tryReceive(peers[i], incoming[i].data() + offset, incoming[i].size() - offset);
+                }
+                state.received += moved;
+                progressed |= moved > 0;
+                if (state.received >= FRAME_HEADER_BYTES && state.received == FRAME_HEADER_BYTES + state.receiveLength) {
+                    state.receiveDone = true; --pending;
+                }
+            }
+        }
+        if (!progressed && pending > 0) waitForProgress();
+    }
+}
+
+void DomainTransport::allGather(const std::vector<uint8_t>& local, std::vector<std::vector<uint8_t>>& gathered) {
+    for (std::vector<uint8_t>& message : allOutgoing_) message.assign(local.begin(), local.end());
+    std::vector<std::vector<uint8_t>> received;
+    exchange(allPeers_, allOutgoing_, received);
+    gathered.resize(rankCount_);
+    gathered[rank_] = local;
+    for (size_t i = 0; i < allPeers_.size(); ++i) gathered[allPeers_[i]] = std::move(received[i]);
+}
+
+#ifndef _WIN32
+
+// --- SocketTransport ---
+SocketTransport::SocketTransport(int rank, std::vector<int> peerFds)
+    : DomainTransport(rank, static_cast<int>(peerFds.size())), peerFds_(std::move(peerFds)) {
+    for (int peer = 0; peer < getRankCount(); ++peer) {
+        if (peer != rank && peerFds_[peer] < 0) throw std::invalid_argument("Socket transport: missing connection to rank " + std::to_string(peer));
+    }
+}
+
+SocketTransport::~SocketTransport() {
+    for (int fd : peerFds_) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+std::vector<std::vector<int>> SocketTransport::createLocalMesh(int rankCount) {
+    std::vector<std::vector<int>> mesh(rankCount, std::vector<int>(rankCount, -1));
+    for (int a = 0; a < rankCount; ++a) {
+        for (int b = a + 1; b < rankCount; ++b) {
+            int pair[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == -1) {
+                std::string error = std::strerror(errno);
+                for (auto& fds : mesh) for (int fd : fds) if (fd >= 0) close(fd);
+                throw std::runtime_error("Socket transport: socketpair: " + error);
+            }
+            mesh[a][b] = pair[0];
+            mesh[b][a] = pair[1];
+        }
+    }
+    return mesh;
+}
+
+void SocketTransport::closeOtherRanks(std::vector<std::vector<int>>& mesh, int rank) {
+    for (int other = 0; other < static_cast<int>(mesh.size()); ++other) {
+        if (other == rank) continue;
+        for (int& fd : mesh[other]) {
+            if (fd >= 0) close(fd);
+            fd = -1;
+        }
+    }
+}
+
+std::unique_ptr<SocketTransport> SocketTransport::connectUnixMesh(const std::string& directory, int rank, int rankCount, int timeoutSeconds) {
+    auto socketPath = [&directory](int peer) { return directory + "/rank-" + std::to_string(peer) + ".sock"; };
+    auto makeAddress = [](const std::string& path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) throw std::runtime_error("Socket transport: path too long: " + path);
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    };
+    auto fail = [](const std::string& what, std::vector<int>& fds, int listenFd) {
+        std::string error = std::strerror(errno);
+        for (int fd : fds) if (fd >= 0) close(fd);
+        if (listenFd >= 0) close(listenFd);
+        throw std::runtime_error("Socket transport: " + what + ": " + error);
+    };
+
+    std::vector<int> peerFds(rankCount, -1);
+    const std::string ownPath = socketPath(rank);
+    sockaddr_un ownAddress = makeAddress(ownPath);
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd == -1) fail("socket", peerFds, -1);
+    unlink(ownPath.c_str()); // Resto de una ejecución anterior
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&ownAddress), sizeof(ownAddress)) == -1 || listen(listenFd, rankCount) == -1) {
+        fail("cannot listen on " + ownPath, peerFds, listenFd);
+    }
+
+    // Rangos menores: conectar (reintentando hasta que existan) y presentarse con el rango propio.
+    // connect termina en cuanto el otro escucha, aunque aún no haya aceptado: no hay bloqueo mutuo.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeoutSeconds);
+    for (int peer = 0; peer < rank; ++peer) {
+        sockaddr_un peerAddress = makeAddress(socketPath(peer));
+        for (;;) {
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd == -1) fail("socket", peerFds, listenFd);
+            if (connect(fd, reinterpret_cast<sockaddr*>(&peerAddress), sizeof(peerAddress)) == 0) { peerFds[peer] = fd; break; }
+            int connectError = errno;
+            close(fd);
+            if ((connectError != ENOENT && connectError != ECONNREFUSED) || std::chrono::steady_clock::now() > deadline) {
+                errno = connectError;
+                fail("cannot connect to rank " + std::to_string(peer), peerFds, listenFd);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        int32_t ownRank = rank;
+        if (send(peerFds[peer], &ownRank, sizeof(ownRank), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(ownRank))) {
+            fail("handshake with rank " + std::to_string(peer), peerFds, listenFd);
+        }
+    }
+
+    // Rangos mayores: aceptar y leer quién es cada uno
+    for (int accepted = rank + 1; accepted < rankCount; ++accepted) {
+        pollfd listenPoll{listenFd, POLLIN, 0};
+        int remainingMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count());
+        if (remainingMs <= 0 || poll(&listenPoll, 1, remainingMs) <= 0) {
+            errno = ETIMEDOUT;
+            fail("waiting for higher ranks", peerFds, listenFd);
+        }
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd == -1) fail("accept", peerFds, listenFd);
+        int32_t peer = -1;
+        if (recv(fd, &peer, sizeof(peer), MSG_WAITALL) != static_cast<ssize_t>(sizeof(peer)) || peer <= rank || peer >= rankCount || peerFds[peer] >= 0) {
+            close(fd);
+            errno = EPROTO;
+            fail("bad handshake", peerFds, listenFd);
+        }
+        peerFds[peer] = fd;
+    }
+    close(listenFd);
+    unlink(ownPath.c_str());
+    return std::make_unique<SocketTransport>(rank, std::move(peerFds));
+}
+
+size_t SocketTransport::trySend(int peer, const uint8_t* data, size_t bytes) {
+    ssize_t sent = send(peerFds_[peer], data, bytes, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (sent >= 0) return static_cast<size_t>(sent);
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+    throw std::runtime_error("Socket transport: send to rank " + std::to_string(peer) + ": " + std::strerror(errno));
+}
+
+size_t SocketTransport::tryReceive(int peer, uint8_t* data, size_t bytes) {
+    ssize_t received = recv(peerFds_[peer], data, bytes, MSG_DONTWAIT);
+    if (received > 0) return static_cast<size_t>(received);
+    if (received == 0) throw std::runtime_error("Socket transport: rank " + std::to_string(peer) + " closed the connection");
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+    throw std::runtime_error("Socket transport: receive from rank " + std::to_string(peer) + ": " + std::strerror(errno));
+}
+
+// Despierta en cuanto llegan datos; si solo se espera a poder enviar, el timeout de 1 ms acota la espera
+void SocketTransport::waitForProgress() {
+    pollfd polls[64];
+    nfds_t count = 0;
+    for (int fd : peerFds_) {
+        if (fd >= 0 && count < 64) polls[count++] = {fd, POLLIN, 0};
+    }
+    poll(polls, count, 1);
+}
+
+// --- SharedMemoryTransport ---
+struct SharedMemoryTransport::Ring {
+    alignas(64) std::atomic<uint64_t> head; // Bytes escritos desde el principio (solo el productor)
+    alignas(64) std::atomic<uint64_t> tail; // Bytes leídos desde el principio (solo el consumidor)
+    // Siguen ringBytes de datos
+};
+
+namespace {
+
+struct alignas(64) SharedTransportHeader {
+    std::atomic<uint32_t> magic; // Se escribe el último
+    uint32_t rankCount;
+    uint64_t ringBytes;
+};
+
+constexpr size_t RING_HEADER_BYTES = 128; // head y tail en líneas de caché separadas
+
+size_t ringStride(size_t ringBytes) {
+    return (RING_HEADER_BYTES + ringBytes + 63) / 64 * 64;
+}
+
+size_t segmentBytes(int rankCount, size_t ringBytes) {
+    return sizeof(SharedTransportHeader) + static_cast<size_t>(rankCount) * rankCount * ringStride(ringBytes);
+}
+
+} // namespace
+
+void SharedMemoryTransport::createSegment(const std::string& name, int rankCount, size_t ringBytes) {
+    static_assert(sizeof(Ring) == RING_HEADER_BYTES, "Ring header must be two cache lines");
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) throw std::runtime_error("Shared memory transport: shm_open(" + name + "): " + std::strerror(errno));
+    size_t bytes = segmentBytes(rankCount, ringBytes);
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    std::string error = std::strerror(errno);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw std::runtime_error("Shared memory transport: cannot map " + std::to_string(bytes) + " bytes: " + error);
+    }
+    // ftruncate deja a cero los índices de todos los anillos
+    auto* header = static_cast<SharedTransportHeader*>(mapped);
+    header->rankCount = static_cast<uint32_t>(rankCount);
+    header->ringBytes = ringBytes;
+    header->magic.store(SHARED_TRANSPORT_MAGIC, std::memory_order_release);
+    munmap(mapped, bytes);
+}
+
+void SharedMemoryTransport::removeSegment(const std::string& name) {
+    shm_unlink(name.c_str());
+}
+
+SharedMemoryTransport::SharedMemoryTransport(const std::string& name, int rank, int rankCount)
+    : DomainTransport(rank, rankCount) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1) throw std::runtime_error("Shared memory transport: shm_open(" + name + "): " + std::strerror(errno));
+    struct stat info{};
+    if (fstat(fd, &info) == -1 || static_cast<size_t>(info.st_size) < sizeof(SharedTransportHeader)) {
+        close(fd);
+        throw std::runtime_error("Shared memory transport: " + name + " is not initialized");
+    }
+    mappedBytes_ = static_cast<size_t>(info.st_size);
+    mapped_ = mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped_ == MAP_FAILED) { mapped_ = nullptr; throw std::runtime_error(std::string("Shared memory transport: mmap: ") + std::strerror(errno)); }
+
+    const auto* header = static_cast<const SharedTransportHeader*>(mapped_);
+    ringBytes_ = static_cast<size_t>(header->ringBytes);
+    if (header->magic.load(std::memory_order_acquire) != SHARED_TRANSPORT_MAGIC || header->rankCount != static_cast<uint32_t>(rankCount) ||
+        ringBytes_ == 0 || segmentBytes(rankCount, ringBytes_) > mappedBytes_) {
+        munmap(mapped_, mappedBytes_); mapped_ = nullptr;
+        throw std::runtime_error("Shared memory transport: " + name + " was not created for " + std::to_string(rankCount) + " ranks");
+    }
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+    if (mapped_ != nullptr) munmap(mapped_, mappedBytes_);
+}
+
+SharedMemoryTransport::Ring& SharedMemoryTransport::getRing(int from, int to) const {
+    char* base = static_cast<char*>(mapped_) + sizeof(SharedTransportHeader);
+    size_t index = static_cast<size_t>(from) * getRankCount() + static_cast<size_t>(to);
+    return *reinterpret_cast<Ring*>(base + index * ringStride(ringBytes_));
+}
+
+size_t SharedMemoryTransport::trySend(int peer, const uint8_t* data, size_t bytes) {
+    Ring& ring = getRing(getRank(), peer);
+    uint8_t* storage = reinterpret_cast<uint8_t*>(&ring + 1);
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    uint64_t tail = ring.tail.load(std::memory_order_acquire);
+    size_t count = std::min<size_t>(bytes, ringBytes_ - static_cast<size_t>(head - tail));
+    size_t offset = static_cast<size_t>(head % ringBytes_);
+    size_t first = std::min(count, ringBytes_ - offset);
+    std::memcpy(storage + offset, data, first);
+    std::memcpy(storage, data + first, count - first);
+    ring.head.store(head + count, std::memory_order_release);
+    return count;
+}
+
+size_t SharedMemoryTransport::tryReceive(int peer, uint8_t* data, size_t bytes) {
+    Ring& ring = getRing(peer, getRank());
+    const uint8_t* storage = reinterpret_cast<const uint8_t*>(&ring + 1);
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    uint64_t head = ring.head.load(std::memory_order_acquire);
+    size_t count = std::min<size_t>(bytes, static_cast<size_t>(head - tail));
+    size_t offset = static_cast<size_t>(tail % ringBytes_);
+    size_t first = std::min(count, ringBytes_ - offset);
+    std::memcpy(data, storage + offset, first);
+    std::memcpy(data + first, storage, count - first);
+    ring.tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+void SharedMemoryTransport::waitForProgress() {
+    sched_yield();
+}
+
+#else
+
+SocketTransport::SocketTransport(int rank, std::vector<int> peerFds)
+    : DomainTransport(rank, static_cast<int>(peerFds.size())), peerFds_(std::move(peerFds)) {
+    throw std::runtime_error("Socket transport: only available on POSIX systems");
+}
+SocketTransport::~SocketTransport() = default;
+std::vector<std::vector<int>> SocketTransport::createLocalMesh(int) { throw std::runtime_error("Socket transport: only available on POSIX systems"); }
+void SocketTransport::closeOtherRanks(std::vector<std::vector<int>>&, int) {}
+std::unique_ptr<SocketTransport> SocketTransport::connectUnixMesh(const std::string&, int, int, int) {
+    throw std::runtime_error("Socket transport: only available on POSIX systems");
+}
+size_t SocketTransport::trySend(int, const uint8_t*, size_t) { return 0; }
+size_t SocketTransport::tryReceive(int, uint8_t*, size_t) { return 0; }
+void SocketTransport::waitForProgress() {}
+
+struct SharedMemoryTransport::Ring {};
+void SharedMemoryTransport::createSegment(const std::string&, int, size_t) {
+    throw std::runtime_error("Shared memory transport: only available on POSIX systems");
+}
+void SharedMemoryTransport::removeSegment(const std::string&) {}
+SharedMemoryTransport::SharedMemoryTransport(const std::string&, int rank, int rankCount) : DomainTransport(rank, rankCount) {
+    throw std::runtime_error("Shared memory transport: only available on POSIX systems");
+}
+SharedMemoryTransport::~SharedMemoryTransport() = default;
+SharedMemoryTransport::Ring& SharedMemoryTransport::getRing(int, int) const { return *static_cast<Ring*>(mapped_); }
+size_t SharedMemoryTransport::trySend(int, const uint8_t*, size_t) { return 0; }
+size_t SharedMemoryTransport::tryReceive(int, uint8_t*, size_t) { return 0; }
+void SharedMemoryTransport::waitForProgress() {}
+
+#endif
+
+} // namespace particulas
@@ -0,0 +1,110 @@
+#ifndef PARTICULAS_UTILS_DOMAIN_TRANSPORT_HPP
+#define PARTICULAS_UTILS_DOMAIN_TRANSPORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace particulas {
+
+// Canal de mensajes entre los procesos de una simulación repartida (DomainDecomposition). Cada
+// proceso tiene un rango en [0, getRankCount()) y todos están conectados con todos.
+// La lógica de intercambio (marcos con longitud, envío y recepción a la vez para que dos procesos
+// que se envían mucho no se bloqueen mutuamente) está aquí; las subclases solo aportan el medio:
+// mover bytes sin bloquear y esperar a que haya progreso. Los mensajes son bytes crudos: todos los
+// procesos deben ser el mismo binario (mismo layout y endianness de Particle).
+// Los errores del medio (un proceso que muere, un segmento que no existe) lanzan std::runtime_error.
+class DomainTransport {
+public:
+    virtual ~DomainTransport() = default;
+
+    int getRank() const { return rank_; }
+    int getRankCount() const { return rankCount_; }
+
+    // Envía outgoing[i] a peers[i] y recibe de cada peers[i] un mensaje en incoming[i]. Bloquea
+    // hasta completar. Colectiva: cada vecino debe llamarla también con este rango en su lista.
+    // incoming conserva la capacidad entre llamadas.
+    void exchange(const std::vector<int>& peers, const std::vector<std::vector<uint8_t>>& outgoing,
+                  std::vector<std::vector<uint8_t>>& incoming);
+    // Cada proceso aporta local y todos reciben los de todos, indexados por rango (incluido el propio)
+    void allGather(const std::vector<uint8_t>& local, std::vector<std::vector<uint8_t>>& gathered);
+
+    DomainTransport(const DomainTransport&) = delete;
+    DomainTransport& operator=(const DomainTransport&) = delete;
+
+protected:
+    DomainTransport(int rank, int rankCount);
+
+    // Copian hasta bytes sin bloquear y devuelven cuántos movieron (0 si el medio está lleno o vacío)
+    virtual size_t trySend(int peer, const uint8_t* data, size_t bytes) = 0;
+    virtual size_t tryReceive(int peer, uint8_t* data, size_t bytes) = 0;
+    // Espera (poco) a que algún peer pueda avanzar
+    virtual void waitForProgress() = 0;
+
+private:
+    int rank_;
+    int rankCount_;
+    std::vector<int> allPeers_; // Reutilizado por allGather
+    std::vector<std::vector<uint8_t>> allOutgoing_;
+};
+
+// Sockets de flujo ya conectados, uno por peer: socketpair entre procesos hijos de un mismo
+// lanzador, sockets Unix con nombre entre procesos independientes o, con el mismo código, TCP
+// entre nodos (solo cambia cómo se abren los descriptores).
+class SocketTransport : public DomainTransport {
+public:
+    // peerFds[peer] conectado con cada peer (-1 en la posición propia); se adueña de ellos
+    SocketTransport(int rank, std::vector<int> peerFds);
+    ~SocketTransport() override;
+
+    // Un socketpair por pareja de rangos: mesh[rank] son los descriptores de ese rango. Para
+    // crearlos antes de fork(); cada hijo cierra los de los demás con closeOtherRanks.
+    static std::vector<std::vector<int>> createLocalMesh(int rankCount);
+    static void closeOtherRanks(std::vector<std::vector<int>>& mesh, int rank);
+    // Procesos lanzados por separado: cada rango escucha en <directory>/rank-<n>.sock, se conecta a
+    // los rangos menores y acepta a los mayores. Espera hasta timeoutSeconds a que arranquen.
+    static std::unique_ptr<SocketTransport> connectUnixMesh(const std::string& directory, int rank, int rankCount,
+                                                            int timeoutSeconds = 30);
+
+protected:
+    size_t trySend(int peer, const uint8_t* data, size_t bytes) override;
+    size_t tryReceive(int peer, uint8_t* data, size_t bytes) override;
+    void waitForProgress() override;
+
+private:
+    std::vector<int> peerFds_;
+};
+
+// Anillos de bytes SPSC en un segmento de memoria compartida POSIX, uno por cada par ordenado de
+// rangos. Sin llamadas al sistema al intercambiar; la espera es activa con cesión de la CPU.
+class SharedMemoryTransport : public DomainTransport {
+public:
+    static constexpr size_t DEFAULT_RING_BYTES = 4 << 20;
+
+    // El lanzador crea el segmento antes de arrancar los procesos y lo borra al final
+    static void createSegment(const std::string& name, int rankCount, size_t ringBytes = DEFAULT_RING_BYTES);
+    static void removeSegment(const std::string& name);
+
+    // Lanza std::runtime_error si el segmento no existe o se creó para otro número de rangos
+    SharedMemoryTransport(const std::string& name, int rank, int rankCount);
+    ~SharedMemoryTransport() override;
+
+protected:
+    size_t trySend(int peer, const uint8_t* data, size_t bytes) override;
+    size_t tryReceive(int peer, uint8_t* data, size_t bytes) override;
+    void waitForProgress() override;
+
+private:
+    struct Ring;
+    Ring& getRing(int from, int to) const;
+
+    void* mapped_ = nullptr;
+    size_t mappedBytes_ = 0;
+    size_t ringBytes_ = 0;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_DOMAIN_TRANSPORT_HPP
@@ -0,0 +1,228 @@
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace particulas {
+
+namespace {
+
+constexpr size_t WRITER_BATCH_SIZE = 512;                          // Mensajes que el escritor ordena de una vez
+constexpr auto WRITER_INTERVAL = std::chrono::milliseconds(5);
+constexpr int64_t SITE_WINDOW_NANOSECONDS = 1000000000;
+
+int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* levelPrefix(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace: return "Trace: ";
+    case LogLevel::Debug: return "Debug: ";
+    case LogLevel::Warning: return "Warning: ";
+    case LogLevel::Error: return "Error: ";
+    case LogLevel::Info: default: return "";
+    }
+}
+
+} // namespace
+
+// --- LogSite ---
+bool LogSite::admit() {
+    int64_t now = nowNanoseconds();
+    int64_t windowStart = windowStart_.load(std::memory_order_relaxed);
+    if (now - windowStart >= SITE_WINDOW_NANOSECONDS &&
+        windowStart_.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+        inWindow_.store(0, std::memory_order_relaxed);
+    }
+    if (inWindow_.fetch_add(1, std::memory_order_relaxed) < LOG_SITE_BURST) return true;
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// --- LogLine ---
+LogLine::LogLine(LogLevel level, LogSite& site) : level_(level), site_(site) {}
+
+LogLine::~LogLine() {
+    uint32_t suppressed = site_.takeSuppressed();
+    if (suppressed > 0) *this << " [" << suppressed << " similar messages suppressed]";
+    if (truncated_) std::memcpy(text_.data() + LOG_MESSAGE_SIZE - 3, "...", 3);
+    Logger::instance().push(level_, text_.data(), length_);
+}
+
+LogLine& LogLine::append(std::string_view text) {
+    size_t room = LOG_MESSAGE_SIZE - length_;
+    size_t count = std::min(text.size(), room);
+    std::memcpy(text_.data() + length_, text.data(), count);
+    length_ += count;
+    if (count < text.size()) truncated_ = true;
+    return *this;
+}
+
+LogLine& LogLine::appendSigned(long long value) {
+    char buffer[24];
+    int length = std::snprintf(buffer, sizeof(buffer), "%lld", value);
+    return append(std::string_view(buffer, static_cast<size_t>(length)));
+}
+
+LogLine& LogLine::appendUnsigned(unsigned long long value, int base) {
+    char buffer[24];
+    int length = std::snprintf(buffer, sizeof(buffer), base == 16 ? "%llx" : "%llu", value);
+    return append(std::string_view(buffer, static_cast<size_t>(length)));
+}
+
+LogLine& LogLine::operator<<(double value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", value); // Como un ostream sin manipuladores
+    return append(std::string_view(buffer, static_cast<size_t>(std::min<int>(length, sizeof(buffer) - 1))));
+}
+
+LogLine& LogLine::operator<<(Fixed fixed) {
+    char buffer[64];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.*f", fixed.precision, fixed.value);
+    return append(std::string_view(buffer, static_cast<size_t>(std::min<int>(length, sizeof(buffer) - 1))));
+}
+
+LogLine& LogLine::operator<<(const void* pointer) {
+    char buffer[24];
+    int length = std::snprintf(buffer, sizeof(buffer), "%p", pointer);
+    return append(std::string_view(buffer, static_cast<size_t>(length)));
+}
+
+// --- Logger ---
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : start_(std::chrono::steady_clock::now()) {
+    batch_.resize(WRITER_BATCH_SIZE);
+    order_.reserve(WRITER_BATCH_SIZE);
+    writer_ = std::thread([this]() { writerLoop(); });
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeCondition_.notify_one();
+    if (writer_.joinable()) writer_.join();
+}
+
+void Logger::flush() {
+    Logger& logger = instance();
+    std::unique_lock<std::mutex> lock(logger.mutex_);
+    if (logger.stop_) return;
+    uint64_t target = ++logger.flushRequested_;
+    logger.wakeCondition_.notify_one();
+    logger.flushedCondition_.wait(lock, [&logger, target]() { return logger.flushCompleted_ >= target || logger.stop_; });
+}
+
+Logger::ThreadQueue* Logger::getThreadQueue() {
+    // Al terminar el hilo la cola queda libre para otro (los mensajes pendientes se siguen escribiendo)
+    struct Holder {
+        ThreadQueue* queue = nullptr;
+        ~Holder() { if (queue != nullptr) queue->owned.store(false, std::memory_order_release); }
+    };
+    thread_local Holder holder;
+    if (holder.queue != nullptr) return holder.queue;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = queueCount_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        bool expected = false;
+        if (queues_[i]->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            holder.queue = queues_[i].get();
+            return holder.queue;
+        }
+    }
+    if (count == LOG_MAX_THREADS) return nullptr;
+    queues_[count] = std::make_unique<ThreadQueue>();
+    queues_[count]->owned.store(true, std::memory_order_relaxed);
+    queueCount_.store(count + 1, std::memory_order_release); // Publica la cola al escritor
+    holder.queue = queues_[count].get();
+    return holder.queue;
+}
+
+void Logger::push(LogLevel level, const char* text, size_t length) {
+    ThreadQueue* queue = getThreadQueue();
+    if (queue == nullptr) { dropped_.fetch_add(1, std::memory_order_relaxed); return; }
+    uint64_t head = queue->head.load(std::memory_order_relaxed);
+    if (head - queue->tail.load(std::memory_order_acquire) == LOG_QUEUE_CAPACITY) {
+        dropped_.fetch_add(1, std::memory_order_relaxed); // Nunca se espera al escritor
+        return;
+    }
+    Record& record = queue->records[head % LOG_QUEUE_CAPACITY];
+    record.timestampNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+    record.level = level;
+    record.length = static_cast<uint32_t>(length);
+    std::memcpy(record.text.data(), text, length);
+    queue->head.store(head + 1, std::memory_order_release);
+    if (level == LogLevel::Error) wakeCondition_.notify_one(); // Que un error llegue a la consola aunque el proceso caiga
+}
+
+void Logger::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wakeCondition_.wait_for(lock, WRITER_INTERVAL);
+        bool stopping = stop_;
+        uint64_t flushTarget = flushRequested_;
+        lock.unlock();
+        drain();
+        lock.lock();
+        flushCompleted_ = flushTarget;
+        flushedCondition_.notify_all();
+        if (stopping) return;
+    }
+}
+
+// Copia lo pendiente de todas las colas en lotes de WRITER_BATCH_SIZE, ordena cada lote por tiempo
+// y lo escribe. Solo se llama desde el hilo escritor.
+void Logger::drain() {
+    bool wrote = false;
+    for (;;) {
+        size_t batchCount = 0;
+        size_t queueCount = queueCount_.load(std::memory_order_acquire);
+        for (size_t q = 0; q < queueCount && batchCount < WRITER_BATCH_SIZE; ++q) {
+            ThreadQueue& queue = *queues_[q];
+            uint64_t tail = queue.tail.load(std::memory_order_relaxed);
+            uint64_t head = queue.head.load(std::memory_order_acquire);
+            for (; tail != head && batchCount < WRITER_BATCH_SIZE; ++tail) {
+                const Record& record = queue.records[tail % LOG_QUEUE_CAPACITY];
+                Record& copy = batch_[batchCount++];
+                copy.timestampNanoseconds = record.timestampNanoseconds;
+                copy.level = record.level;
+                copy.length = record.length;
+                std::memcpy(copy.text.data(), record.text.data(), record.length);
+            }
+            queue.tail.store(tail, std::memory_order_release); // El hilo ya puede reutilizar esas posiciones
+        }
+        if (batchCount == 0) break;
+
+        order_.clear();
+        for (uint32_t i = 0; i < batchCount; ++i) order_.push_back(i);
+        std::stable_sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b) {
+            return batch_[a].timestampNanoseconds < batch_[b].timestampNanoseconds;
+        });
+        for (uint32_t index : order_) {
+            const Record& record = batch_[index];
+            FILE* stream = record.level >= LogLevel::Warning ? stderr : stdout;
+            std::fprintf(stream, "[%9.3f] %s%.*s\n", static_cast<double>(record.timestampNanoseconds) * 1e-9,
+                         levelPrefix(record.level), static_cast<int>(record.length), record.text.data());
+        }
+        wrote = true;
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reportedDropped_) {
+        std::fprintf(stderr, "[logger] %" PRIu64 " messages dropped (queue full)\n", dropped - reportedDropped_);
+        reportedDropped_ = dropped;
+        wrote = true;
+    }
+    if (wrote) { std::fflush(stdout); std::fflush(stderr); }
+}
+
+} // namespace particulas
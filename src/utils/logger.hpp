@@ -0,0 +1,169 @@
+#ifndef PARTICULAS_UTILS_LOGGER_HPP
+#define PARTICULAS_UTILS_LOGGER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace particulas {
+
+enum class LogLevel { Trace = 0, Debug, Info, Warning, Error, Off };
+
+// Nivel mínimo compilado: lo que está por debajo desaparece del binario (ni se formatea ni se
+// evalúan sus argumentos). Se fija con la variable de CMake PARTICULAS_LOG_MIN_LEVEL (0 = Trace ..
+// 5 = Off); por defecto Debug en builds de depuración e Info en release.
+#ifndef PARTICULAS_LOG_MIN_LEVEL
+    #ifdef NDEBUG
+        #define PARTICULAS_LOG_MIN_LEVEL 2
+    #else
+        #define PARTICULAS_LOG_MIN_LEVEL 1
+    #endif
+#endif
+
+constexpr size_t LOG_MESSAGE_SIZE = 1000;   // Texto de un mensaje; lo que no cabe se trunca con "..."
+constexpr size_t LOG_QUEUE_CAPACITY = 128;  // Mensajes pendientes por hilo; si se llena se descartan
+constexpr uint32_t LOG_SITE_BURST = 32;     // Mensajes por segundo de un mismo punto del código
+constexpr size_t LOG_MAX_THREADS = 64;      // Hilos con cola propia a la vez; los demás no registran
+
+// Límite de frecuencia de un punto del código (una instancia estática por cada PARTICULAS_LOG):
+// hasta LOG_SITE_BURST mensajes por ventana de un segundo; el resto se cuenta y el siguiente
+// mensaje admitido indica cuántos se omitieron.
+class LogSite {
+public:
+    bool admit();
+    uint32_t takeSuppressed() { return suppressed_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> windowStart_{INT64_MIN};
+    std::atomic<uint32_t> inWindow_{0};
+    std::atomic<uint32_t> suppressed_{0};
+};
+
+// Un mensaje: se formatea en un buffer de la pila (sin reservar memoria) y el destructor lo copia
+// a la cola del hilo. Admite texto, enteros, enums, bool y coma flotante (como %g);
+// logFixed y logHex cubren los casos de std::fixed/std::setprecision y std::hex.
+class LogLine {
+public:
+    LogLine(LogLevel level, LogSite& site);
+    ~LogLine();
+
+    LogLine& operator<<(const char* text) { return append(text != nullptr ? std::string_view(text) : std::string_view("(null)")); }
+    LogLine& operator<<(const std::string& text) { return append(text); }
+    LogLine& operator<<(std::string_view text) { return append(text); }
+    LogLine& operator<<(char c) { return append(std::string_view(&c, 1)); }
+    LogLine& operator<<(bool value) { return append(value ? "true" : "false"); }
+    LogLine& operator<<(double value);
+    LogLine& operator<<(float value) { return *this << static_cast<double>(value); }
+    LogLine& operator<<(const void* pointer);
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    LogLine& operator<<(T value) {
+        if (std::is_signed<T>::value) return appendSigned(static_cast<long long>(value));
+        return appendUnsigned(static_cast<unsigned long long>(value), 10);
+    }
+    template <typename T, typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+    LogLine& operator<<(T value) { return *this << static_cast<typename std::underlying_type<T>::type>(value); }
+
+    struct Fixed { double value; int precision; };
+    struct Hex { unsigned long long value; };
+    LogLine& operator<<(Fixed fixed);
+    LogLine& operator<<(Hex hex) { return appendUnsigned(hex.value, 16); }
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+private:
+    LogLine& append(std::string_view text);
+    LogLine& appendSigned(long long value);
+    LogLine& appendUnsigned(unsigned long long value, int base);
+
+    LogLevel level_;
+    LogSite& site_;
+    size_t length_ = 0;
+    bool truncated_ = false;
+    std::array<char, LOG_MESSAGE_SIZE> text_;
+};
+
+inline LogLine::Fixed logFixed(double value, int precision) { return {value, precision}; }
+inline LogLine::Hex logHex(unsigned long long value) { return {value}; }
+
+// Registro asíncrono. Cada hilo escribe en su propia cola SPSC (sin locks: solo dos índices
+// atómicos) y un hilo de fondo las vacía cada pocos milisegundos, ordena el lote por tiempo y lo
+// escribe de una vez (Info y Debug a stdout, Warning y Error a stderr). Registrar un mensaje
+// cuesta formatearlo y copiarlo; nunca bloquea ni hace llamadas al sistema salvo en Error, que
+// despierta al escritor. Si una cola se llena los mensajes se descartan y se cuentan.
+// La cola de un hilo se crea la primera vez que registra algo y se reutiliza cuando el hilo termina.
+class Logger {
+public:
+    static Logger& instance();
+
+    // Bloquea hasta que todo lo registrado antes de la llamada está escrito. Antes de imprimir
+    // directamente en la consola (tablas, informes) para no desordenar la salida.
+    static void flush();
+
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+private:
+    friend class LogLine;
+
+    struct Record {
+        int64_t timestampNanoseconds;
+        LogLevel level;
+        uint32_t length;
+        std::array<char, LOG_MESSAGE_SIZE> text;
+    };
+
+    struct ThreadQueue {
+        std::array<Record, LOG_QUEUE_CAPACITY> records;
+        std::atomic<uint64_t> head{0}; // Siguiente posición que escribe su hilo
+        std::atomic<uint64_t> tail{0}; // Siguiente posición que lee el escritor
+        std::atomic<bool> owned{false};
+    };
+
+    Logger();
+    ThreadQueue* getThreadQueue(); // nullptr si ya hay LOG_MAX_THREADS colas ocupadas
+    void push(LogLevel level, const char* text, size_t length);
+    void writerLoop();
+    void drain();
+
+    std::chrono::steady_clock::time_point start_;
+    std::mutex mutex_;                       // Registro de colas y señales al escritor
+    std::condition_variable wakeCondition_;
+    std::condition_variable flushedCondition_;
+    // Tamaño fijo: el escritor recorre las colas publicadas (queueCount_) sin tomar el lock
+    std::array<std::unique_ptr<ThreadQueue>, LOG_MAX_THREADS> queues_;
+    std::atomic<size_t> queueCount_{0};
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t reportedDropped_ = 0;
+    uint64_t flushRequested_ = 0, flushCompleted_ = 0;
+    bool stop_ = false;
+    std::vector<Record> batch_;              // Solo el escritor: lote copiado de las colas
+    std::vector<uint32_t> order_;            // Índices del lote ordenados por tiempo
+    std::thread writer_;
+};
+
+} // namespace particulas
+
+// Uso: PARTICULAS_LOG(Info) << "Swapchain created: " << width << "x" << height;
+// Por debajo de PARTICULAS_LOG_MIN_LEVEL la línea entera se descarta al compilar.
+#define PARTICULAS_LOG(level)                                                                                   \
+    if constexpr (static_cast<int>(::particulas::LogLevel::level) < PARTICULAS_LOG_MIN_LEVEL) {                \
+    } else if (static ::particulas::LogSite particulasLogSite; !particulasLogSite.admit()) {                    \
+    } else                                                                                                      \
+        ::particulas::LogLine(::particulas::LogLevel::level, particulasLogSite)
+
+#endif // PARTICULAS_UTILS_LOGGER_HPP
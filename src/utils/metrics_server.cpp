@@ -0,0 +1,226 @@
+#include "metrics_server.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: sin SIGPIPE por envío
+#endif
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace particulas {
+
+namespace {
+
+void appendNumber(std::string& out, double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    out += buffer;
+}
+
+void appendMetric(std::string& out, const char* name, const char* type, const char* help, double value) {
+    out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+    out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+    out += name; out += ' ';
+    appendNumber(out, value);
+    out += '\n';
+}
+
+} // namespace
+
+LiveHistogram::LiveHistogram(std::initializer_list<double> upperBounds) {
+    if (upperBounds.size() > MAX_BUCKETS) throw std::invalid_argument("LiveHistogram: too many buckets");
+    for (double bound : upperBounds) bounds_[boundCount_++] = bound;
+}
+
+void LiveHistogram::observe(double value) {
+    size_t bucket = 0;
+    while (bucket < boundCount_ && value > bounds_[bucket]) ++bucket;
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed); // Un solo escritor
+}
+
+void LiveHistogram::writePrometheus(std::string& out, const char* name, const char* help) const {
+    out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+    out += "# TYPE "; out += name; out += " histogram\n";
+    // Las cubetas se leen una a una: el total se calcula de lo leído para que _count coincida con +Inf
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= boundCount_; ++i) {
+        cumulative += buckets_[i].load(std::memory_order_relaxed);
+        out += name; out += "_bucket{le=\"";
+        if (i < boundCount_) appendNumber(out, bounds_[i]);
+        else out += "+Inf";
+        out += "\"} ";
+        out += std::to_string(cumulative);
+        out += '\n';
+    }
+    out += name; out += "_sum ";
+    appendNumber(out, sum_.load(std::memory_order_relaxed));
+    out += '\n';
+    out += name; out += "_count ";
+    out += std::to_string(cumulative);
+    out += '\n';
+}
+
+void LiveMetrics::writePrometheus(std::string& out) const {
+    frameTimeSeconds.writePrometheus(out, "particulas_frame_time_seconds", "Interval between frame starts.");
+    submitLatencySeconds.writePrometheus(out, "particulas_queue_submit_seconds", "CPU time spent in the frame's queue submit.");
+    appendMetric(out, "particulas_frames_total", "counter", "Frames rendered.",
+                 static_cast<double>(frames.load(std::memory_order_relaxed)));
+    appendMetric(out, "particulas_simulation_steps_total", "counter", "Simulation steps advanced.",
+                 static_cast<double>(simulationSteps.load(std::memory_order_relaxed)));
+    appendMetric(out, "particulas_simulation_steps_per_second", "gauge", "Simulation steps over the last second.",
+                 simulationStepsPerSecond.load(std::memory_order_relaxed));
+    appendMetric(out, "particulas_particles_live", "gauge", "Live particles (CPU simulation).",
+                 static_cast<double>(liveParticles.load(std::memory_order_relaxed)));
+    appendMetric(out, "particulas_particles_drawn", "gauge", "Particles uploaded and drawn last frame.",
+                 static_cast<double>(drawnParticles.load(std::memory_order_relaxed)));
+    appendMetric(out, "particulas_particles_capacity", "gauge", "Particle pool capacity.",
+                 static_cast<double>(particleCapacity.load(std::memory_order_relaxed)));
+    appendMetric(out, "particulas_quality_decisions_total", "counter", "Quality controller level changes.",
+                 static_cast<double>(qualityDecisions.load(std::memory_order_relaxed)));
+    appendMetric(out, "particulas_quality_substeps", "gauge", "Simulation substeps per step set by the quality controller.",
+                 static_cast<double>(qualitySubsteps.load(std::memory_order_relaxed)));
+    appendMetric(out, "particulas_quality_render_scale", "gauge", "Splat accumulation resolution relative to the window.",
+                 qualityRenderScale.load(std::memory_order_relaxed));
+    appendMetric(out, "particulas_quality_draw_fraction", "gauge", "Fraction of visible particles uploaded and drawn.",
+                 qualityDrawFraction.load(std::memory_order_relaxed));
+    out += "# HELP particulas_gpu_memory_bytes Device memory held by the application, by use.\n"
+           "# TYPE particulas_gpu_memory_bytes gauge\n"
+           "particulas_gpu_memory_bytes{use=\"particles\"} ";
+    out += std::to_string(gpuParticleBytes.load(std::memory_order_relaxed));
+    out += "\nparticulas_gpu_memory_bytes{use=\"transient\"} ";
+    out += std::to_string(gpuTransientBytes.load(std::memory_order_relaxed));
+    out += '\n';
+
+    uint32_t heapCount = std::min<uint32_t>(gpuHeapCount.load(std::memory_order_relaxed), MAX_GPU_HEAPS);
+    appendMetric(out, "particulas_gpu_budget_reported", "gauge", "1 if heap usage comes from VK_EXT_memory_budget, 0 if estimated.",
+                 gpuBudgetReported.load(std::memory_order_relaxed) ? 1.0 : 0.0);
+    const char* heapMetrics[2][2] = {{"particulas_gpu_heap_budget_bytes", "Memory the process can use in each device heap."},
+                                     {"particulas_gpu_heap_usage_bytes", "Memory the process uses in each device heap."}};
+    for (size_t metric = 0; metric < 2; ++metric) {
+        const auto& values = metric == 0 ? gpuHeapBudgetBytes : gpuHeapUsageBytes;
+        out += "# HELP "; out += heapMetrics[metric][0]; out += ' '; out += heapMetrics[metric][1]; out += '\n';
+        out += "# TYPE "; out += heapMetrics[metric][0]; out += " gauge\n";
+        for (uint32_t heap = 0; heap < heapCount; ++heap) {
+            out += heapMetrics[metric][0]; out += "{heap=\""; out += std::to_string(heap); out += "\"} ";
+            out += std::to_string(values[heap].load(std::memory_order_relaxed));
+            out += '\n';
+        }
+    }
+}
+
+#ifndef _WIN32
+
+MetricsServer::MetricsServer(const LiveMetrics& metrics, uint16_t port)
+    : metrics_(metrics), port_(port) {
+    listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ == -1) throw std::runtime_error(std::string("Metrics endpoint: socket: ") + std::strerror(errno));
+
+    int reuse = 1;
+    setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Solo local
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 || listen(listenFd_, 4) == -1) {
+        std::string error = std::strerror(errno);
+        close(listenFd_);
+        throw std::runtime_error("Metrics endpoint: cannot listen on 127.0.0.1:" + std::to_string(port) + ": " + error);
+    }
+    socklen_t addressLength = sizeof(address);
+    if (getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &addressLength) == 0) port_ = ntohs(address.sin_port); // Puerto 0: el que asignó el sistema
+
+    thread_ = std::thread([this]() { serveLoop(); });
+}
+
+MetricsServer::~MetricsServer() {
+    stopping_.store(true);
+    if (thread_.joinable()) thread_.join();
+    if (listenFd_ != -1) close(listenFd_);
+}
+
+void MetricsServer::serveLoop() {
+#ifdef __linux__
+    // En Linux el valor nice es por hilo: solo este hilo cede la CPU al bucle de frame
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+    std::string response;
+    response.reserve(8192); // Se reutiliza entre scrapes
+    pollfd listenPoll{listenFd_, POLLIN, 0};
+    while (!stopping_.load()) {
+        // Despierta cada 200 ms para ver si hay que parar
+        if (poll(&listenPoll, 1, 200) <= 0 || !(listenPoll.revents & POLLIN)) continue;
+        int clientFd = accept(listenFd_, nullptr, nullptr);
+        if (clientFd == -1) continue;
+        timeval timeout{1, 0}; // Un cliente lento no retiene el hilo
+        setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        handleConnection(clientFd, response);
+        close(clientFd);
+    }
+}
+
+void MetricsServer::handleConnection(int clientFd, std::string& response) {
+    // Basta con la línea de petición; el resto de cabeceras se ignora
+    char request[1024];
+    ssize_t received = recv(clientFd, request, sizeof(request) - 1, 0);
+    if (received <= 0) return;
+    request[received] = '\0';
+
+    std::string body;
+    const char* status = "200 OK";
+    if (std::strncmp(request, "GET /metrics ", 13) == 0 || std::strncmp(request, "GET / ", 6) == 0) {
+        body.reserve(8192);
+        metrics_.writePrometheus(body);
+    } else {
+        status = "404 Not Found";
+        body = "Only GET /metrics is served.\n";
+    }
+
+    response.clear();
+    response += "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: ";
+    response += std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    response += body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = send(clientFd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) return;
+        sent += static_cast<size_t>(written);
+    }
+}
+
+#else
+
+MetricsServer::MetricsServer(const LiveMetrics& metrics, uint16_t port)
+    : metrics_(metrics), port_(port) {
+    throw std::runtime_error("Metrics endpoint: only available on POSIX systems");
+}
+
+MetricsServer::~MetricsServer() = default;
+
+void MetricsServer::serveLoop() {}
+
+void MetricsServer::handleConnection(int, std::string&) {}
+
+#endif
+
+} // namespace particulas
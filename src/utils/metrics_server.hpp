@@ -0,0 +1,89 @@
+#ifndef PARTICULAS_UTILS_METRICS_SERVER_HPP
+#define PARTICULAS_UTILS_METRICS_SERVER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <thread>
+
+namespace particulas {
+
+// Histograma acumulativo al estilo de Prometheus con límites fijos (segundos).
+// Un único escritor (el bucle de frame) y lectores concurrentes: cubetas atómicas relajadas, sin locks.
+class LiveHistogram {
+public:
+    static constexpr size_t MAX_BUCKETS = 16;
+
+    LiveHistogram(std::initializer_list<double> upperBounds);
+
+    void observe(double value);
+    // Formato de texto de Prometheus: _bucket{le=...}, _sum y _count
+    void writePrometheus(std::string& out, const char* name, const char* help) const;
+
+private:
+    std::array<double, MAX_BUCKETS> bounds_{};
+    size_t boundCount_ = 0;
+    std::array<std::atomic<uint64_t>, MAX_BUCKETS + 1> buckets_{}; // La última es +Inf
+    std::atomic<double> sum_{0.0};                                  // Solo la escribe el escritor
+};
+
+// Contadores del proceso en vivo. El bucle de frame escribe con stores relajados (coste de unas
+// pocas instrucciones) y el servidor los lee cuando alguien hace scrape: nunca se bloquean entre sí.
+struct LiveMetrics {
+    LiveHistogram frameTimeSeconds{0.002, 0.004, 0.008, 0.0125, 0.0167, 0.025, 0.0333, 0.05, 0.1, 0.25};
+    LiveHistogram submitLatencySeconds{25e-6, 50e-6, 100e-6, 250e-6, 500e-6, 1e-3, 2.5e-3, 5e-3, 10e-3};
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> simulationSteps{0};
+    std::atomic<double> simulationStepsPerSecond{0.0};
+    std::atomic<uint64_t> liveParticles{0};
+    std::atomic<uint64_t> drawnParticles{0};
+    std::atomic<uint64_t> particleCapacity{0};
+    std::atomic<uint64_t> gpuParticleBytes{0};   // Buffers de partículas en el dispositivo
+    std::atomic<uint64_t> gpuTransientBytes{0};  // Temporales del grafo de frame
+    // Controlador de calidad: decisiones tomadas y niveles vigentes (1 = calidad completa)
+    std::atomic<uint64_t> qualityDecisions{0};
+    std::atomic<uint32_t> qualitySubsteps{1};
+    std::atomic<double> qualityRenderScale{1.0};
+    std::atomic<double> qualityDrawFraction{1.0};
+    // Heaps de memoria del dispositivo: presupuesto y uso (uso exacto solo con VK_EXT_memory_budget)
+    static constexpr size_t MAX_GPU_HEAPS = 16;
+    std::atomic<uint32_t> gpuHeapCount{0};
+    std::atomic<bool> gpuBudgetReported{false};
+    std::array<std::atomic<uint64_t>, MAX_GPU_HEAPS> gpuHeapBudgetBytes{};
+    std::array<std::atomic<uint64_t>, MAX_GPU_HEAPS> gpuHeapUsageBytes{};
+
+    void writePrometheus(std::string& out) const;
+};
+
+// Endpoint HTTP mínimo en 127.0.0.1:port que sirve GET /metrics en formato de texto de Prometheus
+// (curl http://127.0.0.1:<port>/metrics). Atiende en su propio hilo, con prioridad baja, una
+// conexión cada vez; solo lee LiveMetrics, así que un scrape no toca el bucle de frame.
+// Con port 0 el sistema elige un puerto libre (getPort lo devuelve). Lanza std::runtime_error si
+// no puede escuchar en el puerto (o fuera de POSIX).
+class MetricsServer {
+public:
+    MetricsServer(const LiveMetrics& metrics, uint16_t port);
+    ~MetricsServer();
+
+    uint16_t getPort() const { return port_; }
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+private:
+    void serveLoop();
+    void handleConnection(int clientFd, std::string& response);
+
+    const LiveMetrics& metrics_;
+    uint16_t port_;
+    int listenFd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_METRICS_SERVER_HPP
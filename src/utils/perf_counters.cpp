@@ -0,0 +1,184 @@
+#include "perf_counters.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace particulas {
+
+const char* perfCounterName(PerfCounter counter) {
+    switch (counter) {
+        case PerfCounter::Cycles: return "Cycles";
+        case PerfCounter::Instructions: return "Instructions";
+        case PerfCounter::CacheMisses: return "CacheMisses";
+        case PerfCounter::BranchMisses: return "BranchMisses";
+    }
+    return "Unknown";
+}
+
+double PerfSample::getIpc() const {
+    uint64_t cycles = get(PerfCounter::Cycles);
+    return cycles > 0 ? static_cast<double>(get(PerfCounter::Instructions)) / static_cast<double>(cycles) : 0.0;
+}
+
+PerfSample& PerfSample::operator+=(const PerfSample& other) {
+    for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i) values[i] += other.values[i];
+    return *this;
+}
+
+#ifdef __linux__
+
+namespace {
+
+constexpr std::array<uint64_t, PERF_COUNTER_COUNT> HARDWARE_EVENTS = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int openEvent(uint64_t config, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = groupFd == -1 ? 1 : 0; // Se arranca el grupo entero desde el líder
+    attr.exclude_kernel = 1;               // Solo espacio de usuario: basta con perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    // pid 0, cpu -1: el hilo que llama, en cualquier CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters(ThreadPool& threadPool, size_t phaseCount)
+    : threads_(threadPool.getConcurrency()), phaseCount_(phaseCount) {
+    for (auto& thread : threads_) {
+        thread.fds.fill(-1);
+        thread.totals.resize(phaseCount_);
+    }
+
+    // Los contadores con pid 0 miden al hilo que los abre: cada hilo abre los suyos
+    threadPool.runOnEachThread([this](size_t threadIndex) {
+        openCurrentThread(threads_[threadIndex]);
+    });
+
+    counterMask_ = (1u << PERF_COUNTER_COUNT) - 1;
+    for (const auto& thread : threads_) {
+        if (thread.opened == 0) {
+            status_ = "perf_event_open: " + thread.error;
+            counterMask_ = 0;
+            return;
+        }
+        counterMask_ &= thread.mask;
+    }
+
+    available_ = true;
+    status_ = "Contadores hardware activos en " + std::to_string(threads_.size()) + " hilos:";
+    for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        if (hasCounter(static_cast<PerfCounter>(i))) {
+            status_ += " ";
+            status_ += perfCounterName(static_cast<PerfCounter>(i));
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (auto& thread : threads_) {
+        for (int fd : thread.fds) {
+            if (fd != -1) close(fd);
+        }
+    }
+}
+
+void PerfCounters::openCurrentThread(ThreadCounters& thread) {
+    for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        int groupFd = thread.opened == 0 ? -1 : thread.fds[0];
+        int fd = openEvent(HARDWARE_EVENTS[i], groupFd);
+        if (fd == -1) {
+            // Sin líder no hay grupo; un miembro que falle (p.ej. sin fallos de caché en la PMU) se omite
+            if (thread.opened == 0 && thread.error.empty()) {
+                int error = errno;
+                thread.error = std::strerror(error);
+                if (error == EACCES || error == EPERM) {
+                    thread.error += " (revisa /proc/sys/kernel/perf_event_paranoid o CAP_PERFMON)";
+                } else if (error == ENOENT || error == EOPNOTSUPP) {
+                    thread.error += " (sin PMU accesible, ¿máquina virtual?)";
+                }
+            }
+            continue;
+        }
+        thread.fds[thread.opened] = fd;
+        thread.order[thread.opened] = i;
+        thread.mask |= 1u << i;
+        ++thread.opened;
+    }
+
+    if (thread.opened == 0) return;
+    ioctl(thread.fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(thread.fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+bool PerfCounters::readThread(const ThreadCounters& thread, PerfSample& sample) const {
+    // PERF_FORMAT_GROUP: { nr, values[nr] } en el orden en que se abrieron
+    std::array<uint64_t, PERF_COUNTER_COUNT + 1> buffer{};
+    ssize_t expected = static_cast<ssize_t>((thread.opened + 1) * sizeof(uint64_t));
+    if (read(thread.fds[0], buffer.data(), sizeof(buffer)) != expected) return false;
+    for (size_t i = 0; i < thread.opened && i < buffer[0]; ++i) {
+        sample.values[thread.order[i]] = buffer[i + 1];
+    }
+    return true;
+}
+
+void PerfCounters::beginPhase() {
+    if (!available_) return;
+    for (auto& thread : threads_) {
+        readThread(thread, thread.phaseStart);
+    }
+}
+
+PerfSample PerfCounters::endPhase(size_t phase) {
+    PerfSample frameTotal;
+    if (!available_ || phase >= phaseCount_) return frameTotal;
+
+    for (auto& thread : threads_) {
+        PerfSample now;
+        if (!readThread(thread, now)) continue;
+        PerfSample delta;
+        for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i) {
+            delta.values[i] = now.values[i] - thread.phaseStart.values[i];
+        }
+        thread.totals[phase] += delta;
+        frameTotal += delta;
+    }
+    return frameTotal;
+}
+
+#else
+
+PerfCounters::PerfCounters(ThreadPool& threadPool, size_t phaseCount)
+    : phaseCount_(phaseCount), status_("Contadores hardware solo disponibles en Linux (perf_event_open)") {
+    (void)threadPool;
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::openCurrentThread(ThreadCounters&) {}
+
+bool PerfCounters::readThread(const ThreadCounters&, PerfSample&) const { return false; }
+
+void PerfCounters::beginPhase() {}
+
+PerfSample PerfCounters::endPhase(size_t) { return PerfSample{}; }
+
+#endif
+
+} // namespace particulas
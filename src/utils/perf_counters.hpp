@@ -0,0 +1,82 @@
+#ifndef PARTICULAS_UTILS_PERF_COUNTERS_HPP
+#define PARTICULAS_UTILS_PERF_COUNTERS_HPP
+
+#include "utils/thread_pool.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace particulas {
+
+enum class PerfCounter { Cycles = 0, Instructions, CacheMisses, BranchMisses };
+constexpr size_t PERF_COUNTER_COUNT = 4;
+
+const char* perfCounterName(PerfCounter counter);
+
+// Valores de los contadores de un intervalo (0 en los que no se pudieron abrir)
+struct PerfSample {
+    std::array<uint64_t, PERF_COUNTER_COUNT> values{};
+
+    uint64_t get(PerfCounter counter) const { return values[static_cast<size_t>(counter)]; }
+    double getIpc() const;
+    PerfSample& operator+=(const PerfSample& other);
+};
+
+// Contadores hardware (ciclos, instrucciones, fallos de caché y de predicción de saltos) de cada
+// hilo del ThreadPool con perf_event_open, solo en espacio de usuario. Las fases se miden con
+// beginPhase/endPhase desde el hilo principal: se lee el grupo de cada hilo al principio y al
+// final y la diferencia se acumula por hilo y por fase. Cada lectura es una llamada al sistema
+// por hilo, así que medir cuesta unos microsegundos por fase.
+// Si el kernel no lo permite (perf_event_paranoid, contenedores, VMs sin PMU) o fuera de Linux,
+// isAvailable() es false, getStatus() explica por qué y el resto de llamadas no hace nada.
+class PerfCounters {
+public:
+    // Abre los contadores en cada hilo del pool (runOnEachThread). phaseCount: fases distintas.
+    PerfCounters(ThreadPool& threadPool, size_t phaseCount);
+    ~PerfCounters();
+
+    bool isAvailable() const { return available_; }
+    const std::string& getStatus() const { return status_; }
+    // Contador abierto en todos los hilos medidos
+    bool hasCounter(PerfCounter counter) const { return (counterMask_ >> static_cast<size_t>(counter)) & 1u; }
+
+    // Las fases no se anidan: beginPhase toma la instantánea y endPhase devuelve la suma de todos
+    // los hilos desde entonces.
+    void beginPhase();
+    PerfSample endPhase(size_t phase);
+
+    size_t getThreadCount() const { return threads_.size(); }
+    size_t getPhaseCount() const { return phaseCount_; }
+    // Total acumulado de un hilo en una fase desde la construcción
+    const PerfSample& getThreadTotal(size_t threadIndex, size_t phase) const { return threads_.at(threadIndex).totals.at(phase); }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+private:
+    struct ThreadCounters {
+        std::array<int, PERF_COUNTER_COUNT> fds;        // fds[0] es el líder del grupo
+        std::array<size_t, PERF_COUNTER_COUNT> order{}; // Contador de cada posición de la lectura de grupo
+        size_t opened = 0;
+        uint32_t mask = 0;
+        std::string error;                              // Motivo si no se pudo abrir el líder
+        PerfSample phaseStart;
+        std::vector<PerfSample> totals;                 // Por fase
+    };
+
+    void openCurrentThread(ThreadCounters& thread);
+    bool readThread(const ThreadCounters& thread, PerfSample& sample) const;
+
+    std::vector<ThreadCounters> threads_;
+    size_t phaseCount_;
+    bool available_ = false;
+    uint32_t counterMask_ = 0;
+    std::string status_;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_PERF_COUNTERS_HPP
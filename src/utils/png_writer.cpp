@@ -0,0 +1,202 @@
+#include "png_writer.hpp"
+
+#include <array>
+#include <cstdio>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+
+const std::array<uint32_t, 256>& getCrcTable() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> result{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            result[n] = c;
+        }
+        return result;
+    }();
+    return table;
+}
+
+uint32_t crc32(const uint8_t* data, size_t bytes) {
+    const std::array<uint32_t, 256>& table = getCrcTable();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < bytes; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Deflate escribe los bits empezando por el menos significativo; los códigos Huffman, por el más
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void put(uint32_t value, int length) {
+        bits_ |= value << count_;
+        count_ += length;
+        while (count_ >= 8) { out_.push_back(static_cast<uint8_t>(bits_)); bits_ >>= 8; count_ -= 8; }
+    }
+    void putCode(uint32_t code, int length) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i) reversed |= ((code >> i) & 1u) << (length - 1 - i);
+        put(reversed, length);
+    }
+    void flush() {
+        if (count_ > 0) out_.push_back(static_cast<uint8_t>(bits_));
+        bits_ = 0;
+        count_ = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint32_t bits_ = 0;
+    int count_ = 0;
+};
+
+// Tabla de longitudes de deflate (símbolos 257..285)
+constexpr std::array<uint16_t, 29> LENGTH_BASE = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<uint8_t, 29> LENGTH_EXTRA = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint32_t MAX_MATCH = 258;
+
+// Bloque deflate con los códigos Huffman fijos
+class FixedDeflate {
+public:
+    explicit FixedDeflate(std::vector<uint8_t>& out) : bits_(out) {
+        bits_.put(1, 1); // Último bloque
+        bits_.put(1, 2); // Huffman fijo
+    }
+
+    void add(uint8_t value) {
+        adlerA_ += value;
+        adlerB_ += adlerA_;
+        if (++adlerPending_ == 5552) reduceAdler(); // Máximo sin desbordar antes del módulo
+        if (haveLast_ && value == last_) {
+            if (++run_ == MAX_MATCH) flushRun();
+            return;
+        }
+        flushRun();
+        putLiteral(value);
+        last_ = value;
+        haveLast_ = true;
+    }
+
+    // Cierra el bloque; devuelve el Adler-32 de los datos sin comprimir
+    uint32_t finish() {
+        flushRun();
+        bits_.putCode(0, 7); // Fin de bloque (256)
+        bits_.flush();
+        reduceAdler();
+        return (adlerB_ << 16) | adlerA_;
+    }
+
+private:
+    void putLiteral(uint8_t value) {
+        if (value < 144) bits_.putCode(0x30u + value, 8);
+        else bits_.putCode(0x190u + (value - 144u), 9);
+    }
+
+    // Repetición del último byte: coincidencia a distancia 1 si compensa, si no literales
+    void flushRun() {
+        if (run_ >= 3) {
+            size_t index = LENGTH_BASE.size() - 1;
+            while (LENGTH_BASE[index] > run_) --index;
+            uint32_t symbol = 257 + static_cast<uint32_t>(index);
+            if (symbol < 280) bits_.putCode(symbol - 256, 7);
+            else bits_.putCode(0xC0u + (symbol - 280), 8);
+            if (LENGTH_EXTRA[index] > 0) bits_.put(run_ - LENGTH_BASE[index], LENGTH_EXTRA[index]);
+            bits_.putCode(0, 5); // Distancia 1
+        } else {
+            for (uint32_t i = 0; i < run_; ++i) putLiteral(last_);
+        }
+        run_ = 0;
+    }
+
+    void reduceAdler() {
+        adlerA_ %= 65521;
+        adlerB_ %= 65521;
+        adlerPending_ = 0;
+    }
+
+    BitWriter bits_;
+    uint8_t last_ = 0;
+    bool haveLast_ = false;
+    uint32_t run_ = 0;
+    uint32_t adlerA_ = 1, adlerB_ = 0, adlerPending_ = 0;
+};
+
+void appendChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, uint32_t bytes) {
+    appendBigEndian(out, bytes);
+    size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + bytes);
+    appendBigEndian(out, crc32(out.data() + typeStart, out.size() - typeStart));
+}
+
+} // namespace
+
+size_t getMaxPngBytes(uint32_t width, uint32_t height, uint32_t channels) {
+    size_t rawBytes = static_cast<size_t>(height) * (1 + static_cast<size_t>(width) * channels);
+    return rawBytes + rawBytes / 8 + 256; // Literales de 9 bits en el peor caso + cabeceras
+}
+
+void encodePng(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels, std::vector<uint8_t>& out) {
+    if ((channels != 3 && channels != 4) || width == 0 || height == 0) {
+        throw std::invalid_argument("PNG encoder: expected a non-empty RGB or RGBA image.");
+    }
+    out.clear();
+    static const uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.insert(out.end(), signature, signature + sizeof(signature));
+
+    // Ancho, alto, 8 bits por canal, RGBA (6) o RGB (2), deflate, filtros estándar, sin entrelazado
+    const uint8_t header[13] = {static_cast<uint8_t>(width >> 24), static_cast<uint8_t>(width >> 16),
+                                static_cast<uint8_t>(width >> 8), static_cast<uint8_t>(width),
+                                static_cast<uint8_t>(height >> 24), static_cast<uint8_t>(height >> 16),
+                                static_cast<uint8_t>(height >> 8), static_cast<uint8_t>(height),
+                                8, static_cast<uint8_t>(channels == 4 ? 6 : 2), 0, 0, 0};
+    appendChunk(out, "IHDR", header, sizeof(header));
+
+    // IDAT escrito en su sitio: longitud provisional, datos y luego la longitud real y el CRC
+    size_t lengthOffset = out.size();
+    appendBigEndian(out, 0);
+    size_t typeOffset = out.size();
+    out.insert(out.end(), {'I', 'D', 'A', 'T', 0x78, 0x01}); // Cabecera zlib (deflate, ventana de 32 KiB)
+    const size_t stride = static_cast<size_t>(width) * channels;
+    uint32_t adler;
+    {
+        FixedDeflate deflate(out);
+        for (uint32_t y = 0; y < height; ++y) {
+            const uint8_t* row = pixels + y * stride;
+            deflate.add(1); // Filtro Sub: cada byte menos el mismo canal del píxel anterior
+            for (size_t i = 0; i < channels; ++i) deflate.add(row[i]);
+            for (size_t i = channels; i < stride; ++i) deflate.add(static_cast<uint8_t>(row[i] - row[i - channels]));
+        }
+        adler = deflate.finish();
+    }
+    appendBigEndian(out, adler);
+    uint32_t dataBytes = static_cast<uint32_t>(out.size() - typeOffset - 4);
+    for (int i = 0; i < 4; ++i) out[lengthOffset + i] = static_cast<uint8_t>(dataBytes >> (24 - 8 * i));
+    appendBigEndian(out, crc32(out.data() + typeOffset, out.size() - typeOffset));
+    appendChunk(out, "IEND", nullptr, 0);
+}
+
+bool writePng(const std::string& path, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels,
+              std::vector<uint8_t>& scratch) {
+    encodePng(pixels, width, height, channels, scratch);
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool written = std::fwrite(scratch.data(), 1, scratch.size(), file) == scratch.size();
+    return std::fclose(file) == 0 && written;
+}
+
+} // namespace particulas
@@ -0,0 +1,26 @@
+#ifndef PARTICULAS_UTILS_PNG_WRITER_HPP
+#define PARTICULAS_UTILS_PNG_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace particulas {
+
+// Codificador PNG mínimo sin dependencias (8 bits, RGB o RGBA). Cada fila lleva el filtro Sub y
+// el deflate solo busca repeticiones del byte anterior (códigos Huffman fijos): rápido y muy eficaz
+// en fondos lisos como los de la simulación, peor que zlib en imágenes con mucho detalle.
+// out se reutiliza entre llamadas (con la capacidad de getMaxPngBytes no vuelve a reservar).
+void encodePng(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels, std::vector<uint8_t>& out);
+
+// Cota superior del tamaño codificado
+size_t getMaxPngBytes(uint32_t width, uint32_t height, uint32_t channels);
+
+// Codifica y escribe en path; false si no se pudo escribir
+bool writePng(const std::string& path, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels,
+              std::vector<uint8_t>& scratch);
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_PNG_WRITER_HPP
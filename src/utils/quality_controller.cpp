@@ -0,0 +1,168 @@
+#include "quality_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+
+namespace particulas {
+
+const char* qualityLeverName(QualityLever lever) {
+    switch (lever) {
+        case QualityLever::Substeps: return "substeps";
+        case QualityLever::RenderScale: return "render_scale";
+        case QualityLever::DrawFraction: return "draw_fraction";
+        case QualityLever::Count: break;
+    }
+    return "unknown";
+}
+
+QualityController::QualityController(const QualitySettings& settings)
+    : settings_(settings), levels_(settings.maximum), upHoldFrames_(settings.upHoldFrames) {
+    const QualityLevels& low = settings_.minimum;
+    const QualityLevels& high = settings_.maximum;
+    if (settings_.frameBudgetMs <= 0.0 || settings_.windowFrames == 0) {
+        throw std::invalid_argument("Quality controller needs a positive frame budget and window.");
+    }
+    if (low.substeps < 1 || low.substeps > high.substeps || low.renderScale <= 0.0f || low.renderScale > high.renderScale
+        || high.renderScale > 1.0f || low.drawFraction <= 0.0f || low.drawFraction > high.drawFraction || high.drawFraction > 1.0f) {
+        throw std::invalid_argument("Quality controller bounds must satisfy 1 <= substeps and 0 < minimum <= maximum <= 1.");
+    }
+    if (settings_.upThreshold <= 0.0 || settings_.upThreshold >= settings_.downThreshold) {
+        throw std::invalid_argument("Quality controller needs 0 < upThreshold < downThreshold (hysteresis band).");
+    }
+    if (settings_.renderScaleStep <= 0.0f || settings_.drawFractionFactor <= 0.0f || settings_.drawFractionFactor >= 1.0f) {
+        throw std::invalid_argument("Quality controller steps must be positive and the draw fraction factor below 1.");
+    }
+    settings_.maxUpHoldFrames = std::max(settings_.maxUpHoldFrames, settings_.upHoldFrames);
+    available_.fill(true);
+    window_.assign(settings_.windowFrames, 0.0);
+    sorted_.resize(settings_.windowFrames);
+    decisions_.reserve(MAX_RECORDED_DECISIONS);
+}
+
+void QualityController::setLeverAvailable(QualityLever lever, bool available) {
+    if (lever != QualityLever::Count) available_[static_cast<size_t>(lever)] = available;
+}
+
+// Un escalón hacia abajo en la primera palanca disponible que aún tenga margen
+bool QualityController::lower(QualityLevels& levels, QualityLever& lever) const {
+    const QualityLevels& low = settings_.minimum;
+    if (available_[static_cast<size_t>(QualityLever::Substeps)] && levels.substeps > low.substeps) {
+        --levels.substeps;
+        lever = QualityLever::Substeps;
+        return true;
+    }
+    if (available_[static_cast<size_t>(QualityLever::RenderScale)] && levels.renderScale > low.renderScale) {
+        levels.renderScale = std::max(low.renderScale, levels.renderScale - settings_.renderScaleStep);
+        lever = QualityLever::RenderScale;
+        return true;
+    }
+    if (available_[static_cast<size_t>(QualityLever::DrawFraction)] && levels.drawFraction > low.drawFraction) {
+        levels.drawFraction = std::max(low.drawFraction, levels.drawFraction * settings_.drawFractionFactor);
+        lever = QualityLever::DrawFraction;
+        return true;
+    }
+    return false;
+}
+
+// En orden inverso: primero se recupera lo que más se nota
+bool QualityController::raise(QualityLevels& levels, QualityLever& lever) const {
+    const QualityLevels& high = settings_.maximum;
+    if (available_[static_cast<size_t>(QualityLever::DrawFraction)] && levels.drawFraction < high.drawFraction) {
+        float fraction = levels.drawFraction / settings_.drawFractionFactor;
+        levels.drawFraction = fraction > high.drawFraction * 0.999f ? high.drawFraction : fraction; // Sin residuos de redondeo
+        lever = QualityLever::DrawFraction;
+        return true;
+    }
+    if (available_[static_cast<size_t>(QualityLever::RenderScale)] && levels.renderScale < high.renderScale) {
+        levels.renderScale = std::min(high.renderScale, levels.renderScale + settings_.renderScaleStep);
+        lever = QualityLever::RenderScale;
+        return true;
+    }
+    if (available_[static_cast<size_t>(QualityLever::Substeps)] && levels.substeps < high.substeps) {
+        ++levels.substeps;
+        lever = QualityLever::Substeps;
+        return true;
+    }
+    return false;
+}
+
+void QualityController::record(QualityLever lever, bool lowered, const QualityLevels& before, double meanMs, double p95Ms,
+                               double timeSeconds) {
+    QualityDecision& decision = lastDecision_;
+    decision.frame = frames_;
+    decision.timeSeconds = timeSeconds;
+    decision.lever = lever;
+    decision.lowered = lowered;
+    decision.meanMs = meanMs;
+    decision.p95Ms = p95Ms;
+    decision.before = before;
+    decision.after = levels_;
+    decision.upHoldFrames = upHoldFrames_;
+    ++decisionCount_;
+    if (decisions_.size() < MAX_RECORDED_DECISIONS) decisions_.push_back(decision);
+}
+
+void QualityController::startWindow() {
+    windowCount_ = 0;
+    windowNext_ = 0;
+}
+
+bool QualityController::addFrameTime(double milliseconds, double timeSeconds) {
+    ++frames_;
+    window_[windowNext_] = milliseconds;
+    windowNext_ = (windowNext_ + 1) % window_.size();
+    if (++windowCount_ < window_.size()) return false;
+
+    // Ventana completa: se evalúa una vez y se empieza otra, así cada decisión ve solo frames con
+    // los niveles actuales
+    std::copy(window_.begin(), window_.end(), sorted_.begin());
+    size_t p95Index = std::min(sorted_.size() - 1, static_cast<size_t>(std::ceil(0.95 * static_cast<double>(sorted_.size()))) - 1);
+    std::nth_element(sorted_.begin(), sorted_.begin() + static_cast<std::ptrdiff_t>(p95Index), sorted_.end());
+    double p95Ms = sorted_[p95Index];
+    double sum = 0.0;
+    for (double frame : window_) sum += frame;
+    double meanMs = sum / static_cast<double>(window_.size());
+    startWindow();
+
+    bool afterRaise = lastWasRaise_;
+    lastWasRaise_ = false;
+    QualityLevels before = levels_;
+    QualityLever lever = QualityLever::Count;
+    if (p95Ms > settings_.frameBudgetMs * settings_.downThreshold) {
+        slackFrames_ = 0;
+        // La subida anterior no cabía: esperar el doble antes de intentarlo otra vez
+        if (afterRaise) upHoldFrames_ = std::min(upHoldFrames_ * 2, settings_.maxUpHoldFrames);
+        if (!lower(levels_, lever)) return false; // Todo al mínimo: no queda nada que recortar
+        record(lever, true, before, meanMs, p95Ms, timeSeconds);
+        return true;
+    }
+    // La subida se sostuvo: la espera vuelve poco a poco a la de partida
+    if (afterRaise) upHoldFrames_ = std::max(settings_.upHoldFrames, upHoldFrames_ / 2);
+    if (p95Ms >= settings_.frameBudgetMs * settings_.upThreshold) {
+        slackFrames_ = 0; // Dentro de la banda de histéresis
+        return false;
+    }
+    slackFrames_ += window_.size();
+    if (slackFrames_ < upHoldFrames_ || !raise(levels_, lever)) return false;
+    slackFrames_ = 0;
+    lastWasRaise_ = true;
+    record(lever, false, before, meanMs, p95Ms, timeSeconds);
+    return true;
+}
+
+void QualityController::writeDecisionsCsv(std::ostream& out) const {
+    out << "frame,time_s,lever,direction,mean_frame_ms,p95_frame_ms,budget_ms,substeps_before,substeps_after,"
+           "render_scale_before,render_scale_after,draw_fraction_before,draw_fraction_after,up_hold_frames\n";
+    out << std::fixed << std::setprecision(3);
+    for (const QualityDecision& decision : decisions_) {
+        out << decision.frame << ',' << decision.timeSeconds << ',' << qualityLeverName(decision.lever) << ','
+            << (decision.lowered ? "down" : "up") << ',' << decision.meanMs << ',' << decision.p95Ms << ','
+            << settings_.frameBudgetMs << ',' << decision.before.substeps << ',' << decision.after.substeps << ','
+            << decision.before.renderScale << ',' << decision.after.renderScale << ','
+            << decision.before.drawFraction << ',' << decision.after.drawFraction << ',' << decision.upHoldFrames << '\n';
+    }
+}
+
+} // namespace particulas
@@ -0,0 +1,112 @@
+#ifndef PARTICULAS_UTILS_QUALITY_CONTROLLER_HPP
+#define PARTICULAS_UTILS_QUALITY_CONTROLLER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace particulas {
+
+// Palancas de calidad, en el orden en que se sacrifican al pasarse del presupuesto
+enum class QualityLever {
+    Substeps,      // Subpasos del solver de restricciones por paso de simulación (precisión de la tela)
+    RenderScale,   // Resolución del acumulador de splats respecto a la ventana
+    DrawFraction,  // Fracción de las partículas visibles que se sube y dibuja
+    Count
+};
+
+const char* qualityLeverName(QualityLever lever);
+
+struct QualityLevels {
+    int substeps = 1;
+    float renderScale = 1.0f;
+    float drawFraction = 1.0f;
+};
+
+struct QualitySettings {
+    double frameBudgetMs = 16.6;
+    QualityLevels minimum{1, 0.5f, 0.25f};
+    QualityLevels maximum{4, 1.0f, 1.0f};   // Nivel de partida
+
+    // Histéresis: se baja si el p95 de la ventana supera budget * downThreshold y solo se sube si
+    // queda por debajo de budget * upThreshold; entre ambos no se toca nada.
+    double downThreshold = 1.0;
+    double upThreshold = 0.75;
+    size_t windowFrames = 60;         // Frames de cada ventana; tras un cambio se empieza una nueva
+    size_t upHoldFrames = 180;        // Frames holgados seguidos antes de subir
+    size_t maxUpHoldFrames = 2880;    // Tope del retroceso tras una subida que hubo que deshacer
+
+    float renderScaleStep = 0.125f;   // Paso aditivo de la escala
+    float drawFractionFactor = 0.75f; // Paso multiplicativo de la fracción dibujada
+};
+
+// Una decisión del controlador, con las estadísticas que la motivaron
+struct QualityDecision {
+    uint64_t frame = 0;
+    double timeSeconds = 0.0;
+    QualityLever lever = QualityLever::Substeps;
+    bool lowered = true;
+    double meanMs = 0.0;
+    double p95Ms = 0.0;
+    QualityLevels before;
+    QualityLevels after;
+    size_t upHoldFrames = 0;          // Espera antes de la siguiente subida tras esta decisión
+};
+
+// Controlador de calidad con presupuesto de frame: mide el intervalo entre frames en ventanas
+// de windowFrames y, según el p95 de cada ventana, baja o sube un escalón de una palanca cada
+// vez (se baja primero lo que menos se nota y se recupera en orden inverso). Sube despacio y baja
+// deprisa; si una subida se deshace en la ventana siguiente, la espera para volver a subir se
+// duplica, así que no oscila entre dos niveles vecinos. No reserva memoria después de construirse.
+class QualityController {
+public:
+    // Lanza std::invalid_argument si los límites o los umbrales no son coherentes
+    explicit QualityController(const QualitySettings& settings);
+
+    // Una palanca no disponible (p. ej. la escala con el renderizador de puntos) se salta en ambos
+    // sentidos y conserva su nivel
+    void setLeverAvailable(QualityLever lever, bool available);
+
+    // Intervalo del último frame. Devuelve true si los niveles cambiaron.
+    bool addFrameTime(double milliseconds, double timeSeconds);
+
+    const QualityLevels& getLevels() const { return levels_; }
+    const QualitySettings& getSettings() const { return settings_; }
+    const std::vector<QualityDecision>& getDecisions() const { return decisions_; }
+    uint64_t getDecisionCount() const { return decisionCount_; } // Incluye las que no cupieron en el registro
+    const QualityDecision* getLastDecision() const { return decisionCount_ > 0 ? &lastDecision_ : nullptr; }
+
+    // Una fila por decisión registrada (CSV con cabecera)
+    void writeDecisionsCsv(std::ostream& out) const;
+
+    static constexpr size_t MAX_RECORDED_DECISIONS = 4096;
+
+private:
+    bool lower(QualityLevels& levels, QualityLever& lever) const;
+    bool raise(QualityLevels& levels, QualityLever& lever) const;
+    void record(QualityLever lever, bool lowered, const QualityLevels& before, double meanMs, double p95Ms, double timeSeconds);
+    void startWindow();
+
+    QualitySettings settings_;
+    QualityLevels levels_;
+    std::array<bool, static_cast<size_t>(QualityLever::Count)> available_;
+
+    std::vector<double> window_;      // Tamaño fijo windowFrames, se rellena en anillo
+    std::vector<double> sorted_;      // Copia para el percentil
+    size_t windowCount_ = 0;
+    size_t windowNext_ = 0;
+    size_t slackFrames_ = 0;          // Frames seguidos en ventanas holgadas
+    size_t upHoldFrames_;
+    bool lastWasRaise_ = false;       // La ventana en curso es la primera tras una subida
+    uint64_t frames_ = 0;
+
+    std::vector<QualityDecision> decisions_;
+    QualityDecision lastDecision_;
+    uint64_t decisionCount_ = 0;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_QUALITY_CONTROLLER_HPP
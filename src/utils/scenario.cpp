@@ -0,0 +1,221 @@
+#include "scenario.hpp"
+
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+namespace particulas {
+
+namespace {
+
+struct Entry {
+    std::string key;
+    std::vector<std::string> values;
+    std::string where; // fichero:línea para los errores
+};
+
+std::string trim(const std::string& text) {
+    size_t begin = 0, end = text.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) ++begin;
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) --end;
+    return text.substr(begin, end - begin);
+}
+
+// Valores separados por comas y/o espacios
+std::vector<std::string> splitValues(const std::string& text) {
+    std::vector<std::string> values;
+    std::string current;
+    for (char c : text) {
+        if (c == ',' || std::isspace(static_cast<unsigned char>(c))) {
+            if (!current.empty()) values.push_back(current);
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!current.empty()) values.push_back(current);
+    return values;
+}
+
+double parseNumber(const Entry& entry, const std::string& value, double min) {
+    size_t used = 0;
+    double number = 0.0;
+    try { number = std::stod(value, &used); } catch (const std::exception&) { used = 0; }
+    if (used == 0 || used != value.size() || !std::isfinite(number)) {
+        throw std::invalid_argument(entry.where + ": '" + value + "' is not a number for " + entry.key);
+    }
+    if (number < min) throw std::invalid_argument(entry.where + ": " + entry.key + " must be at least " + std::to_string(min));
+    return number;
+}
+
+// Claves enteras: sin parte fraccionaria y dentro del rango del tipo de destino (el cast no lo comprueba)
+uint64_t parseInteger(const Entry& entry, const std::string& value, uint64_t min, uint64_t max) {
+    double number = parseNumber(entry, value, -HUGE_VAL);
+    if (number != std::floor(number)) throw std::invalid_argument(entry.where + ": " + entry.key + " must be an integer, not '" + value + "'");
+    if (number < static_cast<double>(min) || number > static_cast<double>(max)) {
+        throw std::invalid_argument(entry.where + ": " + entry.key + " must be between " + std::to_string(min) + " and " + std::to_string(max));
+    }
+    return static_cast<uint64_t>(number);
+}
+
+bool parseSwitch(const Entry& entry, const std::string& value, const char* off, const char* on) {
+    if (value == on) return true;
+    if (value == off) return false;
+    throw std::invalid_argument(entry.where + ": " + entry.key + " must be " + off + " or " + on + ", not '" + value + "'");
+}
+
+void applyValue(Scenario& scenario, const Entry& entry, const std::string& value) {
+    const std::string& key = entry.key;
+    if (key == "particles") {
+        scenario.particleCount = static_cast<int>(parseInteger(entry, value, 1, INT_MAX));
+    } else if (key == "capacity") {
+        scenario.capacity = static_cast<size_t>(parseInteger(entry, value, 0, UINT32_MAX));
+    } else if (key == "distribution") {
+        if (!parseDistribution(value, scenario.distribution)) {
+            throw std::invalid_argument(entry.where + ": unknown distribution '" + value + "' (uniform, clusters, ring)");
+        }
+    } else if (key == "physics") {
+        bool found = false;
+        for (PhysicsMode mode : {PhysicsMode::Free, PhysicsMode::Gravity, PhysicsMode::Emitter, PhysicsMode::Cloth}) {
+            if (value == physicsModeName(mode)) { scenario.physics = mode; found = true; }
+        }
+        if (!found) throw std::invalid_argument(entry.where + ": unknown physics mode '" + value + "' (free, gravity, emitter, cloth)");
+    } else if (key == "gravity") {
+        scenario.gravity = static_cast<float>(parseNumber(entry, value, -1e9));
+    } else if (key == "emitter_rate") {
+        scenario.emitterRate = static_cast<float>(parseNumber(entry, value, 0.0));
+    } else if (key == "emitter_lifetime") {
+        scenario.emitterLifetime = static_cast<float>(parseNumber(entry, value, 0.001));
+    } else if (key == "seed") {
+        scenario.seed = static_cast<uint32_t>(parseInteger(entry, value, 0, UINT32_MAX));
+    } else if (key == "simulation") {
+        scenario.simulateOnGpu = parseSwitch(entry, value, "cpu", "gpu");
+    } else if (key == "renderer") {
+        scenario.splats = parseSwitch(entry, value, "points", "splats");
+    } else if (key == "present_mode") {
+        static const std::map<std::string, VkPresentModeKHR> modes = {
+            {"immediate", VK_PRESENT_MODE_IMMEDIATE_KHR}, {"mailbox", VK_PRESENT_MODE_MAILBOX_KHR},
+            {"fifo", VK_PRESENT_MODE_FIFO_KHR}, {"fifo-relaxed", VK_PRESENT_MODE_FIFO_RELAXED_KHR}};
+        auto mode = modes.find(value);
+        if (mode == modes.end()) throw std::invalid_argument(entry.where + ": unknown present mode '" + value + "'");
+        scenario.presentMode = mode->second;
+    } else if (key == "window") {
+        size_t separator = value.find('x');
+        if (separator == std::string::npos) throw std::invalid_argument(entry.where + ": window must be WIDTHxHEIGHT, not '" + value + "'");
+        scenario.windowWidth = static_cast<uint32_t>(parseInteger(entry, value.substr(0, separator), 64, INT_MAX));
+        scenario.windowHeight = static_cast<uint32_t>(parseInteger(entry, value.substr(separator + 1), 64, INT_MAX));
+    } else if (key == "threads") {
+        scenario.threads = static_cast<int>(parseInteger(entry, value, 0, INT_MAX));
+    } else if (key == "simulation_rate") {
+        scenario.simulationRateHz = static_cast<float>(parseNumber(entry, value, 0.0));
+    } else if (key == "hud") {
+        scenario.hud = parseSwitch(entry, value, "off", "on");
+    } else if (key == "frame_budget") {
+        scenario.frameBudgetMs = parseNumber(entry, value, 0.0);
+    } else if (key == "warmup") {
+        scenario.warmupSeconds = parseNumber(entry, value, 0.0);
+    } else if (key == "duration") {
+        scenario.durationSeconds = parseNumber(entry, value, 0.1);
+    } else {
+        throw std::invalid_argument(entry.where + ": unknown key '" + key + "'");
+    }
+}
+
+// Un escenario por combinación de los valores de las claves con lista, en orden de aparición
+// (la última clave varía más deprisa)
+void expandSection(const Scenario& base, const std::vector<Entry>& entries, std::vector<Scenario>& out) {
+    Scenario fixed = base;
+    std::vector<const Entry*> swept;
+    for (const Entry& entry : entries) {
+        if (entry.values.size() == 1) applyValue(fixed, entry, entry.values.front());
+        else swept.push_back(&entry);
+    }
+    std::vector<size_t> index(swept.size(), 0);
+    while (true) {
+        Scenario scenario = fixed;
+        for (size_t i = 0; i < swept.size(); ++i) {
+            const std::string& value = swept[i]->values[index[i]];
+            applyValue(scenario, *swept[i], value);
+            scenario.sweptValues.emplace_back(swept[i]->key, value);
+        }
+        out.push_back(std::move(scenario));
+        size_t position = swept.size();
+        while (position > 0 && ++index[position - 1] == swept[position - 1]->values.size()) index[--position] = 0;
+        if (position == 0) break;
+    }
+}
+
+} // namespace
+
+const char* physicsModeName(PhysicsMode mode) {
+    switch (mode) {
+        case PhysicsMode::Free: return "free";
+        case PhysicsMode::Gravity: return "gravity";
+        case PhysicsMode::Emitter: return "emitter";
+        case PhysicsMode::Cloth: return "cloth";
+    }
+    return "unknown";
+}
+
+std::string Scenario::getLabel() const {
+    std::string label = name;
+    for (const auto& swept : sweptValues) label += " " + swept.first + "=" + swept.second;
+    return label;
+}
+
+std::vector<Scenario> parseScenarios(std::istream& in, const std::string& sourceName) {
+    std::vector<Scenario> scenarios;
+    Scenario defaults;
+    std::string section;
+    std::vector<Entry> entries;
+    auto finishSection = [&] {
+        if (section.empty()) return;
+        if (section == "defaults") {
+            for (const Entry& entry : entries) {
+                if (entry.values.size() != 1) throw std::invalid_argument(entry.where + ": lists are not allowed in [defaults]");
+                applyValue(defaults, entry, entry.values.front());
+            }
+        } else {
+            Scenario base = defaults;
+            base.name = section;
+            expandSection(base, entries, scenarios);
+        }
+        entries.clear();
+    };
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        std::string where = sourceName + ":" + std::to_string(lineNumber);
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+        if (line.front() == '[') {
+            if (line.back() != ']' || line.size() < 3) throw std::invalid_argument(where + ": malformed section header");
+            finishSection();
+            section = trim(line.substr(1, line.size() - 2));
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) throw std::invalid_argument(where + ": expected key = value");
+        if (section.empty()) throw std::invalid_argument(where + ": key outside of a [section]");
+        Entry entry{trim(line.substr(0, equals)), splitValues(line.substr(equals + 1)), where};
+        if (entry.values.empty()) throw std::invalid_argument(where + ": missing value for " + entry.key);
+        entries.push_back(std::move(entry));
+    }
+    finishSection();
+    if (scenarios.empty()) throw std::invalid_argument(sourceName + ": no scenarios (only [defaults] or empty file)");
+    return scenarios;
+}
+
+std::vector<Scenario> loadScenarios(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Cannot open scenario file " + path);
+    return parseScenarios(file, path);
+}
+
+} // namespace particulas
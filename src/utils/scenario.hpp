@@ -0,0 +1,78 @@
+#ifndef PARTICULAS_UTILS_SCENARIO_HPP
+#define PARTICULAS_UTILS_SCENARIO_HPP
+
+#include "particles/particle_distribution.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace particulas {
+
+enum class PhysicsMode {
+    Free,     // Rebotes contra los bordes, sin fuerzas
+    Gravity,  // Aceleración constante hacia abajo
+    Emitter,  // Emisor radial en el centro (partículas con vida limitada)
+    Cloth     // Tela de restricciones PBD fijada por las esquinas (ignora distribution)
+};
+
+const char* physicsModeName(PhysicsMode mode);
+
+// Una ejecución de benchmark: qué se simula, cómo se dibuja y cuánto se mide
+struct Scenario {
+    std::string name;                 // Sección del fichero
+    std::vector<std::pair<std::string, std::string>> sweptValues; // Claves con lista y su valor en esta ejecución
+
+    int particleCount = 10000;
+    size_t capacity = 0;              // 0 = particleCount más lo que mantiene vivo el emisor
+    ParticleDistribution distribution = ParticleDistribution::Uniform;
+    PhysicsMode physics = PhysicsMode::Free;
+    float gravity = 120.0f;           // Gravity y Cloth (positiva hacia abajo)
+    float emitterRate = 2000.0f;      // Emitter: partículas por segundo
+    float emitterLifetime = 3.0f;
+    uint32_t seed = 1;
+
+    bool simulateOnGpu = false;
+    bool splats = false;              // Renderizador inicial: puntos o splats
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    uint32_t windowWidth = 1920;
+    uint32_t windowHeight = 1080;
+    int threads = 0;                  // Hilos de simulación incluido el principal (0 = todos)
+    float simulationRateHz = 0.0f;    // 0 = un paso por frame
+    bool hud = false;
+    double frameBudgetMs = 0.0;       // > 0: controlador de calidad con este presupuesto (p95 del frame)
+
+    double warmupSeconds = 1.0;       // Frames que no se miden (cachés, pipelines, relojes de la GPU)
+    double durationSeconds = 10.0;
+
+    // "nombre" o "nombre particles=50000 threads=4"
+    std::string getLabel() const;
+};
+
+// Formato de los ficheros de escenarios (texto, una clave por línea, '#' comenta el resto):
+//
+//   [defaults]              # Valores de partida para las secciones siguientes
+//   duration = 8
+//   window = 1280x720
+//
+//   [thread_scaling]        # Un escenario por sección...
+//   particles = 200000
+//   threads = 1, 2, 4, 8    # ...salvo que una clave lleve una lista: producto cartesiano
+//
+// Claves: particles, capacity, distribution (uniform|clusters|ring), physics (free|gravity|
+// emitter|cloth), gravity, emitter_rate, emitter_lifetime, seed, simulation (cpu|gpu), renderer
+// (points|splats), present_mode (fifo|mailbox|immediate|fifo-relaxed), window (AnchoxAlto),
+// threads, simulation_rate, hud (on|off), frame_budget (ms, 0 = sin controlador de calidad),
+// warmup, duration (segundos).
+// Lanza std::invalid_argument con fichero:línea ante cualquier error.
+std::vector<Scenario> parseScenarios(std::istream& in, const std::string& sourceName);
+// Lanza std::runtime_error si no puede abrir path
+std::vector<Scenario> loadScenarios(const std::string& path);
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_SCENARIO_HPP
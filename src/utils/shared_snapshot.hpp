@@ -0,0 +1,73 @@
+#ifndef PARTICULAS_UTILS_SHARED_SNAPSHOT_HPP
+#define PARTICULAS_UTILS_SHARED_SNAPSHOT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Layout de la memoria compartida con la que el simulador publica sus snapshots a otros procesos
+// (SharedSnapshotWriter escribe, SharedSnapshotReader lee). Solo tipos triviales y sin GLM, para
+// que un consumidor pueda incluirlo sin el resto del proyecto.
+//
+//   [SharedSnapshotHeader][slot 0: SharedSnapshotSlot + capacidad * SharedParticle][slot 1] ...
+//
+// Es un anillo de slotCount snapshots: el frame publicado N va al slot N % slotCount. Cada slot
+// lleva un seqlock (sequence impar mientras se escribe): el escritor nunca espera a nadie y un
+// lector que comprueba la secuencia antes y después de leer sabe si lo leído es consistente.
+// Un lector tiene slotCount - 1 publicaciones de margen antes de que su slot se reescriba.
+
+namespace particulas {
+
+constexpr uint32_t SHARED_SNAPSHOT_MAGIC = 0x50534E50; // "PNSP"
+constexpr uint32_t SHARED_SNAPSHOT_VERSION = 1;
+constexpr size_t SHARED_SNAPSHOT_ALIGNMENT = 64;       // Cada bloque empieza en su propia línea de caché
+
+// Mismo layout que particulas::Particle (32 bytes). Los slots libres del pool van con alive = 0.
+struct SharedParticle {
+    float positionX, positionY;
+    float velocityX, velocityY;
+    float age;
+    float lifetime;
+    uint16_t species;
+    uint16_t reserved;
+    uint32_t alive;
+};
+static_assert(sizeof(SharedParticle) == 32, "SharedParticle must match particulas::Particle");
+
+// Los atómicos de 64 bits sin lock no dependen de la dirección: valen entre procesos
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared snapshots need lock-free 64-bit atomics");
+
+struct alignas(SHARED_SNAPSHOT_ALIGNMENT) SharedSnapshotHeader {
+    std::atomic<uint32_t> magic;      // Se escribe el último: hasta entonces el segmento no está listo
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t particleSize;            // sizeof(SharedParticle) del escritor
+    uint64_t slotCapacity;            // Partículas que caben en un slot
+    uint64_t slotBytes;               // Distancia entre slots
+    uint64_t writerPid;
+    std::atomic<uint64_t> latestFrame; // Último frame publicado completo (0 = ninguno todavía)
+    std::atomic<uint64_t> writerClosed; // 1 cuando el simulador ha terminado
+};
+
+// Metadatos de un snapshot. Los campos son atómicos relajados: el orden lo ponen las barreras del
+// seqlock, y así leerlos mientras el escritor los cambia no es una carrera.
+struct alignas(SHARED_SNAPSHOT_ALIGNMENT) SharedSnapshotSlot {
+    std::atomic<uint64_t> sequence;        // Impar mientras el escritor está dentro
+    std::atomic<uint64_t> frame;           // Número de publicación (empieza en 1)
+    std::atomic<uint64_t> simulationStep;  // Pasos de simulación acumulados
+    std::atomic<uint64_t> particleCount;   // Partículas válidas a continuación (vivas y libres)
+    std::atomic<uint64_t> timestampNanoseconds; // steady_clock del escritor al publicar
+};
+
+inline size_t sharedSnapshotSlotBytes(size_t slotCapacity) {
+    size_t bytes = sizeof(SharedSnapshotSlot) + slotCapacity * sizeof(SharedParticle);
+    return (bytes + SHARED_SNAPSHOT_ALIGNMENT - 1) / SHARED_SNAPSHOT_ALIGNMENT * SHARED_SNAPSHOT_ALIGNMENT;
+}
+
+inline size_t sharedSnapshotTotalBytes(size_t slotCount, size_t slotCapacity) {
+    return sizeof(SharedSnapshotHeader) + slotCount * sharedSnapshotSlotBytes(slotCapacity);
+}
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_SHARED_SNAPSHOT_HPP
@@ -0,0 +1,137 @@
+#include "shared_snapshot_reader.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace particulas {
+
+#ifndef _WIN32
+
+SharedSnapshotReader::SharedSnapshotReader(const std::string& name) {
+    map(name, true);
+}
+
+SharedSnapshotReader::~SharedSnapshotReader() {
+    if (mapped_ != nullptr) munmap(const_cast<void*>(mapped_), mappedBytes_);
+}
+
+std::unique_ptr<SharedSnapshotReader> SharedSnapshotReader::tryOpen(const std::string& name) {
+    std::unique_ptr<SharedSnapshotReader> reader(new SharedSnapshotReader());
+    if (!reader->map(name, false)) return nullptr;
+    return reader;
+}
+
+bool SharedSnapshotReader::map(const std::string& name, bool throwIfMissing) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        if (!throwIfMissing && errno == ENOENT) return false;
+        throw std::runtime_error("Shared snapshots: shm_open(" + name + "): " + std::strerror(errno));
+    }
+    struct stat info{};
+    if (fstat(fd, &info) == -1 || static_cast<size_t>(info.st_size) < sizeof(SharedSnapshotHeader)) {
+        close(fd);
+        if (!throwIfMissing) return false; // El escritor aún no le ha dado tamaño
+        throw std::runtime_error("Shared snapshots: " + name + " is not initialized");
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) throw std::runtime_error(std::string("Shared snapshots: mmap: ") + std::strerror(errno));
+    mapped_ = mapped;
+    mappedBytes_ = static_cast<size_t>(info.st_size);
+    header_ = static_cast<const SharedSnapshotHeader*>(mapped_);
+
+    if (header_->magic.load(std::memory_order_acquire) != SHARED_SNAPSHOT_MAGIC) {
+        munmap(mapped, mappedBytes_); mapped_ = nullptr; header_ = nullptr;
+        if (!throwIfMissing) return false;
+        throw std::runtime_error("Shared snapshots: " + name + " is not initialized");
+    }
+    if (header_->version != SHARED_SNAPSHOT_VERSION || header_->particleSize != sizeof(SharedParticle) || header_->slotCount == 0 ||
+        header_->slotBytes != sharedSnapshotSlotBytes(header_->slotCapacity) ||
+        sharedSnapshotTotalBytes(header_->slotCount, header_->slotCapacity) > mappedBytes_) {
+        uint32_t version = header_->version;
+        munmap(mapped, mappedBytes_); mapped_ = nullptr; header_ = nullptr;
+        throw std::runtime_error("Shared snapshots: " + name + " has an incompatible layout (version " + std::to_string(version) + ")");
+    }
+    return true;
+}
+
+const SharedSnapshotSlot& SharedSnapshotReader::getSlot(uint64_t frame) const {
+    const char* base = static_cast<const char*>(mapped_) + sizeof(SharedSnapshotHeader);
+    return *reinterpret_cast<const SharedSnapshotSlot*>(base + (frame % header_->slotCount) * header_->slotBytes);
+}
+
+bool SharedSnapshotReader::acquireLatest(SnapshotView& view) {
+    uint64_t frame = header_->latestFrame.load(std::memory_order_acquire);
+    if (frame == 0 || frame == lastFrame_) return false;
+
+    const SharedSnapshotSlot& slot = getSlot(frame);
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence & 1) return false; // El escritor ya ha dado la vuelta al anillo y está en este slot
+    uint64_t slotFrame = slot.frame.load(std::memory_order_relaxed);
+    uint64_t count = slot.particleCount.load(std::memory_order_relaxed);
+    view.simulationStep = slot.simulationStep.load(std::memory_order_relaxed);
+    view.timestampNanoseconds = slot.timestampNanoseconds.load(std::memory_order_relaxed);
+    if (slotFrame != frame || count > header_->slotCapacity) return false;
+
+    view.particles = reinterpret_cast<const SharedParticle*>(&slot + 1);
+    view.particleCount = static_cast<size_t>(count);
+    view.frame = frame;
+    view.slot_ = &slot;
+    view.sequence_ = sequence;
+    if (!isStillValid(view)) return false; // Los metadatos leídos también deben ser consistentes
+    lastFrame_ = frame;
+    return true;
+}
+
+bool SharedSnapshotReader::isStillValid(const SnapshotView& view) const {
+    if (view.slot_ == nullptr) return false;
+    // Las lecturas de los datos no pueden pasar por detrás de la comprobación
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return view.slot_->sequence.load(std::memory_order_relaxed) == view.sequence_;
+}
+
+bool SharedSnapshotReader::copyLatest(std::vector<SharedParticle>& out, SnapshotView& info) {
+    SnapshotView view;
+    if (!acquireLatest(view)) return false;
+    out.resize(view.particleCount);
+    std::memcpy(out.data(), view.particles, view.particleCount * sizeof(SharedParticle));
+    if (!isStillValid(view)) return false;
+    info = view;
+    info.particles = out.data();
+    return true;
+}
+
+bool SharedSnapshotReader::isWriterClosed() const {
+    return header_->writerClosed.load(std::memory_order_acquire) != 0;
+}
+
+#else
+
+SharedSnapshotReader::SharedSnapshotReader(const std::string&) {
+    throw std::runtime_error("Shared snapshots: only available on POSIX systems");
+}
+
+SharedSnapshotReader::~SharedSnapshotReader() = default;
+
+std::unique_ptr<SharedSnapshotReader> SharedSnapshotReader::tryOpen(const std::string&) {
+    throw std::runtime_error("Shared snapshots: only available on POSIX systems");
+}
+
+bool SharedSnapshotReader::map(const std::string&, bool) { return false; }
+const SharedSnapshotSlot& SharedSnapshotReader::getSlot(uint64_t) const { return *static_cast<const SharedSnapshotSlot*>(mapped_); }
+bool SharedSnapshotReader::acquireLatest(SnapshotView&) { return false; }
+bool SharedSnapshotReader::isStillValid(const SnapshotView&) const { return false; }
+bool SharedSnapshotReader::copyLatest(std::vector<SharedParticle>&, SnapshotView&) { return false; }
+bool SharedSnapshotReader::isWriterClosed() const { return true; }
+
+#endif
+
+} // namespace particulas
@@ -0,0 +1,72 @@
+#ifndef PARTICULAS_UTILS_SHARED_SNAPSHOT_READER_HPP
+#define PARTICULAS_UTILS_SHARED_SNAPSHOT_READER_HPP
+
+#include "utils/shared_snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace particulas {
+
+// Snapshot leído en el sitio, sin copiar: particles apunta a la memoria compartida. El escritor
+// puede reutilizar el slot en cualquier momento (tras slotCount - 1 publicaciones más), así que
+// después de procesarlo hay que confirmar con SharedSnapshotReader::isStillValid que no se
+// reescribió mientras tanto; si no, los resultados se descartan.
+struct SnapshotView {
+    const SharedParticle* particles = nullptr;
+    size_t particleCount = 0;      // Incluye slots libres (alive = 0)
+    uint64_t frame = 0;            // Número de publicación: los huecos son snapshots que no se vieron
+    uint64_t simulationStep = 0;
+    uint64_t timestampNanoseconds = 0; // steady_clock del escritor (misma máquina)
+
+private:
+    friend class SharedSnapshotReader;
+    const SharedSnapshotSlot* slot_ = nullptr;
+    uint64_t sequence_ = 0;
+};
+
+// Biblioteca de lectura para procesos externos (herramientas de análisis y visualización).
+// Solo mapea el segmento en lectura: un lector nunca retrasa al simulador, y si se queda atrás
+// simplemente salta al último snapshot. Lanza std::runtime_error si el segmento no existe o no
+// tiene el formato esperado; con tryOpen se puede esperar a que el simulador arranque.
+class SharedSnapshotReader {
+public:
+    explicit SharedSnapshotReader(const std::string& name);
+    ~SharedSnapshotReader();
+
+    // nullptr mientras el segmento no exista o no esté inicializado; lanza si el formato no encaja
+    static std::unique_ptr<SharedSnapshotReader> tryOpen(const std::string& name);
+
+    // Último snapshot publicado, si es más nuevo que el anterior devuelto. false si no hay ninguno
+    // nuevo o si el escritor lo está reescribiendo en este momento (basta con volver a intentarlo).
+    bool acquireLatest(SnapshotView& view);
+    // true si el slot de view no se ha tocado desde acquireLatest: lo leído es consistente
+    bool isStillValid(const SnapshotView& view) const;
+    // Atajo con copia: acquireLatest + copia a out + isStillValid. out se reutiliza entre llamadas.
+    bool copyLatest(std::vector<SharedParticle>& out, SnapshotView& info);
+
+    bool isWriterClosed() const;
+    uint64_t getWriterPid() const { return header_->writerPid; }
+    size_t getCapacity() const { return static_cast<size_t>(header_->slotCapacity); }
+    uint32_t getSlotCount() const { return header_->slotCount; }
+
+    SharedSnapshotReader(const SharedSnapshotReader&) = delete;
+    SharedSnapshotReader& operator=(const SharedSnapshotReader&) = delete;
+
+private:
+    SharedSnapshotReader() = default;
+    bool map(const std::string& name, bool throwIfMissing);
+    const SharedSnapshotSlot& getSlot(uint64_t frame) const;
+
+    size_t mappedBytes_ = 0;
+    const void* mapped_ = nullptr;
+    const SharedSnapshotHeader* header_ = nullptr;
+    uint64_t lastFrame_ = 0;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_SHARED_SNAPSHOT_READER_HPP
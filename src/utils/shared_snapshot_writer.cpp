@@ -0,0 +1,122 @@
+#include "shared_snapshot_writer.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace particulas {
+
+namespace {
+
+// Bloque de partículas por tarea al copiar en paralelo (1 MiB)
+constexpr size_t COPY_GRAIN_SIZE = 32768;
+
+static_assert(sizeof(Particle) == sizeof(SharedParticle), "Particle and SharedParticle must have the same size");
+static_assert(offsetof(Particle, age) == offsetof(SharedParticle, age), "Particle and SharedParticle layouts differ");
+static_assert(offsetof(Particle, species) == offsetof(SharedParticle, species), "Particle and SharedParticle layouts differ");
+static_assert(offsetof(Particle, alive) == offsetof(SharedParticle, alive), "Particle and SharedParticle layouts differ");
+
+} // namespace
+
+#ifndef _WIN32
+
+SharedSnapshotWriter::SharedSnapshotWriter(const std::string& name, size_t particleCapacity, uint32_t slotCount)
+    : name_(name), capacity_(particleCapacity), slotCount_(std::max<uint32_t>(slotCount, 2)) {
+    // Un segmento de una ejecución anterior que no terminó bien puede tener otro tamaño
+    shm_unlink(name_.c_str());
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd == -1) throw std::runtime_error("Shared snapshots: shm_open(" + name_ + "): " + std::strerror(errno));
+
+    mappedBytes_ = sharedSnapshotTotalBytes(slotCount_, capacity_);
+    if (ftruncate(fd, static_cast<off_t>(mappedBytes_)) == -1) {
+        std::string error = std::strerror(errno);
+        close(fd); shm_unlink(name_.c_str());
+        throw std::runtime_error("Shared snapshots: cannot size " + name_ + " to " + std::to_string(mappedBytes_) + " bytes: " + error);
+    }
+    mapped_ = mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // El mapeo mantiene el segmento
+    if (mapped_ == MAP_FAILED) {
+        mapped_ = nullptr;
+        shm_unlink(name_.c_str());
+        throw std::runtime_error(std::string("Shared snapshots: mmap: ") + std::strerror(errno));
+    }
+
+    // ftruncate deja el segmento a cero: basta con rellenar la cabecera. El magic va el último
+    // para que un lector que se adelante vea un segmento todavía sin inicializar.
+    header_ = static_cast<SharedSnapshotHeader*>(mapped_);
+    header_->version = SHARED_SNAPSHOT_VERSION;
+    header_->slotCount = slotCount_;
+    header_->particleSize = sizeof(SharedParticle);
+    header_->slotCapacity = capacity_;
+    header_->slotBytes = sharedSnapshotSlotBytes(capacity_);
+    header_->writerPid = static_cast<uint64_t>(getpid());
+    header_->magic.store(SHARED_SNAPSHOT_MAGIC, std::memory_order_release);
+}
+
+SharedSnapshotWriter::~SharedSnapshotWriter() {
+    if (mapped_ == nullptr) return;
+    header_->writerClosed.store(1, std::memory_order_release);
+    munmap(mapped_, mappedBytes_);
+    // Los lectores que ya lo tienen mapeado siguen leyendo el último snapshot; el nombre desaparece
+    shm_unlink(name_.c_str());
+}
+
+SharedSnapshotSlot& SharedSnapshotWriter::getSlot(uint64_t frame) const {
+    char* base = static_cast<char*>(mapped_) + sizeof(SharedSnapshotHeader);
+    return *reinterpret_cast<SharedSnapshotSlot*>(base + (frame % slotCount_) * header_->slotBytes);
+}
+
+void SharedSnapshotWriter::publish(const Particle* particles, size_t count, uint64_t simulationStep, ThreadPool* pool) {
+    count = std::min(count, capacity_);
+    uint64_t frame = ++frame_;
+    SharedSnapshotSlot& slot = getSlot(frame);
+    auto* destination = reinterpret_cast<SharedParticle*>(&slot + 1);
+
+    // Seqlock: secuencia impar, barrera, datos, secuencia par. Un lector que vea la misma
+    // secuencia par antes y después de leer tiene un snapshot entero.
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.frame.store(frame, std::memory_order_relaxed);
+    slot.simulationStep.store(simulationStep, std::memory_order_relaxed);
+    slot.particleCount.store(count, std::memory_order_relaxed);
+    slot.timestampNanoseconds.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count()), std::memory_order_relaxed);
+    auto copy = [&](size_t begin, size_t end) {
+        std::memcpy(destination + begin, particles + begin, (end - begin) * sizeof(Particle));
+    };
+    if (pool != nullptr && count > COPY_GRAIN_SIZE) pool->parallelFor(0, count, COPY_GRAIN_SIZE, copy);
+    else copy(0, count);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    header_->latestFrame.store(frame, std::memory_order_release);
+}
+
+#else
+
+SharedSnapshotWriter::SharedSnapshotWriter(const std::string& name, size_t particleCapacity, uint32_t slotCount)
+    : name_(name), capacity_(particleCapacity), slotCount_(slotCount) {
+    throw std::runtime_error("Shared snapshots: only available on POSIX systems");
+}
+
+SharedSnapshotWriter::~SharedSnapshotWriter() = default;
+
+SharedSnapshotSlot& SharedSnapshotWriter::getSlot(uint64_t) const { return *static_cast<SharedSnapshotSlot*>(mapped_); }
+
+void SharedSnapshotWriter::publish(const Particle*, size_t, uint64_t, ThreadPool*) {}
+
+#endif
+
+} // namespace particulas
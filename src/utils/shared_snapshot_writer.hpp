@@ -0,0 +1,50 @@
+#ifndef PARTICULAS_UTILS_SHARED_SNAPSHOT_WRITER_HPP
+#define PARTICULAS_UTILS_SHARED_SNAPSHOT_WRITER_HPP
+
+#include "utils/shared_snapshot.hpp"
+#include "particles/particle.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace particulas {
+
+class ThreadPool;
+
+// Publica snapshots de la simulación en memoria compartida POSIX (shm_open + mmap) con el layout
+// de shared_snapshot.hpp. publish() copia las partículas al siguiente slot del anillo (en
+// paralelo si se le pasa el pool) y no se bloquea nunca por los lectores. El segmento se crea
+// (o se reemplaza) al construir y se borra al destruir.
+// Lanza std::runtime_error si no puede crearlo (o fuera de POSIX).
+class SharedSnapshotWriter {
+public:
+    // name: nombre POSIX del segmento, p. ej. "/particulas_snapshots"
+    SharedSnapshotWriter(const std::string& name, size_t particleCapacity, uint32_t slotCount);
+    ~SharedSnapshotWriter();
+
+    // Publica [0, count) de particles; más allá de la capacidad se recorta. No reserva memoria.
+    void publish(const Particle* particles, size_t count, uint64_t simulationStep, ThreadPool* pool = nullptr);
+
+    const std::string& getName() const { return name_; }
+    size_t getCapacity() const { return capacity_; }
+    uint64_t getPublishedFrames() const { return frame_; }
+
+    SharedSnapshotWriter(const SharedSnapshotWriter&) = delete;
+    SharedSnapshotWriter& operator=(const SharedSnapshotWriter&) = delete;
+
+private:
+    SharedSnapshotSlot& getSlot(uint64_t frame) const;
+
+    std::string name_;
+    size_t capacity_;
+    uint32_t slotCount_;
+    size_t mappedBytes_ = 0;
+    void* mapped_ = nullptr;
+    SharedSnapshotHeader* header_ = nullptr;
+    uint64_t frame_ = 0;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_SHARED_SNAPSHOT_WRITER_HPP
@@ -0,0 +1,28 @@
+#include "startup_timer.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+namespace particulas {
+
+double StartupTimer::getElapsedMilliseconds() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+}
+
+void StartupTimer::print() const {
+    double total = getElapsedMilliseconds();
+    std::cout << "--- Startup time breakdown ---\n";
+    std::cout << std::left << std::setw(34) << "step" << std::right << std::setw(10) << "ms" << std::setw(8) << "%" << "\n";
+    for (const Step& step : steps_) {
+        std::string label = std::string(static_cast<size_t>(step.depth) * 2, ' ') + step.name;
+        std::cout << std::left << std::setw(34) << label << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << step.milliseconds << std::setprecision(1)
+                  << std::setw(7) << (total > 0.0 ? 100.0 * step.milliseconds / total : 0.0) << "%\n";
+    }
+    std::cout << std::left << std::setw(34) << "total" << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << total << "\n";
+    for (const std::string& note : notes_) std::cout << "  " << note << "\n";
+    std::cout << std::defaultfloat << std::flush;
+}
+
+} // namespace particulas
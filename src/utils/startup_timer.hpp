@@ -0,0 +1,54 @@
+#ifndef PARTICULAS_UTILS_STARTUP_TIMER_HPP
+#define PARTICULAS_UTILS_STARTUP_TIMER_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace particulas {
+
+// Desglose del tiempo de arranque por pasos. Los pasos pueden anidarse (measure dentro de
+// measure); la tabla muestra la jerarquía con sangría y el porcentaje sobre el total medido.
+class StartupTimer {
+public:
+    StartupTimer() : start_(std::chrono::steady_clock::now()) {}
+
+    template <typename Fn>
+    void measure(const std::string& step, Fn&& fn) {
+        size_t index = steps_.size();
+        steps_.push_back({step, depth_, 0.0});
+        ++depth_;
+        auto begin = std::chrono::steady_clock::now();
+        try {
+            fn();
+        } catch (...) {
+            --depth_;
+            throw;
+        }
+        steps_[index].milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        --depth_;
+    }
+
+    // Tiempo desde la construcción hasta ahora
+    double getElapsedMilliseconds() const;
+
+    // Imprime la tabla (paso, ms, % del total) seguida de las notas añadidas con addNote
+    void print() const;
+    void addNote(const std::string& note) { notes_.push_back(note); }
+
+private:
+    struct Step {
+        std::string name;
+        int depth;
+        double milliseconds;
+    };
+
+    std::chrono::steady_clock::time_point start_;
+    std::vector<Step> steps_;
+    std::vector<std::string> notes_;
+    int depth_ = 0;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_STARTUP_TIMER_HPP
@@ -0,0 +1,119 @@
+#include "sweep_report.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <utility>
+
+namespace particulas {
+
+namespace {
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t index = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, index > 0 ? index - 1 : 0)];
+}
+
+// Las comas separarían columnas: los valores de las listas no las llevan, pero el nombre de la sección sí podría
+std::string csvField(const std::string& text) {
+    if (text.find_first_of(",\"") == std::string::npos) return text;
+    std::string quoted = "\"";
+    for (char c : text) quoted += (c == '"') ? std::string("\"\"") : std::string(1, c);
+    return quoted + "\"";
+}
+
+// Valor de la curva en el eje: los hilos de verdad (threads = 0 son todos) y las partículas pedidas
+double getAxisValue(const ScenarioResult& result, const std::string& axis) {
+    return axis == "threads" ? static_cast<double>(result.threads) : static_cast<double>(result.scenario.particleCount);
+}
+
+} // namespace
+
+void summarizeFrameTimes(std::vector<double>& frameSeconds, ScenarioResult& result) {
+    result.frames = frameSeconds.size();
+    if (frameSeconds.empty()) return;
+    std::sort(frameSeconds.begin(), frameSeconds.end());
+    double sum = 0.0;
+    for (double seconds : frameSeconds) sum += seconds;
+    result.meanFrameMs = sum * 1000.0 / static_cast<double>(frameSeconds.size());
+    result.p50FrameMs = percentile(frameSeconds, 0.50) * 1000.0;
+    result.p95FrameMs = percentile(frameSeconds, 0.95) * 1000.0;
+    result.p99FrameMs = percentile(frameSeconds, 0.99) * 1000.0;
+    result.maxFrameMs = frameSeconds.back() * 1000.0;
+}
+
+void writeSweepResults(std::ostream& out, const std::vector<ScenarioResult>& results) {
+    out << "scenario,swept,particles,capacity,distribution,physics,simulation,renderer,present_mode,width,height,threads,"
+           "simulation_rate_hz,frames,seconds,fps,mean_frame_ms,p50_frame_ms,p95_frame_ms,p99_frame_ms,max_frame_ms,"
+           "mean_simulate_ms,particle_updates_per_s,mean_live_particles,mean_drawn_particles,frame_budget_ms,quality_decisions,"
+           "final_substeps,final_render_scale,final_draw_fraction\n";
+    out << std::fixed << std::setprecision(3);
+    for (const ScenarioResult& result : results) {
+        const Scenario& scenario = result.scenario;
+        std::string swept;
+        for (const auto& value : scenario.sweptValues) swept += (swept.empty() ? "" : " ") + value.first + "=" + value.second;
+        out << csvField(scenario.name) << ',' << swept << ',' << scenario.particleCount << ',' << scenario.capacity << ','
+            << distributionName(scenario.distribution) << ',' << physicsModeName(scenario.physics) << ','
+            << (scenario.simulateOnGpu ? "gpu" : "cpu") << ',' << (scenario.splats ? "splats" : "points") << ','
+            << result.presentMode << ',' << result.width << ',' << result.height << ',' << result.threads << ','
+            << scenario.simulationRateHz << ',' << result.frames << ',' << result.seconds << ',' << result.getFps() << ','
+            << result.meanFrameMs << ',' << result.p50FrameMs << ',' << result.p95FrameMs << ',' << result.p99FrameMs << ','
+            << result.maxFrameMs << ',' << result.meanSimulateMs << ',' << result.particleUpdatesPerSecond << ','
+            << result.meanLiveParticles << ',' << result.meanDrawnParticles << ',' << scenario.frameBudgetMs << ','
+            << result.qualityDecisions << ',' << result.finalSubsteps << ',' << result.finalRenderScale << ','
+            << result.finalDrawFraction << '\n';
+    }
+}
+
+void writeScalingCurves(std::ostream& out, const std::vector<ScenarioResult>& results) {
+    out << "axis,curve,x,fps,mean_frame_ms,p99_frame_ms,particle_updates_per_s,ns_per_update,speedup,parallel_efficiency\n";
+    out << std::fixed << std::setprecision(3);
+    for (const std::string axis : {"particles", "threads"}) {
+        // Curva = sección + valores del resto de claves con lista; en orden de aparición
+        std::vector<std::pair<std::string, std::vector<const ScenarioResult*>>> curves;
+        for (const ScenarioResult& result : results) {
+            const Scenario& scenario = result.scenario;
+            bool onAxis = false;
+            std::string curve = scenario.name;
+            for (const auto& value : scenario.sweptValues) {
+                if (value.first == axis) onAxis = true;
+                else curve += " " + value.first + "=" + value.second;
+            }
+            if (!onAxis) continue;
+            auto existing = std::find_if(curves.begin(), curves.end(), [&](const auto& entry) { return entry.first == curve; });
+            if (existing == curves.end()) curves.push_back({curve, {&result}});
+            else existing->second.push_back(&result);
+        }
+        for (auto& curve : curves) {
+            std::vector<const ScenarioResult*>& points = curve.second;
+            std::stable_sort(points.begin(), points.end(), [&](const ScenarioResult* a, const ScenarioResult* b) {
+                return getAxisValue(*a, axis) < getAxisValue(*b, axis);
+            });
+            const ScenarioResult& first = *points.front();
+            for (const ScenarioResult* point : points) {
+                double speedup = first.particleUpdatesPerSecond > 0.0 ? point->particleUpdatesPerSecond / first.particleUpdatesPerSecond : 0.0;
+                double nsPerUpdate = point->particleUpdatesPerSecond > 0.0 ? 1e9 / point->particleUpdatesPerSecond : 0.0;
+                out << axis << ',' << csvField(curve.first) << ',' << std::setprecision(0) << getAxisValue(*point, axis) << std::setprecision(3) << ','
+                    << point->getFps() << ',' << point->meanFrameMs << ',' << point->p99FrameMs << ','
+                    << point->particleUpdatesPerSecond << ',' << nsPerUpdate << ',' << speedup << ',';
+                if (axis == "threads" && first.threads > 0) out << speedup * first.threads / point->threads;
+                out << '\n';
+            }
+        }
+    }
+}
+
+void printSweepSummary(std::ostream& out, const std::vector<ScenarioResult>& results) {
+    out << "--- Sweep results (" << results.size() << " scenarios) ---\n";
+    out << std::left << std::setw(40) << "scenario" << std::right << std::setw(10) << "fps" << std::setw(10) << "mean ms"
+        << std::setw(10) << "p99 ms" << std::setw(12) << "sim ms" << std::setw(16) << "Mupdates/s" << "\n";
+    for (const ScenarioResult& result : results) {
+        out << std::left << std::setw(40) << result.scenario.getLabel() << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << result.getFps() << std::setprecision(2) << std::setw(10) << result.meanFrameMs
+            << std::setw(10) << result.p99FrameMs << std::setw(12) << result.meanSimulateMs
+            << std::setw(16) << result.particleUpdatesPerSecond / 1e6 << "\n";
+    }
+    out << std::defaultfloat;
+}
+
+} // namespace particulas
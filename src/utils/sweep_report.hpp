@@ -0,0 +1,53 @@
+#ifndef PARTICULAS_UTILS_SWEEP_REPORT_HPP
+#define PARTICULAS_UTILS_SWEEP_REPORT_HPP
+
+#include "scenario.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace particulas {
+
+// Lo medido en un escenario tras el calentamiento
+struct ScenarioResult {
+    Scenario scenario;
+    // Lo que se obtuvo de verdad (el modo de presentación o el tamaño pueden no estar disponibles)
+    uint32_t width = 0, height = 0;
+    std::string presentMode;
+    int threads = 0;
+
+    uint64_t frames = 0;
+    double seconds = 0.0;
+    double meanFrameMs = 0.0, p50FrameMs = 0.0, p95FrameMs = 0.0, p99FrameMs = 0.0, maxFrameMs = 0.0;
+    double meanSimulateMs = 0.0;
+    double particleUpdatesPerSecond = 0.0; // Partículas vivas x pasos de simulación por segundo
+    double meanLiveParticles = 0.0;
+    double meanDrawnParticles = 0.0;
+    // Controlador de calidad (frame_budget > 0): decisiones durante la medida y niveles al acabar
+    uint64_t qualityDecisions = 0;
+    int finalSubsteps = 1;
+    float finalRenderScale = 1.0f;
+    float finalDrawFraction = 1.0f;
+
+    double getFps() const { return seconds > 0.0 ? static_cast<double>(frames) / seconds : 0.0; }
+};
+
+// Rellena frames y los tiempos por frame (media y percentiles); ordena frameSeconds
+void summarizeFrameTimes(std::vector<double>& frameSeconds, ScenarioResult& result);
+
+// Tabla consolidada: una fila por escenario (CSV con cabecera)
+void writeSweepResults(std::ostream& out, const std::vector<ScenarioResult>& results);
+
+// Curvas de escalado (CSV): para cada sección en la que particles o threads lleva una lista, los
+// puntos que solo difieren en esa clave, ordenados, con el rendimiento relativo al primero. Con
+// threads, además la eficiencia paralela (speedup / hilos relativos).
+void writeScalingCurves(std::ostream& out, const std::vector<ScenarioResult>& results);
+
+// Resumen legible para la consola
+void printSweepSummary(std::ostream& out, const std::vector<ScenarioResult>& results);
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_SWEEP_REPORT_HPP
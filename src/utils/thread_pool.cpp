@@ -0,0 +1,125 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+namespace particulas {
+
+namespace {
+thread_local size_t currentThreadIndex = 0;
+}
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 1 ? hw - 1 : 0;
+    }
+    activeWorkerLimit_ = threadCount;
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this, i]() {
+            currentThreadIndex = i + 1;
+            workerLoop(i);
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeCondition_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+size_t ThreadPool::getCurrentThreadIndex() {
+    return currentThreadIndex;
+}
+
+void ThreadPool::setActiveWorkerCount(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    activeWorkerLimit_ = std::min(count, workers_.size());
+}
+
+void ThreadPool::runParallelFor(size_t begin, size_t end, size_t grainSize, ChunkFunction function, const void* body) {
+    if (begin >= end) return;
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    // Trabajo pequeño o sin workers: ejecutar en línea, sin sincronización
+    if (activeWorkerLimit_ == 0 || end - begin <= grainSize) {
+        function(body, begin, end);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chunkFunction_ = function;
+        body_ = body;
+        nextIndex_.store(begin, std::memory_order_relaxed);
+        endIndex_ = end;
+        grainSize_ = grainSize;
+        participants_ = activeWorkerLimit_;
+        activeWorkers_ = participants_;
+        ++generation_;
+    }
+    wakeCondition_.notify_all();
+
+    runChunks(); // El hilo llamante también procesa bloques
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCondition_.wait(lock, [this]() { return activeWorkers_ == 0; });
+    body_ = nullptr;
+}
+
+void ThreadPool::runOnEachThread(const std::function<void(size_t)>& body) {
+    if (!workers_.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        perThreadBody_ = &body;
+        participants_ = workers_.size();
+        activeWorkers_ = participants_;
+        ++generation_;
+    }
+    wakeCondition_.notify_all();
+
+    body(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCondition_.wait(lock, [this]() { return activeWorkers_ == 0; });
+    perThreadBody_ = nullptr;
+}
+
+void ThreadPool::runChunks() {
+    for (;;) {
+        size_t chunkBegin = nextIndex_.fetch_add(grainSize_, std::memory_order_relaxed);
+        if (chunkBegin >= endIndex_) break;
+        size_t chunkEnd = std::min(chunkBegin + grainSize_, endIndex_);
+        chunkFunction_(body_, chunkBegin, chunkEnd);
+    }
+}
+
+void ThreadPool::workerLoop(size_t workerIndex) {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        const std::function<void(size_t)>* perThreadBody = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeCondition_.wait(lock, [&]() { return stopping_ || generation_ != seenGeneration; });
+            if (stopping_) return;
+            seenGeneration = generation_;
+            if (workerIndex >= participants_) continue; // Fuera del límite: no cuenta en activeWorkers_
+            perThreadBody = perThreadBody_;
+        }
+
+        if (perThreadBody) (*perThreadBody)(workerIndex + 1);
+        else runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--activeWorkers_ == 0) doneCondition_.notify_one();
+        }
+    }
+}
+
+} // namespace particulas
@@ -0,0 +1,85 @@
+#ifndef PARTICULAS_UTILS_THREAD_POOL_HPP
+#define PARTICULAS_UTILS_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace particulas {
+
+// Pool de hilos persistente para bucles paralelos (parallelFor).
+// El hilo que llama también trabaja, así que un pool de N hilos usa N+1 núcleos.
+class ThreadPool {
+public:
+    // threadCount == 0 -> usar hardware_concurrency() - 1 (mínimo 0 hilos extra)
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    // Ejecuta body(chunkBegin, chunkEnd) sobre [begin, end) repartido en bloques de grainSize.
+    // Bloquea hasta que todos los bloques terminan. body se usa por referencia (no se copia a un
+    // std::function), así que una lambda con capturas no reserva memoria en cada llamada.
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grainSize, const Body& body) {
+        runParallelFor(begin, end, grainSize, &invokeChunk<Body>, &body);
+    }
+
+    // Ejecuta body(threadIndex) exactamente una vez en cada hilo del pool, incluido el que llama
+    // (índice 0), sin importar el límite de setActiveWorkerCount. Para inicializar estado por hilo;
+    // body no debe lanzar (en un worker terminaría el proceso).
+    void runOnEachThread(const std::function<void(size_t)>& body);
+
+    // Número total de hilos que participan (workers + hilo llamante)
+    size_t getConcurrency() const { return workers_.size() + 1; }
+
+    // Limita los workers que procesan bloques en los siguientes parallelFor (el resto vuelve a esperar).
+    // Los hilos no se crean ni se destruyen: los índices de getCurrentThreadIndex no cambian.
+    // Solo desde el hilo que llama a parallelFor y fuera de él.
+    void setActiveWorkerCount(size_t count);
+    size_t getActiveWorkerCount() const { return activeWorkerLimit_; }
+
+    // Índice del hilo actual dentro del pool: 0 para el hilo llamante (o cualquier hilo ajeno),
+    // 1..N para los workers. Permite a cada hilo usar recursos propios (p. ej. command pools).
+    static size_t getCurrentThreadIndex();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+    using ChunkFunction = void (*)(const void* body, size_t chunkBegin, size_t chunkEnd);
+
+    template <typename Body>
+    static void invokeChunk(const void* body, size_t chunkBegin, size_t chunkEnd) {
+        (*static_cast<const Body*>(body))(chunkBegin, chunkEnd);
+    }
+
+    void runParallelFor(size_t begin, size_t end, size_t grainSize, ChunkFunction function, const void* body);
+    void workerLoop(size_t workerIndex);
+    void runChunks();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wakeCondition_;
+    std::condition_variable doneCondition_;
+    bool stopping_ = false;
+    uint64_t generation_ = 0;   // Se incrementa con cada parallelFor para despertar a los workers
+    size_t activeWorkers_ = 0;  // Workers que aún no han terminado el trabajo actual
+    size_t participants_ = 0;   // Workers [0, participants_) despertados para el trabajo actual
+    size_t activeWorkerLimit_;  // Workers que participan en cada parallelFor
+
+    // --- Trabajo actual (válido solo durante parallelFor) ---
+    ChunkFunction chunkFunction_ = nullptr;
+    const void* body_ = nullptr;
+    const std::function<void(size_t)>* perThreadBody_ = nullptr; // Solo durante runOnEachThread
+    std::atomic<size_t> nextIndex_{0};
+    size_t endIndex_ = 0;
+    size_t grainSize_ = 1;
+};
+
+} // namespace particulas
+
+#endif // PARTICULAS_UTILS_THREAD_POOL_HPP
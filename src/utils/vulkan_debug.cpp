@@ -1,14 +1,16 @@
 #include "vulkan_debug.hpp"
-#include <iostream> // Para std::cerr y std::cout
+#include "utils/logger.hpp"
 
 namespace particulas::debug {
 
 // --- Implementación de checkVkResult ---
 void checkVkResult(VkResult result, const std::string& originMessage) {
-    if (result != VK_SUCCESS) {
-        // Podríamos tener una función más elaborada para convertir VkResult a string
-        throw std::runtime_error(originMessage + " failed! Vulkan Error code: " + std::to_string(result));
-    }
+    if (result != VK_SUCCESS) throwVkError(result, originMessage.c_str());
+}
+
+void throwVkError(VkResult result, const char* originMessage) {
+    // Podríamos tener una función más elaborada para convertir VkResult a string
+    throw std::runtime_error(std::string(originMessage) + " failed! Vulkan Error code: " + std::to_string(result));
 }
 
 // --- Implementación de las Funciones del Debug Messenger ---
@@ -67,32 +69,27 @@ VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
     const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
     void* pUserData) { // pUserData no se usa aquí, pero está disponible
 
-    // Imprimir mensajes de error en std::cerr, otros en std::cout
-    std::ostream& output_stream = (messageSeverity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) ? std::cerr : std::cout;
-
-    output_stream << "Validation Layer ";
-
-    // Añadir etiquetas de severidad para claridad
-    if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
-        output_stream << "[ERROR]";
-    } else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
-        output_stream << "[WARNING]";
-    } else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) {
-        output_stream << "[INFO]";
-    } else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT) {
-        output_stream << "[VERBOSE]";
-    }
-
-    // Añadir etiquetas de tipo
+    // Etiqueta de tipo para claridad
+    const char* type = "";
     if (messageType & VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT) {
-        output_stream << "[GENERAL]";
+        type = "[GENERAL]";
     } else if (messageType & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) {
-        output_stream << "[VALIDATION]";
+        type = "[VALIDATION]";
     } else if (messageType & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT) {
-        output_stream << "[PERFORMANCE]";
+        type = "[PERFORMANCE]";
     }
 
-    output_stream << ": " << pCallbackData->pMessage << std::endl;
+    // La capa llama desde dentro de las funciones de Vulkan (también en el bucle de frame): el
+    // logger asíncrono evita escribir en la consola desde aquí. Errores y avisos van a stderr.
+    if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
+        PARTICULAS_LOG(Error) << "Validation Layer " << type << ": " << pCallbackData->pMessage;
+    } else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
+        PARTICULAS_LOG(Warning) << "Validation Layer " << type << ": " << pCallbackData->pMessage;
+    } else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) {
+        PARTICULAS_LOG(Info) << "Validation Layer " << type << ": " << pCallbackData->pMessage;
+    } else {
+        PARTICULAS_LOG(Debug) << "Validation Layer " << type << ": " << pCallbackData->pMessage;
+    }
 
     // La especificación indica que la aplicación debe devolver VK_FALSE siempre.
     return VK_FALSE;
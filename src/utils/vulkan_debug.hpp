@@ -10,6 +10,14 @@ namespace particulas::debug { // Usamos un sub-namespace para claridad
 // Declaración para verificar los resultados de Vulkan. Lanza excepción en error.
 void checkVkResult(VkResult result, const std::string& originMessage);
 
+[[noreturn]] void throwVkError(VkResult result, const char* originMessage);
+
+// Sobrecarga para literales (la del bucle de frame): el mensaje solo se convierte en std::string
+// si hay error, así que comprobar un resultado correcto no reserva memoria.
+inline void checkVkResult(VkResult result, const char* originMessage) {
+    if (result != VK_SUCCESS) throwVkError(result, originMessage);
+}
+
 // Configura el debug messenger de Vulkan.
 // Devuelve el resultado de vkCreateDebugUtilsMessengerEXT.
 VkResult setupDebugMessenger(VkInstance instance,
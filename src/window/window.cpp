@@ -36,22 +36,72 @@ void Window::initWindow() {
 
      // Puedes añadir callbacks aquí si los necesitas (p.ej., teclado, ratón)
      // glfwSetKeyCallback(window_, key_callback);
+     glfwSetWindowUserPointer(window_, this);
+     glfwSetScrollCallback(window_, scrollCallback);
+}
+
+void Window::scrollCallback(GLFWwindow* window, double /*xOffset*/, double yOffset) {
+    auto* self = static_cast<Window*>(glfwGetWindowUserPointer(window));
+    if (self) self->scrollDelta_ += yOffset;
+}
+
+double Window::consumeScrollDelta() {
+    double delta = scrollDelta_;
+    scrollDelta_ = 0.0;
+    return delta;
 }
 
 bool Window::shouldClose() const {
     return glfwWindowShouldClose(window_);
 }
 
+bool Window::isKeyPressed(int key) const {
+    return glfwGetKey(window_, key) == GLFW_PRESS;
+}
+
+bool Window::isMouseButtonPressed(int button) const {
+    return glfwGetMouseButton(window_, button) == GLFW_PRESS;
+}
+
+void Window::getCursorPosition(double& x, double& y) const {
+    glfwGetCursorPos(window_, &x, &y);
+    // Coordenadas de ventana -> framebuffer (difieren en pantallas HiDPI)
+    int windowWidth = 0, windowHeight = 0, framebufferWidth = 0, framebufferHeight = 0;
+    glfwGetWindowSize(window_, &windowWidth, &windowHeight);
+    glfwGetFramebufferSize(window_, &framebufferWidth, &framebufferHeight);
+    if (windowWidth > 0 && windowHeight > 0) {
+        x *= static_cast<double>(framebufferWidth) / windowWidth;
+        y *= static_cast<double>(framebufferHeight) / windowHeight;
+    }
+}
+
 void Window::pollEvents() const {
     glfwPollEvents();
 }
 
+void Window::waitEvents() const {
+    glfwWaitEvents();
+}
+
 VkExtent2D Window::getFramebufferExtent() const {
     int width, height;
     glfwGetFramebufferSize(window_, &width, &height);
     return {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
 }
 
+bool Window::setSize(int width, int height, double timeoutSeconds) {
+    glfwSetWindowSize(window_, width, height);
+    double deadline = glfwGetTime() + timeoutSeconds;
+    int currentWidth = 0, currentHeight = 0;
+    do {
+        glfwWaitEventsTimeout(0.01);
+        glfwGetWindowSize(window_, &currentWidth, &currentHeight);
+    } while ((currentWidth != width || currentHeight != height) && glfwGetTime() < deadline);
+    width_ = currentWidth;
+    height_ = currentHeight;
+    return currentWidth == width && currentHeight == height;
+}
+
 VkResult Window::createSurface(VkInstance instance, VkSurfaceKHR* surface) {
     // GLFW proporciona esta función para crear la superficie de Vulkan específica de la plataforma
     if (glfwCreateWindowSurface(instance, window_, nullptr, surface) != VK_SUCCESS) {
@@ -27,6 +27,9 @@ public:
     // Procesa los eventos pendientes de GLFW (teclado, ratón, etc.).
     void pollEvents() const;
 
+    // Bloquea hasta que llegue algún evento (p. ej. mientras la ventana está minimizada).
+    void waitEvents() const;
+
     // --- Getters ---
 
     int getWidth() const { return width_; }
@@ -35,6 +38,21 @@ public:
     // Obtiene el tamaño del framebuffer (puede ser diferente al tamaño de la ventana en pantallas HiDPI).
     VkExtent2D getFramebufferExtent() const;
 
+    // Cambia el tamaño de la ventana (la ventana no es redimensionable por el usuario). El gestor de
+    // ventanas lo aplica de forma asíncrona: se procesan eventos hasta que el framebuffer lo refleja
+    // o pasa timeoutSeconds. Devuelve false si no llegó a cambiar (p. ej. tamaño mayor que la pantalla).
+    bool setSize(int width, int height, double timeoutSeconds = 1.0);
+
+    // Estado actual de una tecla (GLFW_KEY_*)
+    bool isKeyPressed(int key) const;
+    bool isMouseButtonPressed(int button) const;
+
+    // Posición del cursor en píxeles del framebuffer (origen arriba a la izquierda)
+    void getCursorPosition(double& x, double& y) const;
+
+    // Desplazamiento vertical de la rueda acumulado desde la última llamada
+    double consumeScrollDelta();
+
     // Crea la superficie de Vulkan para esta ventana.
     // Necesita la instancia de Vulkan para crear la superficie.
     VkResult createSurface(VkInstance instance, VkSurfaceKHR* surface);
@@ -49,6 +67,9 @@ private:
     int width_;
     int height_;
     std::string title_;
+    double scrollDelta_ = 0.0; // Acumulado por el callback de GLFW
+
+    static void scrollCallback(GLFWwindow* window, double xOffset, double yOffset);
 
     // --- Inicialización ---
     void initWindow(); // Función privada llamada por el constructor